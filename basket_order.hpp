@@ -0,0 +1,504 @@
+// basket_order.hpp - Atomic multi-leg order baskets: combined risk check, back-to-back dispatch, leg-failure handling
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdio>
+#include <functional>
+#include <vector>
+#include "messages.hpp"
+#include "order_manager.hpp"
+
+namespace hft {
+
+/**
+ * One leg of a basket (always a market order)
+ */
+struct BasketLeg {
+    SymbolId symbol;
+    Side side;
+    Venue venue;
+    Quantity quantity;
+    double reference_price;     // Expected fill price; sizes the leg's notional for the risk check
+};
+
+/**
+ * What to do when a leg comes back short
+ *
+ * UNWIND: all or nothing - flatten whatever the other legs filled (entries).
+ * HEDGE:  re-send the missing quantity to restore the hedge, up to
+ *         max_hedge_attempts; never unwinds (exits).
+ */
+enum class LegFailurePolicy : uint8_t {
+    UNWIND = 0,
+    HEDGE = 1
+};
+
+/**
+ * Basket order: legs in one contiguous buffer
+ */
+struct BasketOrder {
+    static constexpr size_t MAX_LEGS = 8;
+
+    std::array<BasketLeg, MAX_LEGS> legs;
+    uint8_t leg_count = 0;
+    uint64_t client_tag = 0;        // Opaque; echoed in the BasketResult
+    StrategyId strategy = 0;
+    LegFailurePolicy on_leg_failure = LegFailurePolicy::UNWIND;
+    uint8_t max_hedge_attempts = 2;
+    bool reduce_only = false;       // Closes existing exposure; skips the exposure limits
+
+    bool add_leg(SymbolId symbol, Side side, Venue venue, Quantity quantity, double reference_price) {
+        if (leg_count == MAX_LEGS || quantity <= 0) return false;
+        legs[leg_count++] = BasketLeg{symbol, side, venue, quantity, reference_price};
+        return true;
+    }
+};
+
+/**
+ * Basket-level risk limits (0 = no limit)
+ */
+struct BasketRiskLimits {
+    double max_gross_notional = 0.0;        // Sum of leg notionals
+    double max_net_notional = 0.0;          // |buys - sells|
+    double max_leg_failure_exposure = 0.0;  // Worst |net| if any one leg fails while the rest fill
+};
+
+struct BasketExposure {
+    double gross = 0.0;
+    double net = 0.0;                       // Signed: buys positive
+    double worst_leg_failure = 0.0;
+};
+
+/**
+ * Combined exposure of a basket in one pass over its legs
+ *
+ * If leg i fails the rest of the basket carries net - n_i, and |net - n|
+ * is largest at the smallest or largest signed leg notional n, so the
+ * worst single-leg failure only needs the running min and max.
+ */
+inline BasketExposure basket_exposure(const BasketOrder& basket) {
+    BasketExposure exposure;
+    double lowest = 0.0;
+    double highest = 0.0;
+    for (size_t i = 0; i < basket.leg_count; ++i) {
+        const BasketLeg& leg = basket.legs[i];
+        const double notional = to_float_quantity(leg.quantity) * leg.reference_price;
+        const double signed_notional = leg.side == Side::BUY ? notional : -notional;
+        exposure.gross += notional;
+        exposure.net += signed_notional;
+        if (i == 0 || signed_notional < lowest) lowest = signed_notional;
+        if (i == 0 || signed_notional > highest) highest = signed_notional;
+    }
+    if (basket.leg_count > 0) {
+        exposure.worst_leg_failure = std::max(std::abs(exposure.net - lowest), std::abs(exposure.net - highest));
+    }
+    return exposure;
+}
+
+enum class BasketStatus : uint8_t {
+    WORKING = 0,
+    HEDGING = 1,        // Re-sending missing leg quantity
+    UNWINDING = 2,      // Flattening legs that filled
+    COMPLETED = 3,      // Every leg fully filled
+    UNWOUND = 4,        // A leg failed; the others were flattened
+    INCOMPLETE = 5,     // HEDGE policy ran out of attempts; legs hold what they filled
+    BROKEN = 6          // Unwind itself came back short; residual exposure remains
+};
+
+inline const char* basket_status_name(BasketStatus status) {
+    switch (status) {
+        case BasketStatus::WORKING: return "WORKING";
+        case BasketStatus::HEDGING: return "HEDGING";
+        case BasketStatus::UNWINDING: return "UNWINDING";
+        case BasketStatus::COMPLETED: return "COMPLETED";
+        case BasketStatus::UNWOUND: return "UNWOUND";
+        case BasketStatus::INCOMPLETE: return "INCOMPLETE";
+        case BasketStatus::BROKEN: return "BROKEN";
+    }
+    return "UNKNOWN";
+}
+
+enum class BasketReject : uint8_t {
+    NONE = 0,
+    EMPTY = 1,
+    GROSS_LIMIT = 2,
+    NET_LIMIT = 3,
+    LEG_FAILURE_LIMIT = 4,
+    POOL_FULL = 5,
+    SUBMIT_FAILED = 6   // OMS ring full or rate limited
+};
+
+struct BasketLegResult {
+    SymbolId symbol;
+    Side side;
+    Quantity requested;
+    Quantity filled;            // Leg fills, including hedge re-sends
+    double notional;            // Of filled
+    Quantity unwound;           // Flattened again by the unwind
+    double unwind_notional;
+    int64_t fees;               // Fixed point (PRICE_MULTIPLIER), leg and unwind orders
+
+    double avg_price() const { return filled > 0 ? notional / to_float_quantity(filled) : 0.0; }
+};
+
+struct BasketResult {
+    uint64_t basket_id;
+    uint64_t client_tag;
+    BasketStatus status;
+    uint8_t leg_count;
+    std::array<BasketLegResult, BasketOrder::MAX_LEGS> legs;
+
+    // P&L realized by the unwind, net of every fee the basket paid
+    double unwind_pnl() const {
+        double pnl = 0.0;
+        for (size_t i = 0; i < leg_count; ++i) {
+            const BasketLegResult& leg = legs[i];
+            const double unwound = to_float_quantity(leg.unwound);
+            if (unwound > 0.0) {
+                const double sign = leg.side == Side::BUY ? 1.0 : -1.0;
+                pnl += sign * (leg.unwind_notional - leg.avg_price() * unwound);
+            }
+            pnl -= static_cast<double>(leg.fees) / PRICE_MULTIPLIER;
+        }
+        return pnl;
+    }
+};
+
+/**
+ * Basket Manager
+ *
+ * Takes a basket through one combined risk check (gross, net and worst
+ * single-leg-failure exposure), then hands every leg to the OMS with one
+ * OrderManager::submit_batch() call: the legs sit back to back in the
+ * request ring and leave in the same OMS poll. Leg orders are tagged
+ * BASKET_TAG | basket id; on_order_update() claims their updates, tracks
+ * leg completion, and applies the basket's LegFailurePolicy when a leg
+ * comes back short. Follow-up orders the OMS refuses are retried from
+ * on_timer(). Single-threaded: owned by the event loop that drains OMS
+ * updates.
+ */
+class BasketManager {
+public:
+    static constexpr uint64_t BASKET_TAG = 1ULL << 62;
+    static constexpr size_t DEFAULT_CAPACITY = 256;
+
+    using DoneCallback = std::function<void(const BasketResult&)>;
+
+    struct Stats {
+        uint64_t submitted = 0;
+        uint64_t risk_rejected = 0;
+        uint64_t submit_rejected = 0;
+        uint64_t legs_sent = 0;
+        uint64_t hedge_orders = 0;
+        uint64_t unwind_orders = 0;
+        uint64_t completed = 0;
+        uint64_t unwound = 0;
+        uint64_t incomplete = 0;
+        uint64_t broken = 0;
+        double unwind_pnl = 0.0;
+    };
+
+private:
+    struct LegState {
+        OrderId order_id = 0;       // Working leg, hedge or unwind order (0 = none)
+        bool unwinding = false;     // order_id is an unwind order
+        uint8_t hedge_attempts = 0;
+    };
+
+    struct Basket {
+        BasketOrder spec;
+        BasketResult result;
+        std::array<LegState, BasketOrder::MAX_LEGS> legs;
+        uint32_t generation = 0;
+        uint8_t working_orders = 0;
+        bool stalled = false;       // A follow-up submit was refused; retried from on_timer()
+        bool active = false;
+    };
+
+    OrderManager& oms_;
+    BasketRiskLimits limits_;
+    std::vector<Basket> baskets_;
+    std::vector<uint32_t> free_list_;
+    std::vector<uint32_t> stalled_;
+    std::vector<uint32_t> retry_;           // Scratch for on_timer()
+    DoneCallback on_done_;
+    Stats stats_;
+    size_t active_ = 0;
+
+public:
+    explicit BasketManager(OrderManager& oms, const BasketRiskLimits& limits = BasketRiskLimits(),
+                           size_t capacity = DEFAULT_CAPACITY)
+        : oms_(oms), limits_(limits), baskets_(capacity) {
+        free_list_.reserve(capacity);
+        for (size_t i = capacity; i-- > 0;) free_list_.push_back(static_cast<uint32_t>(i));
+        stalled_.reserve(capacity);
+        retry_.reserve(capacity);
+    }
+
+    void set_done_callback(DoneCallback callback) { on_done_ = std::move(callback); }
+    void set_limits(const BasketRiskLimits& limits) { limits_ = limits; }
+    const BasketRiskLimits& limits() const { return limits_; }
+
+    /**
+     * Risk-check the basket as a unit and send every leg
+     * @return Basket id, or 0 if refused (reason in *reject when given)
+     */
+    uint64_t submit(const BasketOrder& basket, uint64_t now_ns, BasketReject* reject = nullptr) {
+        const BasketReject reason = check(basket);
+        if (reason != BasketReject::NONE) {
+            stats_.risk_rejected++;
+            if (reject) *reject = reason;
+            return 0;
+        }
+        if (free_list_.empty()) {
+            if (reject) *reject = BasketReject::POOL_FULL;
+            return 0;
+        }
+
+        const uint32_t slot = free_list_.back();
+        Basket& state = baskets_[slot];
+        const uint32_t generation = (state.generation + 1) & 0xFFFF;
+        state = Basket{};
+        state.generation = generation;
+        state.spec = basket;
+        const uint64_t id = (static_cast<uint64_t>(generation) << 32) | slot;
+
+        BasketResult& result = state.result;
+        result.basket_id = id;
+        result.client_tag = basket.client_tag;
+        result.status = BasketStatus::WORKING;
+        result.leg_count = basket.leg_count;
+        for (size_t i = 0; i < basket.leg_count; ++i) {
+            result.legs[i] = BasketLegResult{basket.legs[i].symbol, basket.legs[i].side, basket.legs[i].quantity,
+                                             0, 0.0, 0, 0.0, 0};
+        }
+
+        std::array<OrderRequest, BasketOrder::MAX_LEGS> requests;
+        for (size_t i = 0; i < basket.leg_count; ++i) {
+            const BasketLeg& leg = basket.legs[i];
+            requests[i] = leg_request(state, id, leg.symbol, leg.side, leg.venue, leg.quantity, now_ns);
+        }
+        if (!oms_.submit_batch(requests.data(), basket.leg_count)) {
+            stats_.submit_rejected++;
+            if (reject) *reject = BasketReject::SUBMIT_FAILED;
+            return 0;
+        }
+
+        free_list_.pop_back();
+        for (size_t i = 0; i < basket.leg_count; ++i) state.legs[i].order_id = requests[i].order_id;
+        state.working_orders = basket.leg_count;
+        state.active = true;
+        active_++;
+        stats_.submitted++;
+        stats_.legs_sent += basket.leg_count;
+        if (reject) *reject = BasketReject::NONE;
+        return id;
+    }
+
+    // Combined pre-trade check: one pass over the legs
+    BasketReject check(const BasketOrder& basket) const {
+        if (basket.leg_count == 0) return BasketReject::EMPTY;
+        if (basket.reduce_only) return BasketReject::NONE;
+        const BasketExposure exposure = basket_exposure(basket);
+        if (limits_.max_gross_notional > 0.0 && exposure.gross > limits_.max_gross_notional) {
+            return BasketReject::GROSS_LIMIT;
+        }
+        if (limits_.max_net_notional > 0.0 && std::abs(exposure.net) > limits_.max_net_notional) {
+            return BasketReject::NET_LIMIT;
+        }
+        if (limits_.max_leg_failure_exposure > 0.0 && exposure.worst_leg_failure > limits_.max_leg_failure_exposure) {
+            return BasketReject::LEG_FAILURE_LIMIT;
+        }
+        return BasketReject::NONE;
+    }
+
+    /**
+     * Offer an OMS update; returns true if it belongs to a basket
+     */
+    bool on_order_update(const OrderUpdate& update) {
+        if ((update.client_tag & BASKET_TAG) == 0) return false;
+
+        const uint64_t id = update.client_tag & ~BASKET_TAG;
+        const uint32_t slot = static_cast<uint32_t>(id & 0xFFFFFFFF);
+        if (slot >= baskets_.size()) return true;
+        Basket& state = baskets_[slot];
+        if (!state.active || state.result.basket_id != id || !update.is_terminal()) return true;
+
+        size_t leg = 0;
+        while (leg < state.spec.leg_count && state.legs[leg].order_id != update.order_id) ++leg;
+        if (leg == state.spec.leg_count) return true;
+
+        BasketLegResult& result = state.result.legs[leg];
+        const double notional = to_float_price(update.avg_fill_price) * to_float_quantity(update.filled_quantity);
+        if (state.legs[leg].unwinding) {
+            result.unwound += update.filled_quantity;
+            result.unwind_notional += notional;
+        } else {
+            result.filled += update.filled_quantity;
+            result.notional += notional;
+        }
+        result.fees += update.fees;
+        state.legs[leg].order_id = 0;
+
+        if (--state.working_orders == 0) advance(slot, update.timestamp_ns);
+        return true;
+    }
+
+    // Retry follow-up orders the OMS refused (ring full / rate limited)
+    void on_timer(uint64_t now_ns) {
+        if (stalled_.empty()) return;
+        retry_.swap(stalled_);
+        for (uint32_t slot : retry_) {
+            baskets_[slot].stalled = false;
+            if (baskets_[slot].active && baskets_[slot].working_orders == 0) advance(slot, now_ns);
+        }
+        retry_.clear();
+    }
+
+    size_t active_baskets() const { return active_; }
+    const Stats& get_stats() const { return stats_; }
+
+    void print_status() const {
+        printf("\n🧺 Basket Manager Status:\n");
+        printf("   Baskets: %lu (risk rejected %lu, submit rejected %lu), Active: %zu, Legs sent: %lu\n",
+               static_cast<unsigned long>(stats_.submitted), static_cast<unsigned long>(stats_.risk_rejected),
+               static_cast<unsigned long>(stats_.submit_rejected), active_,
+               static_cast<unsigned long>(stats_.legs_sent));
+        printf("   Completed: %lu, Unwound: %lu (P&L $%.2f), Incomplete: %lu, Broken: %lu\n",
+               static_cast<unsigned long>(stats_.completed), static_cast<unsigned long>(stats_.unwound),
+               stats_.unwind_pnl, static_cast<unsigned long>(stats_.incomplete),
+               static_cast<unsigned long>(stats_.broken));
+        printf("   Hedge orders: %lu, Unwind orders: %lu\n",
+               static_cast<unsigned long>(stats_.hedge_orders), static_cast<unsigned long>(stats_.unwind_orders));
+    }
+
+private:
+    OrderRequest leg_request(const Basket& state, uint64_t id, SymbolId symbol, Side side, Venue venue,
+                             Quantity quantity, uint64_t now_ns) {
+        OrderRequest request{};
+        request.action = OrderRequest::Action::NEW;
+        request.order_id = oms_.reserve_order_id();
+        request.client_tag = BASKET_TAG | id;
+        request.timestamp_ns = now_ns;
+        request.quantity = quantity;
+        request.symbol = symbol;
+        request.strategy = state.spec.strategy;
+        request.side = side;
+        request.type = OrderType::MARKET;
+        request.tif = TimeInForce::DAY;
+        request.venue = venue;
+        return request;
+    }
+
+    // Every working order has reported: complete, hedge, unwind or give up
+    void advance(uint32_t slot, uint64_t now_ns) {
+        Basket& state = baskets_[slot];
+        BasketResult& result = state.result;
+
+        if (result.status == BasketStatus::UNWINDING) {
+            bool flat = true;
+            for (size_t i = 0; i < result.leg_count; ++i) flat &= result.legs[i].unwound == result.legs[i].filled;
+            finish(slot, flat ? BasketStatus::UNWOUND : BasketStatus::BROKEN);
+            return;
+        }
+
+        bool complete = true;
+        for (size_t i = 0; i < result.leg_count; ++i) complete &= result.legs[i].filled >= result.legs[i].requested;
+        if (complete) {
+            finish(slot, BasketStatus::COMPLETED);
+            return;
+        }
+
+        if (state.spec.on_leg_failure == LegFailurePolicy::HEDGE) {
+            bool attempts_left = false;
+            for (size_t i = 0; i < result.leg_count; ++i) {
+                attempts_left |= result.legs[i].filled < result.legs[i].requested &&
+                                 state.legs[i].hedge_attempts < state.spec.max_hedge_attempts;
+            }
+            if (!attempts_left) {
+                finish(slot, BasketStatus::INCOMPLETE);
+                return;
+            }
+            result.status = BasketStatus::HEDGING;
+            send_follow_ups(slot, now_ns, false);
+            return;
+        }
+
+        result.status = BasketStatus::UNWINDING;
+        bool anything_filled = false;
+        for (size_t i = 0; i < result.leg_count; ++i) anything_filled |= result.legs[i].filled > 0;
+        if (!anything_filled) {
+            finish(slot, BasketStatus::UNWOUND);
+            return;
+        }
+        send_follow_ups(slot, now_ns, true);
+    }
+
+    // Hedge: re-send each short leg's missing quantity. Unwind: flatten each leg's fills.
+    void send_follow_ups(uint32_t slot, uint64_t now_ns, bool unwind) {
+        Basket& state = baskets_[slot];
+        BasketResult& result = state.result;
+
+        std::array<OrderRequest, BasketOrder::MAX_LEGS> requests;
+        std::array<uint8_t, BasketOrder::MAX_LEGS> legs;
+        size_t count = 0;
+        for (size_t i = 0; i < result.leg_count; ++i) {
+            const BasketLeg& leg = state.spec.legs[i];
+            Quantity quantity = 0;
+            Side side = leg.side;
+            if (unwind) {
+                quantity = result.legs[i].filled - result.legs[i].unwound;
+                side = leg.side == Side::BUY ? Side::SELL : Side::BUY;
+            } else if (state.legs[i].hedge_attempts < state.spec.max_hedge_attempts) {
+                quantity = result.legs[i].requested > result.legs[i].filled
+                    ? result.legs[i].requested - result.legs[i].filled : 0;
+            }
+            if (quantity <= 0) continue;
+            legs[count] = static_cast<uint8_t>(i);
+            requests[count++] = leg_request(state, result.basket_id, leg.symbol, side, leg.venue, quantity, now_ns);
+        }
+
+        if (!oms_.submit_batch(requests.data(), count)) {
+            if (!state.stalled) {
+                state.stalled = true;
+                stalled_.push_back(slot);
+            }
+            return;
+        }
+
+        for (size_t k = 0; k < count; ++k) {
+            LegState& leg = state.legs[legs[k]];
+            leg.order_id = requests[k].order_id;
+            leg.unwinding = unwind;
+            if (!unwind) leg.hedge_attempts++;
+        }
+        state.working_orders = static_cast<uint8_t>(count);
+        (unwind ? stats_.unwind_orders : stats_.hedge_orders) += count;
+    }
+
+    void finish(uint32_t slot, BasketStatus status) {
+        Basket& state = baskets_[slot];
+        state.result.status = status;
+        state.active = false;
+        active_--;
+        free_list_.push_back(slot);
+
+        switch (status) {
+            case BasketStatus::COMPLETED: stats_.completed++; break;
+            case BasketStatus::UNWOUND: stats_.unwound++; break;
+            case BasketStatus::INCOMPLETE: stats_.incomplete++; break;
+            case BasketStatus::BROKEN: stats_.broken++; break;
+            default: break;
+        }
+        if (status == BasketStatus::UNWOUND || status == BasketStatus::BROKEN) {
+            stats_.unwind_pnl += state.result.unwind_pnl();
+        }
+
+        const BasketResult result = state.result;
+        if (on_done_) on_done_(result);
+    }
+};
+
+} // namespace hft
@@ -0,0 +1,760 @@
+// io_service.hpp - Consolidated file output: per-thread byte rings drained by one I/O thread (io_uring when available)
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cerrno>
+#include <charconv>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <type_traits>
+#include <vector>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "ring_buffer.hpp"
+
+#if defined(__has_include)
+#if __has_include(<linux/io_uring.h>)
+#include <linux/io_uring.h>
+#include <sys/syscall.h>
+#define HFT_HAS_IO_URING 1
+#endif
+#endif
+
+namespace hft {
+
+using IoFileId = uint16_t;
+constexpr IoFileId INVALID_IO_FILE = 0;
+
+// Append a value as text: bool as 1/0, floats in %g style or fixed with precision >= 0
+template<typename T>
+inline void append_value(std::string& out, T value, int precision = -1) {
+    char buffer[400];
+    std::to_chars_result result{buffer, std::errc()};
+    if constexpr (std::is_same_v<T, bool>) {
+        out += value ? '1' : '0';
+        return;
+    } else if constexpr (std::is_same_v<T, char>) {
+        out += value;
+        return;
+    } else if constexpr (std::is_enum_v<T>) {
+        result = std::to_chars(buffer, buffer + sizeof(buffer), static_cast<std::underlying_type_t<T>>(value));
+    } else if constexpr (std::is_floating_point_v<T>) {
+        result = precision >= 0
+            ? std::to_chars(buffer, buffer + sizeof(buffer), value, std::chars_format::fixed, precision)
+            : std::to_chars(buffer, buffer + sizeof(buffer), value, std::chars_format::general, 6);
+    } else {
+        result = std::to_chars(buffer, buffer + sizeof(buffer), value);
+    }
+    if (result.ec == std::errc()) {
+        out.append(buffer, result.ptr);
+    } else {
+        out += '?';
+    }
+}
+
+// IoLine manipulator: later floating-point values in fixed notation
+struct IoFixed {
+    int precision;
+};
+
+inline IoFixed io_fixed(int precision) { return IoFixed{precision}; }
+
+/**
+ * Record builder for IoService::write
+ *
+ * Streams like an ofstream (numbers as an ofstream would print them by
+ * default; io_fixed(n) for std::fixed << std::setprecision(n)) into a
+ * per-thread buffer, so building a line allocates nothing once the
+ * buffer has grown. One IoLine per thread at a time.
+ */
+class IoLine {
+private:
+    std::string& text_;
+    int precision_ = -1;
+
+    static std::string& thread_text() {
+        thread_local std::string text;
+        return text;
+    }
+
+public:
+    IoLine() : text_(thread_text()) { text_.clear(); }
+
+    IoLine(const IoLine&) = delete;
+    IoLine& operator=(const IoLine&) = delete;
+
+    IoLine& operator<<(std::string_view text) {
+        text_.append(text);
+        return *this;
+    }
+    IoLine& operator<<(const char* text) { return *this << std::string_view(text); }
+    IoLine& operator<<(const std::string& text) { return *this << std::string_view(text); }
+
+    template<typename T>
+        requires std::is_arithmetic_v<T> || std::is_enum_v<T>
+    IoLine& operator<<(T value) {
+        append_value(text_, value, precision_);
+        return *this;
+    }
+
+    IoLine& operator<<(IoFixed fixed) {
+        precision_ = fixed.precision;
+        return *this;
+    }
+
+    std::string_view view() const { return text_; }
+    operator std::string_view() const { return text_; }
+};
+
+#ifdef HFT_HAS_IO_URING
+/**
+ * Minimal io_uring submission/completion rings (raw syscalls, no liburing)
+ *
+ * Used by the I/O thread only: queue writes, then submit them all with
+ * one io_uring_enter and wait for their completions.
+ */
+class IoUring {
+private:
+    int fd_ = -1;
+    void* sq_ring_ = nullptr;
+    void* cq_ring_ = nullptr;
+    size_t sq_ring_bytes_ = 0;
+    size_t cq_ring_bytes_ = 0;
+    io_uring_sqe* sqes_ = nullptr;
+    size_t sqes_bytes_ = 0;
+
+    unsigned* sq_head_ = nullptr;
+    unsigned* sq_tail_ = nullptr;
+    unsigned* sq_array_ = nullptr;
+    unsigned sq_mask_ = 0;
+    unsigned sq_entries_ = 0;
+    unsigned* cq_head_ = nullptr;
+    unsigned* cq_tail_ = nullptr;
+    unsigned cq_mask_ = 0;
+    io_uring_cqe* cqes_ = nullptr;
+
+    unsigned queued_ = 0;       // Prepared, not yet submitted
+    unsigned inflight_ = 0;     // Submitted, not yet completed
+
+    template<typename T>
+    static T* at(void* ring, uint32_t offset) {
+        return reinterpret_cast<T*>(static_cast<uint8_t*>(ring) + offset);
+    }
+
+public:
+    IoUring() = default;
+    IoUring(const IoUring&) = delete;
+    IoUring& operator=(const IoUring&) = delete;
+
+    ~IoUring() {
+        if (sqes_) ::munmap(sqes_, sqes_bytes_);
+        if (cq_ring_ && cq_ring_ != sq_ring_) ::munmap(cq_ring_, cq_ring_bytes_);
+        if (sq_ring_) ::munmap(sq_ring_, sq_ring_bytes_);
+        if (fd_ >= 0) ::close(fd_);
+    }
+
+    // false if the kernel (or a seccomp policy) refuses io_uring
+    bool init(unsigned entries) {
+        io_uring_params params{};
+        fd_ = static_cast<int>(::syscall(__NR_io_uring_setup, entries, &params));
+        if (fd_ < 0) return false;
+
+        sq_ring_bytes_ = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+        cq_ring_bytes_ = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+        const bool single_mmap = params.features & IORING_FEAT_SINGLE_MMAP;
+        if (single_mmap) sq_ring_bytes_ = cq_ring_bytes_ = std::max(sq_ring_bytes_, cq_ring_bytes_);
+
+        sq_ring_ = ::mmap(nullptr, sq_ring_bytes_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd_,
+                          IORING_OFF_SQ_RING);
+        if (sq_ring_ == MAP_FAILED) {
+            sq_ring_ = nullptr;
+            return false;
+        }
+        cq_ring_ = single_mmap ? sq_ring_
+                               : ::mmap(nullptr, cq_ring_bytes_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                                        fd_, IORING_OFF_CQ_RING);
+        if (cq_ring_ == MAP_FAILED) {
+            cq_ring_ = nullptr;
+            return false;
+        }
+        sqes_bytes_ = params.sq_entries * sizeof(io_uring_sqe);
+        void* sqes = ::mmap(nullptr, sqes_bytes_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd_,
+                            IORING_OFF_SQES);
+        if (sqes == MAP_FAILED) return false;
+        sqes_ = static_cast<io_uring_sqe*>(sqes);
+
+        sq_head_ = at<unsigned>(sq_ring_, params.sq_off.head);
+        sq_tail_ = at<unsigned>(sq_ring_, params.sq_off.tail);
+        sq_array_ = at<unsigned>(sq_ring_, params.sq_off.array);
+        sq_mask_ = *at<unsigned>(sq_ring_, params.sq_off.ring_mask);
+        sq_entries_ = params.sq_entries;
+        cq_head_ = at<unsigned>(cq_ring_, params.cq_off.head);
+        cq_tail_ = at<unsigned>(cq_ring_, params.cq_off.tail);
+        cq_mask_ = *at<unsigned>(cq_ring_, params.cq_off.ring_mask);
+        cqes_ = at<io_uring_cqe>(cq_ring_, params.cq_off.cqes);
+        return true;
+    }
+
+    unsigned capacity() const { return sq_entries_; }
+
+    // Queue a write at an explicit offset; false if the submission ring is full
+    bool prepare_write(int fd, const void* data, uint32_t length, uint64_t offset, uint64_t user_data) {
+        const unsigned tail = *sq_tail_;
+        const unsigned head = std::atomic_ref<unsigned>(*sq_head_).load(std::memory_order_acquire);
+        if (tail - head >= sq_entries_) return false;
+
+        const unsigned index = tail & sq_mask_;
+        io_uring_sqe& sqe = sqes_[index];
+        std::memset(&sqe, 0, sizeof(sqe));
+        sqe.opcode = IORING_OP_WRITE;
+        sqe.fd = fd;
+        sqe.addr = reinterpret_cast<uint64_t>(data);
+        sqe.len = length;
+        sqe.off = offset;
+        sqe.user_data = user_data;
+        sq_array_[index] = index;
+        std::atomic_ref<unsigned>(*sq_tail_).store(tail + 1, std::memory_order_release);
+        queued_++;
+        return true;
+    }
+
+    /**
+     * Submit the queued writes and wait for all of them
+     *
+     * @param done Called as done(user_data, result) per completion; result
+     *             is bytes written or -errno
+     * @return false if io_uring_enter itself failed
+     */
+    template<typename Done>
+    bool submit_and_wait(Done&& done) {
+        while (queued_ > 0 || inflight_ > 0) {
+            const int submitted = static_cast<int>(::syscall(__NR_io_uring_enter, fd_, queued_, inflight_ + queued_,
+                                                             IORING_ENTER_GETEVENTS, nullptr, 0));
+            if (submitted < 0) {
+                if (errno == EINTR) continue;
+                return false;
+            }
+            queued_ -= static_cast<unsigned>(submitted);
+            inflight_ += static_cast<unsigned>(submitted);
+
+            unsigned head = *cq_head_;
+            const unsigned tail = std::atomic_ref<unsigned>(*cq_tail_).load(std::memory_order_acquire);
+            for (; head != tail; ++head) {
+                const io_uring_cqe& cqe = cqes_[head & cq_mask_];
+                done(cqe.user_data, cqe.res);
+                inflight_--;
+            }
+            std::atomic_ref<unsigned>(*cq_head_).store(head, std::memory_order_release);
+        }
+        return true;
+    }
+};
+#endif
+
+/**
+ * I/O Service
+ *
+ * The one place files are written. Any thread hands a preformatted
+ * record to write(): it is copied into that thread's SPSCByteRing,
+ * tagged with the file, and the call returns - no syscall, no lock. One
+ * I/O thread drains every ring, appends the records to per-file batches
+ * and writes each batch to a long-lived descriptor: all of a sweep's
+ * batches go out in one io_uring_enter where the kernel allows io_uring,
+ * as pwrite calls otherwise.
+ *
+ * Files rotate by size: the full file is renamed with a timestamp, a new
+ * one is started (with the file's header), and the rotated one is gzipped
+ * by a low-priority background thread.
+ *
+ * What a full ring does depends on the file. By default the record is
+ * dropped and counted in stats().dropped, so a slow disk never stalls a
+ * trading thread. Files opened with block_when_full (audit trails, and
+ * writers that are off the trading path) make the writer wait for the
+ * I/O thread instead; stats().stalls counts those waits. Records from one
+ * thread keep their order; records from different threads are ordered
+ * by sweep.
+ */
+class IoService {
+public:
+    struct FileOptions {
+        bool truncate = false;          // Start empty (applies to the first open in this process)
+        std::string header;             // Starts every new file: created, truncated, empty or rotated
+        size_t rotate_bytes = 0;        // Rotate once the file reaches this size; 0 never
+        bool compress_rotated = true;   // gzip rotated files in the background
+        bool block_when_full = false;   // Wait for ring space instead of dropping (audit trails)
+    };
+
+    struct Config {
+        size_t thread_buffer_bytes = 1024 * 1024;   // Per writing thread, rounded up to a power of two
+        uint32_t idle_sleep_us = 500;               // I/O thread's sleep when every ring is empty
+        unsigned queue_depth = 64;                  // io_uring submission entries
+    };
+
+    struct Stats {
+        uint64_t records = 0;
+        uint64_t bytes = 0;
+        uint64_t writes = 0;        // Write operations issued (one per file per sweep)
+        uint64_t submits = 0;       // io_uring_enter calls, or pwrite calls without io_uring
+        uint64_t stalls = 0;        // Writers that waited for ring space (block_when_full files)
+        uint64_t dropped = 0;       // Records dropped on a full ring (other files)
+        uint64_t rotations = 0;
+        uint64_t errors = 0;
+        bool io_uring = false;
+        size_t threads = 0;
+        size_t files = 0;
+        size_t buffered_bytes = 0;  // Waiting in the rings
+        size_t buffer_bytes = 0;    // Capacity of the rings
+    };
+
+    static constexpr size_t MAX_FILES = 256;
+
+private:
+    struct IoBuffer {
+        SPSCByteRing ring;
+        std::atomic<uint64_t> stalls{0};        // Written by the owning thread only
+        std::atomic<uint64_t> dropped{0};       // ... likewise
+        std::atomic<bool> retired{false};
+
+        explicit IoBuffer(size_t capacity) : ring(capacity) {}
+    };
+
+    // Marks the thread's ring retired when the thread exits; the I/O thread frees it once drained
+    struct ThreadHandle {
+        IoBuffer* buffer = nullptr;
+        ~ThreadHandle() {
+            if (buffer) buffer->retired.store(true, std::memory_order_release);
+        }
+    };
+
+    struct FileState {
+        std::string path;
+        FileOptions options;
+        int fd = -1;
+        uint64_t offset = 0;        // Current size; writes are positional
+        std::string batch;          // This sweep's bytes
+        uint32_t rotations = 0;
+    };
+
+    Config config_;
+    std::atomic<bool> running_{false};
+    std::thread io_thread_;
+    std::mutex mutex_;              // Registration, start/stop
+
+    std::array<std::unique_ptr<FileState>, MAX_FILES> files_;
+    std::atomic<size_t> file_count_{1};     // Slot 0 is INVALID_IO_FILE
+
+    std::vector<std::unique_ptr<IoBuffer>> buffers_;
+    std::mutex buffers_mutex_;
+    uint64_t retired_stalls_ = 0;
+    uint64_t retired_dropped_ = 0;
+
+    // I/O thread state
+    std::vector<IoBuffer*> sweep_;
+    std::vector<FileState*> dirty_;
+#ifdef HFT_HAS_IO_URING
+    std::unique_ptr<IoUring> uring_;
+#endif
+    std::atomic<uint64_t> sweeps_{0};
+
+    // Background compression of rotated files
+    std::thread compress_thread_;
+    std::deque<std::string> compress_queue_;
+    std::mutex compress_mutex_;
+    std::condition_variable compress_cv_;
+    bool compress_stop_ = false;
+
+    std::atomic<uint64_t> records_{0};
+    std::atomic<uint64_t> bytes_{0};
+    std::atomic<uint64_t> writes_{0};
+    std::atomic<uint64_t> submits_{0};
+    std::atomic<uint64_t> rotations_{0};
+    std::atomic<uint64_t> errors_{0};
+    std::atomic<bool> using_io_uring_{false};
+
+    IoService() = default;
+
+    IoBuffer* register_thread() {
+        std::lock_guard<std::mutex> lock(buffers_mutex_);
+        buffers_.push_back(std::make_unique<IoBuffer>(config_.thread_buffer_bytes));
+        return buffers_.back().get();
+    }
+
+    IoBuffer* thread_buffer() {
+        thread_local ThreadHandle handle;
+        if (!handle.buffer) [[unlikely]] handle.buffer = register_thread();
+        return handle.buffer;
+    }
+
+    static int open_fd(const std::string& path, bool truncate) {
+        return ::open(path.c_str(), O_WRONLY | O_CREAT | O_CLOEXEC | (truncate ? O_TRUNC : 0), 0644);
+    }
+
+    void io_worker() {
+#ifdef HFT_HAS_IO_URING
+        uring_ = std::make_unique<IoUring>();
+        if (!uring_->init(config_.queue_depth)) uring_.reset();
+        using_io_uring_.store(uring_ != nullptr, std::memory_order_relaxed);
+#endif
+        while (running_.load(std::memory_order_acquire)) {
+            if (sweep() == 0) {
+                std::this_thread::sleep_for(std::chrono::microseconds(config_.idle_sleep_us));
+            }
+        }
+
+        // Drain what writers queued before stop()
+        while (sweep() > 0) {}
+#ifdef HFT_HAS_IO_URING
+        uring_.reset();
+#endif
+    }
+
+    /**
+     * One pass: move every ring's records into per-file batches, write them
+     *
+     * @return Records moved
+     */
+    size_t sweep() {
+        {
+            std::lock_guard<std::mutex> lock(buffers_mutex_);
+            sweep_.clear();
+            for (const auto& buffer : buffers_) sweep_.push_back(buffer.get());
+        }
+
+        size_t records = 0;
+        dirty_.clear();
+        for (IoBuffer* buffer : sweep_) {
+            SPSCByteRing::Frame frame;
+            const uint8_t* payload;
+            while ((payload = buffer->ring.peek(frame))) {
+                FileState* file = frame.tag < MAX_FILES ? files_[frame.tag].get() : nullptr;
+                if (file) {
+                    uint32_t length;
+                    std::memcpy(&length, payload, sizeof(length));
+                    if (file->batch.empty()) dirty_.push_back(file);
+                    file->batch.append(reinterpret_cast<const char*>(payload + sizeof(length)), length);
+                    records++;
+                }
+                buffer->ring.release();
+            }
+        }
+
+        if (!dirty_.empty()) write_batches();
+        if (records > 0) records_.fetch_add(records, std::memory_order_relaxed);
+        sweeps_.fetch_add(1, std::memory_order_release);
+
+        // Free rings whose threads have exited, once drained
+        std::lock_guard<std::mutex> lock(buffers_mutex_);
+        for (auto it = buffers_.begin(); it != buffers_.end();) {
+            if ((*it)->retired.load(std::memory_order_acquire) && (*it)->ring.empty()) {
+                retired_stalls_ += (*it)->stalls.load(std::memory_order_relaxed);
+                retired_dropped_ += (*it)->dropped.load(std::memory_order_relaxed);
+                it = buffers_.erase(it);
+            } else {
+                ++it;
+            }
+        }
+        return records;
+    }
+
+    void write_batches() {
+        size_t next = 0;
+        while (next < dirty_.size()) {
+            size_t end = dirty_.size();
+#ifdef HFT_HAS_IO_URING
+            if (uring_) {
+                // One submission for as many files as the ring holds
+                end = next;
+                while (end < dirty_.size()) {
+                    FileState& file = *dirty_[end];
+                    if (file.fd < 0 || !uring_->prepare_write(file.fd, file.batch.data(),
+                                                              static_cast<uint32_t>(file.batch.size()),
+                                                              file.offset, end)) {
+                        break;
+                    }
+                    end++;
+                }
+                if (end == next) end = next + 1;   // Unopened file: fall through to the error path below
+                submits_.fetch_add(1, std::memory_order_relaxed);
+                bool unsupported = false;
+                const bool ok = uring_->submit_and_wait([&](uint64_t index, int result) {
+                    unsupported |= result == -EINVAL || result == -EOPNOTSUPP;
+                    complete(*dirty_[index], result);
+                });
+                if (!ok || unsupported) {
+                    // io_uring_enter refused, or a kernel without IORING_OP_WRITE: pwrite from here on
+                    uring_.reset();
+                    using_io_uring_.store(false, std::memory_order_relaxed);
+                }
+                for (size_t i = next; i < end; ++i) finish(*dirty_[i]);
+                next = end;
+                continue;
+            }
+#endif
+            for (; next < end; ++next) {
+                submits_.fetch_add(1, std::memory_order_relaxed);
+                finish(*dirty_[next]);
+            }
+        }
+    }
+
+    // Account an io_uring completion: drop what was written from the batch
+    void complete(FileState& file, int result) {
+        writes_.fetch_add(1, std::memory_order_relaxed);
+        if (result > 0) {
+            bytes_.fetch_add(static_cast<uint64_t>(result), std::memory_order_relaxed);
+            file.offset += static_cast<uint64_t>(result);
+            file.batch.erase(0, static_cast<size_t>(result));
+        } else if (result < 0 && result != -EINVAL && result != -EOPNOTSUPP) {
+            // EINVAL/EOPNOTSUPP leave the batch for finish() to pwrite
+            errors_.fetch_add(1, std::memory_order_relaxed);
+            file.batch.clear();
+        }
+    }
+
+    // Write whatever the batch still holds (all of it without io_uring, a short write's tail with), then rotate
+    void finish(FileState& file) {
+        if (file.fd < 0) {
+            errors_.fetch_add(1, std::memory_order_relaxed);
+            file.batch.clear();
+            return;
+        }
+        size_t done = 0;
+        while (done < file.batch.size()) {
+            const ssize_t written = ::pwrite(file.fd, file.batch.data() + done, file.batch.size() - done,
+                                             static_cast<off_t>(file.offset));
+            if (written < 0 && errno == EINTR) continue;
+            if (written <= 0) {
+                errors_.fetch_add(1, std::memory_order_relaxed);
+                break;
+            }
+            writes_.fetch_add(1, std::memory_order_relaxed);
+            bytes_.fetch_add(static_cast<uint64_t>(written), std::memory_order_relaxed);
+            file.offset += static_cast<uint64_t>(written);
+            done += static_cast<size_t>(written);
+        }
+        file.batch.clear();
+
+        if (file.options.rotate_bytes > 0 && file.offset >= file.options.rotate_bytes &&
+            file.offset > file.options.header.size()) {
+            rotate(file);
+        }
+    }
+
+    void rotate(FileState& file) {
+        char stamp[32];
+        const std::time_t now = std::time(nullptr);
+        std::tm local{};
+        localtime_r(&now, &local);
+        std::strftime(stamp, sizeof(stamp), "%Y%m%d-%H%M%S", &local);
+        const std::string rotated = file.path + "." + stamp + "." + std::to_string(++file.rotations);
+
+        ::close(file.fd);
+        if (std::rename(file.path.c_str(), rotated.c_str()) != 0) errors_.fetch_add(1, std::memory_order_relaxed);
+        file.fd = open_fd(file.path, true);
+        file.offset = 0;
+        if (file.fd >= 0 && !file.options.header.empty()) {
+            file.batch = file.options.header;
+            finish(file);
+        }
+        rotations_.fetch_add(1, std::memory_order_relaxed);
+        if (file.options.compress_rotated) compress_later(rotated);
+    }
+
+    void compress_later(const std::string& path) {
+        std::lock_guard<std::mutex> lock(compress_mutex_);
+        if (!compress_thread_.joinable()) {
+            compress_stop_ = false;
+            compress_thread_ = std::thread(&IoService::compress_worker, this);
+        }
+        compress_queue_.push_back(path);
+        compress_cv_.notify_one();
+    }
+
+    void compress_worker() {
+        std::unique_lock<std::mutex> lock(compress_mutex_);
+        for (;;) {
+            compress_cv_.wait(lock, [this] { return compress_stop_ || !compress_queue_.empty(); });
+            if (compress_queue_.empty()) return;
+            const std::string path = compress_queue_.front();
+            compress_queue_.pop_front();
+            lock.unlock();
+            const std::string command = "nice -n 19 gzip -f '" + path + "' 2>/dev/null";
+            if (std::system(command.c_str()) != 0) errors_.fetch_add(1, std::memory_order_relaxed);
+            lock.lock();
+        }
+    }
+
+    void start_locked() {
+        if (running_.load(std::memory_order_acquire)) return;
+        running_.store(true, std::memory_order_release);
+        io_thread_ = std::thread(&IoService::io_worker, this);
+        static const bool registered = std::atexit([] { IoService::instance().stop(); }) == 0;
+        (void)registered;
+    }
+
+public:
+    // Never destroyed: threads may still write (and exit, retiring their rings) during static destruction
+    static IoService& instance() {
+        static IoService* service = new IoService();
+        return *service;
+    }
+
+    // Settings for the next start(); the I/O thread starts on the first open()
+    void configure(const Config& config) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        config_ = config;
+    }
+
+    void start() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        start_locked();
+    }
+
+    // Write everything queued, stop the I/O thread and finish pending compression; files stay open
+    void stop() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (running_.exchange(false, std::memory_order_acq_rel) && io_thread_.joinable()) {
+            io_thread_.join();
+        }
+        {
+            std::lock_guard<std::mutex> compress_lock(compress_mutex_);
+            compress_stop_ = true;
+            compress_cv_.notify_one();
+        }
+        if (compress_thread_.joinable()) compress_thread_.join();
+    }
+
+    /**
+     * Register a file (rare: construction time, takes a lock, opens it)
+     *
+     * Opening a path that is already registered returns its id and
+     * ignores the options.
+     *
+     * @return The file's id, or INVALID_IO_FILE if it cannot be opened
+     */
+    IoFileId open(const std::string& path) {
+        return open(path, FileOptions{});
+    }
+
+    IoFileId open(const std::string& path, const FileOptions& options) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        const size_t count = file_count_.load(std::memory_order_acquire);
+        for (size_t id = 1; id < count; ++id) {
+            if (files_[id]->path == path) return static_cast<IoFileId>(id);
+        }
+        if (count >= MAX_FILES) return INVALID_IO_FILE;
+
+        auto file = std::make_unique<FileState>();
+        file->path = path;
+        file->options = options;
+        file->fd = open_fd(path, options.truncate);
+        if (file->fd < 0) return INVALID_IO_FILE;
+        struct stat st;
+        file->offset = ::fstat(file->fd, &st) == 0 ? static_cast<uint64_t>(st.st_size) : 0;
+        const bool needs_header = file->offset == 0 && !options.header.empty();
+
+        files_[count] = std::move(file);
+        file_count_.store(count + 1, std::memory_order_release);
+        start_locked();
+
+        const IoFileId id = static_cast<IoFileId>(count);
+        if (needs_header) write(id, options.header);
+        return id;
+    }
+
+    /**
+     * Queue bytes for a file (any thread; never a syscall)
+     *
+     * On a full ring the record is dropped, unless the file was opened with
+     * block_when_full. A record larger than the ring's largest payload is
+     * split, and may then interleave with other threads' records for the
+     * same file. It is dropped only when its first chunk finds no space;
+     * once a record has started, the writer waits for space rather than
+     * leave part of it in the file.
+     *
+     * @return false if the id is invalid, the service is stopped or the
+     *         record was dropped
+     */
+    bool write(IoFileId file, std::string_view bytes) {
+        if (file == INVALID_IO_FILE || file >= file_count_.load(std::memory_order_acquire) ||
+            !running_.load(std::memory_order_relaxed)) {
+            return false;
+        }
+        const bool block = files_[file]->options.block_when_full;
+        IoBuffer* buffer = thread_buffer();
+        const size_t max_chunk = buffer->ring.max_payload() - sizeof(uint32_t);
+        bool started = false;
+        do {
+            const uint32_t length = static_cast<uint32_t>(std::min(bytes.size(), max_chunk));
+            uint8_t* out;
+            while (!(out = buffer->ring.reserve(sizeof(uint32_t) + length))) {
+                if (!block && !started) {
+                    buffer->dropped.store(buffer->dropped.load(std::memory_order_relaxed) + 1,
+                                          std::memory_order_relaxed);
+                    return false;
+                }
+                if (!running_.load(std::memory_order_acquire)) return false;
+                buffer->stalls.store(buffer->stalls.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+                std::this_thread::yield();
+            }
+            started = true;
+            std::memcpy(out, &length, sizeof(length));
+            std::memcpy(out + sizeof(length), bytes.data(), length);
+            buffer->ring.commit(file);
+            bytes.remove_prefix(length);
+        } while (!bytes.empty());
+        return true;
+    }
+
+    // Block until everything queued before the call is written (shutdown, tests)
+    void flush() {
+        if (!running_.load(std::memory_order_acquire)) return;
+        // The sweep running now may have passed this thread's ring; the one after it cannot
+        const uint64_t target = sweeps_.load(std::memory_order_acquire) + 2;
+        while (running_.load(std::memory_order_acquire) && sweeps_.load(std::memory_order_acquire) < target) {
+            std::this_thread::sleep_for(std::chrono::microseconds(50));
+        }
+    }
+
+    Stats stats() {
+        Stats stats;
+        stats.records = records_.load(std::memory_order_relaxed);
+        stats.bytes = bytes_.load(std::memory_order_relaxed);
+        stats.writes = writes_.load(std::memory_order_relaxed);
+        stats.submits = submits_.load(std::memory_order_relaxed);
+        stats.rotations = rotations_.load(std::memory_order_relaxed);
+        stats.errors = errors_.load(std::memory_order_relaxed);
+        stats.io_uring = using_io_uring_.load(std::memory_order_relaxed);
+        stats.files = file_count_.load(std::memory_order_acquire) - 1;
+        std::lock_guard<std::mutex> lock(buffers_mutex_);
+        stats.stalls = retired_stalls_;
+        stats.dropped = retired_dropped_;
+        for (const auto& buffer : buffers_) {
+            stats.stalls += buffer->stalls.load(std::memory_order_relaxed);
+            stats.dropped += buffer->dropped.load(std::memory_order_relaxed);
+            stats.buffered_bytes += buffer->ring.used();
+            stats.buffer_bytes += buffer->ring.capacity();
+        }
+        stats.threads = buffers_.size();
+        return stats;
+    }
+
+    bool running() const { return running_.load(std::memory_order_acquire); }
+};
+
+} // namespace hft
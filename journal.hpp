@@ -0,0 +1,380 @@
+// journal.hpp - Binary write-ahead journal of fills and balance deltas on a pre-allocated mmap segment
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "messages.hpp"
+#include "symbol_table.hpp"
+
+namespace hft {
+
+enum class JournalRecordType : uint16_t {
+    SYMBOL = 1,         // Journal symbol id -> name, written before the id's first use
+    FILL = 2,
+    BALANCE = 3,
+    SESSION_TRADE = 4,  // IntradayRiskManager trade result
+    SESSION_HALT = 5    // IntradayRiskManager halt / resume
+};
+
+struct JournalSymbol {
+    SymbolId symbol;
+    char name[38];
+};
+
+struct JournalFill {
+    Venue venue;
+    SymbolId symbol;
+    double quantity;
+    double price;
+};
+
+struct JournalBalance {
+    Venue venue;
+    char asset[4];      // "BTC", "ETH" or "USD"
+    double delta_total;
+    double delta_available;
+};
+
+struct JournalSessionTrade {
+    double pnl;
+    double fees;
+};
+
+struct JournalSessionHalt {
+    uint8_t halted;
+    char reason[39];
+};
+
+/**
+ * Journal record - one cache line
+ *
+ * The checksum covers every byte after it, so a record torn by a crash
+ * mid-write fails validation and ends the replay.
+ */
+struct alignas(64) JournalRecord {
+    uint32_t checksum;
+    JournalRecordType type;
+    uint16_t reserved;
+    uint64_t sequence;
+    uint64_t timestamp_ns;
+    union {
+        JournalSymbol symbol;
+        JournalFill fill;
+        JournalBalance balance;
+        JournalSessionTrade trade;
+        JournalSessionHalt halt;
+        uint8_t raw[40];
+    };
+
+    uint32_t compute_checksum() const {
+        // FNV-1a over everything after the checksum field
+        const uint8_t* bytes = reinterpret_cast<const uint8_t*>(this);
+        uint32_t hash = 2166136261u;
+        for (size_t i = sizeof(checksum); i < sizeof(JournalRecord); ++i) {
+            hash = (hash ^ bytes[i]) * 16777619u;
+        }
+        return hash;
+    }
+};
+static_assert(sizeof(JournalRecord) == 64, "JournalRecord must be one cache line");
+
+/**
+ * Trade Journal
+ *
+ * Append-only log of fills, balance deltas and session risk events in a
+ * file that is pre-allocated and mapped once at open. Appending copies a
+ * 64-byte record into the mapping - no syscall, no lock - and records are
+ * published in reservation order so the committed prefix never has gaps.
+ * commit() makes everything published so far durable with one fdatasync,
+ * so a busy event loop pays one sync per iteration rather than per fill.
+ *
+ * The segment header carries a session id; opening a segment written for
+ * another session starts it afresh. After a snapshot the owner calls
+ * reset() to start the segment over at the next sequence number.
+ */
+class TradeJournal {
+public:
+    static constexpr size_t DEFAULT_CAPACITY = 64 * 1024 * 1024;
+
+private:
+    static constexpr uint64_t MAGIC = 0x314C4E524A544648ULL;   // "HFTJRNL1"
+    static constexpr uint32_t VERSION = 1;
+
+    struct alignas(64) Header {
+        uint64_t magic;
+        uint32_t version;
+        uint32_t record_size;
+        uint64_t capacity_records;
+        uint64_t base_sequence;     // Sequence of the first record in the segment
+        uint32_t session_id;
+    };
+    static_assert(sizeof(Header) == 64, "Header must be one cache line");
+
+    enum SymbolState : uint8_t { UNDEFINED = 0, DEFINING = 1, DEFINED = 2 };
+
+    int fd_ = -1;
+    void* mapping_ = nullptr;
+    size_t mapping_size_ = 0;
+    Header* header_ = nullptr;
+    JournalRecord* records_ = nullptr;
+    size_t capacity_records_ = 0;
+
+    alignas(64) std::atomic<uint64_t> next_index_{0};      // Next record to reserve
+    alignas(64) std::atomic<uint64_t> published_{0};       // Records fully written, in order
+    uint64_t durable_ = 0;                                  // Records covered by the last commit
+
+    std::unique_ptr<std::atomic<uint8_t>[]> symbols_;       // SymbolState per SymbolId
+    std::atomic<uint64_t> dropped_{0};
+    std::atomic<uint64_t> commits_{0};
+
+    static void sync_fd(int fd) {
+#ifdef __APPLE__
+        ::fsync(fd);
+#else
+        ::fdatasync(fd);
+#endif
+    }
+
+    bool valid(uint64_t index) const {
+        const JournalRecord& record = records_[index];
+        return record.sequence == header_->base_sequence + index &&
+               record.type >= JournalRecordType::SYMBOL && record.type <= JournalRecordType::SESSION_HALT &&
+               record.checksum == record.compute_checksum();
+    }
+
+    void initialize(uint32_t session_id) {
+        std::memset(records_, 0, sizeof(JournalRecord));
+        header_->magic = MAGIC;
+        header_->version = VERSION;
+        header_->record_size = sizeof(JournalRecord);
+        header_->capacity_records = capacity_records_;
+        header_->base_sequence = 1;
+        header_->session_id = session_id;
+        sync_fd(fd_);
+    }
+
+    /**
+     * Reserve the next record, fill it in and publish it once every
+     * earlier record is published
+     */
+    template<typename Fill>
+    bool append(JournalRecordType type, uint64_t timestamp_ns, Fill&& fill) {
+        if (!records_) return false;
+        const uint64_t index = next_index_.fetch_add(1, std::memory_order_relaxed);
+        if (index >= capacity_records_) {
+            dropped_.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+
+        JournalRecord record;
+        std::memset(&record, 0, sizeof(record));
+        record.type = type;
+        record.sequence = header_->base_sequence + index;
+        record.timestamp_ns = timestamp_ns;
+        fill(record);
+        record.checksum = record.compute_checksum();
+        std::memcpy(&records_[index], &record, sizeof(record));
+
+        while (published_.load(std::memory_order_acquire) != index) {}
+        published_.store(index + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Write the symbol's name ahead of its first use in this segment
+    void define_symbol(SymbolId symbol, uint64_t timestamp_ns) {
+        std::atomic<uint8_t>& state = symbols_[symbol];
+        uint8_t current = state.load(std::memory_order_acquire);
+        if (current == DEFINED) return;
+        if (current == UNDEFINED && state.compare_exchange_strong(current, DEFINING, std::memory_order_acquire)) {
+            const std::string& name = SymbolTable::instance().name(symbol);
+            append(JournalRecordType::SYMBOL, timestamp_ns, [&](JournalRecord& record) {
+                record.symbol.symbol = symbol;
+                std::strncpy(record.symbol.name, name.c_str(), sizeof(record.symbol.name) - 1);
+            });
+            state.store(DEFINED, std::memory_order_release);
+            return;
+        }
+        while (state.load(std::memory_order_acquire) != DEFINED) {}
+    }
+
+public:
+    TradeJournal() : symbols_(std::make_unique<std::atomic<uint8_t>[]>(SymbolTable::MAX_SYMBOLS)) {
+        for (size_t i = 0; i < SymbolTable::MAX_SYMBOLS; ++i) symbols_[i].store(UNDEFINED, std::memory_order_relaxed);
+    }
+
+    ~TradeJournal() { close(); }
+
+    TradeJournal(const TradeJournal&) = delete;
+    TradeJournal& operator=(const TradeJournal&) = delete;
+
+    /**
+     * Open (or create) and map a journal segment, then find its tail
+     *
+     * @param session_id Trading session (e.g. YYYYMMDD); a segment from
+     *                   another session is discarded
+     * @return false if the file could not be created or mapped
+     */
+    bool open(const std::string& path, uint32_t session_id, size_t capacity_bytes = DEFAULT_CAPACITY) {
+        close();
+
+        fd_ = ::open(path.c_str(), O_RDWR | O_CREAT, 0644);
+        if (fd_ < 0) return false;
+
+        capacity_records_ = capacity_bytes / sizeof(JournalRecord);
+        if (capacity_records_ < 2) capacity_records_ = 2;
+        mapping_size_ = sizeof(Header) + capacity_records_ * sizeof(JournalRecord);
+
+        struct stat st;
+        if (::fstat(fd_, &st) != 0 || (static_cast<size_t>(st.st_size) < mapping_size_ &&
+                                       ::ftruncate(fd_, static_cast<off_t>(mapping_size_)) != 0)) {
+            close();
+            return false;
+        }
+
+        mapping_ = ::mmap(nullptr, mapping_size_, PROT_READ | PROT_WRITE, MAP_SHARED, fd_, 0);
+        if (mapping_ == MAP_FAILED) {
+            mapping_ = nullptr;
+            close();
+            return false;
+        }
+        header_ = static_cast<Header*>(mapping_);
+        records_ = reinterpret_cast<JournalRecord*>(static_cast<char*>(mapping_) + sizeof(Header));
+
+        if (header_->magic != MAGIC || header_->version != VERSION ||
+            header_->record_size != sizeof(JournalRecord) || header_->session_id != session_id ||
+            header_->capacity_records != capacity_records_) {
+            initialize(session_id);
+        }
+
+        // Tail: the longest prefix of valid, consecutive records
+        uint64_t tail = 0;
+        while (tail < capacity_records_ && valid(tail)) ++tail;
+        next_index_.store(tail, std::memory_order_relaxed);
+        published_.store(tail, std::memory_order_release);
+        durable_ = tail;
+        return true;
+    }
+
+    void close() {
+        if (mapping_) {
+            commit();
+            ::munmap(mapping_, mapping_size_);
+        }
+        if (fd_ >= 0) ::close(fd_);
+        fd_ = -1;
+        mapping_ = nullptr;
+        header_ = nullptr;
+        records_ = nullptr;
+    }
+
+    bool is_open() const { return records_ != nullptr; }
+
+    // ========== Appends (any thread, lock-free) ==========
+
+    bool append_fill(Venue venue, SymbolId symbol, double quantity, double price, uint64_t timestamp_ns) {
+        if (!records_ || symbol >= SymbolTable::MAX_SYMBOLS) return false;
+        define_symbol(symbol, timestamp_ns);
+        return append(JournalRecordType::FILL, timestamp_ns, [&](JournalRecord& record) {
+            record.fill.venue = venue;
+            record.fill.symbol = symbol;
+            record.fill.quantity = quantity;
+            record.fill.price = price;
+        });
+    }
+
+    bool append_balance(Venue venue, const char* asset, double delta_total, double delta_available,
+                        uint64_t timestamp_ns) {
+        return append(JournalRecordType::BALANCE, timestamp_ns, [&](JournalRecord& record) {
+            record.balance.venue = venue;
+            std::strncpy(record.balance.asset, asset, sizeof(record.balance.asset) - 1);
+            record.balance.delta_total = delta_total;
+            record.balance.delta_available = delta_available;
+        });
+    }
+
+    bool append_session_trade(double pnl, double fees, uint64_t timestamp_ns) {
+        return append(JournalRecordType::SESSION_TRADE, timestamp_ns, [&](JournalRecord& record) {
+            record.trade.pnl = pnl;
+            record.trade.fees = fees;
+        });
+    }
+
+    bool append_session_halt(bool halted, const std::string& reason, uint64_t timestamp_ns) {
+        return append(JournalRecordType::SESSION_HALT, timestamp_ns, [&](JournalRecord& record) {
+            record.halt.halted = halted ? 1 : 0;
+            std::strncpy(record.halt.reason, reason.c_str(), sizeof(record.halt.reason) - 1);
+        });
+    }
+
+    // ========== Durability ==========
+
+    /**
+     * Group commit: one fdatasync for every record published since the last commit
+     *
+     * Call from one thread (typically the event loop).
+     * @return Records made durable by this call
+     */
+    uint64_t commit() {
+        if (!records_) return 0;
+        const uint64_t published = published_.load(std::memory_order_acquire);
+        if (published <= durable_) return 0;
+        sync_fd(fd_);
+        const uint64_t synced = published - durable_;
+        durable_ = published;
+        commits_.fetch_add(1, std::memory_order_relaxed);
+        return synced;
+    }
+
+    /**
+     * Start the segment over at next_sequence (after a snapshot covering
+     * everything before it). No append may run concurrently.
+     */
+    void reset(uint64_t next_sequence) {
+        if (!records_) return;
+        commit();
+        std::memset(records_, 0, sizeof(JournalRecord));
+        header_->base_sequence = next_sequence;
+        sync_fd(fd_);
+        next_index_.store(0, std::memory_order_relaxed);
+        published_.store(0, std::memory_order_release);
+        durable_ = 0;
+        for (size_t i = 0; i < SymbolTable::MAX_SYMBOLS; ++i) symbols_[i].store(UNDEFINED, std::memory_order_relaxed);
+    }
+
+    /**
+     * Visit every published record in order
+     * @return Records visited
+     */
+    template<typename Fn>
+    size_t replay(Fn&& fn) const {
+        if (!records_) return 0;
+        const uint64_t published = published_.load(std::memory_order_acquire);
+        for (uint64_t i = 0; i < published; ++i) fn(records_[i]);
+        return static_cast<size_t>(published);
+    }
+
+    // Sequence of the last published record (0 if none yet)
+    uint64_t last_sequence() const {
+        if (!records_) return 0;
+        return header_->base_sequence + published_.load(std::memory_order_acquire) - 1;
+    }
+
+    uint32_t session_id() const { return header_ ? header_->session_id : 0; }
+    size_t size() const { return static_cast<size_t>(published_.load(std::memory_order_acquire)); }
+    size_t capacity() const { return capacity_records_; }
+    double utilization() const {
+        return capacity_records_ ? static_cast<double>(size()) / static_cast<double>(capacity_records_) : 0.0;
+    }
+    uint64_t dropped() const { return dropped_.load(std::memory_order_relaxed); }
+    uint64_t commits() const { return commits_.load(std::memory_order_relaxed); }
+};
+
+} // namespace hft
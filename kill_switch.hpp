@@ -0,0 +1,326 @@
+// kill_switch.hpp - Process-wide risk-state word on a shared-memory page: halt order flow across processes
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <fcntl.h>
+#include <signal.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "messages.hpp"
+
+namespace hft {
+
+/**
+ * Risk state page - the start of a shared-memory page
+ *
+ * word packs a change counter (high 32 bits) and the halt sources that
+ * are currently set (low 32 bits); order flow is halted while any source
+ * bit is set. The metadata after it describes the last change and is
+ * best-effort: a concurrent second flip may leave it describing either.
+ * The second cache line records, per source bit, the pid that last set
+ * it; it is only meaningful while the bit is set.
+ */
+struct alignas(64) RiskStatePage {
+    std::atomic<uint64_t> word;
+    uint64_t magic;
+    uint64_t changed_ns;        // get_timestamp_ns() of the last change
+    uint32_t layout;
+    int32_t changed_by;         // pid of the last writer
+    char reason[32];
+
+    alignas(64) std::atomic<int32_t> owner[32];    // pid that last set each source bit (0 = never)
+};
+static_assert(offsetof(RiskStatePage, owner) == 64, "Risk state word and metadata must share one cache line");
+static_assert(sizeof(RiskStatePage) == 192, "Unexpected RiskStatePage layout");
+static_assert(std::atomic<uint64_t>::is_always_lock_free, "Risk state word must be lock-free to be shared");
+
+/**
+ * Kill Switch
+ *
+ * One risk-state word that every order-emitting hot path reads with a
+ * single atomic load. It starts on a process-private page; attach() maps
+ * a named shared-memory page over that same address, so pointers cached
+ * by hot paths stay valid and every attached process - plus the hft_kill
+ * CLI - sees a flip as soon as the cache line moves.
+ *
+ * Each halt source owns a bit, so resuming one source (e.g. a risk
+ * manager's emergency stop being reset) never clears another (the
+ * operator's kill). Every change bumps the version, so watchers detect
+ * flips by comparing words instead of registering callbacks.
+ *
+ * Each halt records the pid that set its sources before publishing them,
+ * and resume() only clears sources whose recorded owner is this process:
+ * one process cannot lift a halt that another process's risk manager
+ * raised, and a source with no recorded owner belongs to nobody. Halting
+ * an already-set source takes it over. The hft_kill CLI clears any source
+ * with override_resume().
+ *
+ * The named page outlives the processes using it, so halts survive a
+ * restart. attach() keeps them (failing safe) and reports sources whose
+ * owner has exited; only the operator can clear those (hft_kill resume
+ * --all), since no live process owns them.
+ *
+ * Attach before trading threads start; bits set in between the two
+ * mappings are carried over, but a flip racing the remap can be lost.
+ */
+class KillSwitch {
+public:
+    // Halt sources
+    static constexpr uint32_t KILL = 1u << 0;               // Operator (hft_kill CLI)
+    static constexpr uint32_t EMERGENCY_STOP = 1u << 1;     // Enhanced / unified risk emergency stop
+    static constexpr uint32_t TRADING_DISABLED = 1u << 2;   // UnifiedRiskController::disable_trading
+    static constexpr uint32_t SESSION_HALT = 1u << 3;       // IntradayRiskManager::emergency_halt
+    static constexpr uint32_t MONITOR_STOP = 1u << 4;       // RealTimeMonitor emergency stop
+    static constexpr uint32_t ALL_SOURCES = 0xFFFFFFFFu;
+
+    static constexpr const char* DEFAULT_NAME = "/hft_risk_state";
+    static constexpr size_t PAGE_SIZE = 4096;
+
+    static constexpr uint32_t flags_of(uint64_t word) { return static_cast<uint32_t>(word); }
+    static constexpr uint32_t version_of(uint64_t word) { return static_cast<uint32_t>(word >> 32); }
+    static constexpr bool is_halted(uint64_t word) { return flags_of(word) != 0; }
+
+private:
+    static constexpr uint64_t MAGIC = 0x314B534952544648ULL;   // "HFTRISK1"
+    static constexpr uint32_t LAYOUT = 2;
+
+    RiskStatePage* page_ = nullptr;
+    bool mapped_ = false;       // page_ is an mmap that attach() can replace
+    std::string name_;
+
+    static void* map_private(void* address) {
+        const int flags = MAP_PRIVATE | MAP_ANONYMOUS | (address ? MAP_FIXED : 0);
+        void* p = ::mmap(address, PAGE_SIZE, PROT_READ | PROT_WRITE, flags, -1, 0);
+        return p == MAP_FAILED ? nullptr : p;
+    }
+
+    static void set_reason(RiskStatePage& page, const char* reason) {
+        std::memset(page.reason, 0, sizeof(page.reason));
+        if (reason) std::strncpy(page.reason, reason, sizeof(page.reason) - 1);
+    }
+
+    static uint64_t next_word(uint64_t word, uint32_t flags) {
+        return (static_cast<uint64_t>(version_of(word) + 1) << 32) | flags;
+    }
+
+    void record_change(const char* reason) {
+        page_->changed_ns = get_timestamp_ns();
+        page_->changed_by = static_cast<int32_t>(::getpid());
+        set_reason(*page_, reason);
+    }
+
+    // Record this process as the owner of the sources, then publish them. The word
+    // is bumped even when every source is already set: a resume() that read the
+    // previous owner then fails its CAS and re-reads the owner instead of clearing
+    // the bit out from under this halt.
+    uint64_t raise(uint32_t sources, const char* reason) {
+        const int32_t pid = static_cast<int32_t>(::getpid());
+        for (uint32_t bit = 0; bit < 32; ++bit) {
+            if (sources & (1u << bit)) page_->owner[bit].store(pid, std::memory_order_relaxed);
+        }
+        uint64_t word = page_->word.load(std::memory_order_acquire);
+        for (;;) {
+            const uint64_t next = next_word(word, flags_of(word) | sources);
+            if (page_->word.compare_exchange_weak(word, next, std::memory_order_acq_rel)) {
+                record_change(reason);
+                return next;
+            }
+        }
+    }
+
+    // Clear the set sources that pass the filter, as one CAS on the word read before
+    // the filter looked at the owners; no-op if none pass
+    template<typename Filter>
+    uint64_t lower(uint32_t sources, const char* reason, Filter&& filter) {
+        uint64_t word = page_->word.load(std::memory_order_acquire);
+        for (;;) {
+            const uint32_t clear = filter(flags_of(word) & sources);
+            if (clear == 0) return word;
+            const uint64_t next = next_word(word, flags_of(word) & ~clear);
+            if (page_->word.compare_exchange_weak(word, next, std::memory_order_acq_rel)) {
+                record_change(reason);
+                return next;
+            }
+        }
+    }
+
+    // Sources whose recorded owner is this process; an unrecorded owner (0) is nobody's
+    uint32_t owned_sources(uint32_t sources) const {
+        const int32_t pid = static_cast<int32_t>(::getpid());
+        uint32_t owned = 0;
+        for (uint32_t bit = 0; bit < 32; ++bit) {
+            if (!(sources & (1u << bit))) continue;
+            if (page_->owner[bit].load(std::memory_order_relaxed) == pid) owned |= 1u << bit;
+        }
+        return owned;
+    }
+
+public:
+    KillSwitch() {
+        page_ = static_cast<RiskStatePage*>(map_private(nullptr));
+        mapped_ = page_ != nullptr;
+        if (!mapped_) page_ = new RiskStatePage{};    // attach() is then refused
+        page_->magic = MAGIC;
+        page_->layout = LAYOUT;
+    }
+
+    ~KillSwitch() {
+        if (mapped_) {
+            ::munmap(page_, PAGE_SIZE);
+        } else {
+            delete page_;
+        }
+    }
+
+    KillSwitch(const KillSwitch&) = delete;
+    KillSwitch& operator=(const KillSwitch&) = delete;
+
+    // Never destroyed: threads still polling the word during exit must not see it unmapped
+    static KillSwitch& instance() {
+        static KillSwitch* kill_switch = new KillSwitch();
+        return *kill_switch;
+    }
+
+    /**
+     * Map the named shared-memory page (creating it if needed) over this
+     * switch's page, merging any bits already set locally
+     *
+     * @return false if the page could not be opened or mapped; the switch
+     *         then stays process-private
+     */
+    bool attach(const char* name = DEFAULT_NAME) {
+        if (!name_.empty() || !mapped_) return false;
+
+        const int fd = ::shm_open(name, O_RDWR | O_CREAT, 0660);
+        if (fd < 0) return false;
+        struct stat st;
+        if (::fstat(fd, &st) != 0 || (static_cast<size_t>(st.st_size) < PAGE_SIZE &&
+                                      ::ftruncate(fd, static_cast<off_t>(PAGE_SIZE)) != 0)) {
+            ::close(fd);
+            return false;
+        }
+
+        // Validate the segment through a temporary mapping before replacing ours
+        void* probe = ::mmap(nullptr, PAGE_SIZE, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        if (probe == MAP_FAILED) {
+            ::close(fd);
+            return false;
+        }
+        RiskStatePage* shared = static_cast<RiskStatePage*>(probe);
+        const bool compatible = shared->magic == 0 || (shared->magic == MAGIC && shared->layout == LAYOUT);
+        if (shared->magic == 0) {
+            // Fresh segment: zero-filled, so the word is already version 0, no halts
+            shared->layout = LAYOUT;
+            shared->magic = MAGIC;
+        }
+        ::munmap(probe, PAGE_SIZE);
+        if (!compatible) {
+            ::close(fd);
+            return false;
+        }
+
+        const uint64_t local = page_->word.load(std::memory_order_acquire);
+        char reason[sizeof(page_->reason)];
+        std::memcpy(reason, page_->reason, sizeof(reason));
+
+        void* p = ::mmap(page_, PAGE_SIZE, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_FIXED, fd, 0);
+        ::close(fd);
+        if (p == MAP_FAILED) {
+            map_private(page_);
+            page_->magic = MAGIC;
+            page_->layout = LAYOUT;
+            page_->word.store(local, std::memory_order_release);
+            return false;
+        }
+
+        name_ = name;
+        if (flags_of(local) != 0) raise(flags_of(local), reason);
+
+        const uint32_t stale = stale_sources();
+        if (stale != 0) {
+            printf("⚠️ Risk state page %s holds halts from exited processes: %s (clear with hft_kill resume --all)\n",
+                   name, describe(stale).c_str());
+        }
+        return true;
+    }
+
+    // Remove a named page; processes already attached keep their mapping
+    static bool unlink(const char* name = DEFAULT_NAME) {
+        return ::shm_unlink(name) == 0;
+    }
+
+    // ========== Hot path (any thread, one load) ==========
+
+    bool halted() const { return is_halted(page_->word.load(std::memory_order_acquire)); }
+    uint64_t state() const { return page_->word.load(std::memory_order_acquire); }
+
+    // Stable for the switch's lifetime, across attach(); hot paths cache it
+    const std::atomic<uint64_t>* word() const { return &page_->word; }
+
+    // ========== Control (rare) ==========
+
+    // Set source bits, taking ownership of them (also of bits already set); returns the resulting word
+    uint64_t halt(uint32_t sources, const char* reason = "") {
+        if (sources == 0) return state();
+        return raise(sources, reason);
+    }
+
+    // Clear the source bits this process set last; others stay set. Returns the resulting word
+    uint64_t resume(uint32_t sources, const char* reason = "") {
+        return lower(sources, reason, [this](uint32_t set) { return owned_sources(set); });
+    }
+
+    // Operator override (hft_kill): clear source bits whoever set them
+    uint64_t override_resume(uint32_t sources, const char* reason = "") {
+        return lower(sources, reason, [](uint32_t set) { return set; });
+    }
+
+    // pid that last set a source (one bit), 0 if it is clear or no owner was recorded
+    int owner(uint32_t source) const {
+        if (!(flags_of(state()) & source)) return 0;
+        for (uint32_t bit = 0; bit < 32; ++bit) {
+            if (source == (1u << bit)) return page_->owner[bit].load(std::memory_order_relaxed);
+        }
+        return 0;
+    }
+
+    // Set sources whose owning process no longer exists (e.g. left by a previous run);
+    // the operator's KILL is always set by a short-lived CLI, so it never counts
+    uint32_t stale_sources() const {
+        const uint32_t flags = flags_of(state()) & ~KILL;
+        uint32_t stale = 0;
+        for (uint32_t bit = 0; bit < 32; ++bit) {
+            if (!(flags & (1u << bit))) continue;
+            const int32_t pid = page_->owner[bit].load(std::memory_order_relaxed);
+            if (pid > 0 && ::kill(pid, 0) != 0 && errno == ESRCH) stale |= 1u << bit;
+        }
+        return stale;
+    }
+
+    bool is_shared() const { return !name_.empty(); }
+    const std::string& name() const { return name_; }
+    uint64_t changed_ns() const { return page_->changed_ns; }
+    int changed_by() const { return page_->changed_by; }
+    std::string reason() const { return std::string(page_->reason, strnlen(page_->reason, sizeof(page_->reason))); }
+
+    static std::string describe(uint32_t flags) {
+        if (flags == 0) return "none";
+        std::string names;
+        const char* labels[] = {"KILL", "EMERGENCY_STOP", "TRADING_DISABLED", "SESSION_HALT", "MONITOR_STOP"};
+        for (uint32_t bit = 0; bit < 32; ++bit) {
+            if (!(flags & (1u << bit))) continue;
+            if (!names.empty()) names += ",";
+            names += bit < 5 ? labels[bit] : "SOURCE_" + std::to_string(bit);
+        }
+        return names;
+    }
+};
+
+} // namespace hft
@@ -0,0 +1,327 @@
+// latency_histogram.hpp - Per-thread log-linear latency histograms, merged on the reporting thread
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "sequencer.hpp"
+
+namespace hft {
+
+/**
+ * TSC clock
+ *
+ * rdtsc() ticks to nanoseconds at the rate measured against steady_clock,
+ * instead of an assumed CPU frequency. Where rdtsc() falls back to the
+ * system clock the measured rate is 1 tick per ns.
+ *
+ * calibrate() sleeps for ~15 ms, so it runs when the metrics registry,
+ * the real-time monitor or a LatencyRecorder is constructed, never on a
+ * hot thread; the conversions are a relaxed load with no static guard.
+ */
+class TscClock {
+public:
+    // Measure the tick rate once (best of three 5 ms windows; a preempted window only reads long)
+    static void calibrate() {
+        std::call_once(calibrated_, [] {
+            double best = 0.0;
+            for (int i = 0; i < 3; ++i) {
+                const auto start_time = std::chrono::steady_clock::now();
+                const uint64_t start_tsc = rdtsc();
+                std::this_thread::sleep_for(std::chrono::milliseconds(5));
+                const uint64_t end_tsc = rdtsc();
+                const auto end_time = std::chrono::steady_clock::now();
+                const auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(end_time - start_time).count();
+                if (ns > 0 && end_tsc > start_tsc) {
+                    const double ticks_per_ns = static_cast<double>(end_tsc - start_tsc) / static_cast<double>(ns);
+                    best = std::max(best, ticks_per_ns);
+                }
+            }
+            if (best > 0.0) ns_per_tick_.store(1.0 / best, std::memory_order_relaxed);
+        });
+    }
+
+    static uint64_t to_ns(uint64_t ticks) noexcept {
+        return static_cast<uint64_t>(static_cast<double>(ticks) * ns_per_tick_.load(std::memory_order_relaxed));
+    }
+
+    static uint64_t from_ns(uint64_t ns) noexcept {
+        return static_cast<uint64_t>(static_cast<double>(ns) / ns_per_tick_.load(std::memory_order_relaxed));
+    }
+
+    static double ticks_per_ns() noexcept { return 1.0 / ns_per_tick_.load(std::memory_order_relaxed); }
+
+    // Nanoseconds elapsed since an earlier rdtsc() reading
+    static uint64_t elapsed_ns(uint64_t start_ticks) noexcept {
+        const uint64_t now = rdtsc();
+        return now > start_ticks ? to_ns(now - start_ticks) : 0;
+    }
+
+private:
+    // Constant-initialized: 1 ns per tick until calibrate() has run
+    inline static std::atomic<double> ns_per_tick_{1.0};
+    inline static std::once_flag calibrated_;
+};
+
+/**
+ * Latency histogram (log-linear)
+ *
+ * Values below 2^SUB_BUCKET_BITS ns get a bucket each; above that every
+ * power of two is split into 2^(SUB_BUCKET_BITS-1) linear sub-buckets, so
+ * a bucket is at most 1/64 of its value wide. The bucket index is one
+ * count-leading-zeros and a shift. Values above MAX_TRACKABLE_NS (~137 s)
+ * land in the last bucket.
+ *
+ * This is the plain value type: merged snapshots, interval deltas and
+ * percentile queries. Recording from hot threads goes through
+ * LatencyRecorder.
+ */
+class LatencyHistogram {
+public:
+    static constexpr unsigned SUB_BUCKET_BITS = 7;
+    static constexpr uint64_t SUB_BUCKET_COUNT = 1ULL << SUB_BUCKET_BITS;
+    static constexpr uint64_t SUB_BUCKET_HALF = SUB_BUCKET_COUNT / 2;
+    static constexpr unsigned MAX_VALUE_BITS = 37;
+    static constexpr uint64_t MAX_TRACKABLE_NS = (1ULL << MAX_VALUE_BITS) - 1;
+    static constexpr size_t BUCKETS =
+        (MAX_VALUE_BITS - SUB_BUCKET_BITS + 1) * SUB_BUCKET_HALF + SUB_BUCKET_HALF;
+
+    [[gnu::always_inline]] static size_t bucket_index(uint64_t value_ns) noexcept {
+        const uint64_t value = std::min(value_ns, MAX_TRACKABLE_NS);
+        const unsigned magnitude = (63 - std::countl_zero(value | (SUB_BUCKET_COUNT - 1))) - (SUB_BUCKET_BITS - 1);
+        return magnitude * SUB_BUCKET_HALF + (value >> magnitude);
+    }
+
+    static uint64_t bucket_lower(size_t index) noexcept {
+        if (index < SUB_BUCKET_COUNT) return index;
+        const unsigned magnitude = static_cast<unsigned>(index / SUB_BUCKET_HALF) - 1;
+        return (index - magnitude * SUB_BUCKET_HALF) << magnitude;
+    }
+
+    static uint64_t bucket_upper(size_t index) noexcept {
+        if (index < SUB_BUCKET_COUNT) return index;
+        const unsigned magnitude = static_cast<unsigned>(index / SUB_BUCKET_HALF) - 1;
+        return ((index - magnitude * SUB_BUCKET_HALF + 1) << magnitude) - 1;
+    }
+
+    void record(uint64_t value_ns, uint64_t count = 1) noexcept {
+        counts_[bucket_index(value_ns)] += count;
+        total_ += count;
+        sum_ns_ += value_ns * count;
+        min_ns_ = std::min(min_ns_, value_ns);
+        max_ns_ = std::max(max_ns_, value_ns);
+    }
+
+    void merge(const LatencyHistogram& other) noexcept {
+        for (size_t i = 0; i < BUCKETS; ++i) counts_[i] += other.counts_[i];
+        total_ += other.total_;
+        sum_ns_ += other.sum_ns_;
+        min_ns_ = std::min(min_ns_, other.min_ns_);
+        max_ns_ = std::max(max_ns_, other.max_ns_);
+    }
+
+    void reset() noexcept { *this = LatencyHistogram{}; }
+
+    uint64_t count() const noexcept { return total_; }
+    uint64_t bucket_count(size_t index) const noexcept { return counts_[index]; }
+    uint64_t sum_ns() const noexcept { return sum_ns_; }
+    uint64_t min_ns() const noexcept { return total_ ? min_ns_ : 0; }
+    uint64_t max_ns() const noexcept { return max_ns_; }
+    uint64_t mean_ns() const noexcept { return total_ ? sum_ns_ / total_ : 0; }
+
+    /**
+     * Value at a percentile
+     *
+     * Upper edge of the bucket holding the ceil(p/100 * count)-th sample,
+     * clamped to the recorded range: never under-reports by more than one
+     * bucket width.
+     *
+     * @param percentile 0-100 (e.g. 99.99)
+     * @return Latency in ns, 0 when empty
+     */
+    uint64_t percentile(double percentile) const noexcept {
+        if (total_ == 0) return 0;
+        const double clamped = std::clamp(percentile, 0.0, 100.0);
+        const double rank = clamped / 100.0 * static_cast<double>(total_);
+        uint64_t target = static_cast<uint64_t>(rank);
+        if (static_cast<double>(target) < rank) ++target;
+        target = std::clamp<uint64_t>(target, 1, total_);
+
+        uint64_t seen = 0;
+        for (size_t i = 0; i < BUCKETS; ++i) {
+            seen += counts_[i];
+            if (seen >= target) return std::clamp(bucket_upper(i), min_ns(), max_ns_);
+        }
+        return max_ns_;
+    }
+
+private:
+    friend class LatencyRecorder;
+
+    std::array<uint64_t, BUCKETS> counts_{};
+    uint64_t total_ = 0;
+    uint64_t sum_ns_ = 0;
+    uint64_t min_ns_ = UINT64_MAX;
+    uint64_t max_ns_ = 0;
+};
+
+/**
+ * Latency recorder
+ *
+ * One per measured operation. Each recording thread gets its own
+ * cache-aligned shard on first use; record() is a thread-local lookup, a
+ * clz and four single-writer relaxed stores: no lock, no RMW, no
+ * allocation, no sort. Counts only ever grow, so the reporting thread
+ * merges the shards without stopping writers and loses nothing:
+ * snapshot() is cumulative, interval() is the difference from the
+ * previous interval() call, so the caller's cadence sets the window.
+ *
+ * A shard outlives its thread; the reporting thread folds retired shards
+ * into a base histogram and frees them.
+ */
+class LatencyRecorder {
+public:
+    LatencyRecorder() : id_(next_id()) { TscClock::calibrate(); }
+
+    LatencyRecorder(const LatencyRecorder&) = delete;
+    LatencyRecorder& operator=(const LatencyRecorder&) = delete;
+
+    [[gnu::hot]] void record(uint64_t value_ns) noexcept {
+        Shard& shard = thread_shard();
+        const size_t index = LatencyHistogram::bucket_index(value_ns);
+        bump(shard.buckets[index], 1);
+        bump(shard.sum_ns, value_ns);
+        if (value_ns > shard.max_ns.load(std::memory_order_relaxed)) {
+            shard.max_ns.store(value_ns, std::memory_order_relaxed);
+        }
+        if (value_ns < shard.min_ns.load(std::memory_order_relaxed)) {
+            shard.min_ns.store(value_ns, std::memory_order_relaxed);
+        }
+    }
+
+    // Record the time since an rdtsc() reading
+    [[gnu::hot]] void record_since(uint64_t start_ticks) noexcept {
+        record(TscClock::elapsed_ns(start_ticks));
+    }
+
+    // Everything recorded so far, all threads
+    LatencyHistogram snapshot() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return collect();
+    }
+
+    // Recorded since the previous interval() call
+    LatencyHistogram interval() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        LatencyHistogram current = collect();
+        LatencyHistogram delta;
+        for (size_t i = 0; i < LatencyHistogram::BUCKETS; ++i) {
+            const uint64_t count = current.counts_[i] - last_interval_.counts_[i];
+            if (count == 0) continue;
+            delta.counts_[i] = count;
+            delta.total_ += count;
+            delta.min_ns_ = std::min(delta.min_ns_, LatencyHistogram::bucket_lower(i));
+            delta.max_ns_ = LatencyHistogram::bucket_upper(i);
+        }
+        delta.sum_ns_ = current.sum_ns_ - last_interval_.sum_ns_;
+        if (delta.total_ > 0) {
+            delta.min_ns_ = std::max(delta.min_ns_, current.min_ns_);
+            delta.max_ns_ = std::min(delta.max_ns_, current.max_ns_);
+        }
+        last_interval_ = current;
+        return delta;
+    }
+
+    size_t threads() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return shards_.size();
+    }
+
+private:
+    struct alignas(CACHE_LINE_SIZE) Shard {
+        std::atomic<uint64_t> sum_ns{0};
+        std::atomic<uint64_t> min_ns{UINT64_MAX};
+        std::atomic<uint64_t> max_ns{0};
+        std::atomic<bool> retired{false};
+        alignas(CACHE_LINE_SIZE) std::array<std::atomic<uint64_t>, LatencyHistogram::BUCKETS> buckets{};
+    };
+
+    // A thread's shards, by recorder id; marks them retired when the thread exits
+    struct ThreadHandle {
+        std::vector<std::shared_ptr<Shard>> shards;
+        ~ThreadHandle() {
+            for (auto& shard : shards) {
+                if (shard) shard->retired.store(true, std::memory_order_release);
+            }
+        }
+    };
+
+    const uint32_t id_;
+    std::mutex mutex_;
+    std::vector<std::shared_ptr<Shard>> shards_;
+    LatencyHistogram retired_;          // Folded from shards whose threads have exited
+    LatencyHistogram last_interval_;
+
+    static uint32_t next_id() {
+        static std::atomic<uint32_t> ids{0};
+        return ids.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    // Single writer: plain load/store instead of a locked RMW
+    [[gnu::always_inline]] static void bump(std::atomic<uint64_t>& counter, uint64_t by) noexcept {
+        counter.store(counter.load(std::memory_order_relaxed) + by, std::memory_order_relaxed);
+    }
+
+    Shard& thread_shard() {
+        thread_local ThreadHandle handle;
+        if (id_ < handle.shards.size() && handle.shards[id_]) [[likely]] return *handle.shards[id_];
+        return register_thread(handle);
+    }
+
+    Shard& register_thread(ThreadHandle& handle) {
+        if (handle.shards.size() <= id_) handle.shards.resize(id_ + 1);
+        auto shard = std::make_shared<Shard>();
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            shards_.push_back(shard);
+        }
+        handle.shards[id_] = shard;
+        return *shard;
+    }
+
+    static void add_shard(LatencyHistogram& into, const Shard& shard) {
+        for (size_t i = 0; i < LatencyHistogram::BUCKETS; ++i) {
+            const uint64_t count = shard.buckets[i].load(std::memory_order_relaxed);
+            into.counts_[i] += count;
+            into.total_ += count;
+        }
+        into.sum_ns_ += shard.sum_ns.load(std::memory_order_relaxed);
+        into.min_ns_ = std::min(into.min_ns_, shard.min_ns.load(std::memory_order_relaxed));
+        into.max_ns_ = std::max(into.max_ns_, shard.max_ns.load(std::memory_order_relaxed));
+    }
+
+    // Caller holds mutex_
+    LatencyHistogram collect() {
+        for (auto it = shards_.begin(); it != shards_.end();) {
+            if ((*it)->retired.load(std::memory_order_acquire)) {
+                add_shard(retired_, **it);
+                it = shards_.erase(it);
+            } else {
+                ++it;
+            }
+        }
+        LatencyHistogram merged = retired_;
+        for (const auto& shard : shards_) add_shard(merged, *shard);
+        return merged;
+    }
+};
+
+} // namespace hft
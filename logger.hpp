@@ -1,16 +1,27 @@
+// logger.hpp - Asynchronous binary logger: per-thread SPSC byte rings, compile-time formats, batched writes
 #pragma once
 
-#include <string>
-#include <memory>
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <charconv>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
 #include <fstream>
+#include <iostream>
+#include <memory>
 #include <mutex>
+#include <string>
+#include <string_view>
 #include <thread>
-#include <queue>
-#include <atomic>
-#include <chrono>
-#include <iomanip>
-#include <sstream>
-#include <condition_variable>
+#include <type_traits>
+#include <vector>
+#include "io_service.hpp"
+#include "ring_buffer.hpp"
 
 namespace hft {
 
@@ -22,264 +33,584 @@ enum class LogLevel {
     CRITICAL = 4
 };
 
-struct LogEntry {
-    uint64_t timestamp_ns;
-    LogLevel level;
-    std::string category;
+// Category of the LOG_* macros; also selects the output file
+enum class LogCategory : uint8_t {
+    SYSTEM,
+    TRADING,
+    RISK
+};
+
+inline const char* log_category_name(LogCategory category) {
+    switch (category) {
+        case LogCategory::TRADING: return "TRADING";
+        case LogCategory::RISK: return "RISK";
+        default: return "SYSTEM";
+    }
+}
+
+// Output file for a free-form category name
+inline LogCategory log_category_file(std::string_view category) {
+    if (category == "TRADING" || category == "SIGNAL") return LogCategory::TRADING;
+    if (category == "RISK") return LogCategory::RISK;
+    return LogCategory::SYSTEM;
+}
+
+// Literal text before a placeholder, and the placeholder's precision (-1 = default)
+struct LogFormatField {
+    uint16_t begin;
+    uint16_t length;
+    int8_t precision;
+};
+
+/**
+ * Format string as a template argument
+ *
+ * Placeholders are "{}" and "{:.Nf}" (fixed, N decimals); any other "{:"
+ * spec fails to compile, and a "{" that starts neither is literal text.
+ */
+template<size_t N>
+struct LogFormat {
+    char text[N]{};
+
+    constexpr LogFormat(const char (&format)[N]) {
+        for (size_t i = 0; i < N; ++i) text[i] = format[i];
+    }
+
+    static constexpr size_t length() { return N - 1; }
+
+    // Index just past the placeholder starting at i, or 0 if none starts there
+    constexpr size_t placeholder_end(size_t i) const {
+        if (text[i] != '{' || i + 1 >= length()) return 0;
+        if (text[i + 1] == '}') return i + 2;
+        if (text[i + 1] != ':') return 0;
+        for (size_t j = i + 2; j < length(); ++j) {
+            if (text[j] == '}') return j + 1;
+        }
+        return 0;
+    }
+
+    constexpr size_t placeholders() const {
+        size_t count = 0;
+        for (size_t i = 0; i < length();) {
+            const size_t end = placeholder_end(i);
+            if (end > 0) {
+                ++count;
+                i = end;
+            } else {
+                ++i;
+            }
+        }
+        return count;
+    }
+};
+
+// A format string split into fields at compile time; fields[placeholders] is the trailing text
+template<LogFormat Format>
+struct ParsedLogFormat {
+    static constexpr size_t placeholders = Format.placeholders();
+
+    static constexpr std::array<LogFormatField, placeholders + 1> fields = [] {
+        std::array<LogFormatField, placeholders + 1> out{};
+        size_t field = 0, literal = 0;
+        for (size_t i = 0; i < Format.length();) {
+            const size_t end = Format.placeholder_end(i);
+            if (end == 0) {
+                ++i;
+                continue;
+            }
+            int precision = -1;
+            if (Format.text[i + 1] == ':') {
+                // "{:.Nf}" only
+                size_t j = i + 2;
+                if (Format.text[j] != '.') throw "unsupported log format spec (use {} or {:.Nf})";
+                precision = 0;
+                for (++j; Format.text[j] >= '0' && Format.text[j] <= '9'; ++j) {
+                    precision = precision * 10 + (Format.text[j] - '0');
+                }
+                if (Format.text[j] != 'f' || j + 2 != end || precision > 17) {
+                    throw "unsupported log format spec (use {} or {:.Nf})";
+                }
+            }
+            out[field++] = LogFormatField{static_cast<uint16_t>(literal), static_cast<uint16_t>(i - literal),
+                                          static_cast<int8_t>(precision)};
+            literal = i = end;
+        }
+        out[field] = LogFormatField{static_cast<uint16_t>(literal), static_cast<uint16_t>(Format.length() - literal), -1};
+        return out;
+    }();
+};
+
+// ========== Argument encoding ==========
+
+template<typename T>
+inline constexpr bool is_log_string_v = std::is_same_v<T, const char*> || std::is_same_v<T, char*> ||
+                                        std::is_same_v<T, std::string> || std::is_same_v<T, std::string_view>;
+
+template<typename T>
+inline constexpr bool is_log_value_v = std::is_arithmetic_v<T> || std::is_enum_v<T>;
+
+template<typename T>
+inline std::string_view log_string_view(const T& value) {
+    if constexpr (std::is_pointer_v<T>) {
+        return value ? std::string_view(value) : std::string_view("(null)");
+    } else {
+        return std::string_view(value);
+    }
+}
+
+// Encoded size: raw bytes for values, a 32-bit length and the bytes for strings
+template<typename T>
+inline size_t log_arg_size(const T& value) {
+    using U = std::decay_t<T>;
+    static_assert(is_log_value_v<U> || is_log_string_v<U>, "log arguments must be arithmetic, enums or strings");
+    if constexpr (is_log_string_v<U>) {
+        return sizeof(uint32_t) + log_string_view<U>(value).size();
+    } else {
+        return sizeof(U);
+    }
+}
+
+template<typename T>
+inline void encode_log_arg(uint8_t*& out, const T& value) {
+    using U = std::decay_t<T>;
+    if constexpr (is_log_string_v<U>) {
+        const std::string_view text = log_string_view<U>(value);
+        const uint32_t length = static_cast<uint32_t>(text.size());
+        std::memcpy(out, &length, sizeof(length));
+        std::memcpy(out + sizeof(length), text.data(), length);
+        out += sizeof(length) + length;
+    } else {
+        const U copy = value;
+        std::memcpy(out, &copy, sizeof(U));
+        out += sizeof(U);
+    }
+}
+
+inline std::string_view decode_log_string(const uint8_t*& in) {
+    uint32_t length;
+    std::memcpy(&length, in, sizeof(length));
+    const std::string_view text(reinterpret_cast<const char*>(in + sizeof(length)), length);
+    in += sizeof(length) + length;
+    return text;
+}
+
+template<typename T>
+inline void decode_log_arg(const uint8_t*& in, std::string& out, int precision) {
+    if constexpr (is_log_string_v<T>) {
+        out.append(decode_log_string(in));
+    } else {
+        T value;
+        std::memcpy(&value, in, sizeof(T));
+        in += sizeof(T);
+        if constexpr (std::is_same_v<T, bool>) {
+            out += value ? "true" : "false";
+        } else {
+            append_value(out, value, precision);
+        }
+    }
+}
+
+// A decoded record on the logging thread
+struct LogLine {
+    LogCategory file = LogCategory::SYSTEM;
+    std::string_view category;
     std::string message;
-    std::thread::id thread_id;
 };
 
+/**
+ * Record header in a thread's ring, followed by the encoded arguments
+ *
+ * decode is instantiated per call site and argument types, so it stands
+ * in for a format id: it knows the format, category and how to read the
+ * arguments back.
+ */
+struct LogRecord {
+    using Decoder = void (*)(const uint8_t* args, LogLine& line);
+
+    Decoder decode;
+    uint64_t timestamp_ns;
+    uint8_t level;
+};
+
+template<LogCategory Category, LogFormat Format, typename... Args, size_t... I>
+inline void decode_log_fields([[maybe_unused]] const uint8_t* in, std::string& out, std::index_sequence<I...>) {
+    using Parsed = ParsedLogFormat<Format>;
+    ((out.append(Format.text + Parsed::fields[I].begin, Parsed::fields[I].length),
+      decode_log_arg<Args>(in, out, Parsed::fields[I].precision)), ...);
+    constexpr LogFormatField tail = Parsed::fields[sizeof...(Args)];
+    out.append(Format.text + tail.begin, tail.length);
+}
+
+template<LogCategory Category, LogFormat Format, typename... Args>
+inline void decode_log_record(const uint8_t* args, LogLine& line) {
+    line.file = Category;
+    line.category = log_category_name(Category);
+    decode_log_fields<Category, Format, Args...>(args, line.message, std::index_sequence_for<Args...>{});
+}
+
+// Free-form record: category and message were encoded as strings
+inline void decode_log_message(const uint8_t* args, LogLine& line) {
+    line.category = decode_log_string(args);
+    line.file = log_category_file(line.category);
+    line.message.append(decode_log_string(args));
+}
+
+// A thread's log ring; retired when the thread exits, freed by the logging thread once drained
+struct LogBuffer {
+    SPSCByteRing ring;
+    std::atomic<uint64_t> dropped{0};       // Ring full; written by the owning thread only
+    std::atomic<bool> retired{false};
+    uint32_t thread_number;
+
+    LogBuffer(size_t capacity, uint32_t number) : ring(capacity), thread_number(number) {}
+
+    void count_drop() { dropped.store(dropped.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed); }
+};
+
+/**
+ * Logger
+ *
+ * A log call from a hot thread costs a clock read, a bounds check and a
+ * memcpy of its arguments into that thread's own LogBuffer: no lock, no
+ * allocation, no formatting. The format string is a template argument,
+ * parsed at compile time (placeholder count checked against the
+ * arguments), and the record carries a pointer to a decoder generated for
+ * the call site. A full ring drops the record and counts it rather than
+ * block the caller.
+ *
+ * The logging thread sweeps every ring, decodes and formats the records,
+ * merges them by timestamp and hands each file's batch to the IoService
+ * once per sweep; it sleeps flush_interval_us when there is nothing to
+ * write.
+ * Records are dropped until init() and after shutdown().
+ */
 class Logger {
-private:
+public:
     struct LoggerConfig {
         std::string system_log_file = "logs/system.log";
-        std::string trading_log_file = "logs/trading.log"; 
+        std::string trading_log_file = "logs/trading.log";
         std::string risk_log_file = "logs/risk.log";
         size_t max_file_size_mb = 100;
         size_t max_files = 10;
         LogLevel min_level = LogLevel::INFO;
         bool enable_console = true;
-        size_t async_buffer_size = 8192;
+        size_t thread_buffer_bytes = 256 * 1024;    // Per logging thread, rounded up to a power of two
+        uint32_t flush_interval_us = 1000;          // Logging thread's sleep when idle
+    };
+
+    struct Stats {
+        uint64_t records = 0;
+        uint64_t batches = 0;       // Sweeps that wrote something
+        uint64_t dropped = 0;       // Ring full
+        size_t threads = 0;         // Rings currently registered
+        size_t buffered_bytes = 0;  // Waiting in the rings
+        size_t buffer_bytes = 0;    // Capacity of the rings
+    };
+
+private:
+    static constexpr uint32_t LOG_RECORD = 1;      // Ring frame tag
+
+    struct Pending {
+        uint64_t timestamp_ns;
+        LogCategory file;
+        uint32_t offset;            // Into text_
+        uint32_t length;
+    };
+
+    // Marks the thread's ring retired when the thread exits; the logging thread frees it once drained
+    struct ThreadHandle {
+        LogBuffer* buffer = nullptr;
+        ~ThreadHandle() {
+            if (buffer) buffer->retired.store(true, std::memory_order_release);
+        }
     };
 
     LoggerConfig config_;
-    
-    // Async logging infrastructure
-    std::queue<LogEntry> log_queue_;
-    std::mutex queue_mutex_;
-    std::condition_variable queue_cv_;
-    std::atomic<bool> shutdown_{false};
+    std::atomic<int> min_level_{static_cast<int>(LogLevel::INFO)};
+    std::atomic<bool> running_{false};
     std::thread logging_thread_;
-    
-    // File handles
-    std::ofstream system_log_;
-    std::ofstream trading_log_;
-    std::ofstream risk_log_;
-    std::mutex file_mutex_;
-    
-    // File rotation tracking
-    std::atomic<size_t> system_log_size_{0};
-    std::atomic<size_t> trading_log_size_{0};
-    std::atomic<size_t> risk_log_size_{0};
-    
+
+    // Rings, registered on a thread's first log call
+    std::vector<std::unique_ptr<LogBuffer>> buffers_;
+    std::mutex buffers_mutex_;
+    uint32_t next_thread_number_ = 1;
+    uint64_t retired_dropped_ = 0;
+
+    // Files on the I/O service, by LogCategory
+    std::array<IoFileId, 3> files_{};
+
+    // Logging thread state, reused across sweeps
+    std::vector<LogBuffer*> sweep_;
+    std::vector<Pending> pending_;
+    std::string text_;
+    std::array<std::string, 3> file_batches_;
+    std::string console_batch_;
+    LogLine line_;
+    int64_t cached_second_ = -1;
+    char cached_time_[32] = {};
+
+    std::atomic<uint64_t> records_{0};
+    std::atomic<uint64_t> batches_{0};
+
     Logger() = default;
-    
+
+    static uint64_t now_ns() {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::system_clock::now().time_since_epoch()).count();
+    }
+
+    LogBuffer* register_thread() {
+        std::lock_guard<std::mutex> lock(buffers_mutex_);
+        buffers_.push_back(std::make_unique<LogBuffer>(config_.thread_buffer_bytes, next_thread_number_++));
+        return buffers_.back().get();
+    }
+
+    LogBuffer* thread_buffer() {
+        thread_local ThreadHandle handle;
+        if (!handle.buffer) [[unlikely]] handle.buffer = register_thread();
+        return handle.buffer;
+    }
+
+    bool enabled(LogLevel level) const {
+        return static_cast<int>(level) >= min_level_.load(std::memory_order_relaxed) &&
+               running_.load(std::memory_order_relaxed);
+    }
+
     void logging_worker() {
-        while (!shutdown_.load(std::memory_order_acquire)) {
-            std::unique_lock<std::mutex> lock(queue_mutex_);
-            queue_cv_.wait(lock, [this] { 
-                return !log_queue_.empty() || shutdown_.load(); 
-            });
-            
-            // Process all queued entries
-            while (!log_queue_.empty()) {
-                LogEntry entry = log_queue_.front();
-                log_queue_.pop();
-                lock.unlock();
-                
-                write_log_entry(entry);
-                
-                lock.lock();
+        while (running_.load(std::memory_order_acquire)) {
+            if (drain() == 0) {
+                std::this_thread::sleep_for(std::chrono::microseconds(config_.flush_interval_us));
             }
         }
-        
+
         // Flush remaining entries on shutdown
-        std::lock_guard<std::mutex> lock(queue_mutex_);
-        while (!log_queue_.empty()) {
-            write_log_entry(log_queue_.front());
-            log_queue_.pop();
+        while (drain() > 0) {}
+    }
+
+    // "YYYY-mm-dd HH:MM:SS.mmm [LEVEL] [CATEGORY] [T:n] " into text_
+    void append_prefix(uint64_t timestamp_ns, uint8_t level, std::string_view category, uint32_t thread) {
+        const int64_t second = static_cast<int64_t>(timestamp_ns / 1000000000ULL);
+        if (second != cached_second_) {
+            const std::time_t time = static_cast<std::time_t>(second);
+            std::tm local{};
+            localtime_r(&time, &local);
+            std::strftime(cached_time_, sizeof(cached_time_), "%Y-%m-%d %H:%M:%S", &local);
+            cached_second_ = second;
         }
+        static const char* level_str[] = {"DEBUG", "INFO", "WARN", "ERROR", "CRIT"};
+        char ms[8];
+        std::snprintf(ms, sizeof(ms), ".%03u", static_cast<unsigned>(timestamp_ns / 1000000 % 1000));
+        text_ += cached_time_;
+        text_ += ms;
+        text_ += " [";
+        text_ += level_str[std::min<uint8_t>(level, 4)];
+        text_ += "] [";
+        text_.append(category);
+        text_ += "] [T:";
+        append_value(text_, thread);
+        text_ += "] ";
     }
-    
-    void write_log_entry(const LogEntry& entry) {
-        if (entry.level < config_.min_level) return;
-        
-        std::string formatted = format_log_entry(entry);
-        
-        // Console output
-        if (config_.enable_console) {
-            std::cout << formatted << std::endl;
+
+    /**
+     * One sweep: decode every ring's records, merge by time, write each file once
+     *
+     * @return Records written
+     */
+    size_t drain() {
+        static constexpr size_t MAX_RECORDS_PER_RING = 4096;
+        {
+            std::lock_guard<std::mutex> lock(buffers_mutex_);
+            sweep_.clear();
+            for (const auto& buffer : buffers_) sweep_.push_back(buffer.get());
         }
-        
-        // File output
-        std::lock_guard<std::mutex> lock(file_mutex_);
-        
-        if (entry.category == "SYSTEM" || entry.category == "ERROR") {
-            write_to_file(system_log_, formatted, system_log_size_);
-        } else if (entry.category == "TRADING" || entry.category == "SIGNAL") {
-            write_to_file(trading_log_, formatted, trading_log_size_);
-        } else if (entry.category == "RISK") {
-            write_to_file(risk_log_, formatted, risk_log_size_);
-        } else {
-            write_to_file(system_log_, formatted, system_log_size_);
+
+        pending_.clear();
+        text_.clear();
+        size_t rings_with_records = 0;
+        for (LogBuffer* buffer : sweep_) {
+            const size_t before = pending_.size();
+            SPSCByteRing::Frame frame;
+            const uint8_t* record;
+            while (pending_.size() - before < MAX_RECORDS_PER_RING && (record = buffer->ring.peek(frame))) {
+                LogRecord header;
+                std::memcpy(&header, record, sizeof(header));
+                line_.message.clear();
+                header.decode(record + sizeof(LogRecord), line_);
+                const size_t offset = text_.size();
+                append_prefix(header.timestamp_ns, header.level, line_.category, buffer->thread_number);
+                text_ += line_.message;
+                text_ += '\n';
+                pending_.push_back(Pending{header.timestamp_ns, line_.file, static_cast<uint32_t>(offset),
+                                           static_cast<uint32_t>(text_.size() - offset)});
+                buffer->ring.release();
+            }
+            rings_with_records += pending_.size() > before;
         }
-    }
-    
-    void write_to_file(std::ofstream& file, const std::string& message, 
-                       std::atomic<size_t>& file_size) {
-        if (!file.is_open()) return;
-        
-        file << message << std::endl;
-        file_size += message.length() + 1;
-        
-        // Check for rotation
-        if (file_size.load() > config_.max_file_size_mb * 1024 * 1024) {
-            // File rotation would be implemented here
-            file_size = 0;
+
+        if (!pending_.empty()) {
+            if (rings_with_records > 1) {
+                std::stable_sort(pending_.begin(), pending_.end(),
+                                 [](const Pending& a, const Pending& b) { return a.timestamp_ns < b.timestamp_ns; });
+            }
+            write_batch();
+            records_.fetch_add(pending_.size(), std::memory_order_relaxed);
+            batches_.fetch_add(1, std::memory_order_relaxed);
         }
+
+        // Free rings whose threads have exited, once drained
+        std::lock_guard<std::mutex> lock(buffers_mutex_);
+        for (auto it = buffers_.begin(); it != buffers_.end();) {
+            if ((*it)->retired.load(std::memory_order_acquire) && (*it)->ring.empty()) {
+                retired_dropped_ += (*it)->dropped.load(std::memory_order_relaxed);
+                it = buffers_.erase(it);
+            } else {
+                ++it;
+            }
+        }
+        return pending_.size();
     }
-    
-    std::string format_log_entry(const LogEntry& entry) {
-        std::stringstream ss;
-        
-        // Timestamp
-        auto time_point = std::chrono::system_clock::time_point(
-            std::chrono::duration_cast<std::chrono::system_clock::duration>(
-                std::chrono::nanoseconds(entry.timestamp_ns)));
-        auto time_t = std::chrono::system_clock::to_time_t(time_point);
-        auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(
-            std::chrono::nanoseconds(entry.timestamp_ns) % 1000000000).count();
-        
-        ss << std::put_time(std::localtime(&time_t), "%Y-%m-%d %H:%M:%S");
-        ss << "." << std::setfill('0') << std::setw(3) << ms;
-        
-        // Log level
-        const char* level_str[] = {"DEBUG", "INFO", "WARN", "ERROR", "CRIT"};
-        ss << " [" << level_str[static_cast<int>(entry.level)] << "]";
-        
-        // Category
-        ss << " [" << entry.category << "]";
-        
-        // Thread ID
-        ss << " [T:" << std::hash<std::thread::id>{}(entry.thread_id) % 10000 << "]";
-        
-        // Message
-        ss << " " << entry.message;
-        
-        return ss.str();
+
+    void write_batch() {
+        for (std::string& batch : file_batches_) batch.clear();
+        console_batch_.clear();
+        for (const Pending& entry : pending_) {
+            const std::string_view text(text_.data() + entry.offset, entry.length);
+            file_batches_[static_cast<size_t>(entry.file)].append(text);
+            if (config_.enable_console) console_batch_.append(text);
+        }
+
+        if (!console_batch_.empty()) {
+            std::cout.write(console_batch_.data(), static_cast<std::streamsize>(console_batch_.size()));
+            std::cout.flush();
+        }
+        for (size_t i = 0; i < files_.size(); ++i) {
+            if (!file_batches_[i].empty()) IoService::instance().write(files_[i], file_batches_[i]);
+        }
     }
-    
+
     void ensure_directories() {
         // Create logs directory if it doesn't exist
         std::system("mkdir -p logs");
     }
 
 public:
+    // Never destroyed: threads may still log (and exit, retiring their rings) during static destruction
     static Logger& instance() {
-        static Logger instance;
-        return instance;
+        static Logger* instance = new Logger();
+        return *instance;
     }
-    
+
     void init() {
         init(LoggerConfig{});
     }
-    
+
     void init(const LoggerConfig& config) {
+        if (running_.load()) return;
         config_ = config;
+        min_level_.store(static_cast<int>(config.min_level), std::memory_order_relaxed);
         ensure_directories();
-        
-        // Open log files
-        std::lock_guard<std::mutex> lock(file_mutex_);
-        system_log_.open(config_.system_log_file, std::ios::app);
-        trading_log_.open(config_.trading_log_file, std::ios::app);
-        risk_log_.open(config_.risk_log_file, std::ios::app);
-        
+
+        // Open log files; the I/O service rotates them by size
+        IoService::FileOptions options;
+        options.rotate_bytes = config_.max_file_size_mb * 1024 * 1024;
+        options.block_when_full = true;     // Written by the logging thread, off the trading path
+        auto& io = IoService::instance();
+        files_[static_cast<size_t>(LogCategory::SYSTEM)] = io.open(config_.system_log_file, options);
+        files_[static_cast<size_t>(LogCategory::TRADING)] = io.open(config_.trading_log_file, options);
+        files_[static_cast<size_t>(LogCategory::RISK)] = io.open(config_.risk_log_file, options);
+
         // Start async logging thread
-        shutdown_.store(false);
+        running_.store(true, std::memory_order_release);
         logging_thread_ = std::thread(&Logger::logging_worker, this);
-        
+
         log(LogLevel::INFO, "SYSTEM", "Logger initialized");
     }
-    
+
     void shutdown() {
+        if (!running_.load()) return;
         log(LogLevel::INFO, "SYSTEM", "Logger shutting down");
-        
-        shutdown_.store(true, std::memory_order_release);
-        queue_cv_.notify_all();
-        
+
+        // Records written after this point are dropped; the thread drains what is already queued
+        running_.store(false, std::memory_order_release);
         if (logging_thread_.joinable()) {
             logging_thread_.join();
         }
-        
-        // Close files
-        std::lock_guard<std::mutex> lock(file_mutex_);
-        system_log_.close();
-        trading_log_.close();
-        risk_log_.close();
-    }
-    
-    void log(LogLevel level, const std::string& category, const std::string& message) {
-        LogEntry entry{
-            .timestamp_ns = static_cast<uint64_t>(
-                std::chrono::high_resolution_clock::now().time_since_epoch().count()),
-            .level = level,
-            .category = category,
-            .message = message,
-            .thread_id = std::this_thread::get_id()
-        };
-        
-        std::lock_guard<std::mutex> lock(queue_mutex_);
-        log_queue_.push(entry);
-        queue_cv_.notify_one();
-    }
-    
-    // Convenience methods
-    template<typename... Args>
-    void log_error(const std::string& format, Args&&... args) {
-        log(LogLevel::ERROR, "SYSTEM", format_string(format, std::forward<Args>(args)...));
-    }
-    
-    template<typename... Args>
-    void log_trade(const std::string& format, Args&&... args) {
-        log(LogLevel::INFO, "TRADING", format_string(format, std::forward<Args>(args)...));
-    }
-    
-    template<typename... Args>
-    void log_risk(const std::string& format, Args&&... args) {
-        log(LogLevel::WARNING, "RISK", format_string(format, std::forward<Args>(args)...));
-    }
-    
-    template<typename... Args>
-    void log_info(const std::string& format, Args&&... args) {
-        log(LogLevel::INFO, "SYSTEM", format_string(format, std::forward<Args>(args)...));
-    }
-    
-    template<typename... Args>
-    void log_debug(const std::string& format, Args&&... args) {
-        log(LogLevel::DEBUG, "SYSTEM", format_string(format, std::forward<Args>(args)...));
+
+        IoService::instance().flush();
     }
 
-private:
-    template<typename... Args>
-    std::string format_string(const std::string& format, Args&&... args) {
-        // Simple string formatting - in production would use fmt library
-        std::stringstream ss;
-        format_impl(ss, format, std::forward<Args>(args)...);
-        return ss.str();
+    /**
+     * Queue a record for a call site (use the LOG_* macros)
+     *
+     * Arguments are copied as raw bytes: arithmetic values, enums and
+     * strings (C strings, std::string, std::string_view).
+     */
+    template<LogLevel Level, LogCategory Category, LogFormat Format, typename... Args>
+    void write(const Args&... args) {
+        static_assert(ParsedLogFormat<Format>::placeholders == sizeof...(Args),
+                      "log format placeholders must match the number of arguments");
+        if (!enabled(Level)) return;
+
+        LogBuffer* buffer = thread_buffer();
+        uint8_t* out = buffer->ring.reserve(sizeof(LogRecord) + (size_t{0} + ... + log_arg_size(args)));
+        if (!out) [[unlikely]] {
+            buffer->count_drop();
+            return;
+        }
+        const LogRecord header{&decode_log_record<Category, Format, std::decay_t<Args>...>, now_ns(),
+                               static_cast<uint8_t>(Level)};
+        std::memcpy(out, &header, sizeof(header));
+        out += sizeof(header);
+        (encode_log_arg(out, args), ...);
+        buffer->ring.commit(LOG_RECORD);
     }
-    
-    void format_impl(std::stringstream& ss, const std::string& format) {
-        ss << format;
+
+    // Free-form record with a runtime category and preformatted message
+    void log(LogLevel level, std::string_view category, std::string_view message) {
+        if (!enabled(level)) return;
+
+        LogBuffer* buffer = thread_buffer();
+        uint8_t* out = buffer->ring.reserve(sizeof(LogRecord) + log_arg_size(category) + log_arg_size(message));
+        if (!out) [[unlikely]] {
+            buffer->count_drop();
+            return;
+        }
+        const LogRecord header{&decode_log_message, now_ns(), static_cast<uint8_t>(level)};
+        std::memcpy(out, &header, sizeof(header));
+        out += sizeof(header);
+        encode_log_arg(out, category);
+        encode_log_arg(out, message);
+        buffer->ring.commit(LOG_RECORD);
     }
-    
-    template<typename T, typename... Args>
-    void format_impl(std::stringstream& ss, const std::string& format, T&& value, Args&&... args) {
-        size_t pos = format.find("{}");
-        if (pos != std::string::npos) {
-            ss << format.substr(0, pos) << std::forward<T>(value);
-            format_impl(ss, format.substr(pos + 2), std::forward<Args>(args)...);
-        } else {
-            ss << format;
+
+    Stats stats() {
+        Stats stats;
+        stats.records = records_.load(std::memory_order_relaxed);
+        stats.batches = batches_.load(std::memory_order_relaxed);
+        std::lock_guard<std::mutex> lock(buffers_mutex_);
+        stats.dropped = retired_dropped_;
+        for (const auto& buffer : buffers_) {
+            stats.dropped += buffer->dropped.load(std::memory_order_relaxed);
+            stats.buffered_bytes += buffer->ring.used();
+            stats.buffer_bytes += buffer->ring.capacity();
         }
+        stats.threads = buffers_.size();
+        return stats;
     }
+
+    bool running() const { return running_.load(std::memory_order_acquire); }
 };
 
-// Global logging macros
-#define LOG_ERROR(...) hft::Logger::instance().log_error(__VA_ARGS__)
-#define LOG_TRADE(...) hft::Logger::instance().log_trade(__VA_ARGS__)
-#define LOG_RISK(...) hft::Logger::instance().log_risk(__VA_ARGS__)
-#define LOG_INFO(...) hft::Logger::instance().log_info(__VA_ARGS__)
-#define LOG_DEBUG(...) hft::Logger::instance().log_debug(__VA_ARGS__)
+// Global logging macros: the format must be a string literal
+#define LOG_ERROR(format, ...) \
+    ::hft::Logger::instance().write<::hft::LogLevel::ERROR, ::hft::LogCategory::SYSTEM, format>(__VA_ARGS__)
+#define LOG_TRADE(format, ...) \
+    ::hft::Logger::instance().write<::hft::LogLevel::INFO, ::hft::LogCategory::TRADING, format>(__VA_ARGS__)
+#define LOG_RISK(format, ...) \
+    ::hft::Logger::instance().write<::hft::LogLevel::WARNING, ::hft::LogCategory::RISK, format>(__VA_ARGS__)
+#define LOG_INFO(format, ...) \
+    ::hft::Logger::instance().write<::hft::LogLevel::INFO, ::hft::LogCategory::SYSTEM, format>(__VA_ARGS__)
+#define LOG_DEBUG(format, ...) \
+    ::hft::Logger::instance().write<::hft::LogLevel::DEBUG, ::hft::LogCategory::SYSTEM, format>(__VA_ARGS__)
 
 } // namespace hft
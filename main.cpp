@@ -7,11 +7,19 @@
 #include "sequencer.hpp"
 #include "position_tracker.hpp"
 #include "logger.hpp"
+#include "kill_switch.hpp"
+#include "metrics_segment.hpp"
 #include "connection_manager.hpp"
+#include "order_manager.hpp"
+#include "smart_order_router.hpp"
 #include "strategies/intraday_strategies.hpp"
+#include "strategies/strategy_host.hpp"
+#include "strategies/execution_pipeline.hpp"
 #include "strategies/intraday_risk_manager.hpp"
+#include "strategies/session_recovery.hpp"
 #include "strategies/enhanced_feed_handler.hpp"
 #include "strategies/simple_executor.hpp"
+#include "strategies/simulated_gateway.hpp"
 #include "strategies/performance_tracker.hpp"
 
 using namespace hft;
@@ -20,6 +28,9 @@ using namespace hft::strategies;
 // Global flag for graceful shutdown
 std::atomic<bool> running{true};
 
+// Round trip of the simulated venue (order -> ack/fill)
+constexpr uint64_t SIMULATED_VENUE_LATENCY_NS = 200000;
+
 void signal_handler(int signum) {
     std::cout << "\n🛑 Received signal " << signum << ", shutting down gracefully...\n";
     running.store(false);
@@ -40,10 +51,46 @@ int main() {
         hft::Logger::instance().init();
         LOG_INFO("Intraday Trading System starting");
         
+        // Risk-state word shared with every other trading process and the hft_kill CLI
+        if (KillSwitch::instance().attach()) {
+            const uint64_t state = KillSwitch::instance().state();
+            std::cout << "🛑 Kill switch: " << KillSwitch::DEFAULT_NAME << " ("
+                      << (KillSwitch::is_halted(state) ? "HALTED: " + KillSwitch::describe(KillSwitch::flags_of(state))
+                                                       : std::string("clear")) << ")\n";
+        } else {
+            std::cout << "⚠️  Kill switch page unavailable - halts stay local to this process\n";
+        }
+        
+        // Metrics collected once a second into shared memory for hft_top / hft_metrics_exporter
+        if (MetricsPublisher::instance().start()) {
+            std::cout << "📡 Metrics: " << MetricsSegment::DEFAULT_NAME << " (hft_top, hft_metrics_exporter)\n";
+        } else {
+            std::cout << "⚠️  Metrics segment unavailable - metrics stay in-process\n";
+        }
+        
+        // Exchange calendar for the session clock (holidays and early closes)
+        if (!SessionClock::instance().load_calendar("config/market_calendar.csv")) {
+            std::cout << "⚠️  Market calendar not found - assuming regular weekday sessions\n";
+        }
+        
         // Initialize position tracker and risk manager
         PositionTracker position_tracker;
         IntradayRiskManager risk_manager(&position_tracker);
         
+        // Book of record: fills and session risk go to a write-ahead journal, compacted into
+        // periodic snapshots. A restart on the same trading day resumes from them.
+        TradeJournal journal;
+        SessionRecovery recovery(journal, "session_snapshot.bin");
+        const uint32_t session_date =
+            SessionTime(SessionClock::instance().compute_word(SessionClock::instance().now_ns())).date();
+        if (journal.open("session_journal.bin", session_date)) {
+            SessionRecovery::print_stats(recovery.recover(position_tracker, &risk_manager));
+            position_tracker.set_journal(&journal);
+            risk_manager.set_journal(&journal);
+        } else {
+            std::cout << "⚠️  Trade journal unavailable - running without crash recovery\n";
+        }
+        
         std::cout << "⚙️  Intraday Configuration:\n";
         std::cout << "   - Starting Capital: $" << risk_manager.get_limits().capital << "\n";
         std::cout << "   - Daily Loss Limit: $" << risk_manager.get_limits().daily_loss_limit << "\n";
@@ -51,24 +98,115 @@ int main() {
         std::cout << "   - Symbols: SPY, QQQ, AAPL\n\n";
         
         // Initialize core components
-        IntradayStrategyEngine strategy_engine;
+        // Strategies run on symbol-sharded worker threads; the feed thread only dispatches
+        StrategyHostConfig host_config;
+        host_config.num_shards = std::max(1u, std::min(4u, std::thread::hardware_concurrency() / 2));
+        StrategyHost strategy_host(host_config);
+        for (const auto& symbol : EnhancedMarketDataFeed::SYMBOLS) {
+            strategy_host.add_symbol(symbol);
+        }
+        if (!strategy_host.load_pairs_from_config("config/intraday_config.json")) {
+            std::cout << "⚠️  No pairs configured - defaulting to SPY/QQQ\n";
+            strategy_host.add_pair("SPY", "QQQ");
+        }
         SimpleExecutor executor;
         PerformanceTracker tracker(risk_manager.get_limits().capital);
         EnhancedMarketDataFeed feed_handler;
         
         LOG_INFO("Core components initialized");
         
-        // Set up market data callback
-        std::vector<Signal> pending_signals;
+        // Orders flow pipeline -> OMS -> simulated venue and back over rings
+        OrderManager oms;
+        // Order-rate budgets checked on submit, per venue and across all venues
+        HierarchicalRateLimiter rate_limiter;
+        rate_limiter.set_global_limit({100.0, 50.0});
+        for (Venue venue : {Venue::NYSE, Venue::NASDAQ, Venue::BATS}) {
+            rate_limiter.set_venue_limit(venue, {50.0, 20.0});
+        }
+        oms.set_rate_limiter(&rate_limiter);
+        SimulatedGateway gateway(oms, executor, &SessionClock::instance(), SIMULATED_VENUE_LATENCY_NS);
+        
+        // Equity venues the router may split across; each is ranked by touch price, taker fee
+        // and measured round trip once its feed quotes (this build's feed is NYSE only)
+        SmartOrderRouter router;
+        VenueFees nyse_fees;
+        nyse_fees.taker_fee = 0.00030;
+        VenueFees nasdaq_fees;
+        nasdaq_fees.taker_fee = 0.00030;
+        VenueFees bats_fees;
+        bats_fees.taker_fee = 0.00025;
+        router.add_venue(Venue::NYSE, nyse_fees, SIMULATED_VENUE_LATENCY_NS);
+        router.add_venue(Venue::NASDAQ, nasdaq_fees, SIMULATED_VENUE_LATENCY_NS);
+        router.add_venue(Venue::BATS, bats_fees, 2 * SIMULATED_VENUE_LATENCY_NS);
+        
+        // Event loop inputs: order intents from the strategy shards and price updates from the feed
+        ExecutionPipeline pipeline(risk_manager, oms);
+        pipeline.set_router(&router);
+        
+        // Entries are worked as short TWAPs on the shared timer wheel; exits stay immediate
+        ExecutionAlgoEngine algos(oms);
+        ParentOrderSpec entry_algo;
+        entry_algo.algo = AlgoType::TWAP;
+        entry_algo.duration_ns = 30ULL * 1000000000ULL;
+        entry_algo.slice_interval_ns = 5ULL * 1000000000ULL;
+        pipeline.set_entry_algo(&algos, entry_algo);
+        
+        // Pair signals trade both legs as one basket: a single combined risk check, legs out together,
+        // unwound if either leg fails
+        BasketRiskLimits basket_limits;
+        basket_limits.max_gross_notional = 2.0 * risk_manager.get_limits().max_position_value;
+        basket_limits.max_net_notional = 0.5 * risk_manager.get_limits().max_position_value;
+        basket_limits.max_leg_failure_exposure = risk_manager.get_limits().max_position_value;
+        BasketManager baskets(oms, basket_limits);
+        pipeline.set_basket_manager(&baskets);
+        SPSCQueue<MarketUpdate, 8192> market_updates;
+        std::unordered_map<std::string, SymbolId> feed_symbol_ids;
+        for (const auto& symbol : EnhancedMarketDataFeed::SYMBOLS) {
+            feed_symbol_ids[symbol] = SymbolTable::instance().intern(symbol);
+            algos.volume_profile(feed_symbol_ids[symbol]);  // Learn each symbol's intraday volume curve
+        }
+        
         feed_handler.set_data_callback([&](const EnhancedMarketData& data) {
-            // Process market data through strategy engine
-            auto signal = strategy_engine.process_market_data(data);
-            if (signal.is_valid && signal.confidence > 0.7) {
-                pending_signals.push_back(signal);
+            // Route market data to the shard owning this symbol
+            strategy_host.dispatch(data);
+            
+            // Forward prices to the event loop for execution and exit triggers
+            auto it = feed_symbol_ids.find(data.symbol);
+            if (it != feed_symbol_ids.end()) {
+                market_updates.push(MarketUpdate{data.timestamp_ns, it->second, Venue::NYSE,
+                                                 data.bid, data.ask, data.last,
+                                                 static_cast<double>(data.bid_size),
+                                                 static_cast<double>(data.ask_size),
+                                                 data.cumulative_volume});
             }
+        });
+        
+        pipeline.set_entry_callback([](const ManagedPosition& position) {
+            const Signal& signal = position.signal;
+            std::cout << "🎯 " << signal.strategy_type << " Signal: " << signal.symbol << " "
+                      << (signal.direction == Signal::LONG ? "LONG" : "SHORT")
+                      << " @ $" << std::fixed << std::setprecision(2) << signal.entry_price
+                      << " (confidence: " << signal.confidence << ")\n";
+            std::cout << "   ✅ Entry filled: " << position.entry.filled_quantity
+                      << " " << position.symbol << " @ $" << position.entry.fill_price
+                      << " (slippage: " << position.entry.slippage_bps << " bps)\n";
+        });
+        
+        pipeline.set_exit_callback([&](const ManagedPosition& position, const OrderResult& exit_order,
+                                       double pnl, ExitReason reason) {
+            const Signal& signal = position.signal;
+            std::cout << "   ✅ Exit filled (" << exit_reason_name(reason) << "): "
+                      << exit_order.filled_quantity << " " << position.symbol
+                      << " @ $" << exit_order.fill_price << "\n";
+            std::cout << "   💰 Trade P&L: $" << pnl << "\n";
             
-            // Update executor with current market data
-            executor.update_market_data(data.symbol, data.bid, data.ask);
+            tracker.record_trade(signal, position.entry, exit_order);
+        });
+        
+        // Every execution is booked (and journaled) as it arrives: open positions, partial exits,
+        // both pair legs and any unwind are in the book of record before the trade closes
+        pipeline.set_fill_callback([&](Venue venue, SymbolId symbol, double quantity, double price) {
+            position_tracker.add_trade(venue, symbol, quantity, price);
         });
         
         std::cout << "🛡️ Intraday risk management initialized\n";
@@ -76,99 +214,88 @@ int main() {
         std::cout << "📈 Performance tracking enabled\n";
         std::cout << "💾 Trade logging: trades.csv\n";
         std::cout << "📋 Risk events: intraday_risk.csv\n";
-        std::cout << "📝 Daily performance: daily_performance.csv\n\n";
+        std::cout << "📝 Daily performance: daily_performance.csv\n";
+        std::cout << "💾 Fill journal: session_journal.bin (snapshots: session_snapshot.bin)\n\n";
         
-        // Start market data feed
+        // Start strategy shards, then the market data feed
+        strategy_host.start();
         feed_handler.start();
         
         std::cout << "✅ Market data feed started\n";
         std::cout << "✅ Strategy engine ready\n";
         std::cout << "✅ Risk management active\n";
         
-        // Main intraday trading loop
+        // Main intraday event loop
         auto start_time = std::chrono::steady_clock::now();
         auto last_status_print = start_time;
+        auto last_metrics_update = start_time;
+        
+        // Loop metrics: counted per event, session figures set once a second on this thread
+        auto& metrics = MetricsRegistry::instance();
+        const CounterId market_update_count = metrics.counter("main.market_updates");
+        const CounterId intent_count = metrics.counter("main.order_intents");
+        const GaugeId pnl_gauge = metrics.gauge("session.pnl");
+        const GaugeId trades_gauge = metrics.gauge("session.trades");
+        const GaugeId capital_gauge = metrics.gauge("session.capital");
+        const GaugeId open_positions_gauge = metrics.gauge("session.open_positions");
         auto last_report_time = start_time;
+        uint32_t idle_iterations = 0;
         
-        std::cout << "✅ Intraday trading loop started\n";
+        std::cout << "✅ Intraday event loop started\n";
         std::cout << "🎯 Target: $60 daily profit, $100 max loss\n";
         std::cout << "⏰ Session timeout: 6 hours\n";
         std::cout << "🛑 Emergency stop: Ctrl+C or risk limits\n\n";
         
-        while (running.load() && risk_manager.can_trade()) {
-            // Process any pending signals from market data callback
-            for (auto it = pending_signals.begin(); it != pending_signals.end();) {
-                const auto& signal = *it;
-                
-                // Risk check before execution
-                if (risk_manager.can_trade(signal)) {
-                    // Calculate position size
-                    auto position_size = risk_manager.calculate_position_size(signal);
-                    
-                    if (position_size.is_valid) {
-                        std::cout << "🎯 " << signal.strategy_type << " Signal: " 
-                                  << signal.symbol << " " 
-                                  << (signal.direction == Signal::LONG ? "LONG" : "SHORT")
-                                  << " @ $" << std::fixed << std::setprecision(2) << signal.entry_price
-                                  << " (confidence: " << signal.confidence << ")\n";
-                        
-                        // Execute entry order
-                        auto entry_order = executor.execute_signal(signal, position_size.shares);
-                        
-                        if (entry_order.is_filled()) {
-                            std::cout << "   ✅ Entry filled: " << entry_order.filled_quantity 
-                                      << " shares @ $" << entry_order.fill_price 
-                                      << " (slippage: " << entry_order.slippage_bps << " bps)\n";
-                            
-                            // Simulate holding period (in real system, this would be handled differently)
-                            std::this_thread::sleep_for(std::chrono::milliseconds(100));
-                            
-                            // Create exit signal (simplified - would use exit conditions)
-                            Signal exit_signal = signal;
-                            exit_signal.direction = (signal.direction == Signal::LONG) ? Signal::SHORT : Signal::LONG;
-                            exit_signal.entry_price = signal.target_price;
-                            
-                            // Execute exit order
-                            auto exit_order = executor.execute_signal(exit_signal, position_size.shares);
-                            
-                            if (exit_order.is_filled()) {
-                                std::cout << "   ✅ Exit filled: " << exit_order.filled_quantity 
-                                          << " shares @ $" << exit_order.fill_price << "\n";
-                                
-                                // Calculate P&L and update tracking
-                                double pnl = executor.calculate_pnl(entry_order, exit_order);
-                                std::cout << "   💰 Trade P&L: $" << pnl << "\n";
-                                
-                                // Record trade
-                                risk_manager.update_trade_result(signal, position_size, pnl, 
-                                                                entry_order.commission + exit_order.commission);
-                                tracker.record_trade(signal, entry_order, exit_order);
-                                
-                                // Update position tracker
-                                position_tracker.add_trade("NYSE", signal.symbol, 
-                                                          entry_order.filled_quantity * 
-                                                          (signal.direction == Signal::LONG ? 1 : -1), 
-                                                          entry_order.fill_price);
-                                position_tracker.add_trade("NYSE", signal.symbol, 
-                                                          exit_order.filled_quantity * 
-                                                          (exit_signal.direction == Signal::LONG ? 1 : -1), 
-                                                          exit_order.fill_price);
-                            }
-                        } else {
-                            std::cout << "   ❌ Entry order rejected: " << entry_order.rejection_reason << "\n";
-                        }
-                    } else {
-                        std::cout << "   ❌ Position sizing failed: " << position_size.reason << "\n";
-                    }
-                } else {
-                    std::cout << "   ❌ Trade blocked by risk manager\n";
-                }
-                
-                it = pending_signals.erase(it);
+        while (running.load() && !risk_manager.is_trading_halted()) {
+            bool did_work = false;
+            
+            // Prices first so entries fill against the latest quote and exits trigger promptly
+            MarketUpdate update;
+            while (market_updates.pop(update)) {
+                const std::string& symbol = SymbolTable::instance().name(update.symbol);
+                router.on_quote(update.venue, update.symbol, update.bid, update.ask,
+                                update.bid_size, update.ask_size, SessionClock::instance().now_ns());
+                gateway.on_market_data(symbol, update.bid, update.ask);
+                algos.on_market_data(update.symbol, update.bid, update.ask, update.cumulative_volume);
+                pipeline.on_market_data(symbol, update.bid, update.ask, update.last);
+                metrics.add(market_update_count);
+                did_work = true;
             }
             
-            // Print status every 30 seconds
+            // Order intents go through risk and execution as soon as they arrive
+            OrderIntent intent;
+            while (strategy_host.poll_intent(intent)) {
+                pipeline.on_signal(strategy_host.to_signal(intent));
+                metrics.add(intent_count);
+                did_work = true;
+            }
+            
+            // Hold-time exits and algo slices
+            const uint64_t now_ns = SessionClock::instance().now_ns();
+            pipeline.on_timer(now_ns);
+            if (algos.on_timer(now_ns) > 0) {
+                did_work = true;
+            }
+            
+            // Order lifecycle: requests out to the venue, acks and fills back to the pipeline
+            if (oms.poll() + gateway.poll() + oms.poll() + pipeline.poll() > 0) {
+                did_work = true;
+            }
+            
+            // Group commit of this iteration's fills, and a snapshot when due
+            journal.commit();
+            recovery.maybe_snapshot(position_tracker, &risk_manager);
+            
             auto now = std::chrono::steady_clock::now();
+            if (now - last_metrics_update >= std::chrono::seconds(1)) {
+                metrics.set(pnl_gauge, risk_manager.get_daily_pnl());
+                metrics.set(trades_gauge, risk_manager.get_trades_today());
+                metrics.set(capital_gauge, tracker.get_current_capital());
+                metrics.set(open_positions_gauge, static_cast<double>(pipeline.open_positions()));
+                last_metrics_update = now;
+            }
+            
+            // Print status every 30 seconds
             if (now - last_status_print >= std::chrono::seconds(30)) {
                 std::cout << "\n📊 === INTRADAY STATUS UPDATE ===\n";
                 
@@ -182,6 +309,13 @@ int main() {
                 
                 // Show feed status
                 feed_handler.print_status();
+                strategy_host.print_status();
+                pipeline.print_status();
+                oms.print_status();
+                rate_limiter.print_status();
+                router.print_status();
+                algos.print_status();
+                baskets.print_status();
                 executor.print_status();
                 risk_manager.print_risk_status();
                 
@@ -197,14 +331,40 @@ int main() {
                 last_report_time = now;
             }
             
-            // Sleep for 1 second (intraday trading doesn't need HFT speed)
-            std::this_thread::sleep_for(std::chrono::seconds(1));
+            // Idle backoff: spin briefly, then yield, then short sleeps
+            if (did_work) {
+                idle_iterations = 0;
+            } else if (++idle_iterations < 1000) {
+#ifdef HAS_X86_INTRINSICS
+                _mm_pause();
+#endif
+            } else if (idle_iterations < 2000) {
+                std::this_thread::yield();
+            } else {
+                std::this_thread::sleep_for(std::chrono::microseconds(50));
+            }
         }
         
         // Cleanup and final reporting
         std::cout << "\n🛑 Shutting down intraday trading system...\n";
         
+        // Flatten open positions while prices are still current, then wait for the exit fills
+        pipeline.flatten_all();
+        auto flatten_deadline = std::chrono::steady_clock::now() + std::chrono::seconds(2);
+        while (pipeline.open_positions() > 0 && std::chrono::steady_clock::now() < flatten_deadline) {
+            oms.poll();
+            gateway.poll();
+            oms.poll();
+            pipeline.poll();
+            std::this_thread::sleep_for(std::chrono::microseconds(50));
+        }
+        
         feed_handler.stop();
+        strategy_host.stop();
+        
+        if (journal.is_open() && recovery.write_snapshot(position_tracker, &risk_manager)) {
+            std::cout << "💾 Session snapshot written (" << recovery.snapshots() << " this run)\n";
+        }
         
         auto total_runtime = std::chrono::duration_cast<std::chrono::seconds>(
             std::chrono::steady_clock::now() - start_time);
@@ -222,7 +382,8 @@ int main() {
         std::cout << "📈 Total return: " << tracker.get_total_return_percent() << "%\n";
         std::cout << "🎯 Thank you for testing the intraday trading system!\n";
         
-        // Shutdown logger last
+        // Final metrics collection stays readable in the segment; shutdown logger last
+        MetricsPublisher::instance().stop();
         hft::Logger::instance().shutdown();
         
     } catch (const std::exception& e) {
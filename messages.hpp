@@ -172,6 +172,61 @@ inline double to_float_price(Price price) {
     return static_cast<double>(price) / PRICE_MULTIPLIER;
 }
 
+/**
+ * Convert floating point quantity to fixed point
+ * @param quantity Floating point quantity (shares may be fractional)
+ * @return Fixed point representation
+ */
+inline Quantity to_fixed_quantity(double quantity) {
+    return static_cast<Quantity>(quantity * QUANTITY_MULTIPLIER + 0.5);
+}
+
+/**
+ * Convert fixed point quantity to floating point
+ * @param quantity Fixed point quantity
+ * @return Floating point representation
+ */
+inline double to_float_quantity(Quantity quantity) {
+    return static_cast<double>(quantity) / QUANTITY_MULTIPLIER;
+}
+
+/**
+ * Venue display name
+ * @param venue Trading venue
+ * @return Exchange name (e.g. "NYSE")
+ */
+inline const char* venue_name(Venue venue) {
+    switch (venue) {
+        case Venue::BINANCE: return "BINANCE";
+        case Venue::COINBASE: return "COINBASE";
+        case Venue::CME: return "CME";
+        case Venue::NYSE: return "NYSE";
+        case Venue::NASDAQ: return "NASDAQ";
+        case Venue::EUREX: return "EUREX";
+        case Venue::DERIBIT: return "DERIBIT";
+        case Venue::OKX: return "OKX";
+        case Venue::BATS: return "BATS";
+        case Venue::ICE: return "ICE";
+    }
+    return "UNKNOWN";
+}
+
+constexpr size_t VENUE_COUNT = 10;
+
+/**
+ * Parse a venue name as produced by venue_name()
+ * @return false if the name is not a known venue
+ */
+inline bool venue_from_name(const char* name, Venue& venue) {
+    for (size_t v = 0; v < VENUE_COUNT; ++v) {
+        if (std::strcmp(name, venue_name(static_cast<Venue>(v))) == 0) {
+            venue = static_cast<Venue>(v);
+            return true;
+        }
+    }
+    return false;
+}
+
 /**
  * Core sequenced message structure
  *
@@ -0,0 +1,410 @@
+// metrics_registry.hpp - Counters, gauges and latency histograms by dense id, updated through per-thread slots
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+#include "latency_histogram.hpp"
+
+namespace hft {
+
+enum class MetricKind : uint8_t {
+    COUNTER,
+    GAUGE,
+    HISTOGRAM
+};
+
+// Dense ids handed out at registration; the default-constructed id is invalid
+struct CounterId {
+    uint32_t index = UINT32_MAX;
+    bool valid() const noexcept { return index != UINT32_MAX; }
+};
+
+struct GaugeId {
+    uint32_t index = UINT32_MAX;
+    bool valid() const noexcept { return index != UINT32_MAX; }
+};
+
+struct HistogramId {
+    uint32_t index = UINT32_MAX;
+    bool valid() const noexcept { return index != UINT32_MAX; }
+};
+
+// Metric name as a template argument, for metric<"name">() ids resolved once per call site
+template<size_t N>
+struct MetricName {
+    char text[N]{};
+
+    constexpr MetricName(const char (&name)[N]) {
+        for (size_t i = 0; i < N; ++i) text[i] = name[i];
+    }
+
+    constexpr std::string_view view() const { return std::string_view(text, N - 1); }
+};
+
+// One collected value; histograms carry a cumulative summary
+struct MetricSample {
+    std::string name;
+    MetricKind kind;
+    double value = 0.0;             // Counter total or gauge value; histogram sample count
+    double rate = 0.0;              // Counter increase per second over the last collection
+    uint64_t sum_ns = 0;
+    uint64_t min_ns = 0;
+    uint64_t max_ns = 0;
+    uint64_t p50_ns = 0;
+    uint64_t p90_ns = 0;
+    uint64_t p99_ns = 0;
+    uint64_t p999_ns = 0;
+    uint64_t p9999_ns = 0;
+};
+
+struct MetricsSnapshot {
+    uint64_t sequence = 0;          // Collections so far
+    uint64_t timestamp_ns = 0;
+    std::vector<MetricSample> samples;
+};
+
+/**
+ * Metrics Registry
+ *
+ * Metrics are declared once, by name, and get dense ids (a second
+ * declaration of a name returns the first id). Updates go through the id:
+ *
+ * - Counters: each thread owns a cache-aligned slot block with one
+ *   64-bit slot per counter; add() is a plain single-writer load/store,
+ *   no RMW, no lock, no string. Totals are the sum over threads plus the
+ *   blocks of threads that have exited.
+ * - Gauges: one cache line each; set() is one relaxed store (last writer
+ *   wins).
+ * - Histograms: a LatencyRecorder each (per-thread shards already).
+ *
+ * The collector thread aggregates everything every collect_interval_ms
+ * into a MetricsSnapshot; readers take a copy of the latest one. Sources
+ * run on it first (to sample gauges that are cheaper to poll than to
+ * push), sinks after (to publish the snapshot).
+ * Registration is the only locked path.
+ */
+class MetricsRegistry {
+public:
+    static constexpr size_t MAX_COUNTERS = 1024;
+    static constexpr size_t MAX_GAUGES = 256;
+    static constexpr size_t MAX_HISTOGRAMS = 128;
+
+    struct Config {
+        uint32_t collect_interval_ms = 1000;
+    };
+
+    static MetricsRegistry& instance() {
+        static MetricsRegistry* registry = new MetricsRegistry();    // Leaked: usable from any static destructor
+        return *registry;
+    }
+
+    /**
+     * Declare metrics
+     *
+     * @return Id for the name; invalid once the kind's table is full
+     */
+    CounterId counter(std::string_view name) { return CounterId{declare(name, MetricKind::COUNTER)}; }
+    GaugeId gauge(std::string_view name) { return GaugeId{declare(name, MetricKind::GAUGE)}; }
+    HistogramId histogram(std::string_view name) { return HistogramId{declare(name, MetricKind::HISTOGRAM)}; }
+
+    // Hot path
+    [[gnu::hot]] void add(CounterId id, uint64_t by = 1) noexcept {
+        if (id.index >= MAX_COUNTERS) [[unlikely]] return;
+        std::atomic<uint64_t>& slot = thread_slots().counters[id.index];
+        slot.store(slot.load(std::memory_order_relaxed) + by, std::memory_order_relaxed);
+    }
+
+    [[gnu::hot]] void set(GaugeId id, double value) noexcept {
+        if (id.index >= MAX_GAUGES) [[unlikely]] return;
+        gauges_[id.index].bits.store(std::bit_cast<uint64_t>(value), std::memory_order_relaxed);
+    }
+
+    [[gnu::hot]] void record(HistogramId id, uint64_t value_ns) noexcept {
+        if (id.index >= histogram_count_.load(std::memory_order_acquire)) [[unlikely]] return;
+        histograms_[id.index]->record(value_ns);
+    }
+
+    // Reads: summed on demand, for the monitoring thread
+    uint64_t value(CounterId id) {
+        if (id.index >= MAX_COUNTERS) return 0;
+        std::lock_guard<std::mutex> lock(mutex_);
+        uint64_t total = retired_counters_[id.index];
+        for (const auto& slots : slots_) total += slots->counters[id.index].load(std::memory_order_relaxed);
+        return total;
+    }
+
+    double value(GaugeId id) const {
+        if (id.index >= MAX_GAUGES) return 0.0;
+        return std::bit_cast<double>(gauges_[id.index].bits.load(std::memory_order_relaxed));
+    }
+
+    LatencyRecorder* recorder(HistogramId id) {
+        return id.index < histogram_count_.load(std::memory_order_acquire) ? histograms_[id.index].get() : nullptr;
+    }
+
+    std::string name(CounterId id) const { return name_of(MetricKind::COUNTER, id.index); }
+    std::string name(GaugeId id) const { return name_of(MetricKind::GAUGE, id.index); }
+    std::string name(HistogramId id) const { return name_of(MetricKind::HISTOGRAM, id.index); }
+
+    size_t size() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return metrics_.size();
+    }
+
+    size_t threads() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return slots_.size();
+    }
+
+    // Collector thread
+    void start() { start(Config{}); }
+
+    void start(const Config& config) {
+        std::lock_guard<std::mutex> lock(control_mutex_);
+        if (running_.load()) return;
+        config_ = config;
+        running_.store(true);
+        collector_ = std::thread(&MetricsRegistry::collector_loop, this);
+    }
+
+    void stop() {
+        std::lock_guard<std::mutex> lock(control_mutex_);
+        if (!running_.exchange(false)) return;
+        if (collector_.joinable()) collector_.join();
+    }
+
+    bool running() const { return running_.load(std::memory_order_acquire); }
+
+    // Called on the collector thread before each collection
+    void add_source(std::function<void(MetricsRegistry&)> source) {
+        std::lock_guard<std::mutex> lock(collect_mutex_);
+        sources_.push_back(std::move(source));
+    }
+
+    // Called on the collector thread with each snapshot
+    void add_sink(std::function<void(const MetricsSnapshot&)> sink) {
+        std::lock_guard<std::mutex> lock(collect_mutex_);
+        sinks_.push_back(std::move(sink));
+    }
+
+    // Aggregate now (the collector thread calls this every collect_interval_ms)
+    void collect() {
+        std::lock_guard<std::mutex> collect_lock(collect_mutex_);
+        for (const auto& source : sources_) source(*this);
+        const uint64_t now = get_timestamp_ns();
+        const double seconds = last_collect_ns_ ? static_cast<double>(now - last_collect_ns_) / 1e9 : 0.0;
+        std::vector<Metric> metrics;
+        std::vector<uint64_t> totals(MAX_COUNTERS, 0);
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            fold_retired();
+            metrics = metrics_;
+            for (size_t i = 0; i < counter_count_; ++i) totals[i] = retired_counters_[i];
+            for (const auto& slots : slots_) {
+                for (size_t i = 0; i < counter_count_; ++i) totals[i] += slots->counters[i].load(std::memory_order_relaxed);
+            }
+        }
+
+        MetricsSnapshot snapshot;
+        snapshot.timestamp_ns = now;
+        snapshot.samples.reserve(metrics.size());
+        last_totals_.resize(MAX_COUNTERS, 0);
+        for (const Metric& metric : metrics) {
+            MetricSample sample;
+            sample.name = metric.name;
+            sample.kind = metric.kind;
+            switch (metric.kind) {
+                case MetricKind::COUNTER:
+                    sample.value = static_cast<double>(totals[metric.index]);
+                    if (seconds > 0.0) {
+                        sample.rate = static_cast<double>(totals[metric.index] - last_totals_[metric.index]) / seconds;
+                    }
+                    last_totals_[metric.index] = totals[metric.index];
+                    break;
+                case MetricKind::GAUGE:
+                    sample.value = value(GaugeId{metric.index});
+                    break;
+                case MetricKind::HISTOGRAM: {
+                    const LatencyHistogram histogram = histograms_[metric.index]->snapshot();
+                    sample.value = static_cast<double>(histogram.count());
+                    sample.sum_ns = histogram.sum_ns();
+                    sample.min_ns = histogram.min_ns();
+                    sample.max_ns = histogram.max_ns();
+                    sample.p50_ns = histogram.percentile(50.0);
+                    sample.p90_ns = histogram.percentile(90.0);
+                    sample.p99_ns = histogram.percentile(99.0);
+                    sample.p999_ns = histogram.percentile(99.9);
+                    sample.p9999_ns = histogram.percentile(99.99);
+                    break;
+                }
+            }
+            snapshot.samples.push_back(std::move(sample));
+        }
+        last_collect_ns_ = now;
+
+        {
+            std::lock_guard<std::mutex> lock(snapshot_mutex_);
+            snapshot.sequence = latest_.sequence + 1;
+            latest_ = snapshot;
+        }
+        for (const auto& sink : sinks_) sink(snapshot);
+    }
+
+    MetricsSnapshot latest() const {
+        std::lock_guard<std::mutex> lock(snapshot_mutex_);
+        return latest_;
+    }
+
+private:
+    struct Metric {
+        std::string name;
+        MetricKind kind;
+        uint32_t index;             // Into the kind's table
+    };
+
+    // A thread's counter slots; retired when the thread exits, folded into retired_counters_ by the collector
+    struct alignas(CACHE_LINE_SIZE) ThreadSlots {
+        std::array<std::atomic<uint64_t>, MAX_COUNTERS> counters{};
+        std::atomic<bool> retired{false};
+    };
+
+    struct ThreadHandle {
+        ThreadSlots* slots = nullptr;
+        ~ThreadHandle() {
+            if (slots) slots->retired.store(true, std::memory_order_release);
+        }
+    };
+
+    struct alignas(CACHE_LINE_SIZE) Gauge {
+        std::atomic<uint64_t> bits{0};      // double
+    };
+
+    mutable std::mutex mutex_;      // Registration, thread slots
+    std::vector<Metric> metrics_;
+    size_t counter_count_ = 0;
+    size_t gauge_count_ = 0;
+    std::atomic<size_t> histogram_count_{0};
+
+    std::vector<std::unique_ptr<ThreadSlots>> slots_;
+    std::array<uint64_t, MAX_COUNTERS> retired_counters_{};
+    std::array<Gauge, MAX_GAUGES> gauges_{};
+    std::array<std::unique_ptr<LatencyRecorder>, MAX_HISTOGRAMS> histograms_{};
+
+    // Collector state
+    Config config_;
+    std::mutex control_mutex_;
+    std::atomic<bool> running_{false};
+    std::thread collector_;
+    std::mutex collect_mutex_;
+    std::vector<std::function<void(MetricsRegistry&)>> sources_;
+    std::vector<std::function<void(const MetricsSnapshot&)>> sinks_;
+    std::vector<uint64_t> last_totals_;
+    uint64_t last_collect_ns_ = 0;
+    mutable std::mutex snapshot_mutex_;
+    MetricsSnapshot latest_;
+
+    MetricsRegistry() { TscClock::calibrate(); }
+
+    uint32_t declare(std::string_view name, MetricKind kind) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (const Metric& metric : metrics_) {
+            if (metric.kind == kind && metric.name == name) return metric.index;
+        }
+        uint32_t index = UINT32_MAX;
+        switch (kind) {
+            case MetricKind::COUNTER:
+                if (counter_count_ < MAX_COUNTERS) index = static_cast<uint32_t>(counter_count_++);
+                break;
+            case MetricKind::GAUGE:
+                if (gauge_count_ < MAX_GAUGES) index = static_cast<uint32_t>(gauge_count_++);
+                break;
+            case MetricKind::HISTOGRAM: {
+                const size_t count = histogram_count_.load(std::memory_order_relaxed);
+                if (count < MAX_HISTOGRAMS) {
+                    histograms_[count] = std::make_unique<LatencyRecorder>();
+                    index = static_cast<uint32_t>(count);
+                    histogram_count_.store(count + 1, std::memory_order_release);
+                }
+                break;
+            }
+        }
+        if (index != UINT32_MAX) metrics_.push_back(Metric{std::string(name), kind, index});
+        return index;
+    }
+
+    std::string name_of(MetricKind kind, uint32_t index) const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (const Metric& metric : metrics_) {
+            if (metric.kind == kind && metric.index == index) return metric.name;
+        }
+        return {};
+    }
+
+    ThreadSlots& thread_slots() {
+        thread_local ThreadHandle handle;
+        if (!handle.slots) [[unlikely]] {
+            auto slots = std::make_unique<ThreadSlots>();
+            handle.slots = slots.get();
+            std::lock_guard<std::mutex> lock(mutex_);
+            slots_.push_back(std::move(slots));
+        }
+        return *handle.slots;
+    }
+
+    // Caller holds mutex_
+    void fold_retired() {
+        for (auto it = slots_.begin(); it != slots_.end();) {
+            if ((*it)->retired.load(std::memory_order_acquire)) {
+                for (size_t i = 0; i < counter_count_; ++i) {
+                    retired_counters_[i] += (*it)->counters[i].load(std::memory_order_relaxed);
+                }
+                it = slots_.erase(it);
+            } else {
+                ++it;
+            }
+        }
+    }
+
+    void collector_loop() {
+        while (running_.load(std::memory_order_acquire)) {
+            collect();
+            for (uint32_t waited = 0; waited < config_.collect_interval_ms && running_.load(std::memory_order_acquire);
+                 waited += 10) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(10));
+            }
+        }
+        collect();
+    }
+};
+
+// Ids resolved on first use at each call site, then a static load
+template<MetricName Name>
+CounterId counter_metric() {
+    static const CounterId id = MetricsRegistry::instance().counter(Name.view());
+    return id;
+}
+
+template<MetricName Name>
+GaugeId gauge_metric() {
+    static const GaugeId id = MetricsRegistry::instance().gauge(Name.view());
+    return id;
+}
+
+template<MetricName Name>
+HistogramId histogram_metric() {
+    static const HistogramId id = MetricsRegistry::instance().histogram(Name.view());
+    return id;
+}
+
+} // namespace hft
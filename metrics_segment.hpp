@@ -0,0 +1,366 @@
+// metrics_segment.hpp - Versioned shared-memory segment the metrics collector publishes into for out-of-process readers
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <new>
+#include <string>
+#include <vector>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "metrics_registry.hpp"
+#include "seqlock.hpp"
+#include "kill_switch.hpp"
+#include "logger.hpp"
+#include "io_service.hpp"
+
+namespace hft {
+
+// One published metric: the MetricSample fields, fixed-size
+struct MetricRecord {
+    char name[96];
+    uint8_t kind;                   // MetricKind
+    uint8_t reserved[7];
+    double value;
+    double rate;
+    uint64_t sum_ns;
+    uint64_t min_ns;
+    uint64_t max_ns;
+    uint64_t p50_ns;
+    uint64_t p90_ns;
+    uint64_t p99_ns;
+    uint64_t p999_ns;
+    uint64_t p9999_ns;
+};
+
+/**
+ * Segment header - the first cache line
+ *
+ * magic is stored last on creation, so a reader that sees it sees the rest.
+ * layout changes whenever MetricRecord or the block layout does; readers
+ * refuse any layout but their own. count and sequence are published after
+ * the blocks they describe.
+ */
+struct alignas(64) MetricsSegmentHeader {
+    std::atomic<uint64_t> magic;
+    uint32_t layout;
+    uint32_t capacity;              // Blocks
+    uint32_t block_size;
+    int32_t pid;                    // Publishing process
+    uint64_t started_ns;
+    std::atomic<uint32_t> count;    // Blocks in use
+    std::atomic<uint64_t> sequence; // Publications so far
+    std::atomic<uint64_t> updated_ns;
+};
+static_assert(sizeof(MetricsSegmentHeader) == 64, "MetricsSegmentHeader must be one cache line");
+
+/**
+ * Metrics Segment
+ *
+ * A named POSIX shared-memory segment: a header and a fixed array of
+ * SeqLock-protected MetricRecord blocks, one per registered metric in
+ * registration order (which never changes, so a metric keeps its block).
+ * The trading process only copies numbers in; names, formatting and
+ * serving happen in the reader (hft_metrics_exporter, hft_top).
+ *
+ * A reader copies a block with a bounded number of SeqLock retries and
+ * skips it if the writer is mid-update or gone.
+ */
+class MetricsSegment {
+public:
+    static constexpr const char* DEFAULT_NAME = "/hft_metrics";
+    static constexpr uint64_t MAGIC = 0x315254454D544648ULL;     // "HFTMETR1"
+    static constexpr uint32_t LAYOUT = 1;
+    static constexpr uint32_t CAPACITY = static_cast<uint32_t>(
+        MetricsRegistry::MAX_COUNTERS + MetricsRegistry::MAX_GAUGES + MetricsRegistry::MAX_HISTOGRAMS);
+
+    using Block = SeqLock<MetricRecord>;
+
+    static constexpr size_t segment_size(uint32_t capacity) {
+        return sizeof(MetricsSegmentHeader) + static_cast<size_t>(capacity) * sizeof(Block);
+    }
+
+    MetricsSegment() = default;
+    MetricsSegment(const MetricsSegment&) = delete;
+    MetricsSegment& operator=(const MetricsSegment&) = delete;
+
+    MetricsSegment(MetricsSegment&& other) noexcept { *this = std::move(other); }
+
+    MetricsSegment& operator=(MetricsSegment&& other) noexcept {
+        if (this != &other) {
+            close();
+            header_ = other.header_;
+            size_ = other.size_;
+            writable_ = other.writable_;
+            name_ = std::move(other.name_);
+            other.header_ = nullptr;
+            other.size_ = 0;
+        }
+        return *this;
+    }
+
+    ~MetricsSegment() { close(); }
+
+    /**
+     * Create (or take over) the named segment for publishing
+     *
+     * A segment left by an earlier run is reinitialized in place, so
+     * readers that keep it mapped pick up the new publisher.
+     */
+    bool create(const char* name = DEFAULT_NAME) {
+        close();
+        const size_t size = segment_size(CAPACITY);
+        const int fd = ::shm_open(name, O_RDWR | O_CREAT, 0644);
+        if (fd < 0) return false;
+        if (::ftruncate(fd, static_cast<off_t>(size)) != 0) {
+            ::close(fd);
+            return false;
+        }
+        void* p = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        ::close(fd);
+        if (p == MAP_FAILED) return false;
+
+        header_ = static_cast<MetricsSegmentHeader*>(p);
+        size_ = size;
+        writable_ = true;
+        name_ = name;
+
+        header_->magic.store(0, std::memory_order_release);
+        header_->layout = LAYOUT;
+        header_->capacity = CAPACITY;
+        header_->block_size = sizeof(Block);
+        header_->pid = static_cast<int32_t>(::getpid());
+        header_->started_ns = get_timestamp_ns();
+        header_->count.store(0, std::memory_order_relaxed);
+        header_->sequence.store(0, std::memory_order_relaxed);
+        header_->updated_ns.store(0, std::memory_order_relaxed);
+        for (uint32_t i = 0; i < CAPACITY; ++i) new (&blocks()[i]) Block();
+        header_->magic.store(MAGIC, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * Map an existing segment read-only
+     *
+     * @return false if it does not exist or has another layout (errno is
+     *         EPROTO for a layout mismatch)
+     */
+    bool open(const char* name = DEFAULT_NAME) {
+        close();
+        const int fd = ::shm_open(name, O_RDONLY, 0);
+        if (fd < 0) return false;
+        struct stat st;
+        if (::fstat(fd, &st) != 0 || static_cast<size_t>(st.st_size) < sizeof(MetricsSegmentHeader)) {
+            ::close(fd);
+            errno = EPROTO;
+            return false;
+        }
+        const size_t size = static_cast<size_t>(st.st_size);
+        void* p = ::mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+        ::close(fd);
+        if (p == MAP_FAILED) return false;
+
+        const auto* header = static_cast<const MetricsSegmentHeader*>(p);
+        if (header->magic.load(std::memory_order_acquire) != MAGIC || header->layout != LAYOUT ||
+            header->block_size != sizeof(Block) || size < segment_size(header->capacity)) {
+            ::munmap(p, size);
+            errno = EPROTO;
+            return false;
+        }
+        header_ = const_cast<MetricsSegmentHeader*>(header);
+        size_ = size;
+        writable_ = false;
+        name_ = name;
+        return true;
+    }
+
+    void close() {
+        if (header_) ::munmap(header_, size_);
+        header_ = nullptr;
+        size_ = 0;
+        writable_ = false;
+    }
+
+    static bool unlink(const char* name = DEFAULT_NAME) {
+        return ::shm_unlink(name) == 0;
+    }
+
+    bool is_open() const { return header_ != nullptr; }
+    const std::string& name() const { return name_; }
+
+    // ========== Publisher (the metrics collector thread) ==========
+
+    void publish(const MetricsSnapshot& snapshot) {
+        if (!writable_) return;
+        const uint32_t count = static_cast<uint32_t>(std::min<size_t>(snapshot.samples.size(), CAPACITY));
+        for (uint32_t i = 0; i < count; ++i) {
+            const MetricSample& sample = snapshot.samples[i];
+            blocks()[i].write([&](MetricRecord& record) {
+                const size_t length = std::min(sample.name.size(), sizeof(record.name) - 1);
+                std::memcpy(record.name, sample.name.data(), length);
+                record.name[length] = '\0';
+                record.kind = static_cast<uint8_t>(sample.kind);
+                record.value = sample.value;
+                record.rate = sample.rate;
+                record.sum_ns = sample.sum_ns;
+                record.min_ns = sample.min_ns;
+                record.max_ns = sample.max_ns;
+                record.p50_ns = sample.p50_ns;
+                record.p90_ns = sample.p90_ns;
+                record.p99_ns = sample.p99_ns;
+                record.p999_ns = sample.p999_ns;
+                record.p9999_ns = sample.p9999_ns;
+            });
+        }
+        header_->count.store(count, std::memory_order_release);
+        header_->updated_ns.store(snapshot.timestamp_ns, std::memory_order_release);
+        header_->sequence.fetch_add(1, std::memory_order_release);
+    }
+
+    // ========== Readers ==========
+
+    struct Info {
+        int pid = 0;
+        uint64_t started_ns = 0;
+        uint64_t updated_ns = 0;
+        uint64_t sequence = 0;
+        uint32_t count = 0;
+        bool valid = false;         // Still this layout (a publisher may be reinitializing it)
+    };
+
+    Info info() const {
+        Info info;
+        if (!header_) return info;
+        info.valid = header_->magic.load(std::memory_order_acquire) == MAGIC;
+        info.pid = header_->pid;
+        info.started_ns = header_->started_ns;
+        info.sequence = header_->sequence.load(std::memory_order_acquire);
+        info.updated_ns = header_->updated_ns.load(std::memory_order_acquire);
+        info.count = std::min(header_->count.load(std::memory_order_acquire), header_->capacity);
+        return info;
+    }
+
+    /**
+     * Copy every published block
+     *
+     * @return Blocks skipped because they could not be read consistently
+     */
+    size_t read(std::vector<MetricRecord>& out) const {
+        out.clear();
+        if (!header_) return 0;
+        const uint32_t count = std::min(header_->count.load(std::memory_order_acquire), header_->capacity);
+        size_t skipped = 0;
+        MetricRecord record;
+        for (uint32_t i = 0; i < count; ++i) {
+            if (blocks()[i].try_load(record)) {
+                record.name[sizeof(record.name) - 1] = '\0';
+                out.push_back(record);
+            } else {
+                ++skipped;
+            }
+        }
+        return skipped;
+    }
+
+private:
+    MetricsSegmentHeader* header_ = nullptr;
+    size_t size_ = 0;
+    bool writable_ = false;
+    std::string name_;
+
+    Block* blocks() const {
+        return reinterpret_cast<Block*>(reinterpret_cast<char*>(header_) + sizeof(MetricsSegmentHeader));
+    }
+};
+
+/**
+ * Metrics Publisher
+ *
+ * Process-side wiring: registers the infrastructure gauges (logger and I/O
+ * ring occupancy and drops, kill-switch state), creates the segment and
+ * publishes every MetricsRegistry collection into it. All of it runs on
+ * the collector thread; hot paths only touch their counter slots.
+ */
+class MetricsPublisher {
+public:
+    static MetricsPublisher& instance() {
+        static MetricsPublisher* publisher = new MetricsPublisher();
+        return *publisher;
+    }
+
+    bool start(const char* name = MetricsSegment::DEFAULT_NAME, uint32_t interval_ms = 1000) {
+        auto& registry = MetricsRegistry::instance();
+        if (!segment_.create(name)) return false;
+        if (!registered_) {
+            register_sources(registry);
+            registry.add_sink([this](const MetricsSnapshot& snapshot) { segment_.publish(snapshot); });
+            registered_ = true;
+        }
+        MetricsRegistry::Config config;
+        config.collect_interval_ms = interval_ms;
+        registry.start(config);
+        return true;
+    }
+
+    // Stop collecting; the last collection stays in the segment for readers
+    void stop() {
+        MetricsRegistry::instance().stop();
+    }
+
+    const MetricsSegment& segment() const { return segment_; }
+
+private:
+    MetricsSegment segment_;
+    bool registered_ = false;
+
+    MetricsPublisher() = default;
+
+    static void register_sources(MetricsRegistry& registry) {
+        const GaugeId log_records = registry.gauge("logger.records");
+        const GaugeId log_dropped = registry.gauge("logger.dropped");
+        const GaugeId log_threads = registry.gauge("logger.rings");
+        const GaugeId log_occupancy = registry.gauge("logger.ring_occupancy_pct");
+        const GaugeId io_records = registry.gauge("io.records");
+        const GaugeId io_bytes = registry.gauge("io.bytes");
+        const GaugeId io_stalls = registry.gauge("io.stalls");
+        const GaugeId io_dropped = registry.gauge("io.dropped");
+        const GaugeId io_errors = registry.gauge("io.errors");
+        const GaugeId io_occupancy = registry.gauge("io.ring_occupancy_pct");
+        const GaugeId halted = registry.gauge("risk.halted");
+        const GaugeId halt_sources = registry.gauge("risk.halt_sources");
+        const GaugeId halt_version = registry.gauge("risk.state_version");
+
+        registry.add_source([=](MetricsRegistry& metrics) {
+            const auto occupancy = [](size_t used, size_t capacity) {
+                return capacity ? 100.0 * static_cast<double>(used) / static_cast<double>(capacity) : 0.0;
+            };
+            const Logger::Stats log = Logger::instance().stats();
+            metrics.set(log_records, static_cast<double>(log.records));
+            metrics.set(log_dropped, static_cast<double>(log.dropped));
+            metrics.set(log_threads, static_cast<double>(log.threads));
+            metrics.set(log_occupancy, occupancy(log.buffered_bytes, log.buffer_bytes));
+
+            const IoService::Stats io = IoService::instance().stats();
+            metrics.set(io_records, static_cast<double>(io.records));
+            metrics.set(io_bytes, static_cast<double>(io.bytes));
+            metrics.set(io_stalls, static_cast<double>(io.stalls));
+            metrics.set(io_dropped, static_cast<double>(io.dropped));
+            metrics.set(io_errors, static_cast<double>(io.errors));
+            metrics.set(io_occupancy, occupancy(io.buffered_bytes, io.buffer_bytes));
+
+            const uint64_t word = KillSwitch::instance().state();
+            metrics.set(halted, KillSwitch::is_halted(word) ? 1.0 : 0.0);
+            metrics.set(halt_sources, static_cast<double>(KillSwitch::flags_of(word)));
+            metrics.set(halt_version, static_cast<double>(KillSwitch::version_of(word)));
+        });
+    }
+};
+
+} // namespace hft
@@ -0,0 +1,127 @@
+#include <cerrno>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+#include "../metrics_segment.hpp"
+
+/**
+ * Metrics Top (hft_top)
+ *
+ * Live view of a trading process's metrics segment: counters with their
+ * per-second rates, gauges (ring occupancy, risk state, component
+ * heartbeats) and latency percentiles. Reads shared memory only; the
+ * trading process does no work for it.
+ *
+ * Usage: hft_top [--name NAME] [--interval MS] [--once]
+ * Exit code: 0 ok, 1 usage or segment error
+ */
+
+namespace {
+
+volatile std::sig_atomic_t watching = 1;
+
+void handle_signal(int) {
+    watching = 0;
+}
+
+void print_usage(const char* program) {
+    printf("Usage: %s [--name NAME] [--interval MS] [--once]\n"
+           "  --name NAME     Metrics segment (default: %s)\n"
+           "  --interval MS   Refresh period (default: 1000)\n"
+           "  --once          Print one snapshot and exit\n",
+           program, hft::MetricsSegment::DEFAULT_NAME);
+}
+
+// Nanoseconds in the most readable unit
+std::string format_ns(uint64_t ns) {
+    char buffer[32];
+    if (ns < 10000) {
+        std::snprintf(buffer, sizeof(buffer), "%lluns", static_cast<unsigned long long>(ns));
+    } else if (ns < 10000000) {
+        std::snprintf(buffer, sizeof(buffer), "%.1fus", ns / 1e3);
+    } else if (ns < 10000000000ULL) {
+        std::snprintf(buffer, sizeof(buffer), "%.1fms", ns / 1e6);
+    } else {
+        std::snprintf(buffer, sizeof(buffer), "%.1fs", ns / 1e9);
+    }
+    return buffer;
+}
+
+void print_snapshot(const hft::MetricsSegment& segment, const std::vector<hft::MetricRecord>& records,
+                    size_t skipped) {
+    const hft::MetricsSegment::Info info = segment.info();
+    const uint64_t now = hft::get_timestamp_ns();
+    const bool alive = info.pid > 0 && (::kill(info.pid, 0) == 0 || errno == EPERM);
+    printf("hft_top - %s  pid %d %s  uptime %.0fs  update #%llu (%.1fs ago)  %u metrics",
+           segment.name().c_str(), info.pid, alive ? "🟢" : "🔴 (exited)",
+           info.started_ns && now > info.started_ns ? (now - info.started_ns) / 1e9 : 0.0,
+           static_cast<unsigned long long>(info.sequence),
+           info.updated_ns && now > info.updated_ns ? (now - info.updated_ns) / 1e9 : 0.0, info.count);
+    if (skipped > 0) printf("  (%zu busy)", skipped);
+    printf("\n");
+
+    printf("\n%-48s %16s %14s\n", "COUNTER", "TOTAL", "RATE/s");
+    for (const auto& record : records) {
+        if (record.kind != static_cast<uint8_t>(hft::MetricKind::COUNTER)) continue;
+        printf("%-48s %16.0f %14.1f\n", record.name, record.value, record.rate);
+    }
+
+    printf("\n%-48s %16s\n", "GAUGE", "VALUE");
+    for (const auto& record : records) {
+        if (record.kind != static_cast<uint8_t>(hft::MetricKind::GAUGE)) continue;
+        printf("%-48s %16.6g\n", record.name, record.value);
+    }
+
+    printf("\n%-36s %10s %9s %9s %9s %9s %9s\n", "LATENCY", "COUNT", "P50", "P99", "P99.9", "P99.99", "MAX");
+    for (const auto& record : records) {
+        if (record.kind != static_cast<uint8_t>(hft::MetricKind::HISTOGRAM)) continue;
+        printf("%-36s %10.0f %9s %9s %9s %9s %9s\n", record.name, record.value, format_ns(record.p50_ns).c_str(),
+               format_ns(record.p99_ns).c_str(), format_ns(record.p999_ns).c_str(),
+               format_ns(record.p9999_ns).c_str(), format_ns(record.max_ns).c_str());
+    }
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const char* name = hft::MetricsSegment::DEFAULT_NAME;
+    int interval_ms = 1000;
+    bool once = false;
+    for (int arg = 1; arg < argc; ++arg) {
+        if (arg + 1 < argc && std::strcmp(argv[arg], "--name") == 0) {
+            name = argv[++arg];
+        } else if (arg + 1 < argc && std::strcmp(argv[arg], "--interval") == 0) {
+            interval_ms = std::max(50, std::atoi(argv[++arg]));
+        } else if (std::strcmp(argv[arg], "--once") == 0) {
+            once = true;
+        } else {
+            print_usage(argv[0]);
+            return 1;
+        }
+    }
+
+    hft::MetricsSegment segment;
+    if (!segment.open(name)) {
+        fprintf(stderr, "❌ Cannot map metrics segment %s: %s\n", name,
+                errno == EPROTO ? "not a metrics segment of this layout" : std::strerror(errno));
+        return 1;
+    }
+
+    std::signal(SIGINT, handle_signal);
+    std::signal(SIGTERM, handle_signal);
+
+    std::vector<hft::MetricRecord> records;
+    while (watching) {
+        const size_t skipped = segment.read(records);
+        if (!once) printf("\033[H\033[2J");
+        print_snapshot(segment, records, skipped);
+        fflush(stdout);
+        if (once) break;
+        std::this_thread::sleep_for(std::chrono::milliseconds(interval_ms));
+    }
+    return 0;
+}
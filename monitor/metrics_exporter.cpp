@@ -0,0 +1,212 @@
+#include <cerrno>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include "../metrics_segment.hpp"
+
+/**
+ * Metrics Exporter (hft_metrics_exporter)
+ *
+ * Serves the trading process's metrics segment in Prometheus text format
+ * on a local HTTP port. Runs as its own process: the trading process only
+ * publishes numbers into shared memory and never formats or touches a
+ * socket for observability. The segment is (re)mapped on demand, so the
+ * exporter can start before the trading process and survives restarts.
+ *
+ * Counters become <name>_total, gauges stay gauges, latency histograms
+ * become summaries in seconds (quantiles 0.5 - 0.9999, _sum, _count).
+ *
+ * Usage: hft_metrics_exporter [--name NAME] [--port PORT] [--bind ADDR]
+ */
+
+namespace {
+
+volatile std::sig_atomic_t serving = 1;
+
+void handle_signal(int) {
+    serving = 0;
+}
+
+void print_usage(const char* program) {
+    printf("Usage: %s [--name NAME] [--port PORT] [--bind ADDR]\n"
+           "  --name NAME   Metrics segment (default: %s)\n"
+           "  --port PORT   HTTP port (default: 9464)\n"
+           "  --bind ADDR   Listen address (default: 127.0.0.1)\n",
+           program, hft::MetricsSegment::DEFAULT_NAME);
+}
+
+// "component.feed_handler.messages" -> "hft_component_feed_handler_messages"
+std::string metric_name(const char* name) {
+    std::string out = "hft_";
+    for (const char* p = name; *p; ++p) {
+        const char c = *p;
+        const bool valid = (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || c == '_';
+        out += valid ? c : '_';
+    }
+    return out;
+}
+
+void append_sample(std::string& out, const std::string& name, const char* labels, double value) {
+    char buffer[64];
+    std::snprintf(buffer, sizeof(buffer), " %.17g\n", value);
+    out += name;
+    out += labels;
+    out += buffer;
+}
+
+bool publisher_alive(const hft::MetricsSegment::Info& info) {
+    return info.valid && info.pid > 0 && (::kill(info.pid, 0) == 0 || errno == EPERM);
+}
+
+std::string render(hft::MetricsSegment& segment, const char* name) {
+    std::string body;
+    // Remap when the publisher is gone: a restarted one may have replaced the segment
+    if (!publisher_alive(segment.info())) segment.open(name);
+    const hft::MetricsSegment::Info info = segment.info();
+    const bool alive = publisher_alive(info);
+
+    body += "# HELP hft_metrics_publisher_up Whether the publishing trading process is running\n";
+    body += "# TYPE hft_metrics_publisher_up gauge\n";
+    append_sample(body, "hft_metrics_publisher_up", "", alive ? 1.0 : 0.0);
+    if (!info.valid) return body;
+
+    const uint64_t now = hft::get_timestamp_ns();
+    body += "# TYPE hft_metrics_publications_total counter\n";
+    append_sample(body, "hft_metrics_publications_total", "", static_cast<double>(info.sequence));
+    body += "# TYPE hft_metrics_last_update_age_seconds gauge\n";
+    append_sample(body, "hft_metrics_last_update_age_seconds", "",
+                  info.updated_ns && now > info.updated_ns ? (now - info.updated_ns) / 1e9 : 0.0);
+
+    std::vector<hft::MetricRecord> records;
+    segment.read(records);
+    for (const hft::MetricRecord& record : records) {
+        const std::string base = metric_name(record.name);
+        switch (static_cast<hft::MetricKind>(record.kind)) {
+            case hft::MetricKind::COUNTER: {
+                const std::string total = base + "_total";
+                body += "# TYPE " + total + " counter\n";
+                append_sample(body, total, "", record.value);
+                break;
+            }
+            case hft::MetricKind::GAUGE:
+                body += "# TYPE " + base + " gauge\n";
+                append_sample(body, base, "", record.value);
+                break;
+            case hft::MetricKind::HISTOGRAM: {
+                const std::string seconds = base + "_seconds";
+                body += "# TYPE " + seconds + " summary\n";
+                append_sample(body, seconds, "{quantile=\"0.5\"}", record.p50_ns / 1e9);
+                append_sample(body, seconds, "{quantile=\"0.9\"}", record.p90_ns / 1e9);
+                append_sample(body, seconds, "{quantile=\"0.99\"}", record.p99_ns / 1e9);
+                append_sample(body, seconds, "{quantile=\"0.999\"}", record.p999_ns / 1e9);
+                append_sample(body, seconds, "{quantile=\"0.9999\"}", record.p9999_ns / 1e9);
+                append_sample(body, seconds + "_sum", "", record.sum_ns / 1e9);
+                append_sample(body, seconds + "_count", "", record.value);
+                body += "# TYPE " + seconds + "_max gauge\n";
+                append_sample(body, seconds + "_max", "", record.max_ns / 1e9);
+                break;
+            }
+        }
+    }
+    return body;
+}
+
+void respond(int client, hft::MetricsSegment& segment, const char* name) {
+    char request[4096];
+    const ssize_t received = ::recv(client, request, sizeof(request) - 1, 0);
+    if (received <= 0) return;
+    request[received] = '\0';
+
+    std::string status = "200 OK";
+    std::string body;
+    std::string type = "text/plain; version=0.0.4; charset=utf-8";
+    if (std::strncmp(request, "GET /metrics ", 13) == 0 || std::strncmp(request, "GET / ", 6) == 0) {
+        body = render(segment, name);
+    } else {
+        status = "404 Not Found";
+        type = "text/plain";
+        body = "Not found: GET /metrics\n";
+    }
+
+    const std::string response = "HTTP/1.1 " + status + "\r\nContent-Type: " + type +
+                                 "\r\nContent-Length: " + std::to_string(body.size()) +
+                                 "\r\nConnection: close\r\n\r\n" + body;
+    size_t sent = 0;
+    while (sent < response.size()) {
+        const ssize_t n = ::send(client, response.data() + sent, response.size() - sent, MSG_NOSIGNAL);
+        if (n <= 0) break;
+        sent += static_cast<size_t>(n);
+    }
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const char* name = hft::MetricsSegment::DEFAULT_NAME;
+    const char* bind_address = "127.0.0.1";
+    int port = 9464;
+    for (int arg = 1; arg < argc; ++arg) {
+        if (arg + 1 < argc && std::strcmp(argv[arg], "--name") == 0) {
+            name = argv[++arg];
+        } else if (arg + 1 < argc && std::strcmp(argv[arg], "--port") == 0) {
+            port = std::atoi(argv[++arg]);
+        } else if (arg + 1 < argc && std::strcmp(argv[arg], "--bind") == 0) {
+            bind_address = argv[++arg];
+        } else {
+            print_usage(argv[0]);
+            return 1;
+        }
+    }
+
+    std::signal(SIGINT, handle_signal);
+    std::signal(SIGTERM, handle_signal);
+    std::signal(SIGPIPE, SIG_IGN);
+
+    const int listener = ::socket(AF_INET, SOCK_STREAM, 0);
+    if (listener < 0) {
+        fprintf(stderr, "❌ socket: %s\n", std::strerror(errno));
+        return 1;
+    }
+    const int reuse = 1;
+    ::setsockopt(listener, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+    sockaddr_in address{};
+    address.sin_family = AF_INET;
+    address.sin_port = htons(static_cast<uint16_t>(port));
+    if (::inet_pton(AF_INET, bind_address, &address.sin_addr) != 1 ||
+        ::bind(listener, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0 || ::listen(listener, 16) != 0) {
+        fprintf(stderr, "❌ Cannot listen on %s:%d: %s\n", bind_address, port, std::strerror(errno));
+        ::close(listener);
+        return 1;
+    }
+
+    hft::MetricsSegment segment;
+    if (!segment.open(name)) {
+        printf("⚠️  Metrics segment %s not available yet (%s) - waiting for the trading process\n", name,
+               std::strerror(errno));
+    }
+    printf("📡 Serving %s on http://%s:%d/metrics\n", name, bind_address, port);
+    fflush(stdout);
+
+    while (serving) {
+        pollfd pfd{listener, POLLIN, 0};
+        if (::poll(&pfd, 1, 500) <= 0) continue;
+        const int client = ::accept(listener, nullptr, nullptr);
+        if (client < 0) continue;
+        const timeval timeout{1, 0};
+        ::setsockopt(client, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+        respond(client, segment, name);
+        ::close(client);
+    }
+
+    ::close(listener);
+    printf("📡 Exporter stopped\n");
+    return 0;
+}
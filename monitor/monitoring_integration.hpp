@@ -16,32 +16,56 @@ namespace hft::monitoring {
 /**
  * Integration layer for real-time monitoring
  * Provides instrumentation wrappers and automatic metric collection
+ *
+ * Components and latency histograms are resolved to pointers / registry
+ * ids once, at construction; per-message instrumentation is a counter
+ * slot increment and a heartbeat stamp, with no name lookups or string
+ * building.
  */
 class MonitoringIntegration {
 public:
     RealTimeMonitor& monitor_;
-private:
     
-    // Timing helpers for latency measurement
-    struct TimingContext {
-        uint64_t start_time;
-        std::string operation_name;
-    };
+    // Latency histograms of the monitored wrappers below
+    const ::hft::HistogramId market_data_latency;
+    const ::hft::HistogramId position_update_latency;
+    const ::hft::HistogramId risk_check_latency;
+    
+private:
+    ComponentHealth* sequencer_;
+    ComponentHealth* feed_handler_;
+    ComponentHealth* risk_manager_;
+    ComponentHealth* position_tracker_;
+    ComponentHealth* connection_manager_;
     
-    thread_local static std::unordered_map<std::string, TimingContext> active_timers_;
+    static void touch(ComponentHealth* component) {
+        if (component) {
+            component->heartbeat();
+            component->increment_messages();
+        }
+    }
 
 public:
-    explicit MonitoringIntegration(RealTimeMonitor& monitor) : monitor_(monitor) {}
+    explicit MonitoringIntegration(RealTimeMonitor& monitor)
+        : monitor_(monitor),
+          market_data_latency(monitor.latency_metric("market_data_processing")),
+          position_update_latency(monitor.latency_metric("position_update")),
+          risk_check_latency(monitor.latency_metric("risk_check")),
+          sequencer_(monitor.component("sequencer")),
+          feed_handler_(monitor.component("feed_handler")),
+          risk_manager_(monitor.component("risk_manager")),
+          position_tracker_(monitor.component("position_tracker")),
+          connection_manager_(monitor.component("connection_manager")) {}
     
     // RAII latency measurement helper
     class LatencyTracker {
     private:
         RealTimeMonitor& monitor_;
-        std::string operation_;
+        ::hft::HistogramId operation_;
         uint64_t start_time_;
         
     public:
-        LatencyTracker(RealTimeMonitor& monitor, const std::string& operation)
+        LatencyTracker(RealTimeMonitor& monitor, ::hft::HistogramId operation)
             : monitor_(monitor), operation_(operation), start_time_(::hft::rdtsc()) {}
         
         ~LatencyTracker() {
@@ -51,8 +75,7 @@ public:
     
     // Market data processing instrumentation
     void instrument_market_data_processing(const ::hft::SequencedMessage& msg) {
-        monitor_.component_heartbeat("feed_handler");
-        monitor_.component_message_processed("feed_handler");
+        touch(feed_handler_);
         
         // Calculate and track spread if it's market data
         if (msg.type == ::hft::MessageType::MARKET_DATA_TICK) {
@@ -64,50 +87,50 @@ public:
                 double spread_bps = ((ask - bid) / mid) * 10000.0;
                 
                 // Generic symbol label based on symbol_id to avoid crypto-specific mapping
-                std::string symbol = std::string("SYM") + std::to_string(static_cast<unsigned>(msg.symbol_id));
-                monitor_.update_spread(symbol, msg.venue, spread_bps);
+                monitor_.update_spread(static_cast<uint32_t>(msg.symbol_id), msg.venue, spread_bps);
             }
         }
     }
     
     // Order processing instrumentation
-    void instrument_order_processing(const std::string& operation_type) {
-        monitor_.component_heartbeat("sequencer");
-        monitor_.component_message_processed("sequencer");
+    void instrument_order_processing([[maybe_unused]] std::string_view operation_type) {
+        touch(sequencer_);
     }
     
     // Risk management instrumentation
-    void instrument_risk_check(const std::string& check_type, bool passed, 
+    void instrument_risk_check(std::string_view check_type, bool passed, 
                               const std::string& details = "") {
-        monitor_.component_heartbeat("risk_manager");
-        monitor_.component_message_processed("risk_manager");
+        touch(risk_manager_);
         
         if (!passed) {
-            monitor_.component_error("risk_manager", "Risk check failed: " + check_type + " - " + details);
+            monitor_.component_error("risk_manager", "Risk check failed: " + std::string(check_type) + " - " + details);
         }
     }
     
     // Position tracking instrumentation
-    void instrument_position_update(const std::string& exchange, const std::string& symbol,
+    void instrument_position_update([[maybe_unused]] const std::string& exchange,
+                                   [[maybe_unused]] const std::string& symbol,
                                    double quantity, double price) {
-        monitor_.component_heartbeat("position_tracker");
-        monitor_.component_message_processed("position_tracker");
+        touch(position_tracker_);
         
         // Calculate trade P&L (simplified - in reality would need more context)
         double notional = quantity * price;
         double estimated_fee = std::abs(notional) * 0.001; // 0.1% fee assumption
         
         // For monitoring purposes, treat each trade as break-even except for fees
-        monitor_.record_trade(0.0, estimated_fee, 
-                             exchange + " " + symbol + " " + std::to_string(quantity));
+        monitor_.record_trade(0.0, estimated_fee);
+    }
+    
+    void instrument_price_update() {
+        if (position_tracker_) position_tracker_->heartbeat();
     }
     
     // Connection health instrumentation
     void instrument_connection_event(::hft::Venue venue, const std::string& event_type, bool success) {
-        monitor_.component_heartbeat("connection_manager");
+        if (connection_manager_) connection_manager_->heartbeat();
         
         if (success) {
-            monitor_.component_message_processed("connection_manager");
+            if (connection_manager_) connection_manager_->increment_messages();
         } else {
             monitor_.component_error("connection_manager", 
                 venue_name(venue) + " " + event_type + " failed");
@@ -116,7 +139,7 @@ public:
     
     // Emergency stop integration
     bool check_emergency_conditions() {
-        if (monitor_.is_emergency_stop()) {
+        if (monitor_.is_emergency_stop() || hft::KillSwitch::instance().halted()) {
             return true;
         }
         
@@ -127,9 +150,13 @@ public:
     }
     
     // Create latency tracker for automatic RAII timing
-    LatencyTracker track_latency(const std::string& operation) {
+    LatencyTracker track_latency(::hft::HistogramId operation) {
         return LatencyTracker(monitor_, operation);
     }
+    
+    LatencyTracker track_latency(const std::string& operation) {
+        return LatencyTracker(monitor_, monitor_.latency_metric(operation));
+    }
 
 private:
     std::string venue_name(::hft::Venue venue) const {
@@ -149,10 +176,6 @@ private:
     }
 };
 
-// Thread-local storage definition
-thread_local std::unordered_map<std::string, MonitoringIntegration::TimingContext> 
-    MonitoringIntegration::active_timers_;
-
 /**
  * Enhanced feed handler with monitoring integration
  */
@@ -175,7 +198,7 @@ public:
     
     // Override market data processing to add monitoring
     void process_market_data_with_monitoring(const ::hft::SequencedMessage& msg) {
-        auto latency_tracker = monitor_integration_.track_latency("market_data_processing");
+        auto latency_tracker = monitor_integration_.track_latency(monitor_integration_.market_data_latency);
         monitor_integration_.instrument_market_data_processing(msg);
         
         // Check for emergency stop
@@ -200,7 +223,7 @@ public:
     
     void add_trade(const std::string& exchange, const std::string& symbol, 
                    double quantity, double price) {
-        auto latency_tracker = monitor_integration_.track_latency("position_update");
+        auto latency_tracker = monitor_integration_.track_latency(monitor_integration_.position_update_latency);
         
         base_tracker_.add_trade(exchange, symbol, quantity, price);
         monitor_integration_.instrument_position_update(exchange, symbol, quantity, price);
@@ -208,7 +231,7 @@ public:
     
     void update_market_price(const std::string& exchange, const std::string& symbol, double price) {
         base_tracker_.update_market_price(exchange, symbol, price);
-        monitor_integration_.monitor_.component_heartbeat("position_tracker");
+        monitor_integration_.instrument_price_update();
     }
     
     void print_status() const {
@@ -230,12 +253,16 @@ public:
     
     bool can_execute_trade(const std::string& exchange, const std::string& symbol,
                           double quantity, double price, double expected_edge_bps) {
-        auto latency_tracker = monitor_integration_.track_latency("risk_check");
+        auto latency_tracker = monitor_integration_.track_latency(monitor_integration_.risk_check_latency);
         
         bool result = base_manager_.can_execute_trade(exchange, symbol, quantity, price, expected_edge_bps);
         
-        monitor_integration_.instrument_risk_check("trade_execution", result,
-            exchange + " " + symbol + " qty=" + std::to_string(quantity));
+        if (result) {
+            monitor_integration_.instrument_risk_check("trade_execution", true);
+        } else {
+            monitor_integration_.instrument_risk_check("trade_execution", false,
+                exchange + " " + symbol + " qty=" + std::to_string(quantity));
+        }
         
         return result;
     }
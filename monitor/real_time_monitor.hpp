@@ -5,15 +5,21 @@
 #include <unordered_map>
 #include <array>
 #include <memory>
+#include <mutex>
+#include <optional>
+#include <shared_mutex>
 #include <thread>
 #include <fstream>
 #include <sstream>
 #include <algorithm>
 #include <numeric>
 #include <functional>
+#include "../kill_switch.hpp"
 #include "../messages.hpp"
 #include "../sequencer.hpp"
 #include "../logger.hpp"
+#include "../latency_histogram.hpp"
+#include "../metrics_registry.hpp"
 #include <ctime>
 #include <iomanip>
 
@@ -27,49 +33,33 @@ struct MonitoringThresholds {
     uint32_t max_error_rate_pct = 10;          // 10% max error rate
     uint64_t heartbeat_timeout_ns = 5000000000ULL; // 5s component timeout
     uint32_t max_queue_depth = 1000;           // Max queue depth before alert
+    uint64_t latency_interval_ms = 1000;       // Window for interval latency percentiles
 };
 
+// Latency report for one operation, filled from a LatencyHistogram on the monitoring thread
 struct LatencyMetrics {
-    uint64_t min_ns = UINT64_MAX;
+    uint64_t min_ns = 0;
     uint64_t max_ns = 0;
     uint64_t avg_ns = 0;
     uint64_t p50_ns = 0;
     uint64_t p95_ns = 0;
     uint64_t p99_ns = 0;
+    uint64_t p999_ns = 0;
+    uint64_t p9999_ns = 0;
     uint64_t sample_count = 0;
-    
-    // Ring buffer for percentile calculations
-    static constexpr size_t SAMPLE_BUFFER_SIZE = 1000;
-    std::array<uint64_t, SAMPLE_BUFFER_SIZE> samples{};
-    size_t sample_index = 0;
-    
-    void add_sample(uint64_t latency_ns) {
-        min_ns = std::min(min_ns, latency_ns);
-        max_ns = std::max(max_ns, latency_ns);
-        
-        samples[sample_index] = latency_ns;
-        sample_index = (sample_index + 1) % SAMPLE_BUFFER_SIZE;
-        sample_count++;
-        
-        // Update percentiles every 100 samples for efficiency
-        if (sample_count % 100 == 0) {
-            calculate_percentiles();
-        }
-    }
-    
-private:
-    void calculate_percentiles() {
-        auto working_samples = samples;
-        size_t valid_samples = std::min(static_cast<size_t>(sample_count), SAMPLE_BUFFER_SIZE);
-        std::sort(working_samples.begin(), working_samples.begin() + valid_samples);
-        
-        if (valid_samples > 0) {
-            avg_ns = std::accumulate(working_samples.begin(), 
-                                   working_samples.begin() + valid_samples, 0ULL) / valid_samples;
-            p50_ns = working_samples[valid_samples * 50 / 100];
-            p95_ns = working_samples[valid_samples * 95 / 100];
-            p99_ns = working_samples[valid_samples * 99 / 100];
-        }
+
+    static LatencyMetrics from(const ::hft::LatencyHistogram& histogram) {
+        LatencyMetrics metrics;
+        metrics.min_ns = histogram.min_ns();
+        metrics.max_ns = histogram.max_ns();
+        metrics.avg_ns = histogram.mean_ns();
+        metrics.p50_ns = histogram.percentile(50.0);
+        metrics.p95_ns = histogram.percentile(95.0);
+        metrics.p99_ns = histogram.percentile(99.0);
+        metrics.p999_ns = histogram.percentile(99.9);
+        metrics.p9999_ns = histogram.percentile(99.99);
+        metrics.sample_count = histogram.count();
+        return metrics;
     }
 };
 
@@ -129,38 +119,65 @@ struct ProfitabilityMetrics {
     }
 };
 
+/**
+ * Component health
+ *
+ * Message and error counts are registry counters
+ * ("component.<name>.messages" / ".errors"), so counting is a per-thread
+ * slot increment and totals are summed only when health is checked. The
+ * heartbeat is an rdtsc() stamp, rewritten at most every
+ * HEARTBEAT_RESOLUTION_NS so busy threads do not keep bouncing its line.
+ */
 struct ComponentHealth {
-    std::atomic<uint64_t> last_heartbeat_ns{0};
-    std::atomic<uint64_t> message_count{0};
-    std::atomic<uint64_t> error_count{0};
+    static constexpr uint64_t HEARTBEAT_RESOLUTION_NS = 1000000;   // 1ms
+    
+    std::atomic<uint64_t> last_heartbeat_tsc{0};
     std::atomic<bool> is_healthy{true};
     std::string component_name;
+    ::hft::CounterId messages;
+    ::hft::CounterId errors;
+    ::hft::GaugeId heartbeat_age;
+    uint64_t resolution_ticks;      // HEARTBEAT_RESOLUTION_NS in TSC ticks (the registry calibrates first)
     
-    ComponentHealth(const std::string& name) : component_name(name) {
-        heartbeat();
+    ComponentHealth(const std::string& name)
+        : component_name(name),
+          messages(::hft::MetricsRegistry::instance().counter("component." + name + ".messages")),
+          errors(::hft::MetricsRegistry::instance().counter("component." + name + ".errors")),
+          heartbeat_age(::hft::MetricsRegistry::instance().gauge("component." + name + ".heartbeat_age_ns")),
+          resolution_ticks(::hft::TscClock::from_ns(HEARTBEAT_RESOLUTION_NS)) {
+        last_heartbeat_tsc.store(::hft::rdtsc(), std::memory_order_relaxed);
     }
     
     void heartbeat() {
-        last_heartbeat_ns.store(::hft::rdtsc(), std::memory_order_relaxed);
+        uint64_t now = ::hft::rdtsc();
+        if (now - last_heartbeat_tsc.load(std::memory_order_relaxed) >= resolution_ticks) {
+            last_heartbeat_tsc.store(now, std::memory_order_relaxed);
+        }
     }
     
     void increment_messages() {
-        message_count.fetch_add(1, std::memory_order_relaxed);
+        ::hft::MetricsRegistry::instance().add(messages);
     }
     
     void increment_errors() {
-        error_count.fetch_add(1, std::memory_order_relaxed);
+        ::hft::MetricsRegistry::instance().add(errors);
+    }
+    
+    uint64_t message_count() const {
+        return ::hft::MetricsRegistry::instance().value(messages);
+    }
+    
+    uint64_t error_count() const {
+        return ::hft::MetricsRegistry::instance().value(errors);
     }
     
     bool check_health(uint64_t timeout_ns, uint32_t max_error_rate_pct) {
-        uint64_t current_time = ::hft::rdtsc();
-        uint64_t last_hb = last_heartbeat_ns.load(std::memory_order_relaxed);
-        
-        // Convert TSC to nanoseconds (approximate)
-        bool heartbeat_ok = (current_time - last_hb) < (timeout_ns * 2400); // Assume 2.4GHz TSC
+        uint64_t heartbeat_age_ns = ::hft::TscClock::elapsed_ns(last_heartbeat_tsc.load(std::memory_order_relaxed));
+        ::hft::MetricsRegistry::instance().set(heartbeat_age, static_cast<double>(heartbeat_age_ns));
+        bool heartbeat_ok = heartbeat_age_ns < timeout_ns;
         
-        uint64_t msgs = message_count.load(std::memory_order_relaxed);
-        uint64_t errs = error_count.load(std::memory_order_relaxed);
+        uint64_t msgs = message_count();
+        uint64_t errs = error_count();
         bool error_rate_ok = (msgs == 0) || ((errs * 100 / msgs) <= max_error_rate_pct);
         
         bool healthy = heartbeat_ok && error_rate_ok;
@@ -192,8 +209,12 @@ struct Alert {
  * Real-Time HFT Monitoring System
  * 
  * Provides comprehensive monitoring including:
- * - End-to-end latency tracking (<50ms target)
+ * - End-to-end latency tracking (<50ms target): per-thread histograms,
+ *   merged on the monitoring thread into cumulative and per-interval
+ *   percentiles (up to p99.99)
  * - Spread monitoring and alerts
+ * - Metrics in the process-wide MetricsRegistry: hot paths hold ids
+ *   (component(), latency_metric()) rather than passing names
  * - Profitability metrics and drawdown tracking
  * - Component health monitoring
  * - Emergency kill switch
@@ -203,9 +224,23 @@ class RealTimeMonitor {
 private:
     MonitoringThresholds thresholds_;
     
-    // Metrics storage
-    std::unordered_map<std::string, LatencyMetrics> latency_metrics_;
-    std::unordered_map<std::string, SpreadMetrics> spread_metrics_;
+    // Metrics storage. Latency histograms live in the MetricsRegistry as
+    // "latency.<operation>"; this maps operation names to their ids for the
+    // by-name calls. Interval reports are rolled by the monitoring thread
+    // every latency_interval_ms.
+    std::unordered_map<std::string, ::hft::HistogramId> latency_ids_;
+    mutable std::shared_mutex latency_mutex_;
+    std::unordered_map<std::string, LatencyMetrics> interval_latency_;
+    mutable std::mutex interval_mutex_;
+    uint64_t last_interval_roll_ns_ = 0;
+    
+    // Spreads by (symbol, venue) key; the label and gauge are made once per key
+    struct SpreadEntry {
+        std::string label;
+        ::hft::GaugeId gauge;
+        SpreadMetrics metrics;
+    };
+    std::unordered_map<uint64_t, SpreadEntry> spread_metrics_;
     ProfitabilityMetrics profitability_;
     
     // Component health tracking
@@ -235,11 +270,26 @@ private:
         std::atomic<bool> dashboard_enabled{false};
         uint64_t refresh_interval_ms = 1000; // 1 second default
     } dashboard_;
+    
+    // Monitor state published to the MetricsRegistry by the monitoring thread
+    struct MonitorGauges {
+        ::hft::GaugeId emergency_stop = ::hft::MetricsRegistry::instance().gauge("monitor.emergency_stop");
+        ::hft::GaugeId trading_halted = ::hft::MetricsRegistry::instance().gauge("monitor.trading_halted");
+        ::hft::GaugeId unhealthy_components = ::hft::MetricsRegistry::instance().gauge("monitor.unhealthy_components");
+        ::hft::GaugeId alerts = ::hft::MetricsRegistry::instance().gauge("monitor.recent_alerts");
+        ::hft::GaugeId dashboard_updates = ::hft::MetricsRegistry::instance().gauge("monitor.dashboard_updates");
+        ::hft::GaugeId net_pnl = ::hft::MetricsRegistry::instance().gauge("pnl.net");
+        ::hft::GaugeId drawdown = ::hft::MetricsRegistry::instance().gauge("pnl.drawdown");
+        ::hft::GaugeId trades = ::hft::MetricsRegistry::instance().gauge("pnl.trades");
+    } gauges_;
 
 public:
     RealTimeMonitor(const MonitoringThresholds& thresholds = MonitoringThresholds{})
         : thresholds_(thresholds), monitoring_start_time_(::hft::rdtsc()) {
         
+        // Tick rate measured here, before any component heartbeats on a hot thread
+        ::hft::TscClock::calibrate();
+        
         // Initialize core component monitors
         register_component("sequencer");
         register_component("feed_handler"); 
@@ -260,6 +310,12 @@ public:
         hft::Logger::instance().log(hft::LogLevel::INFO, "monitoring", "Registered component for monitoring: " + name);
     }
     
+    // Resolve once for per-message instrumentation; nullptr if not registered
+    ComponentHealth* component(const std::string& name) const {
+        auto it = components_.find(name);
+        return it != components_.end() ? it->second.get() : nullptr;
+    }
+    
     void component_heartbeat(const std::string& component) {
         auto it = components_.find(component);
         if (it != components_.end()) {
@@ -285,33 +341,53 @@ public:
     
     // Latency monitoring
     void start_latency_measurement(const std::string& operation_name) {
-        // Store start timestamp for the operation
-        // This could be enhanced with thread-local storage for multi-threaded scenarios
+        latency_metric(operation_name);
+    }
+    
+    /**
+     * Histogram id for an operation, registered on first use
+     *
+     * Hot paths resolve this once and call record_latency(id, ...) to skip
+     * the name lookup.
+     */
+    ::hft::HistogramId latency_metric(const std::string& operation_name) {
+        {
+            std::shared_lock<std::shared_mutex> lock(latency_mutex_);
+            auto it = latency_ids_.find(operation_name);
+            if (it != latency_ids_.end()) return it->second;
+        }
+        std::unique_lock<std::shared_mutex> lock(latency_mutex_);
+        auto& id = latency_ids_[operation_name];
+        if (!id.valid()) id = ::hft::MetricsRegistry::instance().histogram("latency." + operation_name);
+        return id;
     }
     
-    void record_latency(const std::string& operation_name, uint64_t start_time_ns) {
-        uint64_t end_time = ::hft::rdtsc();
-        uint64_t latency_ns = (end_time - start_time_ns) * 1000000000ULL / 2400000000ULL; // Approx conversion
-        
-        latency_metrics_[operation_name].add_sample(latency_ns);
+    void record_latency(const std::string& operation_name, uint64_t start_time_tsc) {
+        record_latency(latency_metric(operation_name), start_time_tsc);
+    }
+    
+    void record_latency(::hft::HistogramId operation, uint64_t start_time_tsc) {
+        uint64_t latency_ns = ::hft::TscClock::elapsed_ns(start_time_tsc);
+        ::hft::MetricsRegistry::instance().record(operation, latency_ns);
         
         // Check against threshold
-        if (latency_ns > thresholds_.max_latency_ns) {
+        if (latency_ns > thresholds_.max_latency_ns) [[unlikely]] {
             raise_alert(AlertLevel::WARNING, "latency", 
-                       "High latency detected in " + operation_name + ": " + 
+                       "High latency detected in " + ::hft::MetricsRegistry::instance().name(operation) + ": " + 
                        std::to_string(latency_ns / 1000000.0) + "ms");
         }
     }
     
     // Spread monitoring
+    void update_spread(uint32_t symbol_id, ::hft::Venue venue, double spread_bps) {
+        update_spread(spread_key(symbol_id, venue), spread_bps, [&] {
+            return "SYM" + std::to_string(symbol_id) + "_" + std::to_string(static_cast<int>(venue));
+        });
+    }
+    
     void update_spread(const std::string& symbol, ::hft::Venue venue, double spread_bps) {
-        std::string key = symbol + "_" + std::to_string(static_cast<int>(venue));
-        spread_metrics_[key].update_spread(spread_bps);
-        
-        if (spread_bps > thresholds_.max_spread_bps) {
-            raise_alert(AlertLevel::CRITICAL, "spread", 
-                       "Excessive spread on " + key + ": " + std::to_string(spread_bps) + " bps");
-        }
+        uint64_t key = (std::hash<std::string>{}(symbol) | (1ULL << 63)) ^ static_cast<uint64_t>(venue);
+        update_spread(key, spread_bps, [&] { return symbol + "_" + std::to_string(static_cast<int>(venue)); });
     }
     
     // Profitability monitoring
@@ -337,6 +413,7 @@ public:
         emergency_stop_.store(true, std::memory_order_release);
         trading_halted_.store(true, std::memory_order_release);
         emergency_reason_ = reason;
+        hft::KillSwitch::instance().halt(hft::KillSwitch::MONITOR_STOP, reason.c_str());
         
         raise_alert(AlertLevel::FATAL, "emergency", "EMERGENCY STOP: " + reason);
         hft::Logger::instance().log(hft::LogLevel::CRITICAL, "emergency", "EMERGENCY STOP TRIGGERED: " + reason);
@@ -372,7 +449,7 @@ public:
     }
     
     void raise_alert(AlertLevel level, const std::string& component, const std::string& message) {
-        Alert alert{level, component, message, ::hft::rdtsc()};
+        Alert alert{level, component, message, ::hft::get_timestamp_ns()};
         
         // Store recent alerts
         recent_alerts_.push_back(alert);
@@ -451,26 +528,31 @@ public:
             bool is_healthy = health->check_health(thresholds_.heartbeat_timeout_ns, 
                                                  thresholds_.max_error_rate_pct);
             std::cout << name << ": " << (is_healthy ? "🟢" : "🔴") 
-                      << " (Msgs: " << health->message_count.load()
-                      << ", Errs: " << health->error_count.load() << ")\n";
+                      << " (Msgs: " << health->message_count()
+                      << ", Errs: " << health->error_count() << ")\n";
         }
         
         // Latency metrics
-        std::cout << "\n⚡ LATENCY METRICS (Target: <50ms)\n";
-        for (const auto& [operation, metrics] : latency_metrics_) {
-            if (metrics.sample_count > 0) {
-                std::cout << operation << ": ";
-                std::cout << "Avg=" << (metrics.avg_ns / 1000000.0) << "ms ";
-                std::cout << "P95=" << (metrics.p95_ns / 1000000.0) << "ms ";
-                std::cout << "P99=" << (metrics.p99_ns / 1000000.0) << "ms ";
-                std::cout << (metrics.p95_ns > thresholds_.max_latency_ns ? "🔴" : "🟢") << "\n";
+        std::cout << "\n⚡ LATENCY METRICS (Target: <50ms, last " << thresholds_.latency_interval_ms << "ms)\n";
+        {
+            std::lock_guard<std::mutex> lock(interval_mutex_);
+            for (const auto& [operation, metrics] : interval_latency_) {
+                if (metrics.sample_count > 0) {
+                    std::cout << operation << ": ";
+                    std::cout << "Avg=" << (metrics.avg_ns / 1000000.0) << "ms ";
+                    std::cout << "P95=" << (metrics.p95_ns / 1000000.0) << "ms ";
+                    std::cout << "P99=" << (metrics.p99_ns / 1000000.0) << "ms ";
+                    std::cout << "P99.99=" << (metrics.p9999_ns / 1000000.0) << "ms ";
+                    std::cout << (metrics.p95_ns > thresholds_.max_latency_ns ? "🔴" : "🟢") << "\n";
+                }
             }
         }
         
         // Spread metrics
         std::cout << "\n📈 SPREAD METRICS\n";
-        for (const auto& [symbol, metrics] : spread_metrics_) {
-            std::cout << symbol << ": " << std::fixed << std::setprecision(1) 
+        for (const auto& [key, entry] : spread_metrics_) {
+            const SpreadMetrics& metrics = entry.metrics;
+            std::cout << entry.label << ": " << std::fixed << std::setprecision(1) 
                       << metrics.current_spread_bps << " bps ";
             std::cout << "(Avg: " << metrics.avg_spread_bps << " bps) ";
             std::cout << (metrics.current_spread_bps > thresholds_.max_spread_bps ? "🔴" : "🟢") << "\n";
@@ -499,9 +581,37 @@ public:
     }
     
     // Getters for current metrics
-    const LatencyMetrics* get_latency_metrics(const std::string& operation) const {
-        auto it = latency_metrics_.find(operation);
-        return it != latency_metrics_.end() ? &it->second : nullptr;
+    
+    // Cumulative latency since the operation was first recorded
+    std::optional<LatencyMetrics> get_latency_metrics(const std::string& operation) const {
+        std::shared_lock<std::shared_mutex> lock(latency_mutex_);
+        auto it = latency_ids_.find(operation);
+        if (it == latency_ids_.end()) return std::nullopt;
+        auto* recorder = ::hft::MetricsRegistry::instance().recorder(it->second);
+        if (!recorder) return std::nullopt;
+        return LatencyMetrics::from(recorder->snapshot());
+    }
+    
+    // Latency over the last completed interval
+    std::optional<LatencyMetrics> get_interval_latency_metrics(const std::string& operation) const {
+        std::lock_guard<std::mutex> lock(interval_mutex_);
+        auto it = interval_latency_.find(operation);
+        return it != interval_latency_.end() ? std::optional<LatencyMetrics>(it->second) : std::nullopt;
+    }
+    
+    // Close the current latency interval now (the monitoring thread does this every latency_interval_ms)
+    void roll_latency_interval() {
+        std::unordered_map<std::string, LatencyMetrics> reports;
+        {
+            std::shared_lock<std::shared_mutex> lock(latency_mutex_);
+            for (const auto& [operation, id] : latency_ids_) {
+                if (auto* recorder = ::hft::MetricsRegistry::instance().recorder(id)) {
+                    reports[operation] = LatencyMetrics::from(recorder->interval());
+                }
+            }
+        }
+        std::lock_guard<std::mutex> lock(interval_mutex_);
+        interval_latency_ = std::move(reports);
     }
     
     const ProfitabilityMetrics& get_profitability_metrics() const {
@@ -514,25 +624,69 @@ public:
     }
     
 private:
+    static uint64_t spread_key(uint32_t symbol_id, ::hft::Venue venue) {
+        return (static_cast<uint64_t>(symbol_id) << 8) | static_cast<uint64_t>(venue);
+    }
+    
+    template<typename MakeLabel>
+    void update_spread(uint64_t key, double spread_bps, MakeLabel&& make_label) {
+        auto it = spread_metrics_.find(key);
+        if (it == spread_metrics_.end()) [[unlikely]] {
+            std::string label = make_label();
+            ::hft::GaugeId gauge = ::hft::MetricsRegistry::instance().gauge("spread_bps." + label);
+            it = spread_metrics_.emplace(key, SpreadEntry{std::move(label), gauge, SpreadMetrics{}}).first;
+        }
+        it->second.metrics.update_spread(spread_bps);
+        ::hft::MetricsRegistry::instance().set(it->second.gauge, spread_bps);
+        
+        if (spread_bps > thresholds_.max_spread_bps) {
+            raise_alert(AlertLevel::CRITICAL, "spread", 
+                       "Excessive spread on " + it->second.label + ": " + std::to_string(spread_bps) + " bps");
+        }
+    }
+    
+    void publish_metrics(size_t unhealthy_components) {
+        auto& registry = ::hft::MetricsRegistry::instance();
+        registry.set(gauges_.emergency_stop, emergency_stop_.load() ? 1.0 : 0.0);
+        registry.set(gauges_.trading_halted, trading_halted_.load() ? 1.0 : 0.0);
+        registry.set(gauges_.unhealthy_components, static_cast<double>(unhealthy_components));
+        registry.set(gauges_.alerts, static_cast<double>(recent_alerts_.size()));
+        registry.set(gauges_.dashboard_updates, static_cast<double>(dashboard_.update_count.load()));
+        registry.set(gauges_.net_pnl, profitability_.net_profit);
+        registry.set(gauges_.drawdown, profitability_.current_drawdown);
+        registry.set(gauges_.trades, static_cast<double>(profitability_.total_trades));
+    }
+    
     void monitoring_loop() {
         while (monitoring_active_.load()) {
             // Check component health
+            size_t unhealthy = 0;
             for (auto& [name, health] : components_) {
                 if (!health->check_health(thresholds_.heartbeat_timeout_ns, 
                                         thresholds_.max_error_rate_pct)) {
                     raise_alert(AlertLevel::CRITICAL, name, "Component unhealthy");
+                    ++unhealthy;
                 }
             }
+            publish_metrics(unhealthy);
+            
+            // Close the latency interval
+            uint64_t now_ns = ::hft::get_timestamp_ns();
+            if (now_ns - last_interval_roll_ns_ >= thresholds_.latency_interval_ms * 1000000ULL) {
+                roll_latency_interval();
+                last_interval_roll_ns_ = now_ns;
+            }
             
             // Update dashboard
             if (dashboard_.dashboard_enabled.load()) {
                 dashboard_.update_count.fetch_add(1);
-                dashboard_.last_update_ns.store(::hft::rdtsc());
+                dashboard_.last_update_ns.store(::hft::get_timestamp_ns());
                 print_dashboard();
             }
             
             // Sleep for refresh interval
-            std::this_thread::sleep_for(std::chrono::milliseconds(dashboard_.refresh_interval_ms));
+            std::this_thread::sleep_for(std::chrono::milliseconds(
+                std::min(dashboard_.refresh_interval_ms, thresholds_.latency_interval_ms)));
         }
     }
     
@@ -11,6 +11,8 @@
 #include <memory>
 #include <cstdio>
 #include <sys/stat.h>
+#include "../io_service.hpp"
+#include "../metrics_registry.hpp"
 
 #ifdef __APPLE__
 #include <mach/mach.h>
@@ -110,12 +112,27 @@ private:
     std::vector<double> memory_history_;
     std::vector<double> latency_history_;
     
+    // Published to the MetricsRegistry after every health check
+    struct HealthGauges {
+        hft::GaugeId cpu_pct = hft::MetricsRegistry::instance().gauge("system.cpu_pct");
+        hft::GaugeId memory_pct = hft::MetricsRegistry::instance().gauge("system.memory_pct");
+        hft::GaugeId disk_pct = hft::MetricsRegistry::instance().gauge("system.disk_pct");
+        hft::GaugeId threads = hft::MetricsRegistry::instance().gauge("system.threads");
+        hft::GaugeId file_descriptors = hft::MetricsRegistry::instance().gauge("system.file_descriptors");
+        hft::GaugeId order_queue = hft::MetricsRegistry::instance().gauge("system.order_queue_depth");
+        hft::GaugeId market_data_queue = hft::MetricsRegistry::instance().gauge("system.market_data_queue_depth");
+        hft::GaugeId risk_queue = hft::MetricsRegistry::instance().gauge("system.risk_event_queue_depth");
+        hft::GaugeId critical_alert = hft::MetricsRegistry::instance().gauge("system.critical_alert");
+    } gauges_;
+    std::unordered_map<std::string, hft::GaugeId> exchange_gauges_;
+    
     void monitoring_loop() {
         while (monitoring_active_) {
             update_system_metrics();
             update_connectivity_status();
             update_application_health();
             check_alert_conditions();
+            publish_metrics();
             
             std::this_thread::sleep_for(
                 std::chrono::milliseconds(health_check_interval_ms_.load()));
@@ -379,29 +396,51 @@ private:
         }
     }
     
+    void publish_metrics() {
+        auto& registry = hft::MetricsRegistry::instance();
+        registry.set(gauges_.cpu_pct, performance_metrics_.cpu_usage_percent);
+        registry.set(gauges_.memory_pct, performance_metrics_.memory_usage_percent);
+        registry.set(gauges_.disk_pct, performance_metrics_.disk_usage_percent);
+        registry.set(gauges_.threads, performance_metrics_.thread_count);
+        registry.set(gauges_.file_descriptors, performance_metrics_.file_descriptor_count);
+        registry.set(gauges_.order_queue, app_health_metrics_.order_processing_queue_depth);
+        registry.set(gauges_.market_data_queue, app_health_metrics_.market_data_queue_depth);
+        registry.set(gauges_.risk_queue, app_health_metrics_.risk_event_queue_depth);
+        registry.set(gauges_.critical_alert, critical_alert_active_ ? 1.0 : 0.0);
+        
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (const auto& [exchange, status] : connectivity_status_) {
+            auto it = exchange_gauges_.find(exchange);
+            if (it == exchange_gauges_.end()) {
+                it = exchange_gauges_.emplace(exchange, registry.gauge("exchange." + exchange + ".connected")).first;
+            }
+            registry.set(it->second, status.is_connected ? 1.0 : 0.0);
+        }
+    }
+    
     void log_critical_alert(const std::vector<std::string>& alerts) {
         auto current_time = std::chrono::duration_cast<std::chrono::nanoseconds>(
             std::chrono::high_resolution_clock::now().time_since_epoch()).count();
         
-        std::ofstream alert_file("critical_system_alerts.log", std::ios::app);
-        if (alert_file.is_open()) {
-            alert_file << current_time << ",CRITICAL_ALERT_START\n";
-            for (const auto& alert : alerts) {
-                alert_file << current_time << "," << alert << "\n";
-            }
+        static const hft::IoFileId alert_file = hft::IoService::instance().open("critical_system_alerts.log");
+        hft::IoLine lines;
+        lines << current_time << ",CRITICAL_ALERT_START\n";
+        for (const auto& alert : alerts) {
+            lines << current_time << "," << alert << "\n";
         }
+        hft::IoService::instance().write(alert_file, lines);
     }
     
     void log_health_alerts(const std::vector<std::string>& alerts) {
         auto current_time = std::chrono::duration_cast<std::chrono::nanoseconds>(
             std::chrono::high_resolution_clock::now().time_since_epoch()).count();
         
-        std::ofstream health_file("system_health.log", std::ios::app);
-        if (health_file.is_open()) {
-            for (const auto& alert : alerts) {
-                health_file << current_time << "," << alert << "\n";
-            }
+        static const hft::IoFileId health_file = hft::IoService::instance().open("system_health.log");
+        hft::IoLine lines;
+        for (const auto& alert : alerts) {
+            lines << current_time << "," << alert << "\n";
         }
+        hft::IoService::instance().write(health_file, lines);
     }
 
 public:
@@ -0,0 +1,740 @@
+// order_manager.hpp - Order management system: open-order table and asynchronous order lifecycle
+#pragma once
+
+#include <atomic>
+#include <cstdio>
+#include <memory>
+#include <vector>
+#include "kill_switch.hpp"
+#include "messages.hpp"
+#include "rate_limiter.hpp"
+#include "ring_buffer.hpp"
+#include "sequencer.hpp"
+
+namespace hft {
+
+/**
+ * Order request from a strategy to the OMS (carried over a ring)
+ */
+struct OrderRequest {
+    enum class Action : uint8_t {
+        NEW = 0,
+        CANCEL = 1,
+        REPLACE = 2
+    };
+
+    OrderId order_id;           // From OrderManager::reserve_order_id()
+    uint64_t client_tag;        // Opaque to the OMS; echoed on every update
+    uint64_t timestamp_ns;
+    Price price;                // Limit price (NEW/REPLACE; 0 for market)
+    Quantity quantity;          // Total quantity (NEW/REPLACE)
+    SymbolId symbol;
+    StrategyId strategy;
+    Action action;
+    Side side;
+    OrderType type;
+    TimeInForce tif;
+    Venue venue;
+};
+
+/**
+ * Execution report from the OMS to strategies (carried over a ring)
+ */
+struct OrderUpdate {
+    OrderId order_id;
+    uint64_t client_tag;
+    uint64_t timestamp_ns;
+    Price price;                // Current working price
+    Price last_fill_price;
+    Quantity last_fill_quantity;
+    Quantity filled_quantity;   // Cumulative
+    Quantity leaves_quantity;
+    Price avg_fill_price;
+    int64_t fees;               // Cumulative, fixed point (PRICE_MULTIPLIER)
+    uint64_t round_trip_ns;     // ORDER_ACK for a new order: sent -> ack (0 otherwise)
+    SymbolId symbol;
+    StrategyId strategy;
+    MessageType event;          // ORDER_ACK, FILL, PARTIAL_FILL, ORDER_REJECT, CANCEL_ACK, CANCEL_REJECT
+    OrderStatus status;
+    Side side;
+    Venue venue;
+    uint8_t flags;              // OrderRecord::FLAG_* describing the event
+
+    bool is_terminal() const {
+        return status == OrderStatus::FILLED || status == OrderStatus::CANCELLED ||
+               status == OrderStatus::REJECTED || status == OrderStatus::EXPIRED;
+    }
+};
+
+/**
+ * Open order record
+ *
+ * Lives in the OMS pool for the life of the order. Hot lifecycle fields
+ * share the first cache line; latency stamps follow.
+ */
+struct alignas(64) OrderRecord {
+    // Event flags (OrderUpdate::flags) and pending-request bits (pending)
+    static constexpr uint8_t FLAG_CANCEL = 0x01;
+    static constexpr uint8_t FLAG_REPLACE = 0x02;
+
+    // ========== Lifecycle (cache line 1) ==========
+    OrderId order_id;
+    uint64_t client_tag;
+    Price price;
+    Quantity quantity;
+    Quantity filled_quantity;
+    Price pending_price;        // Replace in flight
+    Quantity pending_quantity;
+    SymbolId symbol;
+    StrategyId strategy;
+    Side side;
+    OrderType type;
+    TimeInForce tif;
+    OrderStatus status;
+    Venue venue;
+    uint8_t pending;            // FLAG_CANCEL / FLAG_REPLACE requests awaiting the venue
+    uint16_t fill_count;
+
+    // ========== Fill accounting and latency stamps (cache line 2) ==========
+    double fill_notional;       // Sum of fill price * quantity (floating, for the average)
+    int64_t fees;
+    uint64_t created_ns;        // Request accepted by the OMS
+    uint64_t sent_ns;           // Written to the venue ring
+    uint64_t acked_ns;
+    uint64_t first_fill_ns;
+    uint64_t last_event_ns;
+    uint64_t done_ns;           // Reached a terminal state
+
+    Quantity leaves() const {
+        return quantity > filled_quantity ? quantity - filled_quantity : 0;
+    }
+
+    Price avg_fill_price() const {
+        return filled_quantity > 0
+            ? static_cast<Price>(fill_notional / to_float_quantity(filled_quantity) * PRICE_MULTIPLIER)
+            : 0;
+    }
+
+    bool is_terminal() const {
+        return status == OrderStatus::FILLED || status == OrderStatus::CANCELLED ||
+               status == OrderStatus::REJECTED || status == OrderStatus::EXPIRED;
+    }
+};
+
+/**
+ * Open Order Table
+ *
+ * Preallocated pool of OrderRecords indexed by an open-addressing hash
+ * (linear probing, backward-shift deletion, no tombstones) keyed by
+ * OrderId. No allocation after construction; lookups touch one or two
+ * cache lines of the index plus the record itself.
+ */
+class OrderTable {
+private:
+    struct Slot {
+        OrderId key;            // 0 = empty
+        uint32_t index;
+    };
+
+    std::vector<OrderRecord> records_;
+    std::vector<uint32_t> free_list_;
+    std::vector<Slot> slots_;
+    uint64_t slot_mask_;
+    size_t size_ = 0;
+
+    size_t home(OrderId id) const {
+        return static_cast<size_t>((id * 0x9E3779B97F4A7C15ULL) >> 20) & slot_mask_;
+    }
+
+public:
+    explicit OrderTable(size_t capacity) : records_(capacity) {
+        size_t slot_count = 1;
+        while (slot_count < capacity * 2) slot_count <<= 1;   // Load factor <= 0.5
+        slots_.assign(slot_count, Slot{0, 0});
+        slot_mask_ = slot_count - 1;
+
+        free_list_.reserve(capacity);
+        for (size_t i = capacity; i-- > 0;) {
+            free_list_.push_back(static_cast<uint32_t>(i));
+        }
+    }
+
+    /**
+     * Allocate a record for a new order
+     * @return Record, or nullptr if the id exists or the pool is exhausted
+     */
+    OrderRecord* insert(OrderId id) {
+        if (id == 0 || free_list_.empty()) return nullptr;
+
+        size_t pos = home(id);
+        while (slots_[pos].key != 0) {
+            if (slots_[pos].key == id) return nullptr;
+            pos = (pos + 1) & slot_mask_;
+        }
+
+        const uint32_t index = free_list_.back();
+        free_list_.pop_back();
+        slots_[pos] = Slot{id, index};
+        ++size_;
+
+        OrderRecord& record = records_[index];
+        record = OrderRecord{};
+        record.order_id = id;
+        return &record;
+    }
+
+    OrderRecord* find(OrderId id) {
+        if (id == 0) return nullptr;
+        for (size_t pos = home(id); slots_[pos].key != 0; pos = (pos + 1) & slot_mask_) {
+            if (slots_[pos].key == id) return &records_[slots_[pos].index];
+        }
+        return nullptr;
+    }
+
+    const OrderRecord* find(OrderId id) const {
+        return const_cast<OrderTable*>(this)->find(id);
+    }
+
+    /**
+     * Release an order's record and index slot
+     */
+    bool erase(OrderId id) {
+        if (id == 0) return false;
+
+        size_t pos = home(id);
+        while (slots_[pos].key != id) {
+            if (slots_[pos].key == 0) return false;
+            pos = (pos + 1) & slot_mask_;
+        }
+        free_list_.push_back(slots_[pos].index);
+        --size_;
+
+        // Backward-shift: pull later cluster members into the hole when their home allows it
+        size_t hole = pos;
+        size_t next = (hole + 1) & slot_mask_;
+        while (slots_[next].key != 0) {
+            const size_t ideal = home(slots_[next].key);
+            const bool movable = ((next - ideal) & slot_mask_) >= ((next - hole) & slot_mask_);
+            if (movable) {
+                slots_[hole] = slots_[next];
+                hole = next;
+            }
+            next = (next + 1) & slot_mask_;
+        }
+        slots_[hole] = Slot{0, 0};
+        return true;
+    }
+
+    size_t size() const { return size_; }
+    size_t capacity() const { return records_.size(); }
+};
+
+/**
+ * Order Management System
+ *
+ * Owns all order state. Strategies never touch it directly: they reserve
+ * an OrderId, push OrderRequests onto the request ring and consume
+ * OrderUpdates from the update ring. Venue gateways consume NEW_ORDER /
+ * CANCEL_ORDER / REPLACE_ORDER SequencedMessages from the outbound ring
+ * and answer with ORDER_ACK, ORDER_REJECT, FILL, PARTIAL_FILL, CANCEL_ACK
+ * and CANCEL_REJECT on the inbound ring (echoing our OrderId in the order
+ * or fill payload). poll() runs the state machine on the OMS thread.
+ *
+ * Replace handling: a REPLACE_ORDER is answered with ORDER_ACK carrying
+ * FLAG_REPLACE in order.flags (or CANCEL_REJECT with FLAG_REPLACE if the
+ * venue refuses it). Fills that race a cancel or replace are applied
+ * against the original order; a replace acked at or below the filled
+ * quantity completes the order as FILLED.
+ *
+ * Fill and terminal updates are never dropped: if the update ring is full
+ * the update is held and poll() stops taking venue messages and requests
+ * until the strategy side has drained enough to accept it (the backlog
+ * stays in the inbound rings). Only informational updates (acks, cancel
+ * rejects) are dropped when the ring is full.
+ *
+ * The venue ring is treated the same way: if it stays full for a short
+ * spin, the outbound message is held and poll() takes no new requests
+ * until it goes out, so a gateway drained on the OMS thread itself (one
+ * event loop, backtests) gets its turn instead of being spun on. Venue
+ * messages are still handled meanwhile.
+ *
+ * While the kill switch is set, new and replace requests are refused both
+ * in submit() and again on the OMS thread before anything reaches the
+ * venue ring, so requests queued before the flip never go out. Cancels
+ * always pass.
+ */
+class OrderManager {
+public:
+    static constexpr size_t DEFAULT_CAPACITY = 16384;
+    static constexpr size_t REQUEST_RING_SIZE = 4096;
+    static constexpr size_t UPDATE_RING_SIZE = 8192;
+    static constexpr size_t VENUE_RING_SIZE = 4096;
+    static constexpr uint32_t OUTBOUND_SPIN_LIMIT = 64;    // Write attempts before holding a venue message
+
+    struct Stats {
+        uint64_t requests = 0;
+        uint64_t rejected_requests = 0;     // Refused by the OMS before reaching a venue
+        uint64_t halted_requests = 0;       // ... of which because the kill switch was set
+        uint64_t orders_sent = 0;
+        uint64_t acks = 0;
+        uint64_t fills = 0;
+        uint64_t venue_rejects = 0;
+        uint64_t cancels = 0;
+        uint64_t replaces = 0;
+        uint64_t dropped_updates = 0;       // Informational update dropped: update ring full
+        uint64_t held_updates = 0;          // Fill/terminal update held back: update ring full
+        uint64_t held_outbound = 0;         // Venue message held back: venue ring full
+        uint64_t unknown_messages = 0;      // Venue message for an order we no longer track
+        uint64_t ack_latency_total_ns = 0;
+        uint64_t ack_latency_max_ns = 0;
+        uint64_t fill_latency_total_ns = 0; // Sent -> first fill
+        uint64_t fill_latency_max_ns = 0;
+        uint64_t first_fills = 0;
+    };
+
+private:
+    OrderTable table_;
+
+    MPSCQueue<OrderRequest, REQUEST_RING_SIZE> requests_;
+    SPSCQueue<OrderUpdate, UPDATE_RING_SIZE> updates_;
+    std::unique_ptr<SPSCRingBuffer<VENUE_RING_SIZE>> to_venue_;
+    std::unique_ptr<SPSCRingBuffer<VENUE_RING_SIZE>> from_venue_;
+
+    alignas(64) std::atomic<OrderId> next_order_id_{1};
+    std::atomic<uint64_t> rate_limited_{0};         // Requests refused by rate_limiter_ in submit()
+    std::atomic<uint64_t> halted_{0};               // Requests refused in submit() by the kill switch
+    HierarchicalRateLimiter* rate_limiter_ = nullptr;
+    const std::atomic<uint64_t>* kill_word_ = KillSwitch::instance().word();
+
+    Stats stats_;
+    OrderUpdate held_update_{};                     // Fill/terminal update awaiting ring space
+    bool update_held_ = false;
+    SequencedMessage held_outbound_{};              // Venue message awaiting ring space
+    bool outbound_held_ = false;
+    uint16_t source_id_;
+
+public:
+    explicit OrderManager(size_t capacity = DEFAULT_CAPACITY, uint16_t source_id = 1)
+        : table_(capacity)
+        , to_venue_(std::make_unique<SPSCRingBuffer<VENUE_RING_SIZE>>())
+        , from_venue_(std::make_unique<SPSCRingBuffer<VENUE_RING_SIZE>>())
+        , source_id_(source_id) {}
+
+    // ========== Strategy side (any thread) ==========
+
+    /**
+     * Reserve a unique OrderId so the strategy can cancel/replace before the ack
+     */
+    OrderId reserve_order_id() noexcept {
+        return next_order_id_.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    /**
+     * Queue a request for the OMS thread
+     * @return false if the request ring is full, or a new/replace order is
+     *         over its rate limit (evaluated at request.timestamp_ns) or
+     *         the kill switch is set; cancels are never refused for either.
+     *         A request refused by a full ring gives its token back.
+     */
+    bool submit(const OrderRequest& request) noexcept {
+        if (request.action != OrderRequest::Action::CANCEL && halted()) [[unlikely]] {
+            halted_.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+        const bool limited = rate_limiter_ && request.action != OrderRequest::Action::CANCEL;
+        if (limited &&
+            rate_limiter_->try_acquire(request.strategy, request.venue, request.timestamp_ns) !=
+                HierarchicalRateLimiter::Result::ALLOWED) {
+            rate_limited_.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+        if (requests_.push(request)) [[likely]] return true;
+
+        if (limited) rate_limiter_->refund(request.strategy, request.venue);
+        return false;
+    }
+
+    /**
+     * Queue several requests back to back (e.g. the legs of a basket)
+     *
+     * All or nothing: either every request is queued, consecutively and
+     * under one rate-limit decision, or none is.
+     */
+    bool submit_batch(const OrderRequest* requests, size_t count) noexcept {
+        if (halted()) [[unlikely]] {
+            for (size_t i = 0; i < count; ++i) {
+                if (requests[i].action != OrderRequest::Action::CANCEL) {
+                    halted_.fetch_add(1, std::memory_order_relaxed);
+                    return false;
+                }
+            }
+        }
+        if (rate_limiter_) {
+            for (size_t i = 0; i < count; ++i) {
+                if (requests[i].action == OrderRequest::Action::CANCEL) continue;
+                if (rate_limiter_->try_acquire(requests[i].strategy, requests[i].venue, requests[i].timestamp_ns) !=
+                    HierarchicalRateLimiter::Result::ALLOWED) {
+                    refund_batch(requests, i);
+                    rate_limited_.fetch_add(1, std::memory_order_relaxed);
+                    return false;
+                }
+            }
+        }
+        if (requests_.push_batch(requests, count)) [[likely]] return true;
+
+        if (rate_limiter_) refund_batch(requests, count);
+        return false;
+    }
+
+    // Attach before orders flow; shared with any other component enforcing the same limits
+    void set_rate_limiter(HierarchicalRateLimiter* limiter) { rate_limiter_ = limiter; }
+    uint64_t rate_limited() const { return rate_limited_.load(std::memory_order_relaxed); }
+
+    // Gate on another switch than the process-wide one (before orders flow)
+    void set_kill_switch(const KillSwitch& kill_switch) { kill_word_ = kill_switch.word(); }
+    bool halted() const noexcept { return KillSwitch::is_halted(kill_word_->load(std::memory_order_acquire)); }
+    uint64_t halted_submits() const { return halted_.load(std::memory_order_relaxed); }
+
+    // Single consumer (the strategy event loop)
+    bool poll_update(OrderUpdate& update) noexcept {
+        return updates_.pop(update);
+    }
+
+    // ========== Venue gateway side ==========
+
+    bool poll_outbound(SequencedMessage& msg) noexcept {
+        return to_venue_->read(msg);
+    }
+
+    bool deliver(const SequencedMessage& msg) noexcept {
+        return from_venue_->write(msg);
+    }
+
+    // ========== OMS thread ==========
+
+    /**
+     * Process pending strategy requests and venue responses
+     * @return Number of messages handled
+     */
+    size_t poll() {
+        size_t work = 0;
+
+        if (outbound_held_ && to_venue_->write(held_outbound_)) {
+            outbound_held_ = false;
+            ++work;
+        }
+
+        // Back-pressure: nothing new is handled until a held update is delivered
+        if (update_held_) {
+            if (!updates_.push(held_update_)) return 0;
+            update_held_ = false;
+        }
+
+        SequencedMessage msg{};
+        while (!update_held_ && from_venue_->read(msg)) {
+            handle_venue_message(msg);
+            ++work;
+        }
+
+        OrderRequest request;
+        while (!update_held_ && !outbound_held_ && requests_.pop(request)) {
+            handle_request(request);
+            ++work;
+        }
+        return work;
+    }
+
+    const OrderRecord* find(OrderId id) const { return table_.find(id); }
+    size_t open_orders() const { return table_.size(); }
+    const Stats& get_stats() const { return stats_; }
+
+    void print_status() const {
+        printf("\n📑 Order Manager Status:\n");
+        printf("   Open orders: %zu/%zu\n", table_.size(), table_.capacity());
+        printf("   Requests: %lu (refused %lu), Sent: %lu, Acks: %lu, Fills: %lu, Venue rejects: %lu\n",
+               static_cast<unsigned long>(stats_.requests), static_cast<unsigned long>(stats_.rejected_requests),
+               static_cast<unsigned long>(stats_.orders_sent), static_cast<unsigned long>(stats_.acks),
+               static_cast<unsigned long>(stats_.fills), static_cast<unsigned long>(stats_.venue_rejects));
+        if (rate_limiter_) {
+            printf("   Rate limited: %lu\n", static_cast<unsigned long>(rate_limited()));
+        }
+        if (stats_.halted_requests > 0 || halted_submits() > 0) {
+            printf("   Kill switch refused: %lu submits, %lu queued requests\n",
+                   static_cast<unsigned long>(halted_submits()), static_cast<unsigned long>(stats_.halted_requests));
+        }
+        printf("   Cancels: %lu, Replaces: %lu, Dropped updates: %lu, Held updates: %lu, Held outbound: %lu\n",
+               static_cast<unsigned long>(stats_.cancels), static_cast<unsigned long>(stats_.replaces),
+               static_cast<unsigned long>(stats_.dropped_updates),
+               static_cast<unsigned long>(stats_.held_updates),
+               static_cast<unsigned long>(stats_.held_outbound));
+        if (stats_.acks > 0) {
+            printf("   Ack latency: avg %.1f us, max %.1f us\n",
+                   stats_.ack_latency_total_ns / 1000.0 / stats_.acks, stats_.ack_latency_max_ns / 1000.0);
+        }
+        if (stats_.first_fills > 0) {
+            printf("   First-fill latency: avg %.1f us, max %.1f us\n",
+                   stats_.fill_latency_total_ns / 1000.0 / stats_.first_fills,
+                   stats_.fill_latency_max_ns / 1000.0);
+        }
+    }
+
+private:
+    // Give back the tokens taken for the first count requests of a refused batch
+    void refund_batch(const OrderRequest* requests, size_t count) noexcept {
+        for (size_t i = 0; i < count; ++i) {
+            if (requests[i].action != OrderRequest::Action::CANCEL) {
+                rate_limiter_->refund(requests[i].strategy, requests[i].venue);
+            }
+        }
+    }
+
+    void handle_request(const OrderRequest& request) {
+        stats_.requests++;
+        const uint64_t now = get_timestamp_ns();
+
+        switch (request.action) {
+            case OrderRequest::Action::NEW: {
+                if (halted()) [[unlikely]] {
+                    stats_.rejected_requests++;
+                    stats_.halted_requests++;
+                    publish_rejected_request(request, now);
+                    return;
+                }
+                OrderRecord* order = request.quantity > 0 ? table_.insert(request.order_id) : nullptr;
+                if (!order) {
+                    stats_.rejected_requests++;
+                    publish_rejected_request(request, now);
+                    return;
+                }
+
+                order->client_tag = request.client_tag;
+                order->price = request.price;
+                order->quantity = request.quantity;
+                order->symbol = request.symbol;
+                order->strategy = request.strategy;
+                order->side = request.side;
+                order->type = request.type;
+                order->tif = request.tif;
+                order->venue = request.venue;
+                order->status = OrderStatus::PENDING;
+                order->created_ns = now;
+
+                send(*order, MessageType::NEW_ORDER, order->price, order->quantity, now);
+                order->status = OrderStatus::SENT;
+                order->sent_ns = now;
+                stats_.orders_sent++;
+                return;
+            }
+
+            case OrderRequest::Action::CANCEL: {
+                OrderRecord* order = table_.find(request.order_id);
+                if (!order || order->is_terminal() || (order->pending & OrderRecord::FLAG_CANCEL)) {
+                    stats_.rejected_requests++;
+                    return;
+                }
+                order->pending |= OrderRecord::FLAG_CANCEL;
+                send(*order, MessageType::CANCEL_ORDER, order->price, order->quantity, now);
+                stats_.cancels++;
+                return;
+            }
+
+            case OrderRequest::Action::REPLACE: {
+                OrderRecord* order = table_.find(request.order_id);
+                const bool stopped = halted();
+                if (!order || order->is_terminal() || order->pending != 0 ||
+                    request.quantity <= order->filled_quantity || stopped) {
+                    stats_.rejected_requests++;
+                    if (stopped) stats_.halted_requests++;
+                    return;
+                }
+                order->pending |= OrderRecord::FLAG_REPLACE;
+                order->pending_price = request.price;
+                order->pending_quantity = request.quantity;
+                send(*order, MessageType::REPLACE_ORDER, request.price, request.quantity, now);
+                stats_.replaces++;
+                return;
+            }
+        }
+    }
+
+    void send(const OrderRecord& order, MessageType type, Price price, Quantity quantity, uint64_t now) {
+        SequencedMessage msg{};
+        msg.timestamp_ns = now;
+        msg.type = type;
+        msg.venue = order.venue;
+        msg.symbol_id = order.symbol;
+        msg.strategy_id = order.strategy;
+        msg.source_id = source_id_;
+        msg.correlation_id = order.order_id;
+        msg.order.order_id = order.order_id;
+        msg.order.price = price;
+        msg.order.quantity = quantity;
+        msg.order.side = order.side;
+        msg.order.order_type = order.type;
+        msg.order.tif = order.tif;
+        msg.order.status = order.status;
+
+        // Outbound ring full means the gateway is behind: spin briefly, then hold the
+        // message (never drop it) and let poll() retry once the gateway has drained
+        for (uint32_t spin = 0; spin < OUTBOUND_SPIN_LIMIT; ++spin) {
+            if (to_venue_->write(msg)) [[likely]] return;
+#ifdef HAS_X86_INTRINSICS
+            _mm_pause();
+#endif
+        }
+        held_outbound_ = msg;
+        outbound_held_ = true;
+        stats_.held_outbound++;
+    }
+
+    void handle_venue_message(const SequencedMessage& msg) {
+        const bool is_fill = msg.type == MessageType::FILL || msg.type == MessageType::PARTIAL_FILL;
+        const OrderId id = is_fill ? msg.fill.order_id : msg.order.order_id;
+
+        OrderRecord* order = table_.find(id);
+        if (!order) {
+            stats_.unknown_messages++;
+            return;
+        }
+
+        const uint64_t now = get_timestamp_ns();
+        order->last_event_ns = now;
+        uint8_t flags = 0;
+
+        switch (msg.type) {
+            case MessageType::ORDER_ACK:
+                if ((msg.order.flags & OrderRecord::FLAG_REPLACE) && (order->pending & OrderRecord::FLAG_REPLACE)) {
+                    order->price = order->pending_price;
+                    order->quantity = order->pending_quantity;
+                    order->pending &= ~OrderRecord::FLAG_REPLACE;
+                    flags = OrderRecord::FLAG_REPLACE;
+
+                    // Fills raced the replace down to (or below) what is already filled
+                    if (order->quantity <= order->filled_quantity) {
+                        order->quantity = order->filled_quantity;
+                        order->status = OrderStatus::FILLED;
+                    }
+                } else {
+                    if (order->acked_ns == 0) {
+                        order->acked_ns = now;
+                        const uint64_t latency = now - order->sent_ns;
+                        stats_.acks++;
+                        stats_.ack_latency_total_ns += latency;
+                        stats_.ack_latency_max_ns = std::max(stats_.ack_latency_max_ns, latency);
+                    }
+                }
+                if (order->status == OrderStatus::SENT) order->status = OrderStatus::ACKNOWLEDGED;
+                break;
+
+            case MessageType::FILL:
+            case MessageType::PARTIAL_FILL: {
+                const Quantity qty = std::min(msg.fill.fill_quantity, order->leaves());
+                order->filled_quantity += qty;
+                order->fill_notional += to_float_price(msg.fill.fill_price) * to_float_quantity(qty);
+                order->fees += msg.fill.fee;
+                order->fill_count++;
+                stats_.fills++;
+                if (order->first_fill_ns == 0) {
+                    order->first_fill_ns = now;
+                    const uint64_t latency = now - order->sent_ns;
+                    stats_.first_fills++;
+                    stats_.fill_latency_total_ns += latency;
+                    stats_.fill_latency_max_ns = std::max(stats_.fill_latency_max_ns, latency);
+                }
+                order->status = order->leaves() == 0 ? OrderStatus::FILLED : OrderStatus::PARTIALLY_FILLED;
+                publish(*order, msg.type, msg.fill.fill_price, qty, 0, now);
+                finish_if_terminal(*order, now);
+                return;
+            }
+
+            case MessageType::ORDER_REJECT:
+                order->status = OrderStatus::REJECTED;
+                stats_.venue_rejects++;
+                break;
+
+            case MessageType::CANCEL_ACK:
+                order->status = OrderStatus::CANCELLED;
+                order->pending &= ~OrderRecord::FLAG_CANCEL;
+                flags = OrderRecord::FLAG_CANCEL;
+                break;
+
+            case MessageType::CANCEL_REJECT:
+                // Either request can be refused (e.g. already filled); the order itself is unchanged
+                flags = msg.order.flags & OrderRecord::FLAG_REPLACE ? OrderRecord::FLAG_REPLACE
+                                                                    : OrderRecord::FLAG_CANCEL;
+                order->pending &= ~flags;
+                break;
+
+            default:
+                stats_.unknown_messages++;
+                return;
+        }
+
+        publish(*order, msg.type, 0, 0, flags, now);
+        finish_if_terminal(*order, now);
+    }
+
+    void finish_if_terminal(OrderRecord& order, uint64_t now) {
+        if (!order.is_terminal()) return;
+        order.done_ns = now;
+        table_.erase(order.order_id);
+    }
+
+    void publish(const OrderRecord& order, MessageType event, Price fill_price, Quantity fill_qty,
+                 uint8_t flags, uint64_t now) {
+        OrderUpdate update{};
+        update.order_id = order.order_id;
+        update.client_tag = order.client_tag;
+        update.timestamp_ns = now;
+        update.price = order.price;
+        update.last_fill_price = fill_price;
+        update.last_fill_quantity = fill_qty;
+        update.filled_quantity = order.filled_quantity;
+        update.leaves_quantity = order.is_terminal() ? 0 : order.leaves();
+        update.avg_fill_price = order.avg_fill_price();
+        update.fees = order.fees;
+        update.round_trip_ns = event == MessageType::ORDER_ACK && flags == 0 ? order.acked_ns - order.sent_ns : 0;
+        update.symbol = order.symbol;
+        update.strategy = order.strategy;
+        update.event = event;
+        update.status = order.status;
+        update.side = order.side;
+        update.venue = order.venue;
+        update.flags = flags;
+
+        push_update(update);
+    }
+
+    void publish_rejected_request(const OrderRequest& request, uint64_t now) {
+        OrderUpdate update{};
+        update.order_id = request.order_id;
+        update.client_tag = request.client_tag;
+        update.timestamp_ns = now;
+        update.price = request.price;
+        update.symbol = request.symbol;
+        update.strategy = request.strategy;
+        update.event = MessageType::ORDER_REJECT;
+        update.status = OrderStatus::REJECTED;
+        update.side = request.side;
+        update.venue = request.venue;
+
+        push_update(update);
+    }
+
+    // Strategies (execution algos, baskets) finish work only on fills and terminal updates
+    void push_update(const OrderUpdate& update) {
+        if (updates_.push(update)) [[likely]] return;
+
+        const bool informational = !update.is_terminal() && update.event != MessageType::FILL &&
+                                   update.event != MessageType::PARTIAL_FILL;
+        if (informational) {
+            stats_.dropped_updates++;
+            return;
+        }
+        held_update_ = update;
+        update_held_ = true;
+        stats_.held_updates++;
+    }
+};
+
+} // namespace hft
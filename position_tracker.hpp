@@ -2,12 +2,17 @@
 
 #include <unordered_map>
 #include <string>
-#include <mutex>
 #include <atomic>
+#include <array>
 #include <chrono>
+#include <memory>
 #include <vector>
 #include <fstream>
+#include "io_service.hpp"
 #include "messages.hpp"
+#include "journal.hpp"
+#include "seqlock.hpp"
+#include "symbol_table.hpp"
 
 struct Position {
     double quantity = 0.0;      // Net position (+ long, - short)
@@ -85,223 +90,768 @@ struct ExchangeBalance {
     }
 };
 
+// One position in a portfolio snapshot; position.unrealized_pnl is marked at mark_price
+struct PositionEntry {
+    hft::Venue venue = hft::Venue::BINANCE;
+    hft::SymbolId symbol = 0;
+    Position position;
+    double mark_price = 0.0;
+};
+
+// Consistent view of the whole book at one epoch
+struct PortfolioSnapshot {
+    uint64_t epoch = 0;                 // 0 until the first publish
+    uint64_t timestamp_ns = 0;
+    std::vector<PositionEntry> positions;
+    std::array<ExchangeBalance, hft::VENUE_COUNT> balances{};
+    uint32_t balance_venues = 0;        // Bit per venue that holds a balance
+    double total_equity = 0.0;
+    double realized_pnl = 0.0;
+    double unrealized_pnl = 0.0;
+};
+
+// Running portfolio totals; each field is current on its own, not as a set
+struct PortfolioAggregates {
+    double total_equity = 0.0;
+    double realized_pnl = 0.0;
+    double unrealized_pnl = 0.0;
+    double gross_exposure = 0.0;        // Sum of |quantity * mark|
+    double net_exposure = 0.0;          // Sum of quantity * mark
+};
+
+/**
+ * Position Tracker
+ *
+ * Positions live in a dense array of slots, one per (venue, SymbolId),
+ * claimed lock-free on first use. Each slot is a SeqLock written by the
+ * thread that books fills for it (and by mark updates, which serialize
+ * behind it), so readers (risk, monitor) copy a position without ever
+ * blocking the fill path.
+ *
+ * Equity, unrealized P&L and gross/net/per-symbol exposure are running
+ * totals: every fill or mark computes its slot's new contribution inside
+ * the slot write and adds the difference to an atomic, so pre-trade risk
+ * reads them in O(1). verify_aggregates() recomputes everything from the
+ * slots and corrects any floating-point drift; call it periodically.
+ *
+ * Whole-book readers use snapshots: publish_snapshot() copies every slot
+ * into the back half of a double buffer and bumps the epoch, and
+ * read_snapshot() copies the front half. Trade logging and performance
+ * metrics run after the slot write, outside any lock.
+ *
+ * With a TradeJournal attached, every fill and balance adjustment is
+ * appended to it after being applied; restore() and replay of the journal
+ * rebuild the book after a restart (see SessionRecovery).
+ *
+ * The string-keyed API is kept for existing callers; it maps the exchange
+ * through venue_from_name() and the symbol through the SymbolTable
+ * (unknown exchanges are ignored).
+ */
 class PositionTracker {
+public:
+    static constexpr size_t DEFAULT_MAX_POSITIONS = 4096;
+
 private:
-    // Position tracking: [exchange][symbol] -> Position
-    std::unordered_map<std::string, std::unordered_map<std::string, Position>> positions_;
-    
-    // Balance tracking: [exchange] -> ExchangeBalance
-    std::unordered_map<std::string, ExchangeBalance> balances_;
-    
-    // Market prices for P&L calculation: [exchange][symbol] -> price
-    std::unordered_map<std::string, std::unordered_map<std::string, double>> market_prices_;
-    
-    // Performance tracking
-    double total_realized_pnl_ = 0.0;
-    double daily_pnl_ = 0.0;
-    double max_drawdown_ = 0.0;
-    double peak_equity_ = 100000.0; // Starting equity
+    static constexpr uint32_t EMPTY_SLOT = 0xFFFFFFFF;
+    static constexpr uint32_t CLAIMING_SLOT = 0xFFFFFFFE;
+
+    enum class Asset : uint8_t { NONE, BTC, ETH };
+
+    // Slot contents; position.unrealized_pnl is kept marked at mark_price
+    struct SlotState {
+        Position position;
+        double mark_price = 0.0;
+        double net_exposure = 0.0;      // quantity * valuation price
+    };
+
+    struct alignas(64) PositionSlot {
+        hft::SeqLock<SlotState> state;
+        std::atomic<double> mark_price{0.0};    // Copy of state.mark_price for venue revaluation
+        std::atomic<bool> ready{false};
+        hft::Venue venue = hft::Venue::BINANCE;
+        hft::SymbolId symbol = 0;
+        Asset asset = Asset::NONE;
+    };
+
+    struct SnapshotBuffer {
+        std::atomic<uint32_t> seq{0};
+        uint64_t epoch = 0;
+        uint64_t timestamp_ns = 0;
+        size_t count = 0;
+        std::unique_ptr<PositionEntry[]> entries;
+        std::array<ExchangeBalance, hft::VENUE_COUNT> balances{};
+        uint32_t balance_venues = 0;
+        double total_equity = 0.0;
+        double realized_pnl = 0.0;
+        double unrealized_pnl = 0.0;
+    };
+
+    // Position slots: [venue * MAX_SYMBOLS + symbol] -> slot index
+    size_t max_positions_;
+    std::unique_ptr<std::atomic<uint32_t>[]> slot_index_;
+    std::unique_ptr<PositionSlot[]> slots_;
+    std::atomic<size_t> next_slot_{0};
+    std::atomic<uint64_t> slot_overflows_{0};
+
+    // Balance tracking, one per venue; equity is the venue's contribution to total_equity_
+    struct VenueBook {
+        ExchangeBalance balance;
+        double equity = 0.0;
+    };
+    std::array<hft::SeqLock<VenueBook>, hft::VENUE_COUNT> books_;
+    std::atomic<uint32_t> balance_venues_{0};
+
+    hft::SymbolId btc_symbol_;
+    hft::SymbolId eth_symbol_;
+
+    // Read by every pre-trade check; kept off the lines the per-fill
+    // and per-mark read-modify-writes below keep invalidating
+    alignas(64) std::atomic<double> total_equity_{0.0};
+    std::atomic<double> daily_pnl_{0.0};
+    std::atomic<double> max_drawdown_{0.0};
+    std::atomic<double> peak_equity_{100000.0}; // Starting equity
     uint64_t trading_session_start_ = 0;
-    
-    mutable std::mutex mutex_;
+
+    // Running aggregates, maintained by delta
+    alignas(64) std::atomic<double> total_realized_pnl_{0.0};
+    std::atomic<double> total_unrealized_pnl_{0.0};
+    std::atomic<double> gross_exposure_{0.0};
+    std::atomic<double> net_exposure_{0.0};
+    std::unique_ptr<std::atomic<double>[]> symbol_exposure_;   // Net, summed over venues
+    std::atomic<uint64_t> aggregate_corrections_{0};
+
+    // Write bookkeeping and snapshot publication
+    alignas(64) std::atomic<uint32_t> writes_in_flight_{0};
+    std::atomic<uint64_t> state_version_{0};        // Bumped by every trade and mark
+    mutable std::array<SnapshotBuffer, 2> snapshots_;
+    mutable std::atomic<uint64_t> published_epoch_{0};
+    mutable uint64_t published_version_ = 0;
+    mutable std::atomic<bool> publishing_{false};
+
     std::atomic<bool> logging_enabled_{true};
-    
+    hft::IoFileId trade_file_ = hft::INVALID_IO_FILE;
+    hft::TradeJournal* journal_ = nullptr;
+
     // Slippage modeling
     struct SlippageModel {
         double linear_impact = 0.0001;    // 1 bp per unit
         double square_root_impact = 0.001; // Square root market impact
         double temporary_impact = 0.0005;  // Temporary price impact
-        
-        double calculate_slippage(double quantity, double avg_volume, 
+
+        double calculate_slippage(double quantity, double avg_volume,
                                  double spread, bool is_taker) const {
             double participation_rate = std::abs(quantity) / avg_volume;
-            double permanent_impact = linear_impact * participation_rate + 
+            double permanent_impact = linear_impact * participation_rate +
                                      square_root_impact * std::sqrt(participation_rate);
             double total_impact = permanent_impact;
-            
+
             if (is_taker) {
                 total_impact += spread / 2.0 + temporary_impact;
             }
-            
+
             return total_impact;
         }
     };
-    
+
+    // Read-only after construction
     std::unordered_map<std::string, SlippageModel> slippage_models_;
     std::unordered_map<std::string, double> average_volumes_;
-    
-    void log_trade(const std::string& exchange, const std::string& symbol, 
-                   double quantity, double price, const std::string& side) {
+
+    void log_trade(const char* exchange, const std::string& symbol,
+                   double quantity, double price, const char* side) {
         if (!logging_enabled_) return;
-        
+
         auto now = std::chrono::system_clock::now();
         auto time_t = std::chrono::system_clock::to_time_t(now);
-        
-        std::ofstream log_file("trade_log.csv", std::ios::app);
-        if (log_file.is_open()) {
-            log_file << time_t << "," << exchange << "," << symbol << "," 
-                    << side << "," << quantity << "," << price << "," 
-                    << (quantity * price) << "\n";
+
+        hft::IoLine line;
+        line << time_t << "," << exchange << "," << symbol << ","
+             << side << "," << quantity << "," << price << ","
+             << (quantity * price) << "\n";
+        hft::IoService::instance().write(trade_file_, line);
+    }
+
+    static size_t index_of(hft::Venue venue, hft::SymbolId symbol) {
+        return static_cast<size_t>(venue) * hft::SymbolTable::MAX_SYMBOLS + symbol;
+    }
+
+    static bool valid_key(hft::Venue venue, hft::SymbolId symbol) {
+        return static_cast<size_t>(venue) < hft::VENUE_COUNT && symbol < hft::SymbolTable::MAX_SYMBOLS;
+    }
+
+    static bool parse_venue(const std::string& exchange, hft::Venue& venue) {
+        return hft::venue_from_name(exchange.c_str(), venue);
+    }
+
+    static uint64_t now_ns() {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::high_resolution_clock::now().time_since_epoch()).count();
+    }
+
+    // Existing slot for a key, or nullptr (never allocates)
+    const PositionSlot* find_slot(hft::Venue venue, hft::SymbolId symbol) const {
+        if (!valid_key(venue, symbol)) return nullptr;
+        const uint32_t slot = slot_index_[index_of(venue, symbol)].load(std::memory_order_acquire);
+        return slot < CLAIMING_SLOT ? &slots_[slot] : nullptr;
+    }
+
+    // Slot for a key, claiming one on first use; nullptr if the table is full
+    PositionSlot* claim_slot(hft::Venue venue, hft::SymbolId symbol) {
+        if (!valid_key(venue, symbol)) return nullptr;
+        std::atomic<uint32_t>& cell = slot_index_[index_of(venue, symbol)];
+
+        uint32_t slot = cell.load(std::memory_order_acquire);
+        while (slot >= CLAIMING_SLOT) {
+            if (slot == EMPTY_SLOT &&
+                cell.compare_exchange_weak(slot, CLAIMING_SLOT, std::memory_order_acquire)) {
+                const size_t next = next_slot_.fetch_add(1, std::memory_order_relaxed);
+                if (next >= max_positions_) {
+                    slot_overflows_.fetch_add(1, std::memory_order_relaxed);
+                    cell.store(EMPTY_SLOT, std::memory_order_release);
+                    return nullptr;
+                }
+                PositionSlot& claimed = slots_[next];
+                claimed.venue = venue;
+                claimed.symbol = symbol;
+                const std::string& name = hft::SymbolTable::instance().name(symbol);
+                claimed.asset = name.find("BTC") != std::string::npos ? Asset::BTC
+                              : name.find("ETH") != std::string::npos ? Asset::ETH
+                              : Asset::NONE;
+                claimed.ready.store(true, std::memory_order_release);
+                cell.store(static_cast<uint32_t>(next), std::memory_order_release);
+                return &claimed;
+            }
+            // Another thread is claiming this key
+            slot = cell.load(std::memory_order_acquire);
         }
+        return &slots_[slot];
+    }
+
+    size_t slot_count() const {
+        const size_t claimed = next_slot_.load(std::memory_order_acquire);
+        return claimed < max_positions_ ? claimed : max_positions_;
+    }
+
+    // Re-mark a slot after its position or mark changed (runs inside the slot write)
+    static void revalue(SlotState& state) {
+        Position& position = state.position;
+        if (state.mark_price > 0.0) position.update_unrealized_pnl(state.mark_price);
+        const double price = state.mark_price > 0.0 ? state.mark_price : position.avg_price;
+        state.net_exposure = position.quantity * price;
+    }
+
+    /**
+     * Apply change to a slot and fold the change in its contribution into
+     * the running aggregates
+     */
+    template<typename Fn>
+    void update_slot(PositionSlot& slot, Fn&& change) {
+        double realized = 0.0, unrealized = 0.0, net = 0.0, gross = 0.0;
+        slot.state.write([&](SlotState& state) {
+            const SlotState before = state;
+            change(state);
+            revalue(state);
+            realized = state.position.realized_pnl - before.position.realized_pnl;
+            unrealized = state.position.unrealized_pnl - before.position.unrealized_pnl;
+            net = state.net_exposure - before.net_exposure;
+            gross = std::abs(state.net_exposure) - std::abs(before.net_exposure);
+        });
+        if (realized != 0.0) total_realized_pnl_.fetch_add(realized, std::memory_order_relaxed);
+        if (unrealized != 0.0) total_unrealized_pnl_.fetch_add(unrealized, std::memory_order_relaxed);
+        if (net != 0.0) {
+            net_exposure_.fetch_add(net, std::memory_order_relaxed);
+            symbol_exposure_[slot.symbol].fetch_add(net, std::memory_order_relaxed);
+        }
+        if (gross != 0.0) gross_exposure_.fetch_add(gross, std::memory_order_relaxed);
+    }
+
+    /**
+     * Apply change to a venue balance and re-value the venue at current marks
+     */
+    template<typename Fn>
+    void update_venue(hft::Venue venue, Fn&& change) {
+        const size_t v = static_cast<size_t>(venue);
+        double delta = 0.0;
+        books_[v].write([&](VenueBook& book) {
+            change(book.balance);
+            const bool held = balance_venues_.load(std::memory_order_acquire) & (1u << v);
+            const double equity = held ? balance_equity(venue, book.balance) : 0.0;
+            delta = equity - book.equity;
+            book.equity = equity;
+        });
+        if (delta != 0.0) total_equity_.fetch_add(delta, std::memory_order_relaxed);
+    }
+
+    double mark_of(hft::Venue venue, hft::SymbolId symbol) const {
+        const PositionSlot* slot = find_slot(venue, symbol);
+        return slot ? slot->mark_price.load(std::memory_order_relaxed) : 0.0;
+    }
+
+    double balance_equity(hft::Venue venue, const ExchangeBalance& balance) const {
+        return balance.usd_balance + balance.btc_balance * mark_of(venue, btc_symbol_)
+                                   + balance.eth_balance * mark_of(venue, eth_symbol_);
     }
 
 public:
-    PositionTracker() {
-        trading_session_start_ = std::chrono::duration_cast<std::chrono::nanoseconds>(
-            std::chrono::high_resolution_clock::now().time_since_epoch()).count();
-        
+    explicit PositionTracker(size_t max_positions = DEFAULT_MAX_POSITIONS)
+        : max_positions_(max_positions)
+        , slot_index_(std::make_unique<std::atomic<uint32_t>[]>(hft::VENUE_COUNT * hft::SymbolTable::MAX_SYMBOLS))
+        , slots_(std::make_unique<PositionSlot[]>(max_positions))
+        , btc_symbol_(hft::SymbolTable::instance().intern("BTC/USD"))
+        , eth_symbol_(hft::SymbolTable::instance().intern("ETH/USD"))
+        , symbol_exposure_(std::make_unique<std::atomic<double>[]>(hft::SymbolTable::MAX_SYMBOLS)) {
+        trading_session_start_ = now_ns();
+
+        for (size_t i = 0; i < hft::VENUE_COUNT * hft::SymbolTable::MAX_SYMBOLS; ++i) {
+            slot_index_[i].store(EMPTY_SLOT, std::memory_order_relaxed);
+        }
+        for (size_t i = 0; i < hft::SymbolTable::MAX_SYMBOLS; ++i) {
+            symbol_exposure_[i].store(0.0, std::memory_order_relaxed);
+        }
+        for (auto& buffer : snapshots_) {
+            buffer.entries = std::make_unique<PositionEntry[]>(max_positions);
+        }
+
         // Initialize exchange balances
-        balances_["COINBASE"] = ExchangeBalance{};
-        balances_["BINANCE"] = ExchangeBalance{};
-        
+        balance_venues_.store((1u << static_cast<uint32_t>(hft::Venue::COINBASE)) |
+                              (1u << static_cast<uint32_t>(hft::Venue::BINANCE)));
+        update_venue(hft::Venue::COINBASE, [](ExchangeBalance&) {});
+        update_venue(hft::Venue::BINANCE, [](ExchangeBalance&) {});
+
         // Initialize slippage models
         slippage_models_["BTC/USD"] = SlippageModel{};
         slippage_models_["ETH/USD"] = SlippageModel{};
-        
+
         // Initialize average volumes (simplified estimates)
         average_volumes_["BTC/USD"] = 100.0;  // 100 BTC average volume
         average_volumes_["ETH/USD"] = 1000.0; // 1000 ETH average volume
-        
-        // Create trade log header
-        std::ofstream log_file("trade_log.csv");
-        if (log_file.is_open()) {
-            log_file << "timestamp,exchange,symbol,side,quantity,price,notional\n";
-        }
+
+        // Trade log: truncated with a header when the process first opens it
+        hft::IoService::FileOptions trades;
+        trades.truncate = true;
+        trades.header = "timestamp,exchange,symbol,side,quantity,price,notional\n";
+        trades.rotate_bytes = 64 * 1024 * 1024;
+        trade_file_ = hft::IoService::instance().open("trade_log.csv", trades);
     }
-    
-    void update_market_price(const std::string& exchange, const std::string& symbol, double price) {
-        std::lock_guard<std::mutex> lock(mutex_);
-        market_prices_[exchange][symbol] = price;
-        
-        // Update unrealized P&L for this symbol
-        if (positions_[exchange].count(symbol)) {
-            positions_[exchange][symbol].update_unrealized_pnl(price);
+
+    PositionTracker(const PositionTracker&) = delete;
+    PositionTracker& operator=(const PositionTracker&) = delete;
+
+    // ========== Fast path: (venue, SymbolId) ==========
+
+    void update_market_price(hft::Venue venue, hft::SymbolId symbol, double price) {
+        PositionSlot* slot = claim_slot(venue, symbol);
+        if (!slot) return;
+
+        writes_in_flight_.fetch_add(1);
+        update_slot(*slot, [&](SlotState& state) {
+            state.mark_price = price;
+            slot->mark_price.store(price, std::memory_order_relaxed);
+        });
+        // Balances are valued at the BTC/USD and ETH/USD marks
+        if (symbol == btc_symbol_ || symbol == eth_symbol_) {
+            update_venue(venue, [](ExchangeBalance&) {});
         }
+        state_version_.fetch_add(1);
+        writes_in_flight_.fetch_sub(1);
+
+        update_performance_metrics();
     }
-    
-    void add_trade(const std::string& exchange, const std::string& symbol, 
-                   double quantity, double price) {
-        std::lock_guard<std::mutex> lock(mutex_);
-        
+
+    void add_trade(hft::Venue venue, hft::SymbolId symbol, double quantity, double price) {
+        PositionSlot* slot = claim_slot(venue, symbol);
+        if (!slot) return;
+
+        writes_in_flight_.fetch_add(1);
+
         // Update position
-        positions_[exchange][symbol].add_trade(quantity, price);
-        
+        update_slot(*slot, [&](SlotState& state) { state.position.add_trade(quantity, price); });
+
         // Update balances (simplified - assumes USD settlement)
-        double notional = quantity * price;
-        if (symbol.find("BTC") != std::string::npos) {
-            balances_[exchange].update_balance("BTC", quantity, quantity);
-            balances_[exchange].update_balance("USD", -notional, -notional);
-        } else if (symbol.find("ETH") != std::string::npos) {
-            balances_[exchange].update_balance("ETH", quantity, quantity);
-            balances_[exchange].update_balance("USD", -notional, -notional);
+        if (slot->asset != Asset::NONE) {
+            const double notional = quantity * price;
+            const char* asset = slot->asset == Asset::BTC ? "BTC" : "ETH";
+            balance_venues_.fetch_or(1u << static_cast<uint32_t>(venue), std::memory_order_release);
+            update_venue(venue, [&](ExchangeBalance& balance) {
+                balance.update_balance(asset, quantity, quantity);
+                balance.update_balance("USD", -notional, -notional);
+            });
         }
-        
-        // Log the trade
-        log_trade(exchange, symbol, quantity, price, quantity > 0 ? "BUY" : "SELL");
-        
-        // Update performance metrics
+        state_version_.fetch_add(1);
+        writes_in_flight_.fetch_sub(1);
+
         update_performance_metrics();
+
+        if (journal_) journal_->append_fill(venue, symbol, quantity, price, now_ns());
+        log_trade(hft::venue_name(venue), hft::SymbolTable::instance().name(symbol),
+                  quantity, price, quantity > 0 ? "BUY" : "SELL");
     }
-    
-    void add_trade_with_slippage(const std::string& exchange, 
+
+    Position get_position(hft::Venue venue, hft::SymbolId symbol) const {
+        const PositionSlot* slot = find_slot(venue, symbol);
+        return slot ? slot->state.load().position : Position{};
+    }
+
+    // Balance held on a venue (one SeqLock copy); false if the venue holds none
+    bool get_balance(hft::Venue venue, ExchangeBalance& out) const {
+        const uint32_t v = static_cast<uint32_t>(venue);
+        if (v >= hft::VENUE_COUNT || !(balance_venues_.load(std::memory_order_acquire) & (1u << v))) return false;
+        out = books_[v].load().balance;
+        return true;
+    }
+
+    /**
+     * Deposit or withdraw an asset ("BTC", "ETH" or "USD") outside of trading
+     */
+    void adjust_balance(hft::Venue venue, const char* asset, double delta_total, double delta_available) {
+        if (static_cast<size_t>(venue) >= hft::VENUE_COUNT) return;
+
+        writes_in_flight_.fetch_add(1);
+        balance_venues_.fetch_or(1u << static_cast<uint32_t>(venue), std::memory_order_release);
+        update_venue(venue, [&](ExchangeBalance& balance) {
+            balance.update_balance(asset, delta_total, delta_available);
+        });
+        state_version_.fetch_add(1);
+        writes_in_flight_.fetch_sub(1);
+
+        update_performance_metrics();
+
+        if (journal_) journal_->append_balance(venue, asset, delta_total, delta_available, now_ns());
+    }
+
+    // ========== String-keyed API ==========
+
+    void update_market_price(const std::string& exchange, const std::string& symbol, double price) {
+        hft::Venue venue;
+        if (!parse_venue(exchange, venue)) return;
+        update_market_price(venue, hft::SymbolTable::instance().intern(symbol), price);
+    }
+
+    void add_trade(const std::string& exchange, const std::string& symbol,
+                   double quantity, double price) {
+        hft::Venue venue;
+        if (!parse_venue(exchange, venue)) return;
+        add_trade(venue, hft::SymbolTable::instance().intern(symbol), quantity, price);
+    }
+
+    void add_trade_with_slippage(const std::string& exchange,
                                  const std::string& symbol,
-                                 double quantity, 
+                                 double quantity,
                                  double quoted_price,
                                  bool is_taker = true) {
-        double slippage = slippage_models_[symbol].calculate_slippage(
-            quantity, average_volumes_[symbol], 0.001, is_taker);
-        
-        double executed_price = quoted_price * (1.0 + 
+        static const SlippageModel default_model{};
+        auto model_it = slippage_models_.find(symbol);
+        auto volume_it = average_volumes_.find(symbol);
+        const SlippageModel& model = model_it != slippage_models_.end() ? model_it->second : default_model;
+        const double avg_volume = volume_it != average_volumes_.end() ? volume_it->second : 0.0;
+
+        // No recorded volume: participation is undefined, so execute at the quote
+        double slippage = avg_volume > 0.0 ? model.calculate_slippage(quantity, avg_volume, 0.001, is_taker)
+                                           : 0.0;
+
+        double executed_price = quoted_price * (1.0 +
             (quantity > 0 ? slippage : -slippage));
-        
+
         add_trade(exchange, symbol, quantity, executed_price);
     }
-    
+
     Position get_position(const std::string& exchange, const std::string& symbol) const {
-        std::lock_guard<std::mutex> lock(mutex_);
-        auto exchange_it = positions_.find(exchange);
-        if (exchange_it != positions_.end()) {
-            auto symbol_it = exchange_it->second.find(symbol);
-            if (symbol_it != exchange_it->second.end()) {
-                return symbol_it->second;
-            }
-        }
-        return Position{}; // Return empty position if not found
+        hft::Venue venue;
+        if (!parse_venue(exchange, venue)) return Position{};
+        const hft::SymbolId id = hft::SymbolTable::instance().find(symbol);
+        return id != hft::SymbolTable::INVALID_SYMBOL ? get_position(venue, id) : Position{};
     }
-    
+
     ExchangeBalance get_balance(const std::string& exchange) const {
-        std::lock_guard<std::mutex> lock(mutex_);
-        auto it = balances_.find(exchange);
-        if (it != balances_.end()) {
-            return it->second;
-        }
-        return ExchangeBalance{};
+        hft::Venue venue;
+        if (!parse_venue(exchange, venue)) return ExchangeBalance{};
+        return books_[static_cast<size_t>(venue)].load().balance;
     }
-    
+
+    // ========== Aggregates (O(1), lock-free) ==========
+
     double get_total_equity() const {
-        std::lock_guard<std::mutex> lock(mutex_);
-        double total_equity = 0.0;
-        
-        for (const auto& [exchange, balance] : balances_) {
-            total_equity += balance.usd_balance;
-            
-            // Add BTC value (assuming current market price)
-            if (market_prices_.count(exchange) && market_prices_.at(exchange).count("BTC/USD")) {
-                double btc_price = market_prices_.at(exchange).at("BTC/USD");
-                total_equity += balance.btc_balance * btc_price;
-            }
-            
-            // Add ETH value
-            if (market_prices_.count(exchange) && market_prices_.at(exchange).count("ETH/USD")) {
-                double eth_price = market_prices_.at(exchange).at("ETH/USD");
-                total_equity += balance.eth_balance * eth_price;
-            }
-        }
-        
-        return total_equity;
+        return total_equity_.load(std::memory_order_relaxed);
     }
-    
+
     double get_total_unrealized_pnl() const {
-        std::lock_guard<std::mutex> lock(mutex_);
-        double total_unrealized = 0.0;
-        
-        for (const auto& [exchange, symbols] : positions_) {
-            for (const auto& [symbol, position] : symbols) {
-                total_unrealized += position.unrealized_pnl;
+        return total_unrealized_pnl_.load(std::memory_order_relaxed);
+    }
+
+    double get_total_realized_pnl() const {
+        return total_realized_pnl_.load(std::memory_order_relaxed);
+    }
+
+    double get_gross_exposure() const {
+        return gross_exposure_.load(std::memory_order_relaxed);
+    }
+
+    double get_net_exposure() const {
+        return net_exposure_.load(std::memory_order_relaxed);
+    }
+
+    // Net exposure to one symbol across all venues
+    double get_symbol_exposure(hft::SymbolId symbol) const {
+        return symbol < hft::SymbolTable::MAX_SYMBOLS ? symbol_exposure_[symbol].load(std::memory_order_relaxed) : 0.0;
+    }
+
+    PortfolioAggregates get_aggregates() const {
+        PortfolioAggregates aggregates;
+        aggregates.total_equity = get_total_equity();
+        aggregates.realized_pnl = get_total_realized_pnl();
+        aggregates.unrealized_pnl = get_total_unrealized_pnl();
+        aggregates.gross_exposure = get_gross_exposure();
+        aggregates.net_exposure = get_net_exposure();
+        return aggregates;
+    }
+
+    /**
+     * Recompute every aggregate from the slots and balances and correct
+     * any that drifted from the running totals by more than tolerance
+     *
+     * Only conclusive while no fill or mark is in flight; otherwise it
+     * does nothing and returns true.
+     *
+     * @return false if a correction was applied
+     */
+    bool verify_aggregates(double tolerance = 1e-6) {
+        if (writes_in_flight_.load() != 0) return true;
+        const uint64_t version = state_version_.load();
+
+        PortfolioAggregates actual;
+        std::vector<double> symbols(hft::SymbolTable::MAX_SYMBOLS, 0.0);
+        const size_t count = slot_count();
+        for (size_t i = 0; i < count; ++i) {
+            const PositionSlot& slot = slots_[i];
+            if (!slot.ready.load(std::memory_order_acquire)) continue;
+            const SlotState state = slot.state.load();
+            actual.realized_pnl += state.position.realized_pnl;
+            actual.unrealized_pnl += state.position.unrealized_pnl;
+            actual.net_exposure += state.net_exposure;
+            actual.gross_exposure += std::abs(state.net_exposure);
+            symbols[slot.symbol] += state.net_exposure;
+        }
+        const uint32_t venues = balance_venues_.load(std::memory_order_acquire);
+        for (size_t v = 0; v < hft::VENUE_COUNT; ++v) {
+            if (venues & (1u << v)) {
+                actual.total_equity += balance_equity(static_cast<hft::Venue>(v), books_[v].load().balance);
             }
         }
-        
-        return total_unrealized;
+
+        const PortfolioAggregates running = get_aggregates();
+        if (writes_in_flight_.load() != 0 || state_version_.load() != version) return true;
+
+        bool clean = true;
+        auto correct = [&](std::atomic<double>& total, double running_value, double actual_value) {
+            const double drift = actual_value - running_value;
+            if (std::abs(drift) > tolerance * std::max(1.0, std::abs(actual_value))) {
+                total.fetch_add(drift, std::memory_order_relaxed);
+                clean = false;
+            }
+        };
+        correct(total_equity_, running.total_equity, actual.total_equity);
+        correct(total_realized_pnl_, running.realized_pnl, actual.realized_pnl);
+        correct(total_unrealized_pnl_, running.unrealized_pnl, actual.unrealized_pnl);
+        correct(gross_exposure_, running.gross_exposure, actual.gross_exposure);
+        correct(net_exposure_, running.net_exposure, actual.net_exposure);
+        std::vector<bool> checked(hft::SymbolTable::MAX_SYMBOLS, false);
+        for (size_t i = 0; i < count; ++i) {
+            const hft::SymbolId symbol = slots_[i].symbol;
+            if (checked[symbol]) continue;
+            checked[symbol] = true;
+            correct(symbol_exposure_[symbol], symbol_exposure_[symbol].load(std::memory_order_relaxed), symbols[symbol]);
+        }
+
+        if (!clean) aggregate_corrections_.fetch_add(1, std::memory_order_relaxed);
+        return clean;
     }
-    
-    double get_total_realized_pnl() const {
-        return total_realized_pnl_;
+
+    uint64_t aggregate_corrections() const {
+        return aggregate_corrections_.load(std::memory_order_relaxed);
     }
-    
+
     double get_daily_pnl() const {
-        return daily_pnl_;
+        return daily_pnl_.load(std::memory_order_relaxed);
     }
-    
+
     double get_max_drawdown() const {
-        return max_drawdown_;
+        return max_drawdown_.load(std::memory_order_relaxed);
     }
-    
-    // Get all positions across all exchanges and symbols
+
+    double get_peak_equity() const {
+        return peak_equity_.load(std::memory_order_relaxed);
+    }
+
+    void set_logging_enabled(bool enabled) {
+        logging_enabled_.store(enabled, std::memory_order_relaxed);
+    }
+
+    bool logging_enabled() const {
+        return logging_enabled_.load(std::memory_order_relaxed);
+    }
+
+    // Journal that fills and balance adjustments are appended to (nullptr to detach)
+    void set_journal(hft::TradeJournal* journal) { journal_ = journal; }
+    hft::TradeJournal* journal() const { return journal_; }
+
+    /**
+     * Load positions, marks and balances from a snapshot (recovery only;
+     * nothing else may touch the tracker meanwhile). Running aggregates
+     * follow by delta as usual.
+     */
+    void restore(const PortfolioSnapshot& snapshot, double peak_equity, double max_drawdown) {
+        for (const auto& entry : snapshot.positions) {
+            PositionSlot* slot = claim_slot(entry.venue, entry.symbol);
+            if (!slot) continue;
+            slot->mark_price.store(entry.mark_price, std::memory_order_relaxed);
+            update_slot(*slot, [&](SlotState& state) {
+                state.position = entry.position;
+                state.mark_price = entry.mark_price;
+            });
+        }
+
+        balance_venues_.fetch_or(snapshot.balance_venues, std::memory_order_release);
+        for (size_t v = 0; v < hft::VENUE_COUNT; ++v) {
+            if (!(snapshot.balance_venues & (1u << v))) continue;
+            update_venue(static_cast<hft::Venue>(v), [&](ExchangeBalance& balance) {
+                balance = snapshot.balances[v];
+            });
+        }
+
+        peak_equity_.store(peak_equity, std::memory_order_relaxed);
+        max_drawdown_.store(max_drawdown, std::memory_order_relaxed);
+        state_version_.fetch_add(1);
+        update_performance_metrics();
+    }
+
+    uint64_t slot_overflows() const {
+        return slot_overflows_.load(std::memory_order_relaxed);
+    }
+
+    // ========== Snapshots ==========
+
+    /**
+     * Publish a snapshot of every slot and balance if anything changed
+     * since the last one
+     *
+     * Writes the back buffer then flips the epoch, so readers of the front
+     * buffer are not disturbed. If another thread is already publishing,
+     * returns without waiting.
+     *
+     * @return Epoch of the latest published snapshot
+     */
+    uint64_t publish_snapshot() const {
+        if (publishing_.exchange(true, std::memory_order_acquire)) {
+            return published_epoch_.load(std::memory_order_acquire);
+        }
+
+        uint64_t epoch = published_epoch_.load(std::memory_order_relaxed);
+        const uint64_t version = state_version_.load(std::memory_order_acquire);
+        if (epoch == 0 || version != published_version_) {
+            ++epoch;
+            SnapshotBuffer& buffer = snapshots_[epoch & 1];
+            const uint32_t seq = buffer.seq.load(std::memory_order_relaxed);
+            buffer.seq.store(seq + 1, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_release);
+
+            buffer.epoch = epoch;
+            buffer.timestamp_ns = now_ns();
+            buffer.realized_pnl = 0.0;
+            buffer.unrealized_pnl = 0.0;
+            size_t count = 0;
+            const size_t slots = slot_count();
+            for (size_t i = 0; i < slots; ++i) {
+                const PositionSlot& slot = slots_[i];
+                if (!slot.ready.load(std::memory_order_acquire)) continue;
+                PositionEntry& entry = buffer.entries[count++];
+                entry.venue = slot.venue;
+                entry.symbol = slot.symbol;
+                const SlotState state = slot.state.load();
+                entry.position = state.position;
+                entry.mark_price = state.mark_price;
+                buffer.realized_pnl += entry.position.realized_pnl;
+                buffer.unrealized_pnl += entry.position.unrealized_pnl;
+            }
+            buffer.count = count;
+
+            buffer.balance_venues = balance_venues_.load(std::memory_order_acquire);
+            buffer.total_equity = 0.0;
+            for (size_t v = 0; v < hft::VENUE_COUNT; ++v) {
+                const VenueBook book = books_[v].load();
+                buffer.balances[v] = book.balance;
+                if (buffer.balance_venues & (1u << v)) buffer.total_equity += book.equity;
+            }
+
+            buffer.seq.store(seq + 2, std::memory_order_release);
+            published_version_ = version;
+            published_epoch_.store(epoch, std::memory_order_release);
+        }
+
+        publishing_.store(false, std::memory_order_release);
+        return epoch;
+    }
+
+    /**
+     * Copy the latest snapshot into out (reuses out's storage)
+     *
+     * @param refresh Publish first if the book changed since the last snapshot
+     * @return false if nothing has been published yet
+     */
+    bool read_snapshot(PortfolioSnapshot& out, bool refresh = true) const {
+        if (refresh) publish_snapshot();
+
+        for (;;) {
+            const uint64_t epoch = published_epoch_.load(std::memory_order_acquire);
+            if (epoch == 0) {
+                out = PortfolioSnapshot{};
+                return false;
+            }
+
+            const SnapshotBuffer& buffer = snapshots_[epoch & 1];
+            const uint32_t before = buffer.seq.load(std::memory_order_acquire);
+            if (before & 1) continue;
+
+            const size_t count = buffer.count < max_positions_ ? buffer.count : max_positions_;
+            out.positions.resize(count);
+            for (size_t i = 0; i < count; ++i) out.positions[i] = buffer.entries[i];
+            out.epoch = buffer.epoch;
+            out.timestamp_ns = buffer.timestamp_ns;
+            out.balances = buffer.balances;
+            out.balance_venues = buffer.balance_venues;
+            out.total_equity = buffer.total_equity;
+            out.realized_pnl = buffer.realized_pnl;
+            out.unrealized_pnl = buffer.unrealized_pnl;
+
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (buffer.seq.load(std::memory_order_relaxed) == before) return true;
+        }
+    }
+
+    uint64_t snapshot_epoch() const {
+        return published_epoch_.load(std::memory_order_acquire);
+    }
+
+    // Get all positions across all exchanges and symbols (built from a snapshot)
     std::unordered_map<std::string, std::unordered_map<std::string, Position>> get_all_positions() const {
-        std::lock_guard<std::mutex> lock(mutex_);
-        return positions_;
+        PortfolioSnapshot snapshot;
+        read_snapshot(snapshot);
+
+        std::unordered_map<std::string, std::unordered_map<std::string, Position>> positions;
+        for (const auto& entry : snapshot.positions) {
+            positions[hft::venue_name(entry.venue)][hft::SymbolTable::instance().name(entry.symbol)] = entry.position;
+        }
+        return positions;
     }
-    
-    bool can_trade(const std::string& exchange, const std::string& symbol, 
+
+    bool can_trade(const std::string& exchange, const std::string& symbol,
                    double quantity, double price) const {
-        std::lock_guard<std::mutex> lock(mutex_);
-        
-        auto balance_it = balances_.find(exchange);
-        if (balance_it == balances_.end()) return false;
-        
-        const auto& balance = balance_it->second;
+        hft::Venue venue;
+        if (!parse_venue(exchange, venue)) return false;
+        if (!(balance_venues_.load(std::memory_order_acquire) & (1u << static_cast<uint32_t>(venue)))) return false;
+
+        const ExchangeBalance balance = books_[static_cast<size_t>(venue)].load().balance;
         double notional = std::abs(quantity * price);
-        
+
         if (quantity > 0) {
             // Buying - need USD
             return balance.has_sufficient_balance("USD", notional);
@@ -313,35 +863,38 @@ public:
                 return balance.has_sufficient_balance("ETH", std::abs(quantity));
             }
         }
-        
+
         return false;
     }
-    
+
     void print_status() const {
-        std::lock_guard<std::mutex> lock(mutex_);
-        
+        PortfolioSnapshot snapshot;
+        read_snapshot(snapshot);
+
         printf("\n📊 === POSITION TRACKER STATUS ===\n");
-        printf("💰 Total Equity: $%.2f\n", get_total_equity());
-        printf("📈 Total Realized P&L: $%.2f\n", total_realized_pnl_);
-        printf("📊 Total Unrealized P&L: $%.2f\n", get_total_unrealized_pnl());
-        printf("📅 Daily P&L: $%.2f\n", daily_pnl_);
-        printf("📉 Max Drawdown: $%.2f\n", max_drawdown_);
-        
+        printf("💰 Total Equity: $%.2f\n", snapshot.total_equity);
+        printf("📈 Total Realized P&L: $%.2f\n", snapshot.realized_pnl);
+        printf("📊 Total Unrealized P&L: $%.2f\n", snapshot.unrealized_pnl);
+        printf("📐 Exposure: gross $%.2f, net $%.2f\n", get_gross_exposure(), get_net_exposure());
+        printf("📅 Daily P&L: $%.2f\n", get_daily_pnl());
+        printf("📉 Max Drawdown: $%.2f\n", get_max_drawdown());
+
         printf("\n🏛️ Exchange Balances:\n");
-        for (const auto& [exchange, balance] : balances_) {
-            printf("  %s: $%.2f USD, %.6f BTC, %.4f ETH\n", 
-                   exchange.c_str(), balance.usd_available, 
+        for (size_t v = 0; v < hft::VENUE_COUNT; ++v) {
+            if (!(snapshot.balance_venues & (1u << v))) continue;
+            const ExchangeBalance& balance = snapshot.balances[v];
+            printf("  %s: $%.2f USD, %.6f BTC, %.4f ETH\n",
+                   hft::venue_name(static_cast<hft::Venue>(v)), balance.usd_available,
                    balance.btc_available, balance.eth_available);
         }
-        
+
         printf("\n📋 Active Positions:\n");
-        for (const auto& [exchange, symbols] : positions_) {
-            for (const auto& [symbol, position] : symbols) {
-                if (std::abs(position.quantity) > 1e-8) {
-                    printf("  %s %s: %.6f @ $%.2f (P&L: $%.2f)\n",
-                           exchange.c_str(), symbol.c_str(), position.quantity,
-                           position.avg_price, position.total_pnl());
-                }
+        for (const auto& entry : snapshot.positions) {
+            const Position& position = entry.position;
+            if (std::abs(position.quantity) > 1e-8) {
+                printf("  %s %s: %.6f @ $%.2f (P&L: $%.2f)\n",
+                       hft::venue_name(entry.venue), hft::SymbolTable::instance().name(entry.symbol).c_str(),
+                       position.quantity, position.avg_price, position.total_pnl());
             }
         }
         printf("=====================================\n\n");
@@ -349,27 +902,24 @@ public:
 
 private:
     void update_performance_metrics() {
-        double current_equity = get_total_equity();
-        
+        const double current_equity = get_total_equity();
+
         // Update peak and drawdown
-        if (current_equity > peak_equity_) {
-            peak_equity_ = current_equity;
-        } else {
-            double drawdown = peak_equity_ - current_equity;
-            if (drawdown > max_drawdown_) {
-                max_drawdown_ = drawdown;
-            }
+        double peak = peak_equity_.load(std::memory_order_relaxed);
+        while (current_equity > peak &&
+               !peak_equity_.compare_exchange_weak(peak, current_equity, std::memory_order_relaxed)) {}
+        if (current_equity < peak) {
+            const double drawdown = peak - current_equity;
+            double worst = max_drawdown_.load(std::memory_order_relaxed);
+            while (drawdown > worst &&
+                   !max_drawdown_.compare_exchange_weak(worst, drawdown, std::memory_order_relaxed)) {}
         }
-        
-        // Update total realized P&L
-        total_realized_pnl_ = 0.0;
-        for (const auto& [exchange, symbols] : positions_) {
-            for (const auto& [symbol, position] : symbols) {
-                total_realized_pnl_ += position.realized_pnl;
-            }
+
+        // Daily P&L (simplified - would need proper session tracking); only stored
+        // when it moves, so marks that leave equity alone don't dirty the line
+        const double daily_pnl = current_equity - 100000.0; // Starting equity
+        if (daily_pnl_.load(std::memory_order_relaxed) != daily_pnl) {
+            daily_pnl_.store(daily_pnl, std::memory_order_relaxed);
         }
-        
-        // Daily P&L (simplified - would need proper session tracking)
-        daily_pnl_ = current_equity - 100000.0; // Starting equity
     }
 };
@@ -0,0 +1,366 @@
+// rate_limiter.hpp - Lock-free order rate limiting: token buckets, sliding windows, hierarchical limits
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include "messages.hpp"
+
+namespace hft {
+
+/**
+ * Rate limit setting
+ *
+ * rate_per_second <= 0 disables the limit. burst is the number of orders
+ * that may go out back to back after an idle period (at least 1).
+ */
+struct RateLimit {
+    double rate_per_second = 0.0;
+    double burst = 1.0;
+};
+
+/**
+ * Atomic Token Bucket
+ *
+ * Implemented as a generic cell rate algorithm: the whole bucket is one
+ * atomic "theoretical arrival time" (TAT), and taking n tokens pushes it
+ * n emission intervals into the future. A request is allowed while the
+ * TAT stays within burst intervals of now. Equivalent to a token bucket
+ * refilled at rate_per_second with capacity burst, but needs no refill
+ * step and a single CAS, so any number of threads can consume from the
+ * same bucket without a lock.
+ *
+ * The limit (interval and burst) is a second atomic word, read once per
+ * call, so configure() may run while other threads are acquiring: each
+ * decision sees either the old limit or the new one. The interval is
+ * capped at MAX_INTERVAL_NS (~18 minutes per token) and the burst at
+ * 65535, in 1/256 steps.
+ */
+class alignas(64) TokenBucket {
+public:
+    static constexpr unsigned BURST_BITS = 24;              // Burst in 16.8 fixed point
+    static constexpr unsigned BURST_FRACTION_BITS = 8;
+    static constexpr uint64_t BURST_MASK = (1ULL << BURST_BITS) - 1;
+    static constexpr uint64_t MAX_INTERVAL_NS = (1ULL << (64 - BURST_BITS)) - 1;
+
+private:
+    std::atomic<uint64_t> tat_ns_{0};
+    std::atomic<uint64_t> limit_{0};    // interval_ns << BURST_BITS | burst; 0 = unlimited
+
+    static uint64_t interval_of(uint64_t limit) noexcept { return limit >> BURST_BITS; }
+
+    // burst * interval_ns; configure() keeps the product within 64 bits
+    static uint64_t tolerance_of(uint64_t limit) noexcept {
+        return (interval_of(limit) * (limit & BURST_MASK)) >> BURST_FRACTION_BITS;
+    }
+
+public:
+    TokenBucket() = default;
+    explicit TokenBucket(const RateLimit& limit) { configure(limit); }
+
+    TokenBucket(const TokenBucket&) = delete;
+    TokenBucket& operator=(const TokenBucket&) = delete;
+
+    void configure(const RateLimit& limit) noexcept {
+        if (limit.rate_per_second <= 0.0) {
+            limit_.store(0, std::memory_order_relaxed);
+            return;
+        }
+        const double interval = 1e9 / limit.rate_per_second;
+        const uint64_t interval_ns = interval >= static_cast<double>(MAX_INTERVAL_NS) ? MAX_INTERVAL_NS
+                                   : interval < 1.0 ? 1 : static_cast<uint64_t>(interval);
+        const double burst = std::min(limit.burst < 1.0 ? 1.0 : limit.burst,
+                                      static_cast<double>(BURST_MASK >> BURST_FRACTION_BITS));
+        uint64_t burst_fixed = static_cast<uint64_t>(burst * (1u << BURST_FRACTION_BITS));
+        burst_fixed = std::min(burst_fixed, UINT64_MAX / interval_ns);
+        limit_.store(interval_ns << BURST_BITS | burst_fixed, std::memory_order_relaxed);
+    }
+
+    /**
+     * Take tokens if available
+     * @return true if the tokens were taken
+     */
+    bool try_acquire(uint64_t now_ns, uint32_t tokens = 1) noexcept {
+        const uint64_t limit = limit_.load(std::memory_order_relaxed);
+        if (limit == 0) return true;
+
+        const uint64_t cost = interval_of(limit) * tokens;
+        const uint64_t tolerance = tolerance_of(limit);
+        uint64_t tat = tat_ns_.load(std::memory_order_relaxed);
+        for (;;) {
+            const uint64_t next = (tat > now_ns ? tat : now_ns) + cost;
+            if (next - now_ns > tolerance) return false;
+            if (tat_ns_.compare_exchange_weak(tat, next, std::memory_order_relaxed)) return true;
+        }
+    }
+
+    /**
+     * Return tokens taken by a request that was refused further down the line
+     */
+    void refund(uint32_t tokens = 1) noexcept {
+        const uint64_t limit = limit_.load(std::memory_order_relaxed);
+        if (limit == 0) return;
+
+        const uint64_t cost = interval_of(limit) * tokens;
+        uint64_t tat = tat_ns_.load(std::memory_order_relaxed);
+        while (!tat_ns_.compare_exchange_weak(tat, tat > cost ? tat - cost : 0, std::memory_order_relaxed)) {}
+    }
+
+    // Whole tokens available at now_ns
+    double available(uint64_t now_ns) const noexcept {
+        const uint64_t limit = limit_.load(std::memory_order_relaxed);
+        if (limit == 0) return 0.0;
+        const uint64_t tolerance = tolerance_of(limit);
+        const uint64_t tat = tat_ns_.load(std::memory_order_relaxed);
+        const uint64_t debt = tat > now_ns ? tat - now_ns : 0;
+        return debt >= tolerance ? 0.0 : static_cast<double>((tolerance - debt) / interval_of(limit));
+    }
+
+    bool unlimited() const noexcept { return limit_.load(std::memory_order_relaxed) == 0; }
+};
+
+/**
+ * Sliding Window Counter
+ *
+ * At most limit events in any window, tracked in BUCKETS fixed time
+ * buckets (the window slides one bucket at a time). Each bucket packs its
+ * epoch and count into one atomic word, so a stale bucket is reset and
+ * counted in the same CAS; buckets older than the window are simply
+ * ignored, never swept. The sum over the earlier buckets is cached per
+ * bucket epoch, so a check is normally two loads and a CAS rather than a
+ * pass over every bucket. Lock-free and allocation-free.
+ *
+ * Callers that check the same window from a hot loop can pass a Lease
+ * they own (one per thread): events are then taken from the bucket a few
+ * at a time and spent with plain loads and stores, so most checks make no
+ * shared read-modify-write at all.
+ */
+template<size_t BUCKETS = 16>
+class SlidingWindowCounter {
+    static_assert(BUCKETS >= 2, "Need at least two buckets");
+
+private:
+    static constexpr uint64_t COUNT_BITS = 24;
+    static constexpr uint64_t COUNT_MASK = (1ULL << COUNT_BITS) - 1;
+    static constexpr uint64_t EPOCH_MASK = (1ULL << (64 - COUNT_BITS)) - 1;
+
+    std::array<std::atomic<uint64_t>, BUCKETS> buckets_;    // epoch << COUNT_BITS | count
+    std::atomic<uint64_t> previous_;                        // epoch << COUNT_BITS | previous_count(epoch)
+    std::atomic<uint64_t> limit_;
+    uint64_t bucket_ns_;
+
+    static uint64_t pack(uint64_t epoch, uint64_t count) {
+        return ((epoch & EPOCH_MASK) << COUNT_BITS) | count;
+    }
+
+    // Count between at_least and at_most events into the current bucket if the
+    // window has room for at_least; returns the number counted (0 = refused)
+    uint64_t take(uint64_t epoch, uint64_t at_least, uint64_t at_most) noexcept {
+        const uint64_t limit = limit_.load(std::memory_order_relaxed);
+        const uint64_t previous = cached_previous_count(epoch);
+
+        std::atomic<uint64_t>& bucket = buckets_[epoch % BUCKETS];
+        uint64_t word = bucket.load(std::memory_order_relaxed);
+        for (;;) {
+            const uint64_t current = (word >> COUNT_BITS) == (epoch & EPOCH_MASK) ? word & COUNT_MASK : 0;
+            const uint64_t used = previous + current;
+            const uint64_t room = std::min(used < limit ? limit - used : 0, COUNT_MASK - current);
+            if (room < at_least) return 0;
+            const uint64_t taken = std::min(room, at_most);
+            if (bucket.compare_exchange_weak(word, pack(epoch, current + taken), std::memory_order_relaxed)) {
+                return taken;
+            }
+        }
+    }
+
+    // Events in the buckets before the current one that are still inside the window.
+    // Each index only ever holds epochs congruent to it, so a straight branch-free
+    // pass that keeps buckets aged 1..BUCKETS-1 is the same as walking back from epoch.
+    uint64_t previous_count(uint64_t epoch) const noexcept {
+        uint64_t total = 0;
+        for (size_t i = 0; i < BUCKETS; ++i) {
+            const uint64_t word = buckets_[i].load(std::memory_order_relaxed);
+            const uint64_t age = (epoch - (word >> COUNT_BITS)) & EPOCH_MASK;
+            total += (age - 1 < BUCKETS - 1) ? word & COUNT_MASK : 0;
+        }
+        return total;
+    }
+
+    // previous_count() summed once per bucket epoch and cached. A thread still
+    // counting into the previous bucket after the cache moved on (stale clock)
+    // goes unseen until the next bucket, so concurrent callers can overshoot
+    // the limit by at most one event each.
+    uint64_t cached_previous_count(uint64_t epoch) noexcept {
+        const uint64_t cached = previous_.load(std::memory_order_relaxed);
+        if ((cached >> COUNT_BITS) == (epoch & EPOCH_MASK) && (cached & COUNT_MASK) != COUNT_MASK) {
+            return cached & COUNT_MASK;
+        }
+        const uint64_t total = previous_count(epoch);
+        previous_.store(pack(epoch, total < COUNT_MASK ? total : COUNT_MASK), std::memory_order_relaxed);
+        return total;
+    }
+
+public:
+    // Events one thread took from a bucket ahead of use
+    struct Lease {
+        uint64_t epoch = ~0ULL;
+        uint64_t remaining = 0;
+    };
+
+    /**
+     * @param limit Events allowed per window (count per bucket is capped at 2^24 - 1)
+     * @param window_ns Window length; split into BUCKETS equal buckets
+     */
+    SlidingWindowCounter(uint64_t limit, uint64_t window_ns)
+        : previous_(pack(EPOCH_MASK, 0)), limit_(limit), bucket_ns_(window_ns / BUCKETS > 0 ? window_ns / BUCKETS : 1) {
+        for (auto& bucket : buckets_) bucket.store(pack(EPOCH_MASK, 0), std::memory_order_relaxed);
+    }
+
+    SlidingWindowCounter(const SlidingWindowCounter&) = delete;
+    SlidingWindowCounter& operator=(const SlidingWindowCounter&) = delete;
+
+    /**
+     * Count events if the window has room for them
+     * @return true if counted
+     */
+    bool try_acquire(uint64_t now_ns, uint32_t events = 1) noexcept {
+        return take(now_ns / bucket_ns_, events, events) != 0;
+    }
+
+    /**
+     * Count one event, spending from a thread-owned lease
+     *
+     * When the lease is empty or from an earlier bucket, up to lease_size
+     * events are taken from the current bucket in one CAS. Leased events
+     * left unspent when the bucket ends were counted but never used, so
+     * the window can undershoot its limit by lease_size - 1 events per
+     * thread per bucket; it never overshoots. A lowered limit applies to
+     * a thread once its current lease runs out.
+     * @return true if counted
+     */
+    bool try_acquire(uint64_t now_ns, Lease& lease, uint32_t lease_size) noexcept {
+        const uint64_t epoch = now_ns / bucket_ns_;
+        if (lease.epoch == epoch && lease.remaining > 0) [[likely]] {
+            --lease.remaining;
+            return true;
+        }
+        const uint64_t taken = take(epoch, 1, lease_size > 0 ? lease_size : 1);
+        if (taken == 0) return false;
+        lease.epoch = epoch;
+        lease.remaining = taken - 1;
+        return true;
+    }
+
+    // Events counted in the window ending at now_ns
+    uint64_t count(uint64_t now_ns) const noexcept {
+        const uint64_t epoch = now_ns / bucket_ns_;
+        const uint64_t word = buckets_[epoch % BUCKETS].load(std::memory_order_relaxed);
+        const uint64_t current = (word >> COUNT_BITS) == (epoch & EPOCH_MASK) ? word & COUNT_MASK : 0;
+        return previous_count(epoch) + current;
+    }
+
+    void set_limit(uint64_t limit) noexcept { limit_.store(limit, std::memory_order_relaxed); }
+    uint64_t limit() const noexcept { return limit_.load(std::memory_order_relaxed); }
+    uint64_t window_ns() const noexcept { return bucket_ns_ * BUCKETS; }
+};
+
+/**
+ * Hierarchical Rate Limiter
+ *
+ * Per-strategy, per-venue and global token buckets checked in that order;
+ * an order must fit all three, and tokens taken at an inner level are
+ * refunded if an outer level refuses. Strategy ids at or above
+ * max_strategies are only subject to the venue and global limits.
+ *
+ * try_acquire() is safe from any number of threads, never allocates, and
+ * costs a few atomic operations. Limits can be changed while orders flow:
+ * each bucket's limit is one atomic word, so a check sees a bucket's old
+ * or new limit, never a mix.
+ */
+class HierarchicalRateLimiter {
+public:
+    enum class Result : uint8_t {
+        ALLOWED = 0,
+        STRATEGY_LIMITED = 1,
+        VENUE_LIMITED = 2,
+        GLOBAL_LIMITED = 3
+    };
+
+    static constexpr size_t MAX_VENUES = 16;
+    static constexpr size_t DEFAULT_MAX_STRATEGIES = 64;
+
+private:
+    TokenBucket global_;
+    std::array<TokenBucket, MAX_VENUES> venues_;
+    std::unique_ptr<TokenBucket[]> strategies_;
+    size_t max_strategies_;
+
+    std::array<std::atomic<uint64_t>, 4> results_{};    // Indexed by Result
+
+public:
+    explicit HierarchicalRateLimiter(size_t max_strategies = DEFAULT_MAX_STRATEGIES)
+        : strategies_(std::make_unique<TokenBucket[]>(max_strategies))
+        , max_strategies_(max_strategies) {}
+
+    void set_global_limit(const RateLimit& limit) { global_.configure(limit); }
+
+    void set_venue_limit(Venue venue, const RateLimit& limit) {
+        const size_t v = static_cast<size_t>(venue);
+        if (v < MAX_VENUES) venues_[v].configure(limit);
+    }
+
+    void set_strategy_limit(StrategyId strategy, const RateLimit& limit) {
+        if (strategy < max_strategies_) strategies_[strategy].configure(limit);
+    }
+
+    Result try_acquire(StrategyId strategy, Venue venue, uint64_t now_ns, uint32_t tokens = 1) noexcept {
+        TokenBucket* strategy_bucket = strategy < max_strategies_ ? &strategies_[strategy] : nullptr;
+        const size_t v = static_cast<size_t>(venue);
+        TokenBucket* venue_bucket = v < MAX_VENUES ? &venues_[v] : nullptr;
+
+        Result result = Result::ALLOWED;
+        if (strategy_bucket && !strategy_bucket->try_acquire(now_ns, tokens)) {
+            result = Result::STRATEGY_LIMITED;
+        } else if (venue_bucket && !venue_bucket->try_acquire(now_ns, tokens)) {
+            if (strategy_bucket) strategy_bucket->refund(tokens);
+            result = Result::VENUE_LIMITED;
+        } else if (!global_.try_acquire(now_ns, tokens)) {
+            if (venue_bucket) venue_bucket->refund(tokens);
+            if (strategy_bucket) strategy_bucket->refund(tokens);
+            result = Result::GLOBAL_LIMITED;
+        }
+
+        results_[static_cast<size_t>(result)].fetch_add(1, std::memory_order_relaxed);
+        return result;
+    }
+
+    // Return tokens for a request refused after try_acquire() allowed it
+    void refund(StrategyId strategy, Venue venue, uint32_t tokens = 1) noexcept {
+        if (strategy < max_strategies_) strategies_[strategy].refund(tokens);
+        const size_t v = static_cast<size_t>(venue);
+        if (v < MAX_VENUES) venues_[v].refund(tokens);
+        global_.refund(tokens);
+    }
+
+    uint64_t count(Result result) const {
+        return results_[static_cast<size_t>(result)].load(std::memory_order_relaxed);
+    }
+
+    // Whole tokens left in the global bucket at now_ns (0 if unlimited)
+    double global_available(uint64_t now_ns) const noexcept { return global_.available(now_ns); }
+
+    void print_status() const {
+        printf("\n🚦 Order Rate Limiter Status:\n");
+        printf("   Allowed: %lu, Refused: strategy %lu, venue %lu, global %lu\n",
+               static_cast<unsigned long>(count(Result::ALLOWED)),
+               static_cast<unsigned long>(count(Result::STRATEGY_LIMITED)),
+               static_cast<unsigned long>(count(Result::VENUE_LIMITED)),
+               static_cast<unsigned long>(count(Result::GLOBAL_LIMITED)));
+    }
+};
+
+} // namespace hft
@@ -5,6 +5,8 @@
 #include <cstring>
 #include <array>
 #include <chrono>
+#include <memory>
+#include <type_traits>
 #include <sys/mman.h>
 #ifdef HAS_NUMA
 #include <numa.h>
@@ -487,4 +489,365 @@ private:
     }
 };
 
-} // namespace hft
\ No newline at end of file
+/**
+ * Typed Single Producer Single Consumer Queue
+ *
+ * Same design as SPSCRingBuffer (cached remote positions, cache-line
+ * separated producer/consumer state, power-of-2 masking) but carries any
+ * trivially copyable record instead of SequencedMessage. Used for
+ * component-local records such as strategy ticks and order intents.
+ *
+ * Performance characteristics:
+ * - Push/pop: ~5ns plus the record copy
+ * - No allocation after construction
+ */
+template<typename T, size_t SIZE>
+class SPSCQueue {
+    static_assert((SIZE & (SIZE - 1)) == 0, "Size must be power of 2");
+    static_assert(std::is_trivially_copyable_v<T>, "Queue records must be trivially copyable");
+
+private:
+    alignas(64) std::atomic<uint64_t> write_pos_{0};
+    uint64_t cached_read_pos_{0};
+
+    alignas(64) std::atomic<uint64_t> read_pos_{0};
+    uint64_t cached_write_pos_{0};
+
+    alignas(64) std::array<T, SIZE> buffer_{};
+
+    static constexpr uint64_t MASK = SIZE - 1;
+
+public:
+    /**
+     * Push a record (Producer side)
+     *
+     * @param item Record to copy in
+     * @return true if written, false if queue full
+     */
+    [[gnu::hot]]
+    bool push(const T& item) noexcept {
+        const uint64_t current_write = write_pos_.load(std::memory_order_relaxed);
+
+        if (current_write - cached_read_pos_ >= SIZE) {
+            cached_read_pos_ = read_pos_.load(std::memory_order_acquire);
+            if (current_write - cached_read_pos_ >= SIZE) {
+                return false;
+            }
+        }
+
+        buffer_[current_write & MASK] = item;
+        write_pos_.store(current_write + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * Pop a record (Consumer side)
+     *
+     * @param item Output record
+     * @return true if a record was read, false if queue empty
+     */
+    [[gnu::hot]]
+    bool pop(T& item) noexcept {
+        const uint64_t current_read = read_pos_.load(std::memory_order_relaxed);
+
+        if (current_read >= cached_write_pos_) {
+            cached_write_pos_ = write_pos_.load(std::memory_order_acquire);
+            if (current_read >= cached_write_pos_) {
+                return false;
+            }
+        }
+
+        item = buffer_[current_read & MASK];
+        read_pos_.store(current_read + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * Pop up to max_count records (Consumer side)
+     *
+     * @return Number of records read
+     */
+    [[gnu::hot]]
+    size_t pop_batch(T* items, size_t max_count) noexcept {
+        const uint64_t current_read = read_pos_.load(std::memory_order_relaxed);
+
+        if (current_read >= cached_write_pos_) {
+            cached_write_pos_ = write_pos_.load(std::memory_order_acquire);
+        }
+
+        const size_t to_read = std::min<size_t>(max_count, cached_write_pos_ - current_read);
+        for (size_t i = 0; i < to_read; ++i) {
+            items[i] = buffer_[(current_read + i) & MASK];
+        }
+
+        if (to_read > 0) {
+            read_pos_.store(current_read + to_read, std::memory_order_release);
+        }
+        return to_read;
+    }
+
+    inline size_t size() const noexcept {
+        return write_pos_.load(std::memory_order_acquire) -
+               read_pos_.load(std::memory_order_acquire);
+    }
+
+    inline bool empty() const noexcept { return size() == 0; }
+    static constexpr size_t capacity() noexcept { return SIZE; }
+};
+
+/**
+ * Typed Multi-Producer Single Consumer Queue
+ *
+ * Bounded queue with a per-slot sequence number (Vyukov style): producers
+ * claim a slot with one CAS on the tail and publish by storing the slot
+ * sequence, so a stalled producer never blocks the others from claiming.
+ *
+ * Performance characteristics:
+ * - Push: ~10-20ns under contention
+ * - Pop: ~5ns
+ */
+template<typename T, size_t SIZE>
+class MPSCQueue {
+    static_assert((SIZE & (SIZE - 1)) == 0, "Size must be power of 2");
+    static_assert(std::is_trivially_copyable_v<T>, "Queue records must be trivially copyable");
+
+private:
+    struct Slot {
+        std::atomic<uint64_t> sequence;
+        T data;
+    };
+
+    alignas(64) std::atomic<uint64_t> tail_{0};   // Producers
+    alignas(64) uint64_t head_{0};                // Consumer
+    alignas(64) std::array<Slot, SIZE> slots_;
+
+    static constexpr uint64_t MASK = SIZE - 1;
+
+public:
+    MPSCQueue() {
+        for (size_t i = 0; i < SIZE; ++i) {
+            slots_[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    /**
+     * Push a record (Producer side - thread safe)
+     *
+     * @return true if written, false if queue full
+     */
+    [[gnu::hot]]
+    bool push(const T& item) noexcept {
+        uint64_t pos = tail_.load(std::memory_order_relaxed);
+        while (true) {
+            Slot& slot = slots_[pos & MASK];
+            const uint64_t seq = slot.sequence.load(std::memory_order_acquire);
+            const int64_t diff = static_cast<int64_t>(seq) - static_cast<int64_t>(pos);
+
+            if (diff == 0) {
+                if (tail_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    slot.data = item;
+                    slot.sequence.store(pos + 1, std::memory_order_release);
+                    return true;
+                }
+            } else if (diff < 0) {
+                return false; // Full
+            } else {
+                pos = tail_.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    /**
+     * Push records into consecutive slots (Producer side - thread safe)
+     *
+     * All or nothing: the consumer sees the records back to back, with no
+     * other producer's record in between.
+     *
+     * @return true if all were written, false if the queue lacks room
+     */
+    [[gnu::hot]]
+    bool push_batch(const T* items, size_t count) noexcept {
+        if (count == 0) return true;
+        if (count > SIZE) return false;
+
+        uint64_t pos = tail_.load(std::memory_order_relaxed);
+        while (true) {
+            // Slots free up in order, so the last one being free means all of them are
+            const uint64_t last = pos + count - 1;
+            const uint64_t seq = slots_[last & MASK].sequence.load(std::memory_order_acquire);
+            const int64_t diff = static_cast<int64_t>(seq) - static_cast<int64_t>(last);
+
+            if (diff == 0) {
+                if (tail_.compare_exchange_weak(pos, pos + count, std::memory_order_relaxed)) {
+                    for (size_t i = 0; i < count; ++i) {
+                        Slot& slot = slots_[(pos + i) & MASK];
+                        slot.data = items[i];
+                        slot.sequence.store(pos + i + 1, std::memory_order_release);
+                    }
+                    return true;
+                }
+            } else if (diff < 0) {
+                return false; // Not enough room
+            } else {
+                pos = tail_.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    /**
+     * Pop a record (Consumer side - single thread only)
+     *
+     * @return true if a record was read, false if empty
+     */
+    [[gnu::hot]]
+    bool pop(T& item) noexcept {
+        Slot& slot = slots_[head_ & MASK];
+        if (slot.sequence.load(std::memory_order_acquire) != head_ + 1) {
+            return false;
+        }
+
+        item = slot.data;
+        slot.sequence.store(head_ + SIZE, std::memory_order_release);
+        ++head_;
+        return true;
+    }
+
+    static constexpr size_t capacity() noexcept { return SIZE; }
+};
+
+/**
+ * Single Producer Single Consumer Byte Ring
+ *
+ * Variable-length records in place: the producer reserves a contiguous
+ * record, fills it and publishes it with one release store; the consumer
+ * reads it where it lies and releases it. Each record starts with a Frame.
+ * A record that would straddle the end is preceded by a padding frame
+ * (tag 0) - or, where not even a frame fits, by an implicit skip.
+ *
+ * Performance characteristics:
+ * - Reserve/commit: ~5ns plus the record copy
+ * - No allocation after construction
+ */
+class SPSCByteRing {
+public:
+    struct Frame {
+        uint32_t size;      // Frame plus payload, a multiple of 8
+        uint32_t tag;       // Caller's record kind; 0 is padding
+    };
+
+    static constexpr uint32_t PADDING = 0;
+
+private:
+    std::unique_ptr<uint64_t[]> storage_;   // 8-byte aligned records
+    uint8_t* data_;
+    size_t capacity_;                       // Power of two
+
+    alignas(64) std::atomic<uint64_t> head_{0};
+    uint64_t cached_tail_{0};
+    uint64_t reserved_{0};                  // Start of the record being written
+    uint32_t reserved_size_{0};
+
+    alignas(64) std::atomic<uint64_t> tail_{0};
+    uint32_t peeked_size_{0};
+
+public:
+    // Capacity is rounded up to a power of two
+    explicit SPSCByteRing(size_t capacity) {
+        capacity_ = 4096;
+        while (capacity_ < capacity) capacity_ <<= 1;
+        storage_ = std::make_unique<uint64_t[]>(capacity_ / sizeof(uint64_t));
+        data_ = reinterpret_cast<uint8_t*>(storage_.get());
+    }
+
+    static constexpr uint32_t frame_size(size_t payload) noexcept {
+        return static_cast<uint32_t>((sizeof(Frame) + payload + 7) & ~size_t{7});
+    }
+
+    // Largest payload a single record can carry
+    size_t max_payload() const noexcept { return capacity_ / 2 - sizeof(Frame); }
+
+    /**
+     * Reserve a record (Producer side)
+     *
+     * @return Payload space for payload bytes, or nullptr if the ring is full
+     */
+    [[gnu::hot]]
+    uint8_t* reserve(size_t payload) noexcept {
+        if (payload > max_payload()) return nullptr;
+        const uint32_t size = frame_size(payload);
+        uint64_t head = head_.load(std::memory_order_relaxed);
+        const size_t offset = head & (capacity_ - 1);
+        const size_t contiguous = capacity_ - offset;
+        const size_t needed = size <= contiguous ? size : contiguous + size;
+        if (head + needed - cached_tail_ > capacity_) {
+            cached_tail_ = tail_.load(std::memory_order_acquire);
+            if (head + needed - cached_tail_ > capacity_) return nullptr;
+        }
+        if (size > contiguous) {
+            if (contiguous >= sizeof(Frame)) {
+                const Frame padding{static_cast<uint32_t>(contiguous), PADDING};
+                std::memcpy(data_ + offset, &padding, sizeof(padding));
+            }
+            head += contiguous;
+        }
+        reserved_ = head;
+        reserved_size_ = size;
+        return data_ + (head & (capacity_ - 1)) + sizeof(Frame);
+    }
+
+    // Publish the reserved record (Producer side); tag must not be PADDING
+    [[gnu::hot]]
+    void commit(uint32_t tag) noexcept {
+        const Frame frame{reserved_size_, tag};
+        std::memcpy(data_ + (reserved_ & (capacity_ - 1)), &frame, sizeof(frame));
+        head_.store(reserved_ + reserved_size_, std::memory_order_release);
+    }
+
+    /**
+     * Next record (Consumer side)
+     *
+     * @param frame Output frame of the record
+     * @return Its payload, or nullptr if the ring is empty
+     */
+    [[gnu::hot]]
+    const uint8_t* peek(Frame& frame) noexcept {
+        for (;;) {
+            const uint64_t tail = tail_.load(std::memory_order_relaxed);
+            if (tail == head_.load(std::memory_order_acquire)) return nullptr;
+            const size_t offset = tail & (capacity_ - 1);
+            const size_t remaining = capacity_ - offset;
+            if (remaining < sizeof(Frame)) {
+                tail_.store(tail + remaining, std::memory_order_release);
+                continue;
+            }
+            std::memcpy(&frame, data_ + offset, sizeof(frame));
+            if (frame.tag == PADDING) {
+                tail_.store(tail + frame.size, std::memory_order_release);
+                continue;
+            }
+            peeked_size_ = frame.size;
+            return data_ + offset + sizeof(Frame);
+        }
+    }
+
+    // Release the record returned by the last peek (Consumer side)
+    [[gnu::hot]]
+    void release() noexcept {
+        tail_.store(tail_.load(std::memory_order_relaxed) + peeked_size_, std::memory_order_release);
+    }
+
+    // Bytes committed but not yet released (any thread; approximate while both sides run)
+    size_t used() const noexcept {
+        const uint64_t tail = tail_.load(std::memory_order_acquire);
+        const uint64_t head = head_.load(std::memory_order_acquire);
+        return head > tail ? static_cast<size_t>(head - tail) : 0;
+    }
+
+    bool empty() const noexcept {
+        return tail_.load(std::memory_order_acquire) == head_.load(std::memory_order_acquire);
+    }
+
+    size_t capacity() const noexcept { return capacity_; }
+};
+
+} // namespace hft
@@ -13,8 +13,12 @@
 #include <algorithm>
 #include <numeric>
 #include "enhanced_risk_manager.hpp"
+#include "risk_pipeline.hpp"
+#include "../io_service.hpp"
 #include "../position_tracker.hpp"
 #include "../messages.hpp"
+#include "../seqlock.hpp"
+#include "../symbol_table.hpp"
 
 namespace risk {
 
@@ -102,6 +106,12 @@ struct SystemRiskMetrics {
  * - Dynamic risk limit adjustment
  * - Liquidity risk controls
  * - Advanced operational risk monitoring
+ *
+ * Its checks run as stages of a RiskPipeline together with the enhanced
+ * manager's. Market data updates (under mutex_) publish what the stages
+ * read - per-symbol volatility/VaR, per-(venue, symbol) liquidity and the
+ * effective dynamic limits - into atomics and a SeqLock, so a check never
+ * takes the lock or builds a key string.
  */
 class ComprehensiveRiskManager {
 private:
@@ -120,6 +130,18 @@ private:
     std::unordered_map<std::string, std::deque<double>> price_history_;
     std::unordered_map<std::string, std::deque<uint64_t>> timestamp_history_;
     
+    // Published for the pipeline stages: NaN = no data yet
+    struct DynamicLimitGate {
+        double max_order_notional = 0.0;
+        double max_position_btc = 0.0;
+        double max_position_eth = 0.0;
+    };
+    std::unique_ptr<std::atomic<double>[]> volatility_gate_;    // Per SymbolId, volatility_1h
+    std::unique_ptr<std::atomic<double>[]> var_gate_;           // Per SymbolId, var_1d_95
+    std::unique_ptr<std::atomic<double>[]> impact_gate_;        // Per (venue, symbol): impact estimate, -1 = illiquid
+    hft::SeqLock<DynamicLimitGate> dynamic_gate_;
+    RiskPipeline pipeline_;
+    
     std::atomic<uint32_t> high_risk_events_today_{0};
     std::atomic<bool> emergency_risk_mode_{false};
     
@@ -138,7 +160,21 @@ private:
 public:
     ComprehensiveRiskManager(PositionTracker* position_tracker) 
         : position_tracker_(position_tracker),
-          enhanced_risk_manager_(std::make_unique<EnhancedRiskManager>(position_tracker)) {
+          enhanced_risk_manager_(std::make_unique<EnhancedRiskManager>(position_tracker)),
+          volatility_gate_(std::make_unique<std::atomic<double>[]>(hft::SymbolTable::MAX_SYMBOLS)),
+          var_gate_(std::make_unique<std::atomic<double>[]>(hft::SymbolTable::MAX_SYMBOLS)),
+          impact_gate_(std::make_unique<std::atomic<double>[]>(hft::VENUE_COUNT * hft::SymbolTable::MAX_SYMBOLS)),
+          pipeline_(position_tracker) {
+        
+        for (size_t i = 0; i < hft::SymbolTable::MAX_SYMBOLS; ++i) {
+            volatility_gate_[i].store(std::nan(""), std::memory_order_relaxed);
+            var_gate_[i].store(0.0, std::memory_order_relaxed);
+        }
+        for (size_t i = 0; i < hft::VENUE_COUNT * hft::SymbolTable::MAX_SYMBOLS; ++i) {
+            impact_gate_[i].store(std::nan(""), std::memory_order_relaxed);
+        }
+        append_risk_stages(pipeline_);
+        pipeline_.compile();
         
         printf("🛡️ Comprehensive Risk Manager initialized\n");
         printf("   Dynamic Risk Limits: %s\n", config_.enable_dynamic_limits ? "ENABLED" : "DISABLED");
@@ -146,46 +182,39 @@ public:
     }
     
     /**
-     * Enhanced trade validation with comprehensive risk checks
+     * Enhanced trade validation with comprehensive risk checks (one pipeline pass)
      */
+    bool can_execute_trade(hft::Venue venue, hft::SymbolId symbol, double quantity, double price,
+                           double current_spread_bps = 0.0, uint64_t timestamp_ns = 0) {
+        RiskCheckContext ctx(venue, symbol, quantity, price, current_spread_bps, timestamp_ns);
+        return pipeline_.run(ctx) == nullptr;
+    }
+    
+    // String-keyed check for existing callers; interns the symbol (registry mutex)
     bool can_execute_trade(const std::string& exchange, const std::string& symbol,
                           double quantity, double price, double current_spread_bps = 0.0) {
-        
-        // 1. Run basic enhanced risk manager checks first
-        if (!enhanced_risk_manager_->can_execute_trade(exchange, symbol, quantity, price, current_spread_bps)) {
-            return false;
+        hft::Venue venue;
+        if (!hft::venue_from_name(exchange.c_str(), venue)) {
+            venue = static_cast<hft::Venue>(hft::VENUE_COUNT);
         }
-        
-        // 2. Market risk checks
-        if (!check_market_risk(exchange, symbol, quantity, price)) {
-            log_risk_event("MARKET_RISK_VIOLATION", exchange, symbol, 
-                         "Market risk limits exceeded", std::abs(quantity * price));
-            return false;
-        }
-        
-        // 3. Liquidity risk checks
-        if (!check_liquidity_risk(exchange, symbol, quantity, price)) {
-            log_risk_event("LIQUIDITY_RISK_VIOLATION", exchange, symbol,
-                         "Liquidity risk limits exceeded", current_spread_bps);
-            return false;
-        }
-        
-        // 4. Dynamic limit checks
-        if (config_.enable_dynamic_limits && 
-            !check_dynamic_limits(exchange, symbol, quantity, price)) {
-            log_risk_event("DYNAMIC_LIMIT_VIOLATION", exchange, symbol,
-                         "Dynamic risk limits exceeded", quantity);
-            return false;
-        }
-        
-        // 5. System risk checks
-        if (!check_system_risk()) {
-            log_risk_event("SYSTEM_RISK_VIOLATION", exchange, symbol,
-                         "System risk concerns detected", 0.0);
-            return false;
-        }
-        
-        return true;
+        RiskCheckContext ctx(venue, hft::SymbolTable::instance().intern(symbol), quantity, price,
+                             current_spread_bps, 0, exchange.c_str());
+        return pipeline_.run(ctx) == nullptr;
+    }
+    
+    /**
+     * Contribute this layer's checks, then the enhanced manager's, to a pipeline
+     */
+    void append_risk_stages(RiskPipeline& pipeline) {
+        pipeline.add_stage<&ComprehensiveRiskManager::check_system_risk>(
+            "comprehensive.system", RiskLayer::COMPREHENSIVE, this, 3.0, 0.001);
+        pipeline.add_stage<&ComprehensiveRiskManager::check_dynamic_limits>(
+            "comprehensive.dynamic_limits", RiskLayer::COMPREHENSIVE, this, 8.0, 0.02);
+        pipeline.add_stage<&ComprehensiveRiskManager::check_market_risk>(
+            "comprehensive.market_risk", RiskLayer::COMPREHENSIVE, this, 6.0, 0.01);
+        pipeline.add_stage<&ComprehensiveRiskManager::check_liquidity_risk>(
+            "comprehensive.liquidity", RiskLayer::COMPREHENSIVE, this, 6.0, 0.005);
+        enhanced_risk_manager_->append_risk_stages(pipeline);
     }
     
     /**
@@ -221,6 +250,8 @@ public:
         if (config_.enable_dynamic_limits) {
             update_dynamic_limits();
         }
+        
+        pipeline_.maybe_recompile();
     }
     
     /**
@@ -285,84 +316,85 @@ public:
         return it != market_risk_metrics_.end() ? it->second : empty;
     }
     
+    // Published 1h volatility for a symbol; 0 until it has market data
+    double market_volatility(hft::SymbolId symbol) const {
+        if (symbol >= hft::SymbolTable::MAX_SYMBOLS) return 0.0;
+        const double volatility = volatility_gate_[symbol].load(std::memory_order_acquire);
+        return std::isnan(volatility) ? 0.0 : volatility;
+    }
+    
+    RiskPipeline& get_risk_pipeline() { return pipeline_; }
     bool is_emergency_mode() const { return emergency_risk_mode_; }
     const DynamicRiskLimits& get_dynamic_limits() const { return dynamic_limits_; }
 
 private:
-    bool check_market_risk(const std::string& exchange, const std::string& symbol,
-                          double quantity, double price) {
-        auto it = market_risk_metrics_.find(symbol);
-        if (it == market_risk_metrics_.end()) return true; // No data, allow trade
-        
-        const auto& metrics = it->second;
-        
-        // Check volatility threshold
-        if (metrics.volatility_1h > config_.volatility_threshold_high) {
-            return false;
-        }
-        
-        // Check VaR threshold
-        double position_var = std::abs(quantity * price) * metrics.var_1d_95;
-        double total_equity = position_tracker_->get_total_equity();
-        if (position_var > total_equity * config_.var_threshold_percent) {
+    // Pipeline stages - lock-free reads of the published gates; events only on rejection
+    bool check_market_risk(RiskCheckContext& ctx) {
+        if (ctx.symbol >= hft::SymbolTable::MAX_SYMBOLS) return true;
+        const double volatility = volatility_gate_[ctx.symbol].load(std::memory_order_acquire);
+        if (std::isnan(volatility)) return true; // No data, allow trade
+        
+        // Volatility threshold, then VaR threshold
+        const double position_var = ctx.notional * var_gate_[ctx.symbol].load(std::memory_order_relaxed);
+        if (volatility > config_.volatility_threshold_high ||
+            position_var > ctx.equity * config_.var_threshold_percent) {
+            ctx.reject_reason = "Market risk limits exceeded";
+            log_risk_event("MARKET_RISK_VIOLATION", ctx.exchange, hft::SymbolTable::instance().name(ctx.symbol),
+                         ctx.reject_reason, ctx.notional);
             return false;
         }
-        
         return true;
     }
     
-    bool check_liquidity_risk(const std::string& exchange, const std::string& symbol,
-                             double quantity, double price) {
-        std::string key = exchange + ":" + symbol;
-        auto it = liquidity_risk_metrics_.find(key);
-        if (it == liquidity_risk_metrics_.end()) return true;
-        
-        const auto& metrics = it->second;
-        
-        // Check if market is liquid enough
-        if (!metrics.is_liquid) return false;
-        
-        // Check market impact
-        double notional = std::abs(quantity * price);
-        double estimated_impact = notional * metrics.market_impact_estimate;
-        if (estimated_impact > price * 0.01) { // 1% max impact
+    bool check_liquidity_risk(RiskCheckContext& ctx) {
+        if (!ctx.known_venue() || ctx.symbol >= hft::SymbolTable::MAX_SYMBOLS) return true;
+        const double impact = impact_gate_[liquidity_index(ctx.venue, ctx.symbol)].load(std::memory_order_relaxed);
+        if (std::isnan(impact)) return true;
+        
+        // Illiquid market, or over 1% max impact
+        if (impact < 0.0 || ctx.notional * impact > ctx.price * 0.01) {
+            ctx.reject_reason = "Liquidity risk limits exceeded";
+            log_risk_event("LIQUIDITY_RISK_VIOLATION", ctx.exchange, hft::SymbolTable::instance().name(ctx.symbol),
+                         ctx.reject_reason, ctx.spread_bps);
             return false;
         }
-        
         return true;
     }
     
-    bool check_dynamic_limits(const std::string& exchange, const std::string& symbol,
-                             double quantity, double price) {
-        double notional = std::abs(quantity * price);
-        
-        if (notional > dynamic_limits_.effective_max_order_size) {
-            return false;
-        }
-        
-        if (symbol.find("BTC") != std::string::npos && 
-            std::abs(quantity) > dynamic_limits_.effective_max_position_btc) {
+    bool check_dynamic_limits(RiskCheckContext& ctx) {
+        if (!config_.enable_dynamic_limits) return true;
+        const DynamicLimitGate gate = dynamic_gate_.load();
+        const double size = std::abs(ctx.quantity);
+        
+        if (ctx.notional > gate.max_order_notional ||
+            ((ctx.assets & ASSET_BTC) && size > gate.max_position_btc) ||
+            ((ctx.assets & ASSET_ETH) && size > gate.max_position_eth)) {
+            ctx.reject_reason = "Dynamic risk limits exceeded";
+            log_risk_event("DYNAMIC_LIMIT_VIOLATION", ctx.exchange, hft::SymbolTable::instance().name(ctx.symbol),
+                         ctx.reject_reason, ctx.quantity);
             return false;
         }
-        
-        if (symbol.find("ETH") != std::string::npos && 
-            std::abs(quantity) > dynamic_limits_.effective_max_position_eth) {
-            return false;
-        }
-        
         return true;
     }
     
-    bool check_system_risk() {
+    bool check_system_risk(RiskCheckContext& ctx) {
         // Check system health metrics
-        if (system_risk_metrics_.cpu_usage_percent > 90.0) return false;
-        if (system_risk_metrics_.memory_usage_percent > 85.0) return false;
-        if (!system_risk_metrics_.exchange_connectivity) return false;
-        if (system_risk_metrics_.market_data_stale) return false;
-        
+        if (system_risk_metrics_.cpu_usage_percent > 90.0 ||
+            system_risk_metrics_.memory_usage_percent > 85.0 ||
+            !system_risk_metrics_.exchange_connectivity ||
+            system_risk_metrics_.market_data_stale) {
+            ctx.reject_reason = "System risk concerns detected";
+            log_risk_event("SYSTEM_RISK_VIOLATION", ctx.exchange, hft::SymbolTable::instance().name(ctx.symbol),
+                         ctx.reject_reason, 0.0);
+            return false;
+        }
         return true;
     }
     
+    static size_t liquidity_index(hft::Venue venue, hft::SymbolId symbol) {
+        return static_cast<size_t>(venue) * hft::SymbolTable::MAX_SYMBOLS + symbol;
+    }
+    
     void update_market_risk_metrics(const std::string& symbol, 
                                    const std::deque<double>& prices,
                                    const std::deque<uint64_t>& timestamps) {
@@ -399,6 +431,12 @@ private:
             metrics.var_1d_99 = -returns[var_99_idx];
         }
         
+        const hft::SymbolId id = hft::SymbolTable::instance().intern(symbol);
+        if (id < hft::SymbolTable::MAX_SYMBOLS) {
+            var_gate_[id].store(metrics.var_1d_95, std::memory_order_relaxed);
+            volatility_gate_[id].store(metrics.volatility_1h, std::memory_order_release);
+        }
+        
         metrics.last_update_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
             std::chrono::high_resolution_clock::now().time_since_epoch()).count();
     }
@@ -416,6 +454,13 @@ private:
         // Simple liquidity assessment
         metrics.is_liquid = (metrics.bid_ask_spread_bps < 100.0) && (volume > 0.01);
         
+        hft::Venue venue;
+        const hft::SymbolId id = hft::SymbolTable::instance().intern(symbol);
+        if (hft::venue_from_name(exchange.c_str(), venue) && id < hft::SymbolTable::MAX_SYMBOLS) {
+            impact_gate_[liquidity_index(venue, id)].store(metrics.is_liquid ? metrics.market_impact_estimate : -1.0,
+                                                           std::memory_order_relaxed);
+        }
+        
         metrics.last_update_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
             std::chrono::high_resolution_clock::now().time_since_epoch()).count();
     }
@@ -454,6 +499,9 @@ private:
         }
         
         dynamic_limits_.calculate_effective_limits();
+        dynamic_gate_.store(DynamicLimitGate{dynamic_limits_.effective_max_order_size,
+                                             dynamic_limits_.effective_max_position_btc,
+                                             dynamic_limits_.effective_max_position_eth});
     }
     
     void log_risk_event(const std::string& type, const std::string& exchange,
@@ -464,11 +512,11 @@ private:
         auto current_time = std::chrono::duration_cast<std::chrono::nanoseconds>(
             std::chrono::high_resolution_clock::now().time_since_epoch()).count();
         
-        std::ofstream log_file("comprehensive_risk_events.csv", std::ios::app);
-        if (log_file.is_open()) {
-            log_file << current_time << "," << type << "," << exchange << "," 
-                    << symbol << "," << description << "," << value << "\n";
-        }
+        static const hft::IoFileId log_file = hft::IoService::instance().open("comprehensive_risk_events.csv");
+        hft::IoLine line;
+        line << current_time << "," << type << "," << exchange << ","
+             << symbol << "," << description << "," << value << "\n";
+        hft::IoService::instance().write(log_file, line);
         
         printf("⚠️ COMPREHENSIVE RISK EVENT: %s - %s %s (%.2f)\n",
                description.c_str(), exchange.c_str(), symbol.c_str(), value);
@@ -0,0 +1,297 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <vector>
+#include "../symbol_table.hpp"
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+namespace risk {
+
+/**
+ * EWMA Covariance Engine
+ *
+ * Incremental exponentially weighted covariance of log returns for up to
+ * max_assets instruments, sampled on a common time grid: prices arriving
+ * between grid points only update each asset's latest price, and crossing
+ * a grid point turns every asset's move since the previous point into one
+ * return vector r and applies C = lambda * C + (1 - lambda) * r r^T.
+ * An asset without a new price contributes a zero return; a gap of k grid
+ * points decays C by lambda^k in the same pass.
+ *
+ * C is stored as the upper triangle of 8x8 blocks, each block contiguous
+ * and each of its rows one 64-byte line, so the rank-1 update streams
+ * through memory once with AVX2 and never touches the lower triangle. Reads are
+ * bias-corrected for the zero starting matrix, and correlations are
+ * derived on demand rather than maintained.
+ *
+ * Single writer: callers serialize updates (InstitutionalRiskManager holds
+ * its risk mutex).
+ */
+class EwmaCovarianceEngine {
+public:
+    static constexpr size_t BLOCK = 8;
+
+    struct Config {
+        size_t max_assets = 1024;
+        uint64_t sample_interval_ns = 1000000000ULL;    // 1 second grid
+        double lambda = 0.999;                          // ~11.5 minute half-life at 1 s
+        uint64_t min_samples = 60;                      // Before is_warm()
+    };
+
+private:
+    struct AlignedFree {
+        void operator()(double* p) const { std::free(p); }
+    };
+    using AlignedArray = std::unique_ptr<double[], AlignedFree>;
+
+    static AlignedArray allocate(size_t count) {
+        const size_t bytes = ((count * sizeof(double) + 63) / 64) * 64;
+        double* p = static_cast<double*>(std::aligned_alloc(64, std::max<size_t>(bytes, 64)));
+        std::memset(p, 0, std::max<size_t>(bytes, 64));
+        return AlignedArray(p);
+    }
+
+    Config config_;
+    size_t capacity_;                       // max_assets rounded up to BLOCK
+    size_t block_count_;
+    AlignedArray blocks_;                   // Upper-triangle blocks, row-major within a block
+    std::vector<size_t> block_row_offset_;  // First block of each block row
+
+    AlignedArray returns_;                  // Current grid return per asset (0 past asset_count_)
+    std::vector<double> last_price_;        // Latest observed price, 0 = none yet
+    std::vector<double> grid_price_;        // Price at the previous grid point, 0 = none yet
+    std::vector<hft::SymbolId> symbols_;
+    std::vector<int32_t> index_of_;         // Per SymbolId, -1 = not tracked
+    size_t asset_count_ = 0;
+
+    uint64_t next_sample_ns_ = 0;
+    uint64_t samples_ = 0;
+    double retained_weight_ = 1.0;          // lambda^(grid points so far): 1 - this = weight of data in C
+
+    const double* block(size_t block_row, size_t block_col) const {
+        return blocks_.get() + (block_row_offset_[block_row] + block_col - block_row) * BLOCK * BLOCK;
+    }
+    double* block(size_t block_row, size_t block_col) {
+        return blocks_.get() + (block_row_offset_[block_row] + block_col - block_row) * BLOCK * BLOCK;
+    }
+
+    double raw(size_t i, size_t j) const {
+        if (i > j) std::swap(i, j);
+        return block(i / BLOCK, j / BLOCK)[(i % BLOCK) * BLOCK + j % BLOCK];
+    }
+
+    // C = decay * C + weight * r r^T over the blocks holding registered assets
+    void rank1_update(double decay, double weight) {
+        const size_t used_blocks = (asset_count_ + BLOCK - 1) / BLOCK;
+        const double* r = returns_.get();
+        for (size_t bi = 0; bi < used_blocks; ++bi) {
+            const double* ri = r + bi * BLOCK;
+            for (size_t bj = bi; bj < used_blocks; ++bj) {
+                double* c = block(bi, bj);
+                const double* rj = r + bj * BLOCK;
+#if defined(__AVX2__)
+                const __m256d d = _mm256_set1_pd(decay);
+                const __m256d rj_lo = _mm256_load_pd(rj);
+                const __m256d rj_hi = _mm256_load_pd(rj + 4);
+                for (size_t a = 0; a < BLOCK; ++a, c += BLOCK) {
+                    const __m256d s = _mm256_set1_pd(weight * ri[a]);
+                    _mm256_store_pd(c, _mm256_add_pd(_mm256_mul_pd(d, _mm256_load_pd(c)), _mm256_mul_pd(s, rj_lo)));
+                    _mm256_store_pd(c + 4, _mm256_add_pd(_mm256_mul_pd(d, _mm256_load_pd(c + 4)), _mm256_mul_pd(s, rj_hi)));
+                }
+#else
+                for (size_t a = 0; a < BLOCK; ++a, c += BLOCK) {
+                    const double s = weight * ri[a];
+                    for (size_t b = 0; b < BLOCK; ++b) c[b] = decay * c[b] + s * rj[b];
+                }
+#endif
+            }
+        }
+    }
+
+    // One grid point after `intervals` grid intervals without a sample
+    void sample(uint64_t intervals) {
+        double* r = returns_.get();
+        for (size_t i = 0; i < asset_count_; ++i) {
+            const double last = last_price_[i];
+            r[i] = (last > 0.0 && grid_price_[i] > 0.0) ? std::log(last / grid_price_[i]) : 0.0;
+            if (last > 0.0) grid_price_[i] = last;
+        }
+
+        const double decay = std::pow(config_.lambda, static_cast<double>(intervals));
+        rank1_update(decay, 1.0 - config_.lambda);
+        retained_weight_ *= decay;
+        ++samples_;
+    }
+
+public:
+    EwmaCovarianceEngine() : EwmaCovarianceEngine(Config{}) {}
+
+    explicit EwmaCovarianceEngine(const Config& config)
+        : config_(config),
+          capacity_(((std::max<size_t>(config.max_assets, 1) + BLOCK - 1) / BLOCK) * BLOCK),
+          block_count_(capacity_ / BLOCK),
+          blocks_(allocate(block_count_ * (block_count_ + 1) / 2 * BLOCK * BLOCK)),
+          block_row_offset_(block_count_),
+          returns_(allocate(capacity_)),
+          last_price_(capacity_, 0.0),
+          grid_price_(capacity_, 0.0),
+          index_of_(hft::SymbolTable::MAX_SYMBOLS, -1) {
+        for (size_t bi = 0, offset = 0; bi < block_count_; ++bi) {
+            block_row_offset_[bi] = offset;
+            offset += block_count_ - bi;
+        }
+        symbols_.reserve(capacity_);
+    }
+
+    /**
+     * Index of a symbol in the matrix, registering it on first use
+     *
+     * @return Dense index, or -1 if the engine is full or the id invalid
+     */
+    int add_asset(hft::SymbolId symbol) {
+        if (symbol >= hft::SymbolTable::MAX_SYMBOLS) return -1;
+        if (index_of_[symbol] >= 0) return index_of_[symbol];
+        if (asset_count_ >= std::min(capacity_, config_.max_assets)) return -1;
+        index_of_[symbol] = static_cast<int32_t>(asset_count_);
+        symbols_.push_back(symbol);
+        return static_cast<int32_t>(asset_count_++);
+    }
+
+    int index_of(hft::SymbolId symbol) const {
+        return symbol < hft::SymbolTable::MAX_SYMBOLS ? index_of_[symbol] : -1;
+    }
+
+    /**
+     * Close every grid point up to timestamp_ns
+     *
+     * The first call anchors the grid; prices seen before it become the
+     * starting grid prices.
+     */
+    void advance_to(uint64_t timestamp_ns) {
+        const uint64_t interval = config_.sample_interval_ns;
+        if (next_sample_ns_ == 0) {
+            next_sample_ns_ = (timestamp_ns / interval + 1) * interval;
+            return;
+        }
+        if (timestamp_ns < next_sample_ns_) return;
+
+        const uint64_t intervals = (timestamp_ns - next_sample_ns_) / interval + 1;
+        sample(intervals);
+        next_sample_ns_ += intervals * interval;
+    }
+
+    /**
+     * Record a price; closes any grid points it is past first
+     *
+     * @return false if the symbol cannot be tracked
+     */
+    bool update_price(hft::SymbolId symbol, double price, uint64_t timestamp_ns) {
+        const int index = add_asset(symbol);
+        if (index < 0 || !(price > 0.0)) return false;
+        advance_to(timestamp_ns);
+        last_price_[index] = price;
+        if (grid_price_[index] == 0.0) grid_price_[index] = price;
+        return true;
+    }
+
+    // Bias-corrected covariance of per-interval log returns
+    double covariance(size_t i, size_t j) const {
+        if (i >= asset_count_ || j >= asset_count_ || retained_weight_ >= 1.0) return 0.0;
+        return raw(i, j) / (1.0 - retained_weight_);
+    }
+
+    double variance(size_t i) const { return covariance(i, i); }
+
+    // Pearson correlation, 0 while either variance is 0
+    double correlation(size_t i, size_t j) const {
+        if (i >= asset_count_ || j >= asset_count_) return 0.0;
+        const double var_i = raw(i, i);
+        const double var_j = raw(j, j);
+        if (var_i <= 0.0 || var_j <= 0.0) return 0.0;
+        return std::clamp(raw(i, j) / std::sqrt(var_i * var_j), -1.0, 1.0);
+    }
+
+    // Correlation sub-matrix for a set of asset indices, row-major into out (n x n)
+    void correlation_matrix(const std::vector<size_t>& assets, std::vector<double>& out) const {
+        const size_t n = assets.size();
+        out.assign(n * n, 0.0);
+        for (size_t a = 0; a < n; ++a) {
+            out[a * n + a] = raw(assets[a], assets[a]) > 0.0 ? 1.0 : 0.0;
+            for (size_t b = a + 1; b < n; ++b) {
+                out[a * n + b] = out[b * n + a] = correlation(assets[a], assets[b]);
+            }
+        }
+    }
+
+    struct CorrelationSummary {
+        double average = 0.0;
+        double max = 0.0;
+        size_t pairs = 0;
+    };
+
+    // Mean and max pairwise correlation over assets with non-zero variance (O(n^2))
+    CorrelationSummary correlation_summary() const {
+        std::vector<double> inv_sd(asset_count_, 0.0);
+        for (size_t i = 0; i < asset_count_; ++i) {
+            const double var = raw(i, i);
+            inv_sd[i] = var > 0.0 ? 1.0 / std::sqrt(var) : 0.0;
+        }
+        CorrelationSummary summary;
+        double total = 0.0;
+        for (size_t i = 0; i < asset_count_; ++i) {
+            if (inv_sd[i] == 0.0) continue;
+            for (size_t j = i + 1; j < asset_count_; ++j) {
+                if (inv_sd[j] == 0.0) continue;
+                const double rho = std::clamp(raw(i, j) * inv_sd[i] * inv_sd[j], -1.0, 1.0);
+                total += rho;
+                summary.max = summary.pairs == 0 ? rho : std::max(summary.max, rho);
+                ++summary.pairs;
+            }
+        }
+        summary.average = summary.pairs > 0 ? total / summary.pairs : 0.0;
+        return summary;
+    }
+
+    /**
+     * w^T C w for exposures indexed like the matrix (size >= asset_count())
+     *
+     * With dollar exposures this is the variance of one interval's P&L.
+     */
+    double portfolio_variance(const std::vector<double>& weights) const {
+        if (retained_weight_ >= 1.0) return 0.0;
+        double total = 0.0;
+        for (size_t i = 0; i < asset_count_; ++i) {
+            if (weights[i] == 0.0) continue;
+            double row = weights[i] * raw(i, i);
+            for (size_t j = i + 1; j < asset_count_; ++j) {
+                row += 2.0 * weights[j] * raw(i, j);
+            }
+            total += weights[i] * row;
+        }
+        return std::max(0.0, total / (1.0 - retained_weight_));
+    }
+
+    // Grid intervals in a period, for scaling per-interval variances
+    double intervals_per(uint64_t period_ns) const {
+        return static_cast<double>(period_ns) / static_cast<double>(config_.sample_interval_ns);
+    }
+    double intervals_per_year() const { return intervals_per(365ULL * 24 * 3600 * 1000000000ULL); }
+
+    // Return vector of the latest grid point (asset_count() entries, log returns)
+    const double* last_returns() const { return returns_.get(); }
+
+    size_t asset_count() const { return asset_count_; }
+    hft::SymbolId symbol_at(size_t index) const { return symbols_[index]; }
+    uint64_t samples() const { return samples_; }
+    bool is_warm() const { return samples_ >= config_.min_samples; }
+    const Config& config() const { return config_; }
+};
+
+} // namespace risk
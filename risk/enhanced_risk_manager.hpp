@@ -1,14 +1,24 @@
 #pragma once
 
+#include <algorithm>
+#include <array>
 #include <atomic>
 #include <chrono>
+#include <limits>
+#include <memory>
 #include <unordered_map>
 #include <string>
 #include <mutex>
 #include <fstream>
 #include <vector>
+#include "../io_service.hpp"
+#include "../kill_switch.hpp"
 #include "../position_tracker.hpp"
 #include "../messages.hpp"
+#include "../rate_limiter.hpp"
+#include "../seqlock.hpp"
+#include "../symbol_table.hpp"
+#include "risk_pipeline.hpp"
 
 enum class RiskViolationType {
     POSITION_LIMIT_EXCEEDED,
@@ -46,6 +56,9 @@ struct RiskLimits {
     uint32_t min_ms_between_orders = 100;  // Min 100ms between orders
     uint32_t max_orders_per_minute = 20;   // Max 20 orders per minute
     
+    // Checks within this fraction of a limit leave the lock-free fast path
+    double fast_path_headroom = 0.10;
+    
     // Circuit breaker settings
     bool circuit_breaker_enabled = true;
     double circuit_breaker_loss_threshold = 1000.0; // Trip at $1k loss
@@ -62,46 +75,137 @@ struct RiskEvent {
     bool trading_halted;
 };
 
+/**
+ * Enhanced Risk Manager
+ *
+ * Pre-trade checks run on a lock-free fast path keyed by (Venue, SymbolId):
+ * RiskLimits are compiled into a per-instrument table (size and position
+ * limits picked once from the symbol name, not per order) plus one set of
+ * account bounds, each in a SeqLock tagged with the limits generation.
+ * Emergency stop, circuit breaker and the equity band live in a single
+ * atomic state word. An order whose every check sits outside the
+ * fast_path_headroom margin of its limit is accepted after one state
+ * load, two table loads, a position and balance copy and the rate limit,
+ * with a single branch deciding between that and the slow path.
+ *
+ * The slow path re-runs every check exactly, raises risk events, trips
+ * the circuit breaker, compiles table entries that are missing or stale,
+ * and republishes the equity band. It runs for orders near or over a
+ * limit, while the state word or the process-wide kill switch is
+ * non-zero, and for the string API when the exchange is not a known venue.
+ * Emergency stops are published to the kill switch so every other order
+ * path in every attached process halts with this one.
+ *
+ * The limits and the rate limits are also contributed to the layered
+ * managers' risk pipelines as two stages over a shared RiskCheckContext.
+ */
 class EnhancedRiskManager {
+public:
+    // Risk state word bits
+    static constexpr uint32_t STATE_EMERGENCY_STOP = 1u << 0;
+    static constexpr uint32_t STATE_CIRCUIT_BREAKER = 1u << 1;
+    static constexpr uint32_t STATE_EQUITY_WARNING = 1u << 2;  // Equity, daily P&L or drawdown within headroom
+    static constexpr uint32_t STATE_EQUITY_BREACH = 1u << 3;   // ... or past its limit
+    static constexpr uint32_t STATE_EQUITY_BAND_MASK = STATE_EQUITY_WARNING | STATE_EQUITY_BREACH;
+
 private:
+    enum class LimitAsset : uint8_t { NONE, BTC, ETH };
+
+    // One instrument's compiled limits; near_* = limit * (1 - headroom)
+    struct InstrumentBounds {
+        double max_order_qty = 0.0;         // Infinity when unlimited
+        double max_position = 0.0;
+        double max_order_notional = 0.0;
+        double near_order_qty = 0.0;
+        double near_position = 0.0;
+        double near_order_notional = 0.0;
+        uint32_t generation = 0;            // 0 = never compiled
+        LimitAsset asset = LimitAsset::NONE;
+    };
+
+    // Account-wide limits with their fast-path margins
+    struct AccountBounds {
+        double min_spread_bps = 0.0;
+        double max_spread_bps = 0.0;
+        double min_equity = 0.0;
+        double min_daily_pnl = 0.0;         // -max_daily_loss
+        double max_drawdown = 0.0;
+        double near_min_spread_bps = 0.0;
+        double near_max_spread_bps = 0.0;
+        double near_min_equity = 0.0;
+        double near_min_daily_pnl = 0.0;
+        double near_max_drawdown = 0.0;
+        uint32_t generation = 0;
+    };
+
     RiskLimits limits_;
     PositionTracker* position_tracker_;
     
-    // Circuit breaker state
-    mutable std::atomic<bool> circuit_breaker_active_{false};
-    mutable std::atomic<uint64_t> circuit_breaker_trigger_time_{0};
-    std::atomic<bool> emergency_stop_active_{false};
+    // Compiled limits
+    std::unique_ptr<hft::SeqLock<InstrumentBounds>[]> instrument_bounds_;
+    hft::SeqLock<AccountBounds> account_bounds_;
+    uint32_t limits_generation_ = 0;        // Guarded by mutex_
+    
+    // Emergency stop, circuit breaker and equity band
+    mutable std::atomic<uint32_t> risk_state_{0};
+    std::atomic<uint64_t> circuit_breaker_trigger_time_{0};
+    hft::KillSwitch& kill_switch_ = hft::KillSwitch::instance();
+    const std::atomic<uint64_t>* kill_word_ = kill_switch_.word();
     
-    // Rate limiting
-    std::unordered_map<std::string, uint64_t> last_order_time_;  // [exchange] -> timestamp
-    std::unordered_map<std::string, std::vector<uint64_t>> recent_orders_; // [exchange] -> timestamps
+    // Rate limiting, one set per venue
+    struct VenueRateLimits {
+        hft::TokenBucket spacing;                           // min_ms_between_orders
+        hft::SlidingWindowCounter<60> per_minute{0, 60000000000ULL};
+    };
+    std::array<VenueRateLimits, hft::VENUE_COUNT> venue_rates_;
+    std::atomic<uint32_t> rate_lease_size_{1};             // per_minute events a thread takes per CAS
+    
+    // Each thread's unspent per_minute leases, per manager (indexed by id_)
+    using VenueRateLeases = std::array<hft::SlidingWindowCounter<60>::Lease, hft::VENUE_COUNT>;
+    const uint32_t id_ = next_id();
     
     // Risk monitoring
     std::vector<RiskEvent> risk_events_;
     std::atomic<uint32_t> risk_violations_today_{0};
+    std::atomic<uint64_t> slow_path_checks_{0};
     
     mutable std::mutex mutex_;
     std::atomic<bool> logging_enabled_{true};
+    hft::IoFileId event_file_ = hft::INVALID_IO_FILE;
+    
+    static uint32_t next_id() {
+        static std::atomic<uint32_t> ids{0};
+        return ids.fetch_add(1, std::memory_order_relaxed);
+    }
+    
+    VenueRateLeases& thread_rate_leases() {
+        thread_local std::vector<VenueRateLeases> leases;
+        if (id_ >= leases.size()) [[unlikely]] leases.resize(id_ + 1);
+        return leases[id_];
+    }
+    
+    static uint64_t now_ns() {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::high_resolution_clock::now().time_since_epoch()).count();
+    }
     
     void log_risk_event(const RiskEvent& event) {
         if (!logging_enabled_) return;
         
-        std::ofstream log_file("risk_events.csv", std::ios::app);
-        if (log_file.is_open()) {
-            log_file << event.timestamp_ns << ","
-                    << static_cast<int>(event.type) << ","
-                    << event.exchange << ","
-                    << event.symbol << ","
-                    << event.description << ","
-                    << event.value << ","
-                    << (event.trading_halted ? "1" : "0") << "\n";
-        }
+        hft::IoLine line;
+        line << event.timestamp_ns << ","
+             << static_cast<int>(event.type) << ","
+             << event.exchange << ","
+             << event.symbol << ","
+             << event.description << ","
+             << event.value << ","
+             << (event.trading_halted ? "1" : "0") << "\n";
+        hft::IoService::instance().write(event_file_, line);
     }
     
     void trigger_circuit_breaker(const std::string& reason) {
-        circuit_breaker_active_ = true;
-        circuit_breaker_trigger_time_ = std::chrono::duration_cast<std::chrono::nanoseconds>(
-            std::chrono::high_resolution_clock::now().time_since_epoch()).count();
+        circuit_breaker_trigger_time_ = now_ns();
+        risk_state_.fetch_or(STATE_CIRCUIT_BREAKER, std::memory_order_acq_rel);
         
         printf("🚨 CIRCUIT BREAKER TRIGGERED: %s\n", reason.c_str());
         printf("⏰ Trading halted for %d seconds\n", limits_.circuit_breaker_cooldown_seconds);
@@ -122,79 +226,154 @@ private:
     }
     
     bool is_circuit_breaker_cooling_down() const {
-        if (!circuit_breaker_active_.load(std::memory_order_acquire)) {
+        if (!(risk_state_.load(std::memory_order_acquire) & STATE_CIRCUIT_BREAKER)) {
             return false;
         }
         
-        auto current_time = std::chrono::duration_cast<std::chrono::nanoseconds>(
-            std::chrono::high_resolution_clock::now().time_since_epoch()).count();
-        
-        auto elapsed_ns = current_time - circuit_breaker_trigger_time_.load(std::memory_order_acquire);
+        auto elapsed_ns = now_ns() - circuit_breaker_trigger_time_.load(std::memory_order_acquire);
         auto elapsed_seconds = elapsed_ns / 1000000000ULL;
         
         if (elapsed_seconds >= limits_.circuit_breaker_cooldown_seconds) {
-            // Properly reset using atomic store
-            circuit_breaker_active_.store(false, std::memory_order_release);
-            printf("✅ Circuit breaker reset - trading resumed\n");
+            // Only the thread that clears the bit reports the reset
+            if (risk_state_.fetch_and(~STATE_CIRCUIT_BREAKER, std::memory_order_acq_rel) & STATE_CIRCUIT_BREAKER) {
+                printf("✅ Circuit breaker reset - trading resumed\n");
+            }
             return false;
         }
         
         return true;
     }
     
-    bool check_rate_limits(const std::string& exchange) {
-        auto current_time = std::chrono::duration_cast<std::chrono::nanoseconds>(
-            std::chrono::high_resolution_clock::now().time_since_epoch()).count();
-        
-        // Check minimum time between orders
-        if (last_order_time_.count(exchange)) {
-            auto time_since_last = (current_time - last_order_time_[exchange]) / 1000000; // Convert to ms
-            if (time_since_last < limits_.min_ms_between_orders) {
-                return false; // Too soon since last order
-            }
+    // Safe while the fast path is acquiring: each limit is published as one atomic word.
+    // Per-thread leases are 1/4096 of the per-minute budget (1..64 orders), so the
+    // window undershoots by well under 2% per thread and low limits stay exact.
+    void configure_rate_limits() {
+        const hft::RateLimit spacing{limits_.min_ms_between_orders > 0 ? 1000.0 / limits_.min_ms_between_orders : 0.0, 1.0};
+        for (auto& rates : venue_rates_) {
+            rates.spacing.configure(spacing);
+            rates.per_minute.set_limit(limits_.max_orders_per_minute);
         }
-        
-        // Check orders per minute limit
-        auto& recent = recent_orders_[exchange];
-        auto minute_ago = current_time - 60000000000ULL; // 60 seconds in nanoseconds
-        
-        // Remove old entries
-        recent.erase(std::remove_if(recent.begin(), recent.end(),
-                    [minute_ago](uint64_t timestamp) { return timestamp < minute_ago; }),
-                    recent.end());
-        
-        if (recent.size() >= limits_.max_orders_per_minute) {
+        rate_lease_size_.store(std::clamp(limits_.max_orders_per_minute >> 12, 1u, 64u), std::memory_order_relaxed);
+    }
+    
+    // Takes a slot in both limits; called last so refused orders don't count.
+    // With spacing off the per-minute window is spent from this thread's lease,
+    // so only one check in lease-size touches a shared line; spacing is one
+    // last-order time per venue and always costs a CAS when enabled.
+    bool check_rate_limits(hft::Venue venue, uint64_t current_time) {
+        if (static_cast<size_t>(venue) >= hft::VENUE_COUNT) return false;
+        if (current_time == 0) current_time = now_ns();
+
+        VenueRateLimits& rates = venue_rates_[static_cast<size_t>(venue)];
+        if (!rates.spacing.try_acquire(current_time)) {
+            return false; // Too soon since last order
+        }
+        hft::SlidingWindowCounter<60>::Lease& lease = thread_rate_leases()[static_cast<size_t>(venue)];
+        if (!rates.per_minute.try_acquire(current_time, lease, rate_lease_size_.load(std::memory_order_relaxed))) {
+            rates.spacing.refund();
             return false; // Too many orders in the last minute
         }
-        
         return true;
     }
-
-public:
-    EnhancedRiskManager(PositionTracker* position_tracker) 
-        : position_tracker_(position_tracker) {
+    
+    // Bump the generation and publish account bounds (mutex_ held); instrument entries recompile lazily
+    void compile_account_bounds() {
+        const double keep = 1.0 - limits_.fast_path_headroom;
+        AccountBounds bounds;
+        bounds.min_spread_bps = limits_.min_spread_bps;
+        bounds.max_spread_bps = limits_.max_spread_bps;
+        bounds.min_equity = limits_.min_account_equity;
+        bounds.min_daily_pnl = -limits_.max_daily_loss;
+        bounds.max_drawdown = limits_.max_drawdown;
+        bounds.near_min_spread_bps = limits_.min_spread_bps / keep;
+        bounds.near_max_spread_bps = limits_.max_spread_bps * keep;
+        bounds.near_min_equity = limits_.min_account_equity / keep;
+        bounds.near_min_daily_pnl = -limits_.max_daily_loss * keep;
+        bounds.near_max_drawdown = limits_.max_drawdown * keep;
+        bounds.generation = ++limits_generation_;
+        account_bounds_.store(bounds);
+    }
+    
+    // Limits for one symbol under the current RiskLimits (mutex_ held)
+    InstrumentBounds compile_instrument(const std::string& name) const {
+        constexpr double unlimited = std::numeric_limits<double>::infinity();
+        const bool btc = name.find("BTC") != std::string::npos;
+        const bool eth = name.find("ETH") != std::string::npos;
+        const double keep = 1.0 - limits_.fast_path_headroom;
+        
+        InstrumentBounds bounds;
+        bounds.max_order_qty = std::min(btc ? limits_.max_order_size_btc : unlimited,
+                                        eth ? limits_.max_order_size_eth : unlimited);
+        bounds.max_position = std::min(btc ? limits_.max_btc_position : unlimited,
+                                       eth ? limits_.max_eth_position : unlimited);
+        bounds.max_order_notional = limits_.max_order_notional;
+        bounds.near_order_qty = bounds.max_order_qty * keep;
+        bounds.near_position = bounds.max_position * keep;
+        bounds.near_order_notional = bounds.max_order_notional * keep;
+        bounds.generation = limits_generation_;
+        bounds.asset = btc ? LimitAsset::BTC : eth ? LimitAsset::ETH : LimitAsset::NONE;
+        return bounds;
+    }
+    
+    InstrumentBounds instrument_limits(hft::SymbolId symbol) {
+        const std::string& name = hft::SymbolTable::instance().name(symbol);
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (symbol >= hft::SymbolTable::MAX_SYMBOLS) return compile_instrument(name);
         
-        // Create risk event log header
-        std::ofstream log_file("risk_events.csv");
-        if (log_file.is_open()) {
-            log_file << "timestamp_ns,risk_type,exchange,symbol,description,value,trading_halted\n";
+        InstrumentBounds bounds = instrument_bounds_[symbol].load();
+        if (bounds.generation != limits_generation_) {
+            bounds = compile_instrument(name);
+            instrument_bounds_[symbol].store(bounds);
+        }
+        return bounds;
+    }
+    
+    // Amount of the funding asset available vs required: USD for buys, the base asset for sells
+    static bool has_funds(const ExchangeBalance& balance, LimitAsset asset, double quantity, double notional) {
+        if (quantity > 0) return balance.usd_available >= notional;
+        const double available = asset == LimitAsset::BTC ? balance.btc_available
+                               : asset == LimitAsset::ETH ? balance.eth_available
+                               : -std::numeric_limits<double>::infinity();
+        return available >= -quantity;
+    }
+    
+    // Publish the equity band for the given aggregates; returns the new state word
+    uint32_t publish_equity_band(const AccountBounds& account, double equity, double daily_pnl, double drawdown) {
+        uint32_t band = 0;
+        if (equity < account.min_equity || daily_pnl < account.min_daily_pnl || drawdown > account.max_drawdown) {
+            band = STATE_EQUITY_BREACH;
+        } else if (equity < account.near_min_equity || daily_pnl < account.near_min_daily_pnl ||
+                   drawdown > account.near_max_drawdown) {
+            band = STATE_EQUITY_WARNING;
         }
         
-        printf("🛡️ Enhanced Risk Manager initialized\n");
-        printf("   Max Daily Loss: $%.0f\n", limits_.max_daily_loss);
-        printf("   Max Drawdown: $%.0f\n", limits_.max_drawdown);
-        printf("   Circuit Breaker: %s\n", limits_.circuit_breaker_enabled ? "ENABLED" : "DISABLED");
+        uint32_t state = risk_state_.load(std::memory_order_relaxed);
+        while ((state & STATE_EQUITY_BAND_MASK) != band &&
+               !risk_state_.compare_exchange_weak(state, (state & ~STATE_EQUITY_BAND_MASK) | band,
+                                                  std::memory_order_acq_rel)) {
+        }
+        return (state & ~STATE_EQUITY_BAND_MASK) | band;
     }
     
-    // Core risk check - called before every trade
-    bool can_execute_trade(const std::string& exchange, const std::string& symbol,
-                          double quantity, double price, double spread_bps = 0.0) {
+    /**
+     * Exact check of every limit except the rate limits, with risk events.
+     * An out-of-range venue has no position or balance.
+     */
+    bool check_limits_slow(const risk::RiskCheckContext& ctx) {
+        slow_path_checks_.fetch_add(1, std::memory_order_relaxed);
+        const std::string& symbol_name = hft::SymbolTable::instance().name(ctx.symbol);
         
         // 1. Emergency stop check
-        if (emergency_stop_active_) {
+        if (risk_state_.load(std::memory_order_acquire) & STATE_EMERGENCY_STOP) {
             printf("🛑 EMERGENCY STOP ACTIVE - All trading halted\n");
             return false;
         }
+        const uint64_t kill_state = kill_word_->load(std::memory_order_acquire);
+        if (hft::KillSwitch::is_halted(kill_state)) {
+            printf("🛑 KILL SWITCH SET (%s) - All trading halted\n",
+                   hft::KillSwitch::describe(hft::KillSwitch::flags_of(kill_state)).c_str());
+            return false;
+        }
         
         // 2. Circuit breaker check
         if (limits_.circuit_breaker_enabled && is_circuit_breaker_cooling_down()) {
@@ -202,97 +381,173 @@ public:
             return false;
         }
         
-        // 3. Rate limiting check
-        if (!check_rate_limits(exchange)) {
-            create_risk_event(RiskViolationType::RAPID_FIRE_PREVENTION, exchange, symbol,
-                            "Rate limit exceeded", 0.0);
-            return false;
-        }
+        const AccountBounds account = account_bounds_.load();
+        const InstrumentBounds limits = instrument_limits(ctx.symbol);
         
-        // 4. Spread check
-        if (spread_bps < limits_.min_spread_bps) {
-            create_risk_event(RiskViolationType::INSUFFICIENT_SPREAD, exchange, symbol,
-                            "Spread below minimum threshold", spread_bps);
+        // 3. Spread check
+        if (ctx.spread_bps < account.min_spread_bps) {
+            create_risk_event(RiskViolationType::INSUFFICIENT_SPREAD, ctx.exchange, symbol_name,
+                            "Spread below minimum threshold", ctx.spread_bps);
             return false;
         }
         
-        if (spread_bps > limits_.max_spread_bps) {
-            create_risk_event(RiskViolationType::INSUFFICIENT_SPREAD, exchange, symbol,
-                            "Spread suspiciously high - possible error", spread_bps);
+        if (ctx.spread_bps > account.max_spread_bps) {
+            create_risk_event(RiskViolationType::INSUFFICIENT_SPREAD, ctx.exchange, symbol_name,
+                            "Spread suspiciously high - possible error", ctx.spread_bps);
             return false;
         }
         
-        // 5. Order size check
-        double notional = std::abs(quantity * price);
-        if (notional > limits_.max_order_notional) {
-            create_risk_event(RiskViolationType::ORDER_SIZE_LIMIT_EXCEEDED, exchange, symbol,
-                            "Order notional exceeds limit", notional);
+        // 4. Order size check
+        if (ctx.notional > limits.max_order_notional) {
+            create_risk_event(RiskViolationType::ORDER_SIZE_LIMIT_EXCEEDED, ctx.exchange, symbol_name,
+                            "Order notional exceeds limit", ctx.notional);
             return false;
         }
         
-        if (symbol.find("BTC") != std::string::npos && std::abs(quantity) > limits_.max_order_size_btc) {
-            create_risk_event(RiskViolationType::ORDER_SIZE_LIMIT_EXCEEDED, exchange, symbol,
-                            "BTC order size exceeds limit", std::abs(quantity));
+        if (std::abs(ctx.quantity) > limits.max_order_qty) {
+            create_risk_event(RiskViolationType::ORDER_SIZE_LIMIT_EXCEEDED, ctx.exchange, symbol_name,
+                            "Order size exceeds instrument limit", std::abs(ctx.quantity));
             return false;
         }
         
-        if (symbol.find("ETH") != std::string::npos && std::abs(quantity) > limits_.max_order_size_eth) {
-            create_risk_event(RiskViolationType::ORDER_SIZE_LIMIT_EXCEEDED, exchange, symbol,
-                            "ETH order size exceeds limit", std::abs(quantity));
+        // 5. Position limit check
+        if (std::abs(ctx.new_position) > limits.max_position) {
+            create_risk_event(RiskViolationType::POSITION_LIMIT_EXCEEDED, ctx.exchange, symbol_name,
+                            "Position limit would be exceeded", std::abs(ctx.new_position));
             return false;
         }
         
-        // 6. Position limit check
-        auto current_position = position_tracker_->get_position(exchange, symbol);
-        double new_position = current_position.quantity + quantity;
-        
-        if (symbol.find("BTC") != std::string::npos && std::abs(new_position) > limits_.max_btc_position) {
-            create_risk_event(RiskViolationType::POSITION_LIMIT_EXCEEDED, exchange, symbol,
-                            "BTC position limit would be exceeded", std::abs(new_position));
+        // 6. Balance check
+        if (!ctx.funded || !has_funds(ctx.balance, limits.asset, ctx.quantity, ctx.notional)) {
+            create_risk_event(RiskViolationType::POSITION_LIMIT_EXCEEDED, ctx.exchange, symbol_name,
+                            "Insufficient balance for trade", ctx.notional);
             return false;
         }
         
-        if (symbol.find("ETH") != std::string::npos && std::abs(new_position) > limits_.max_eth_position) {
-            create_risk_event(RiskViolationType::POSITION_LIMIT_EXCEEDED, exchange, symbol,
-                            "ETH position limit would be exceeded", std::abs(new_position));
+        // 7. Equity and drawdown check
+        if (publish_equity_band(account, ctx.equity, ctx.daily_pnl, ctx.drawdown) & STATE_EQUITY_BREACH) {
+            if (ctx.equity < account.min_equity) {
+                trigger_circuit_breaker("Account equity below minimum threshold");
+            } else if (ctx.daily_pnl < account.min_daily_pnl) {
+                trigger_circuit_breaker("Daily loss limit exceeded");
+            } else {
+                trigger_circuit_breaker("Maximum drawdown limit exceeded");
+            }
             return false;
         }
         
-        // 7. Balance check
-        if (!position_tracker_->can_trade(exchange, symbol, quantity, price)) {
-            create_risk_event(RiskViolationType::POSITION_LIMIT_EXCEEDED, exchange, symbol,
-                            "Insufficient balance for trade", notional);
-            return false;
+        return true;
+    }
+    
+    /**
+     * Every limit except the rate limits (lock-free fast path)
+     *
+     * Every check is evaluated and OR-ed into one flag, so an order far from
+     * all limits costs a single branch; anything near a limit, or any
+     * non-zero risk state, goes to the exact slow path.
+     */
+    bool check_limits(risk::RiskCheckContext& ctx) {
+        const size_t v = static_cast<size_t>(ctx.venue);
+        if (v >= hft::VENUE_COUNT || ctx.symbol >= hft::SymbolTable::MAX_SYMBOLS) {
+            return check_limits_slow(ctx);
         }
         
-        // 8. Equity and drawdown check
-        double current_equity = position_tracker_->get_total_equity();
-        if (current_equity < limits_.min_account_equity) {
-            trigger_circuit_breaker("Account equity below minimum threshold");
-            return false;
+        const uint32_t state = risk_state_.load(std::memory_order_acquire);
+        const AccountBounds account = account_bounds_.load();
+        const InstrumentBounds limits = instrument_bounds_[ctx.symbol].load();
+        
+        const bool near_limit = (state != 0)
+                              | hft::KillSwitch::is_halted(kill_word_->load(std::memory_order_acquire))
+                              | (limits.generation != account.generation)
+                              | (ctx.spread_bps < account.near_min_spread_bps)
+                              | (ctx.spread_bps > account.near_max_spread_bps)
+                              | (ctx.notional > limits.near_order_notional)
+                              | (std::abs(ctx.quantity) > limits.near_order_qty)
+                              | (std::abs(ctx.new_position) > limits.near_position)
+                              | !ctx.funded
+                              | !has_funds(ctx.balance, limits.asset, ctx.quantity, ctx.notional)
+                              | (ctx.equity < account.near_min_equity)
+                              | (ctx.daily_pnl < account.near_min_daily_pnl)
+                              | (ctx.drawdown > account.near_max_drawdown);
+        
+        if (near_limit) [[unlikely]] {
+            return check_limits_slow(ctx);
         }
-        
-        double daily_pnl = position_tracker_->get_daily_pnl();
-        if (daily_pnl < -limits_.max_daily_loss) {
-            trigger_circuit_breaker("Daily loss limit exceeded");
+        return true;
+    }
+    
+    // Rate limits - last, so only otherwise acceptable orders use up the budget
+    bool acquire_rate_slot(risk::RiskCheckContext& ctx) {
+        if (!check_rate_limits(ctx.venue, ctx.timestamp_ns)) [[unlikely]] {
+            create_risk_event(RiskViolationType::RAPID_FIRE_PREVENTION, ctx.exchange,
+                            hft::SymbolTable::instance().name(ctx.symbol), "Rate limit exceeded", 0.0);
             return false;
         }
+        return true;
+    }
+
+public:
+    EnhancedRiskManager(PositionTracker* position_tracker) 
+        : position_tracker_(position_tracker)
+        , instrument_bounds_(std::make_unique<hft::SeqLock<InstrumentBounds>[]>(hft::SymbolTable::MAX_SYMBOLS)) {
+        configure_rate_limits();
+        compile_account_bounds();
+        
+        // Risk event log: truncated with a header when the process first opens it
+        hft::IoService::FileOptions events;
+        events.truncate = true;
+        events.header = "timestamp_ns,risk_type,exchange,symbol,description,value,trading_halted\n";
+        events.rotate_bytes = 64 * 1024 * 1024;
+        events.block_when_full = true;          // Risk event audit trail
+        event_file_ = hft::IoService::instance().open("risk_events.csv", events);
         
-        double max_drawdown = position_tracker_->get_max_drawdown();
-        if (max_drawdown > limits_.max_drawdown) {
-            trigger_circuit_breaker("Maximum drawdown limit exceeded");
-            return false;
+        printf("🛡️ Enhanced Risk Manager initialized\n");
+        printf("   Max Daily Loss: $%.0f\n", limits_.max_daily_loss);
+        printf("   Max Drawdown: $%.0f\n", limits_.max_drawdown);
+        printf("   Circuit Breaker: %s\n", limits_.circuit_breaker_enabled ? "ENABLED" : "DISABLED");
+    }
+    
+    /**
+     * Core risk check - called before every trade (lock-free fast path)
+     *
+     * An order far from every limit costs one state load, two table loads,
+     * the shared position/balance/aggregate loads, a single branch and the
+     * rate limit.
+     *
+     * @param timestamp_ns Time for the rate limits, e.g. the triggering
+     *                     event's; 0 reads the clock
+     */
+    bool can_execute_trade(hft::Venue venue, hft::SymbolId symbol,
+                           double quantity, double price, double spread_bps = 0.0,
+                           uint64_t timestamp_ns = 0) {
+        risk::RiskCheckContext ctx(venue, symbol, quantity, price, spread_bps, timestamp_ns);
+        risk::load_shared_state(*position_tracker_, ctx);
+        return check_limits(ctx) && acquire_rate_slot(ctx);
+    }
+    
+    // String-keyed check for existing callers; interns the symbol (registry mutex)
+    bool can_execute_trade(const std::string& exchange, const std::string& symbol,
+                          double quantity, double price, double spread_bps = 0.0) {
+        const hft::SymbolId id = hft::SymbolTable::instance().intern(symbol);
+        hft::Venue venue;
+        if (!hft::venue_from_name(exchange.c_str(), venue)) {
+            venue = static_cast<hft::Venue>(hft::VENUE_COUNT);
         }
-        
-        // All checks passed - update rate limiting
-        auto current_time = std::chrono::duration_cast<std::chrono::nanoseconds>(
-            std::chrono::high_resolution_clock::now().time_since_epoch()).count();
-        
-        std::lock_guard<std::mutex> lock(mutex_);
-        last_order_time_[exchange] = current_time;
-        recent_orders_[exchange].push_back(current_time);
-        
-        return true;
+        risk::RiskCheckContext ctx(venue, id, quantity, price, spread_bps, 0, exchange.c_str());
+        risk::load_shared_state(*position_tracker_, ctx);
+        return check_limits(ctx) && acquire_rate_slot(ctx);
+    }
+    
+    /**
+     * Contribute this layer's checks to a risk pipeline: the limits (fast
+     * path with slow-path fallback) and the rate limits, which consume
+     * budget and so run after every other stage.
+     */
+    void append_risk_stages(risk::RiskPipeline& pipeline) {
+        pipeline.add_stage<&EnhancedRiskManager::check_limits>(
+            "enhanced.limits", risk::RiskLayer::ENHANCED, this, 30.0, 0.02);
+        pipeline.add_stage<&EnhancedRiskManager::acquire_rate_slot>(
+            "enhanced.rate_limit", risk::RiskLayer::ENHANCED, this, 15.0, 0.01, true);
     }
     
     void create_risk_event(RiskViolationType type, const std::string& exchange,
@@ -315,7 +570,8 @@ public:
     }
     
     void emergency_stop(const std::string& reason) {
-        emergency_stop_active_ = true;
+        risk_state_.fetch_or(STATE_EMERGENCY_STOP, std::memory_order_acq_rel);
+        kill_switch_.halt(hft::KillSwitch::EMERGENCY_STOP, reason.c_str());
         printf("🛑 EMERGENCY STOP ACTIVATED: %s\n", reason.c_str());
         printf("   All trading immediately halted!\n");
         printf("   Manual intervention required to resume.\n");
@@ -325,7 +581,13 @@ public:
     }
     
     void reset_emergency_stop() {
-        emergency_stop_active_ = false;
+        risk_state_.fetch_and(~STATE_EMERGENCY_STOP, std::memory_order_acq_rel);
+        const uint64_t word = kill_switch_.resume(hft::KillSwitch::EMERGENCY_STOP, "emergency stop reset");
+        if (hft::KillSwitch::flags_of(word) & hft::KillSwitch::EMERGENCY_STOP) {
+            printf("⚠️ Shared emergency stop is held by pid %d - only it or hft_kill resume --all can clear it\n",
+                   kill_switch_.owner(hft::KillSwitch::EMERGENCY_STOP));
+            return;
+        }
         printf("✅ Emergency stop reset - trading can resume\n");
     }
     
@@ -336,22 +598,48 @@ public:
     void update_limits(const RiskLimits& new_limits) {
         std::lock_guard<std::mutex> lock(mutex_);
         limits_ = new_limits;
+        configure_rate_limits();
+        compile_account_bounds();
         printf("🔧 Risk limits updated\n");
     }
     
     bool is_trading_halted() const {
-        return emergency_stop_active_ || 
+        return (risk_state_.load(std::memory_order_acquire) & STATE_EMERGENCY_STOP) ||
+               hft::KillSwitch::is_halted(kill_word_->load(std::memory_order_acquire)) ||
                (limits_.circuit_breaker_enabled && is_circuit_breaker_cooling_down());
     }
     
+    // Current risk state word (STATE_* bits); the equity band is as of the last slow-path check
+    uint32_t risk_state() const {
+        return risk_state_.load(std::memory_order_acquire);
+    }
+    
+    // Recompute and publish the equity band from the tracker's current aggregates
+    uint32_t refresh_risk_state() {
+        return publish_equity_band(account_bounds_.load(), position_tracker_->get_total_equity(),
+                                   position_tracker_->get_daily_pnl(), position_tracker_->get_max_drawdown());
+    }
+    
+    // Checks that took the slow path (near or over a limit, or non-zero state)
+    uint64_t slow_path_checks() const {
+        return slow_path_checks_.load(std::memory_order_relaxed);
+    }
+    
+    void set_logging_enabled(bool enabled) {
+        logging_enabled_.store(enabled, std::memory_order_relaxed);
+    }
+    
     void print_risk_status() const {
         std::lock_guard<std::mutex> lock(mutex_);
         
         printf("\n🛡️ === RISK MANAGER STATUS ===\n");
-        printf("🚨 Emergency Stop: %s\n", emergency_stop_active_ ? "ACTIVE" : "OFF");
+        printf("🚨 Emergency Stop: %s\n", (risk_state_.load() & STATE_EMERGENCY_STOP) ? "ACTIVE" : "OFF");
         printf("⚡ Circuit Breaker: %s\n", 
                is_circuit_breaker_cooling_down() ? "ACTIVE" : "OFF");
         printf("⚠️ Risk Violations Today: %d\n", risk_violations_today_.load());
+        printf("📉 Equity Band: %s\n", (risk_state_.load() & STATE_EQUITY_BREACH) ? "BREACH"
+                                      : (risk_state_.load() & STATE_EQUITY_WARNING) ? "WARNING" : "NORMAL");
+        printf("🐢 Slow-Path Checks: %llu\n", static_cast<unsigned long long>(slow_path_checks()));
         
         double current_equity = position_tracker_->get_total_equity();
         double daily_pnl = position_tracker_->get_daily_pnl();
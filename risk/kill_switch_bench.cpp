@@ -0,0 +1,241 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include "../kill_switch.hpp"
+#include "../order_manager.hpp"
+#include "../sequencer.hpp"
+
+/**
+ * Kill Switch Propagation Benchmark
+ *
+ * Forks emitter processes that attach to a private risk-state page and
+ * push orders through their own OrderManager as fast as they can (the
+ * venue side rejects each one so the order table never fills). The
+ * parent flips the operator kill and records, per trial, the time from
+ * the flip to the last order any emitter got onto its venue ring, and to
+ * the last emitter noticing the halt. The target is p99 flip-to-last-order
+ * under 10 us; the exit code is 2 if missed.
+ *
+ * On fewer cores than emitters + 1 the numbers measure the scheduler, not
+ * the cache line: give each emitter its own core (--pin) for a real bound.
+ *
+ * Usage: kill_switch_bench [--processes N] [--threads N] [--trials N] [--pin]
+ */
+
+namespace {
+
+constexpr double PROPAGATION_P99_TARGET_US = 10.0;
+constexpr size_t MAX_EMITTERS = 64;
+
+struct alignas(64) EmitterSlot {
+    std::atomic<uint64_t> orders;           // Orders that reached the venue ring
+    std::atomic<uint64_t> last_order_ns;
+    std::atomic<uint64_t> seen_ns;          // First observation of the halt in trial seen_trial
+    std::atomic<uint32_t> seen_trial;
+    std::atomic<uint32_t> ready;
+};
+
+// Anonymous shared mapping created before fork: parent <-> emitters coordination
+struct BenchControl {
+    std::atomic<uint32_t> trial;
+    std::atomic<uint32_t> done;
+    EmitterSlot slots[MAX_EMITTERS];
+};
+
+void emit_orders(BenchControl& control, EmitterSlot& slot, int cpu) {
+    if (cpu >= 0) hft::pin_current_thread(cpu);
+    hft::OrderManager oms(1024);
+    const hft::SymbolId symbol = 0;
+
+    slot.ready.store(1, std::memory_order_release);
+    while (!control.done.load(std::memory_order_relaxed)) {
+        if (oms.halted()) [[unlikely]] {
+            const uint32_t trial = control.trial.load(std::memory_order_acquire);
+            if (slot.seen_trial.load(std::memory_order_relaxed) != trial) {
+                slot.seen_ns.store(hft::get_timestamp_ns(), std::memory_order_relaxed);
+                slot.seen_trial.store(trial, std::memory_order_release);
+            }
+        }
+
+        hft::OrderRequest request{};
+        request.action = hft::OrderRequest::Action::NEW;
+        request.order_id = oms.reserve_order_id();
+        request.timestamp_ns = hft::get_timestamp_ns();
+        request.quantity = hft::to_fixed_quantity(1.0);
+        request.price = hft::to_fixed_price(100.0);
+        request.symbol = symbol;
+        request.side = hft::Side::BUY;
+        request.type = hft::OrderType::LIMIT;
+        request.venue = hft::Venue::BINANCE;
+        oms.submit(request);
+        oms.poll();
+
+        // Venue side: note the order's arrival, then reject it so the table drains
+        hft::SequencedMessage msg;
+        while (oms.poll_outbound(msg)) {
+            if (msg.type != hft::MessageType::NEW_ORDER) continue;
+            slot.last_order_ns.store(hft::get_timestamp_ns(), std::memory_order_relaxed);
+            slot.orders.fetch_add(1, std::memory_order_release);
+            hft::SequencedMessage reject{};
+            reject.type = hft::MessageType::ORDER_REJECT;
+            reject.order.order_id = msg.order.order_id;
+            oms.deliver(reject);
+        }
+        oms.poll();
+        hft::OrderUpdate update;
+        while (oms.poll_update(update)) {}
+    }
+}
+
+double percentile(std::vector<double> values, double q) {
+    if (values.empty()) return 0.0;
+    std::sort(values.begin(), values.end());
+    return values[std::min(values.size() - 1, static_cast<size_t>(q * values.size()))];
+}
+
+void print_distribution(const char* name, const std::vector<double>& us) {
+    double total = 0.0;
+    for (double v : us) total += v;
+    printf("   %-26s %9.2f %9.2f %9.2f %9.2f\n", name, us.empty() ? 0.0 : total / us.size(),
+           percentile(us, 0.50), percentile(us, 0.99), us.empty() ? 0.0 : *std::max_element(us.begin(), us.end()));
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    size_t processes = 2;
+    size_t threads = 1;
+    size_t trials = 200;
+    bool pin = false;
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        if (arg == "--processes" && i + 1 < argc) {
+            processes = std::strtoul(argv[++i], nullptr, 10);
+        } else if (arg == "--threads" && i + 1 < argc) {
+            threads = std::strtoul(argv[++i], nullptr, 10);
+        } else if (arg == "--trials" && i + 1 < argc) {
+            trials = std::strtoul(argv[++i], nullptr, 10);
+        } else if (arg == "--pin") {
+            pin = true;
+        } else {
+            printf("Usage: %s [--processes N] [--threads N] [--trials N] [--pin]\n", argv[0]);
+            return 1;
+        }
+    }
+    const size_t emitters = processes * threads;
+    if (emitters == 0 || emitters > MAX_EMITTERS || trials == 0) {
+        printf("❌ Need 1..%zu emitters and at least one trial\n", MAX_EMITTERS);
+        return 1;
+    }
+
+    const std::string name = "/hft_kill_bench_" + std::to_string(::getpid());
+    void* mapping = ::mmap(nullptr, sizeof(BenchControl), PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+    if (mapping == MAP_FAILED) return 1;
+    BenchControl& control = *new (mapping) BenchControl{};
+
+    hft::KillSwitch kill_switch;
+    if (!kill_switch.attach(name.c_str())) {
+        printf("❌ Cannot create risk state page %s\n", name.c_str());
+        return 1;
+    }
+
+    // Emitters attach the process-wide switch by name after fork, as a trading process would
+    std::vector<pid_t> children;
+    for (size_t p = 0; p < processes; ++p) {
+        const pid_t pid = ::fork();
+        if (pid == 0) {
+            if (!hft::KillSwitch::instance().attach(name.c_str())) ::_exit(1);
+            std::vector<std::thread> workers;
+            for (size_t t = 0; t < threads; ++t) {
+                const size_t index = p * threads + t;
+                workers.emplace_back(emit_orders, std::ref(control), std::ref(control.slots[index]),
+                                     pin ? static_cast<int>(index + 1) : -1);
+            }
+            for (auto& worker : workers) worker.join();
+            ::_exit(0);
+        }
+        if (pid > 0) children.push_back(pid);
+    }
+    if (pin) hft::pin_current_thread(0);
+
+    for (size_t i = 0; i < emitters; ++i) {
+        while (!control.slots[i].ready.load(std::memory_order_acquire)) std::this_thread::yield();
+    }
+
+    printf("\n🛑 Kill switch propagation: %zu process(es) x %zu thread(s), %zu trials, %u cores%s\n",
+           processes, threads, trials, std::thread::hardware_concurrency(), pin ? ", pinned" : "");
+    if (emitters + 1 > std::thread::hardware_concurrency()) {
+        printf("   ⚠️ More spinning threads than cores - results include scheduling delay\n");
+    }
+
+    std::mt19937 rng(42);
+    std::uniform_int_distribution<int> pause_us(20, 200);
+    std::vector<double> last_order_us, observed_us;
+    size_t late_trials = 0;
+    uint64_t total_orders = 0;
+
+    for (uint32_t trial = 1; trial <= trials; ++trial) {
+        // Resume and wait until every emitter has order flow again
+        kill_switch.resume(hft::KillSwitch::KILL, "bench resume");
+        std::vector<uint64_t> before(emitters);
+        for (size_t i = 0; i < emitters; ++i) before[i] = control.slots[i].orders.load(std::memory_order_acquire);
+        for (size_t i = 0; i < emitters; ++i) {
+            while (control.slots[i].orders.load(std::memory_order_acquire) <= before[i] + 1) std::this_thread::yield();
+        }
+        control.trial.store(trial, std::memory_order_release);
+        std::this_thread::sleep_for(std::chrono::microseconds(pause_us(rng)));
+
+        const uint64_t flip_ns = hft::get_timestamp_ns();
+        kill_switch.halt(hft::KillSwitch::KILL, "bench flip");
+
+        uint64_t last_seen = flip_ns;
+        for (size_t i = 0; i < emitters; ++i) {
+            EmitterSlot& slot = control.slots[i];
+            while (slot.seen_trial.load(std::memory_order_acquire) != trial) std::this_thread::yield();
+            last_seen = std::max(last_seen, slot.seen_ns.load(std::memory_order_relaxed));
+        }
+        // Let any order that passed its check before the flip land on the ring
+        std::this_thread::sleep_for(std::chrono::microseconds(200));
+
+        uint64_t last_order = 0;
+        for (size_t i = 0; i < emitters; ++i) {
+            last_order = std::max(last_order, control.slots[i].last_order_ns.load(std::memory_order_acquire));
+        }
+        if (last_order > flip_ns) late_trials++;
+        last_order_us.push_back(last_order > flip_ns ? (last_order - flip_ns) / 1000.0 : 0.0);
+        observed_us.push_back((last_seen - flip_ns) / 1000.0);
+    }
+
+    control.done.store(1, std::memory_order_release);
+    int failed_children = 0;
+    for (pid_t pid : children) {
+        int status = 0;
+        ::waitpid(pid, &status, 0);
+        if (!WIFEXITED(status) || WEXITSTATUS(status) != 0) failed_children++;
+    }
+    for (size_t i = 0; i < emitters; ++i) total_orders += control.slots[i].orders.load();
+    hft::KillSwitch::unlink(name.c_str());
+
+    printf("\n   %-26s %9s %9s %9s %9s\n", "after flip (us)", "mean", "p50", "p99", "max");
+    print_distribution("last order out", last_order_us);
+    print_distribution("last emitter halted", observed_us);
+    printf("\n   Orders sent: %llu; trials with an order after the flip: %zu of %zu\n",
+           static_cast<unsigned long long>(total_orders), late_trials, trials);
+    if (failed_children > 0) printf("   ⚠️ %d emitter process(es) failed to attach\n", failed_children);
+
+    const double p99 = percentile(last_order_us, 0.99);
+    const bool met = p99 < PROPAGATION_P99_TARGET_US && failed_children == 0;
+    printf("   %s Flip-to-last-order p99 %.2f us (target < %.0f us)\n\n",
+           met ? "✅" : "❌", p99, PROPAGATION_P99_TARGET_US);
+    return met ? 0 : 2;
+}
@@ -0,0 +1,126 @@
+#include <cerrno>
+#include <chrono>
+#include <csignal>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <thread>
+#include "../kill_switch.hpp"
+
+/**
+ * Kill Switch CLI (hft_kill)
+ *
+ * Flips or inspects the shared risk-state word every attached trading
+ * process gates its order flow on. halt sets the operator's KILL source;
+ * resume clears it (--all also clears every risk manager's source, e.g.
+ * an emergency stop whose owner is gone). Trading processes can only
+ * clear the sources they set themselves; this CLI overrides ownership.
+ * status lists the pid holding each source. watch prints every change.
+ *
+ * Usage: hft_kill [--name NAME] status | halt [reason] | resume [--all] | watch
+ * Exit code: 0 ok (status: clear), 1 usage or page error, 2 status: halted
+ */
+
+namespace {
+
+volatile std::sig_atomic_t watching = 1;
+
+void print_usage(const char* program) {
+    printf("Usage: %s [--name NAME] <command>\n"
+           "  status             Show the risk state (exit 2 if halted)\n"
+           "  halt [reason]      Set the operator kill: every attached process stops sending orders\n"
+           "  resume [--all]     Clear the operator kill (--all: every halt source)\n"
+           "  watch              Print each change until Ctrl+C\n"
+           "  --name NAME        Shared-memory page (default: %s)\n",
+           program, hft::KillSwitch::DEFAULT_NAME);
+}
+
+void print_state(const hft::KillSwitch& kill_switch, uint64_t word) {
+    const uint32_t flags = hft::KillSwitch::flags_of(word);
+    const uint64_t now = hft::get_timestamp_ns();
+    const uint64_t changed = kill_switch.changed_ns();
+    printf("%s  version %u  sources %s",
+           flags ? "🛑 HALTED" : "✅ CLEAR ", hft::KillSwitch::version_of(word),
+           hft::KillSwitch::describe(flags).c_str());
+    if (changed > 0) {
+        printf("  (changed %.3f s ago by pid %d: \"%s\")", now > changed ? (now - changed) / 1e9 : 0.0,
+               kill_switch.changed_by(), kill_switch.reason().c_str());
+    }
+    printf("\n");
+
+    const uint32_t stale = kill_switch.stale_sources();
+    for (uint32_t bit = 0; bit < 32; ++bit) {
+        const uint32_t source = 1u << bit;
+        if (!(flags & source)) continue;
+        printf("   %-18s held by pid %d%s\n", hft::KillSwitch::describe(source).c_str(),
+               kill_switch.owner(source), stale & source ? " (exited)" : "");
+    }
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const char* name = hft::KillSwitch::DEFAULT_NAME;
+    int arg = 1;
+    if (arg + 1 < argc && std::strcmp(argv[arg], "--name") == 0) {
+        name = argv[arg + 1];
+        arg += 2;
+    }
+    if (arg >= argc) {
+        print_usage(argv[0]);
+        return 1;
+    }
+    const std::string command = argv[arg++];
+    if (command != "status" && command != "halt" && command != "resume" && command != "watch") {
+        print_usage(argv[0]);
+        return 1;
+    }
+
+    hft::KillSwitch kill_switch;
+    if (!kill_switch.attach(name)) {
+        fprintf(stderr, "❌ Cannot map risk state page %s: %s\n", name, std::strerror(errno));
+        return 1;
+    }
+
+    if (command == "status") {
+        const uint64_t word = kill_switch.state();
+        print_state(kill_switch, word);
+        return hft::KillSwitch::is_halted(word) ? 2 : 0;
+    }
+
+    if (command == "halt") {
+        std::string reason;
+        for (; arg < argc; ++arg) {
+            if (!reason.empty()) reason += " ";
+            reason += argv[arg];
+        }
+        if (reason.empty()) reason = "operator kill";
+        print_state(kill_switch, kill_switch.halt(hft::KillSwitch::KILL, reason.c_str()));
+        return 0;
+    }
+
+    if (command == "resume") {
+        const bool all = arg < argc && std::strcmp(argv[arg], "--all") == 0;
+        const uint64_t word = kill_switch.override_resume(all ? hft::KillSwitch::ALL_SOURCES : hft::KillSwitch::KILL,
+                                                          all ? "operator resume (all sources)" : "operator resume");
+        print_state(kill_switch, word);
+        if (hft::KillSwitch::is_halted(word)) {
+            printf("   Other halt sources are still set; resume --all clears them\n");
+        }
+        return 0;
+    }
+
+    // watch
+    std::signal(SIGINT, [](int) { watching = 0; });
+    uint64_t last = kill_switch.state();
+    print_state(kill_switch, last);
+    while (watching) {
+        const uint64_t word = kill_switch.state();
+        if (word != last) {
+            print_state(kill_switch, word);
+            last = word;
+        }
+        std::this_thread::sleep_for(std::chrono::microseconds(100));
+    }
+    return 0;
+}
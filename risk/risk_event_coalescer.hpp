@@ -0,0 +1,342 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "../ring_buffer.hpp"
+#include "../sequencer.hpp"
+#include "../symbol_table.hpp"
+#include "../messages.hpp"
+
+namespace risk {
+
+enum class RiskEventType : uint8_t {
+    FILL,           // Position changed
+    MARK,           // New price for a symbol
+    LIMIT_CHANGE    // Limits, trading switches or emergency state changed
+};
+
+// One change notification; trivially copyable so it travels through the ring
+struct RiskEvent {
+    RiskEventType type = RiskEventType::MARK;
+    hft::Venue venue = hft::Venue::BINANCE;
+    hft::SymbolId symbol = hft::SymbolTable::MAX_SYMBOLS;   // MAX_SYMBOLS = no symbol
+    double quantity = 0.0;
+    double price = 0.0;
+    uint64_t timestamp_ns = 0;
+};
+
+/**
+ * Coalesced batch of risk events
+ *
+ * Each symbol appears once, carrying its latest price and timestamp and
+ * how many fills and marks it absorbed; handlers recompute those symbols
+ * and the aggregates that depend on them. overflowed() means the ring
+ * dropped events and everything must be treated as dirty; timer() marks a
+ * pass for time-driven checks, with or without events.
+ */
+class RiskDirtySet {
+public:
+    struct Symbol {
+        hft::SymbolId symbol;
+        hft::Venue venue;
+        double price;           // Latest, 0 if only fills without price arrived
+        uint64_t timestamp_ns;
+        uint32_t fills;
+        uint32_t marks;
+    };
+
+private:
+    std::vector<Symbol> symbols_;
+    std::vector<int32_t> slot_of_;      // Per SymbolId, index into symbols_ or -1
+    uint64_t events_ = 0;
+    uint32_t fills_ = 0;
+    uint32_t marks_ = 0;
+    uint32_t limit_changes_ = 0;
+    bool overflowed_ = false;
+    bool timer_ = false;
+
+public:
+    RiskDirtySet() : slot_of_(hft::SymbolTable::MAX_SYMBOLS, -1) {}
+
+    void add(const RiskEvent& event) {
+        ++events_;
+        if (event.type == RiskEventType::LIMIT_CHANGE) ++limit_changes_;
+        if (event.symbol >= hft::SymbolTable::MAX_SYMBOLS) return;
+
+        int32_t& slot = slot_of_[event.symbol];
+        if (slot < 0) {
+            slot = static_cast<int32_t>(symbols_.size());
+            symbols_.push_back(Symbol{event.symbol, event.venue, 0.0, 0, 0, 0});
+        }
+        Symbol& entry = symbols_[slot];
+        entry.venue = event.venue;
+        if (event.price > 0.0) entry.price = event.price;
+        entry.timestamp_ns = std::max(entry.timestamp_ns, event.timestamp_ns);
+        if (event.type == RiskEventType::FILL) {
+            ++entry.fills;
+            ++fills_;
+        } else if (event.type == RiskEventType::MARK) {
+            ++entry.marks;
+            ++marks_;
+        }
+    }
+
+    void clear() {
+        for (const Symbol& entry : symbols_) slot_of_[entry.symbol] = -1;
+        symbols_.clear();
+        events_ = 0;
+        fills_ = marks_ = limit_changes_ = 0;
+        overflowed_ = timer_ = false;
+    }
+
+    void set_overflowed() { overflowed_ = true; }
+    void set_timer() { timer_ = true; }
+
+    const std::vector<Symbol>& symbols() const { return symbols_; }
+    uint64_t events() const { return events_; }
+    uint32_t fills() const { return fills_; }
+    uint32_t marks() const { return marks_; }
+    bool limits_changed() const { return limit_changes_ > 0; }
+    bool overflowed() const { return overflowed_; }
+    bool timer() const { return timer_; }
+    bool empty() const { return events_ == 0 && !overflowed_; }
+};
+
+/**
+ * Risk Event Coalescer
+ *
+ * Event-driven replacement for sleep-polled risk monitoring threads.
+ * Producers (market data, fills, control actions) post RiskEvents into a
+ * lock-free MPSC ring and return; one risk thread, optionally pinned to a
+ * dedicated core, drains the ring into a RiskDirtySet and hands each
+ * batch to the subscribed handlers, which recompute only what the batch
+ * touched and publish the results atomically.
+ *
+ * Batches are dispatched at most once per min_interval_ns, so a burst of
+ * marks costs one recompute. With no events the thread sleeps; it wakes
+ * for a timer pass every timer_interval_ns so time-driven checks (stale
+ * heartbeats, scheduled stress tests) still run. Producers only touch the
+ * thread's mutex when it is parked.
+ */
+class RiskEventCoalescer {
+public:
+    struct Config {
+        uint64_t min_interval_ns = 1000000;          // At most one recompute per 1 ms
+        uint64_t timer_interval_ns = 1000000000;     // Timer pass every second
+        int cpu = -1;                                // Core for the risk thread (-1 = unpinned)
+    };
+
+    using Handler = std::function<void(const RiskDirtySet&)>;
+    static constexpr size_t RING_SIZE = 8192;
+
+    struct Stats {
+        uint64_t events = 0;
+        uint64_t batches = 0;
+        uint64_t timer_passes = 0;
+        uint64_t overflows = 0;
+        uint64_t max_batch_ns = 0;      // Slowest handler pass
+    };
+
+private:
+    Config config_;
+    std::vector<Handler> handlers_;
+    std::unique_ptr<hft::MPSCQueue<RiskEvent, RING_SIZE>> ring_;
+
+    alignas(64) std::atomic<uint64_t> posted_{0};
+    std::atomic<bool> overflow_{false};
+    alignas(64) std::atomic<uint64_t> processed_{0};   // Events whose batch has been handled
+    std::atomic<bool> sleeping_{false};
+    std::atomic<bool> flush_requested_{false};
+
+    std::atomic<bool> running_{false};
+    std::thread thread_;
+    std::mutex mutex_;
+    std::condition_variable wake_cv_;
+    std::condition_variable flushed_cv_;
+
+    RiskDirtySet dirty_;
+    uint64_t consumed_ = 0;             // Risk thread only
+    uint64_t last_batch_ns_ = 0;
+    uint64_t last_timer_ns_ = 0;
+
+    std::atomic<uint64_t> batches_{0};
+    std::atomic<uint64_t> timer_passes_{0};
+    std::atomic<uint64_t> overflows_{0};
+    std::atomic<uint64_t> max_batch_ns_{0};
+
+    static uint64_t now_ns() {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    bool pending() const {
+        return posted_.load() != consumed_ || overflow_.load();
+    }
+
+    void drain() {
+        RiskEvent event;
+        while (ring_->pop(event)) {
+            dirty_.add(event);
+            ++consumed_;
+        }
+        if (overflow_.exchange(false)) {
+            dirty_.set_overflowed();
+            overflows_.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    void dispatch(uint64_t now) {
+        if (now - last_timer_ns_ >= config_.timer_interval_ns) {
+            dirty_.set_timer();
+            last_timer_ns_ = now;
+            timer_passes_.fetch_add(1, std::memory_order_relaxed);
+        }
+        for (const Handler& handler : handlers_) handler(dirty_);
+
+        const uint64_t elapsed = now_ns() - now;
+        if (elapsed > max_batch_ns_.load(std::memory_order_relaxed)) {
+            max_batch_ns_.store(elapsed, std::memory_order_relaxed);
+        }
+        if (!dirty_.empty()) batches_.fetch_add(1, std::memory_order_relaxed);
+        dirty_.clear();
+        last_batch_ns_ = now;
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        processed_.store(consumed_, std::memory_order_release);
+        flushed_cv_.notify_all();
+    }
+
+    void run() {
+        if (config_.cpu >= 0) hft::pin_current_thread(config_.cpu);
+        last_timer_ns_ = now_ns();
+
+        while (running_.load(std::memory_order_acquire)) {
+            drain();
+            uint64_t now = now_ns();
+            const bool timer_due = now - last_timer_ns_ >= config_.timer_interval_ns;
+
+            if (dirty_.empty() && !timer_due) {
+                // Park until an event, the next timer pass or shutdown
+                std::unique_lock<std::mutex> lock(mutex_);
+                sleeping_.store(true);
+                wake_cv_.wait_for(lock, std::chrono::nanoseconds(last_timer_ns_ + config_.timer_interval_ns - now),
+                                  [this] { return pending() || !running_.load(); });
+                sleeping_.store(false);
+                continue;
+            }
+
+            // Coalesce: hold the batch open until min_interval since the last one
+            if (!dirty_.empty() && !timer_due && !flush_requested_.load() &&
+                now - last_batch_ns_ < config_.min_interval_ns) {
+                std::this_thread::sleep_for(std::chrono::nanoseconds(last_batch_ns_ + config_.min_interval_ns - now));
+                drain();
+                now = now_ns();
+            }
+            flush_requested_.store(false);
+            dispatch(now);
+        }
+    }
+
+public:
+    RiskEventCoalescer() : RiskEventCoalescer(Config{}) {}
+
+    explicit RiskEventCoalescer(const Config& config)
+        : config_(config), ring_(std::make_unique<hft::MPSCQueue<RiskEvent, RING_SIZE>>()) {}
+
+    ~RiskEventCoalescer() { stop(); }
+
+    RiskEventCoalescer(const RiskEventCoalescer&) = delete;
+    RiskEventCoalescer& operator=(const RiskEventCoalescer&) = delete;
+
+    // Register a batch handler; call before start(). Handlers run on the risk thread in order.
+    void subscribe(Handler handler) { handlers_.push_back(std::move(handler)); }
+
+    void start() {
+        if (running_.exchange(true)) return;
+        thread_ = std::thread(&RiskEventCoalescer::run, this);
+    }
+
+    // Join the risk thread; events still queued are not dispatched
+    void stop() {
+        if (!running_.exchange(false)) return;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            wake_cv_.notify_all();
+        }
+        if (thread_.joinable()) thread_.join();
+    }
+
+    /**
+     * Queue an event (any thread, lock-free unless the risk thread is parked)
+     *
+     * @return false if the ring was full; the next batch is then marked overflowed
+     */
+    bool post(const RiskEvent& event) {
+        const bool queued = ring_->push(event);
+        if (queued) {
+            posted_.fetch_add(1);
+        } else {
+            overflow_.store(true);
+        }
+        if (sleeping_.load()) {
+            std::lock_guard<std::mutex> lock(mutex_);
+            wake_cv_.notify_one();
+        }
+        return queued;
+    }
+
+    bool post_fill(hft::Venue venue, hft::SymbolId symbol, double quantity, double price, uint64_t timestamp_ns = 0) {
+        return post(RiskEvent{RiskEventType::FILL, venue, symbol, quantity, price, timestamp_ns});
+    }
+
+    bool post_mark(hft::Venue venue, hft::SymbolId symbol, double price, uint64_t timestamp_ns = 0) {
+        return post(RiskEvent{RiskEventType::MARK, venue, symbol, 0.0, price, timestamp_ns});
+    }
+
+    bool post_limit_change() {
+        return post(RiskEvent{RiskEventType::LIMIT_CHANGE, hft::Venue::BINANCE, hft::SymbolTable::MAX_SYMBOLS,
+                              0.0, 0.0, 0});
+    }
+
+    /**
+     * Block until every event posted before the call has been handled,
+     * skipping the coalescing delay. Without a running risk thread the
+     * batch is handled on the caller.
+     */
+    void flush() {
+        const uint64_t target = posted_.load();
+        if (!running_.load()) {
+            drain();
+            dispatch(now_ns());
+            return;
+        }
+        std::unique_lock<std::mutex> lock(mutex_);
+        flush_requested_.store(true);
+        wake_cv_.notify_one();
+        flushed_cv_.wait(lock, [&] {
+            return processed_.load(std::memory_order_acquire) >= target || !running_.load();
+        });
+    }
+
+    Stats stats() const {
+        Stats stats;
+        stats.events = processed_.load(std::memory_order_relaxed);
+        stats.batches = batches_.load(std::memory_order_relaxed);
+        stats.timer_passes = timer_passes_.load(std::memory_order_relaxed);
+        stats.overflows = overflows_.load(std::memory_order_relaxed);
+        stats.max_batch_ns = max_batch_ns_.load(std::memory_order_relaxed);
+        return stats;
+    }
+
+    bool running() const { return running_.load(); }
+    const Config& config() const { return config_; }
+};
+
+} // namespace risk
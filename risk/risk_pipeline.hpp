@@ -0,0 +1,380 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <string>
+#include "../position_tracker.hpp"
+#include "../messages.hpp"
+#include "../symbol_table.hpp"
+
+namespace risk {
+
+/**
+ * Layer a pipeline stage was contributed by
+ */
+enum class RiskLayer : uint8_t {
+    UNIFIED,
+    INSTITUTIONAL,
+    COMPREHENSIVE,
+    ENHANCED
+};
+
+inline const char* risk_layer_name(RiskLayer layer) {
+    switch (layer) {
+        case RiskLayer::UNIFIED: return "UNIFIED";
+        case RiskLayer::INSTITUTIONAL: return "INSTITUTIONAL";
+        case RiskLayer::COMPREHENSIVE: return "COMPREHENSIVE";
+        case RiskLayer::ENHANCED: return "ENHANCED";
+        default: return "UNKNOWN";
+    }
+}
+
+// Asset classes a symbol's limits are keyed on (from its name, e.g. "BTC/USD")
+constexpr uint8_t ASSET_BTC = 1u << 0;
+constexpr uint8_t ASSET_ETH = 1u << 1;
+
+inline uint8_t classify_assets(const std::string& symbol) {
+    return (symbol.find("BTC") != std::string::npos ? ASSET_BTC : 0) |
+           (symbol.find("ETH") != std::string::npos ? ASSET_ETH : 0);
+}
+
+/**
+ * Risk Check Context
+ *
+ * One order plus the portfolio state several layers need, looked up once
+ * per check instead of once per layer. Stages read it and may set the
+ * risk score and a static rejection reason; nothing in it allocates.
+ */
+struct RiskCheckContext {
+    // Order
+    hft::Venue venue;
+    hft::SymbolId symbol;
+    double quantity;
+    double price;
+    double spread_bps;
+    uint64_t timestamp_ns;              // Rate-limit time, e.g. the triggering event's; 0 reads the clock
+    const char* exchange;               // Venue name, or the caller's string for an unknown venue
+
+    // Shared state, filled by load_shared_state()
+    double notional = 0.0;
+    double position = 0.0;              // Current position on (venue, symbol)
+    double new_position = 0.0;          // ... after this order
+    double equity = 0.0;
+    double daily_pnl = 0.0;
+    double drawdown = 0.0;
+    ExchangeBalance balance;
+    bool funded = false;                // The venue holds a balance
+    uint8_t assets = 0;                 // ASSET_* bits
+
+    // Set by stages
+    double risk_score = 0.0;
+    const char* reject_reason = nullptr;
+
+    RiskCheckContext(hft::Venue order_venue, hft::SymbolId order_symbol, double order_quantity,
+                     double order_price, double order_spread_bps = 0.0, uint64_t order_timestamp_ns = 0,
+                     const char* exchange_name = nullptr)
+        : venue(order_venue), symbol(order_symbol), quantity(order_quantity), price(order_price),
+          spread_bps(order_spread_bps), timestamp_ns(order_timestamp_ns),
+          exchange(exchange_name ? exchange_name
+                   : static_cast<size_t>(order_venue) < hft::VENUE_COUNT ? hft::venue_name(order_venue)
+                   : "UNKNOWN") {}
+
+    bool known_venue() const { return static_cast<size_t>(venue) < hft::VENUE_COUNT; }
+};
+
+// One position copy, one balance copy and three aggregate loads; an unknown venue has neither
+inline void load_shared_state(const PositionTracker& tracker, RiskCheckContext& ctx) {
+    ctx.notional = std::abs(ctx.quantity * ctx.price);
+    ctx.position = tracker.get_position(ctx.venue, ctx.symbol).quantity;
+    ctx.new_position = ctx.position + ctx.quantity;
+    ctx.funded = tracker.get_balance(ctx.venue, ctx.balance);
+    ctx.equity = tracker.get_total_equity();
+    ctx.daily_pnl = tracker.get_daily_pnl();
+    ctx.drawdown = tracker.get_max_drawdown();
+}
+
+/**
+ * One check contributed by a risk layer
+ */
+struct RiskStage {
+    using CheckFn = bool (*)(void* owner, RiskCheckContext& ctx);
+
+    const char* name = "";
+    RiskLayer layer = RiskLayer::ENHANCED;
+    CheckFn check = nullptr;
+    void* owner = nullptr;
+    double cost_ns = 0.0;               // Estimated cost until measured
+    double reject_rate = 0.0;           // Prior rejection probability until observed
+    bool consumes = false;              // Uses up a budget (rate limit): runs after all others, in order added
+};
+
+/**
+ * Risk Pipeline
+ *
+ * The layered managers contribute their checks as stages, and the pipeline
+ * runs them as one ordered pass over a shared RiskCheckContext: the first
+ * failing stage rejects the order. compile() orders stages by expected cost
+ * per rejection (cheap, frequently rejecting checks first), from the hints
+ * given at registration until enough samples exist, then from observed
+ * rejection counts and sampled latencies. Budget-consuming stages always
+ * run last so refused orders do not spend them.
+ *
+ * The compiled order is one atomic word (4 bits per stage, the count in
+ * the top nibble), so a recompile from a monitoring thread never blocks
+ * checks. Every SAMPLE_INTERVAL-th check times each stage; the rest only
+ * bump the check counter, and a rejection bumps its stage's counter.
+ *
+ * Stages are added before the first compile() and never removed. Until
+ * the first compile() the pipeline fails closed: run() rejects every order.
+ */
+class RiskPipeline {
+public:
+    static constexpr size_t MAX_STAGES = 15;
+    static constexpr uint64_t SAMPLE_INTERVAL = 256;    // Under 1% of checks, so p99 is the untimed pass
+    static constexpr uint64_t MIN_SAMPLES = 32;         // Per stage before measurements replace the hints
+    static constexpr double PRIOR_WEIGHT = 100.0;       // Pseudo-checks the reject_rate hint is worth
+
+    struct StageStats {
+        const char* name = "";
+        RiskLayer layer = RiskLayer::ENHANCED;
+        size_t position = 0;            // Index in the compiled order
+        uint64_t rejections = 0;
+        double reject_rate = 0.0;       // Of the checks that reached the stage (estimated)
+        double mean_ns = 0.0;           // Sampled; the cost hint until MIN_SAMPLES
+    };
+
+private:
+    // Never a compiled word: stage index 15 does not exist
+    static constexpr uint64_t UNCOMPILED = ~0ULL;
+    static constexpr RiskStage UNCOMPILED_STAGE{"uncompiled", RiskLayer::UNIFIED};
+
+    struct StageSlot {
+        RiskStage stage;
+        std::atomic<uint64_t> rejections{0};
+        std::atomic<uint64_t> sampled_runs{0};
+        std::atomic<uint64_t> sampled_ns{0};
+    };
+
+    const PositionTracker* tracker_;
+    std::array<StageSlot, MAX_STAGES> slots_;
+    size_t count_ = 0;
+
+    std::atomic<uint64_t> order_{UNCOMPILED};
+    std::unique_ptr<std::atomic<uint8_t>[]> assets_;    // Per SymbolId: 0 = unclassified, else 0x80 | ASSET_*
+
+    alignas(64) std::atomic<uint64_t> checks_{0};
+    std::atomic<uint64_t> sampled_checks_{0};
+    std::atomic<uint64_t> compiled_at_checks_{0};
+    std::mutex compile_mutex_;
+    uint64_t clock_overhead_ns_ = 0;                     // Cost of one steady_clock read, taken off each sample
+
+    static uint64_t measure_clock_overhead() {
+        uint64_t best = ~0ULL;
+        for (int i = 0; i < 1000; ++i) {
+            const auto t0 = std::chrono::steady_clock::now();
+            const auto t1 = std::chrono::steady_clock::now();
+            best = std::min<uint64_t>(best, std::chrono::duration_cast<std::chrono::nanoseconds>(t1 - t0).count());
+        }
+        return best;
+    }
+
+    uint8_t assets_of(hft::SymbolId symbol) {
+        if (symbol >= hft::SymbolTable::MAX_SYMBOLS) {
+            return classify_assets(hft::SymbolTable::instance().name(symbol));
+        }
+        uint8_t cached = assets_[symbol].load(std::memory_order_relaxed);
+        if (cached == 0) [[unlikely]] {
+            cached = 0x80 | classify_assets(hft::SymbolTable::instance().name(symbol));
+            assets_[symbol].store(cached, std::memory_order_relaxed);
+        }
+        return cached & 0x7F;
+    }
+
+    // Expected-cost estimates for one stage, measured once it has MIN_SAMPLES
+    void estimate(const StageSlot& slot, uint64_t checks, uint64_t sampled_checks,
+                  double& cost_ns, double& reject_rate) const {
+        cost_ns = slot.stage.cost_ns;
+        reject_rate = slot.stage.reject_rate;
+        const uint64_t runs = slot.sampled_runs.load(std::memory_order_relaxed);
+        if (runs < MIN_SAMPLES || sampled_checks == 0) return;
+
+        cost_ns = static_cast<double>(slot.sampled_ns.load(std::memory_order_relaxed)) / runs;
+        // Sampled checks reach the stage in the same proportion as all checks
+        const double reached = static_cast<double>(checks) * runs / sampled_checks;
+        reject_rate = (slot.rejections.load(std::memory_order_relaxed) + slot.stage.reject_rate * PRIOR_WEIGHT) /
+                      (reached + PRIOR_WEIGHT);
+    }
+
+    const RiskStage* run_sampled(RiskCheckContext& ctx, uint64_t order, size_t count) {
+        sampled_checks_.fetch_add(1, std::memory_order_relaxed);
+        auto start = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < count; ++i, order >>= 4) {
+            StageSlot& slot = slots_[order & 0xF];
+            const bool passed = slot.stage.check(slot.stage.owner, ctx);
+            const auto end = std::chrono::steady_clock::now();
+            const uint64_t elapsed_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count();
+            slot.sampled_runs.fetch_add(1, std::memory_order_relaxed);
+            slot.sampled_ns.fetch_add(elapsed_ns > clock_overhead_ns_ ? elapsed_ns - clock_overhead_ns_ : 0,
+                                      std::memory_order_relaxed);
+            start = end;
+            if (!passed) {
+                slot.rejections.fetch_add(1, std::memory_order_relaxed);
+                return &slot.stage;
+            }
+        }
+        return nullptr;
+    }
+
+public:
+    explicit RiskPipeline(const PositionTracker* tracker)
+        : tracker_(tracker),
+          assets_(std::make_unique<std::atomic<uint8_t>[]>(hft::SymbolTable::MAX_SYMBOLS)),
+          clock_overhead_ns_(measure_clock_overhead()) {}
+
+    RiskPipeline(const RiskPipeline&) = delete;
+    RiskPipeline& operator=(const RiskPipeline&) = delete;
+
+    /**
+     * Register Owner::Check (a bool(RiskCheckContext&) member) as a stage
+     *
+     * @param cost_ns     Estimated cost, used until measured
+     * @param reject_rate Estimated rejection probability, the prior for the observed rate
+     * @param consumes    Spends a budget when it passes: pinned after every other stage
+     */
+    template<auto Check, typename Owner>
+    void add_stage(const char* name, RiskLayer layer, Owner* owner,
+                   double cost_ns, double reject_rate, bool consumes = false) {
+        if (count_ >= MAX_STAGES) {
+            printf("⚠️ Risk pipeline full - stage %s not added\n", name);
+            return;
+        }
+        RiskStage& stage = slots_[count_++].stage;
+        stage.name = name;
+        stage.layer = layer;
+        stage.check = [](void* self, RiskCheckContext& ctx) { return (static_cast<Owner*>(self)->*Check)(ctx); };
+        stage.owner = owner;
+        stage.cost_ns = cost_ns;
+        stage.reject_rate = reject_rate;
+        stage.consumes = consumes;
+    }
+
+    /**
+     * Order stages by expected cost per rejection and publish the order
+     */
+    void compile() {
+        std::lock_guard<std::mutex> lock(compile_mutex_);
+        const uint64_t checks = checks_.load(std::memory_order_relaxed);
+        const uint64_t sampled_checks = sampled_checks_.load(std::memory_order_relaxed);
+
+        std::array<double, MAX_STAGES> rank{};
+        std::array<uint8_t, MAX_STAGES> order{};
+        for (size_t i = 0; i < count_; ++i) {
+            double cost_ns, reject_rate;
+            estimate(slots_[i], checks, sampled_checks, cost_ns, reject_rate);
+            rank[i] = cost_ns / std::max(reject_rate, 1e-9);
+            order[i] = static_cast<uint8_t>(i);
+        }
+        std::stable_sort(order.begin(), order.begin() + count_, [&](uint8_t a, uint8_t b) {
+            const bool a_consumes = slots_[a].stage.consumes;
+            const bool b_consumes = slots_[b].stage.consumes;
+            if (a_consumes != b_consumes) return b_consumes;
+            return !a_consumes && rank[a] < rank[b];
+        });
+
+        uint64_t word = static_cast<uint64_t>(count_) << 60;
+        for (size_t i = 0; i < count_; ++i) {
+            word |= static_cast<uint64_t>(order[i]) << (4 * i);
+        }
+        order_.store(word, std::memory_order_release);
+        compiled_at_checks_.store(checks, std::memory_order_relaxed);
+    }
+
+    // Recompile once min_new_checks have run since the last compile; for monitoring loops
+    bool maybe_recompile(uint64_t min_new_checks = 4096) {
+        if (checks_.load(std::memory_order_relaxed) - compiled_at_checks_.load(std::memory_order_relaxed) < min_new_checks) {
+            return false;
+        }
+        compile();
+        return true;
+    }
+
+    /**
+     * Run every stage in compiled order over ctx
+     *
+     * @return The rejecting stage, or nullptr if the order passed
+     *         (an "uncompiled" stage before the first compile())
+     */
+    const RiskStage* run(RiskCheckContext& ctx) {
+        load_shared_state(*tracker_, ctx);
+        ctx.assets = assets_of(ctx.symbol);
+
+        uint64_t order = order_.load(std::memory_order_acquire);
+        if (order == UNCOMPILED) [[unlikely]] {
+            ctx.reject_reason = "Risk pipeline not compiled";
+            return &UNCOMPILED_STAGE;
+        }
+        const size_t count = static_cast<size_t>(order >> 60);
+        if ((checks_.fetch_add(1, std::memory_order_relaxed) & (SAMPLE_INTERVAL - 1)) == 0) [[unlikely]] {
+            return run_sampled(ctx, order, count);
+        }
+        for (size_t i = 0; i < count; ++i, order >>= 4) {
+            StageSlot& slot = slots_[order & 0xF];
+            if (!slot.stage.check(slot.stage.owner, ctx)) [[unlikely]] {
+                slot.rejections.fetch_add(1, std::memory_order_relaxed);
+                return &slot.stage;
+            }
+        }
+        return nullptr;
+    }
+
+    size_t stage_count() const { return count_; }
+    uint64_t checks() const { return checks_.load(std::memory_order_relaxed); }
+
+    // Stats for the stage at a position in the compiled order
+    StageStats stage_stats(size_t position) const {
+        StageStats stats;
+        const uint64_t order = order_.load(std::memory_order_acquire);
+        if (order == UNCOMPILED || position >= static_cast<size_t>(order >> 60)) return stats;
+
+        const StageSlot& slot = slots_[(order >> (4 * position)) & 0xF];
+        const uint64_t checks = checks_.load(std::memory_order_relaxed);
+        const uint64_t sampled_checks = sampled_checks_.load(std::memory_order_relaxed);
+        const uint64_t runs = slot.sampled_runs.load(std::memory_order_relaxed);
+        double cost_ns, reject_rate;
+        estimate(slot, checks, sampled_checks, cost_ns, reject_rate);
+
+        stats.name = slot.stage.name;
+        stats.layer = slot.stage.layer;
+        stats.position = position;
+        stats.rejections = slot.rejections.load(std::memory_order_relaxed);
+        stats.reject_rate = runs > 0 && sampled_checks > 0
+            ? stats.rejections / std::max(1.0, static_cast<double>(checks) * runs / sampled_checks) : 0.0;
+        stats.mean_ns = cost_ns;
+        return stats;
+    }
+
+    void print_stats(const char* title) const {
+        uint64_t rejected = 0;
+        for (size_t i = 0; i < count_; ++i) rejected += slots_[i].rejections.load(std::memory_order_relaxed);
+        const uint64_t checks = checks_.load(std::memory_order_relaxed);
+
+        printf("\n🧮 %s Risk Pipeline: %llu checks, %llu approved\n", title,
+               static_cast<unsigned long long>(checks),
+               static_cast<unsigned long long>(checks > rejected ? checks - rejected : 0));
+        printf("  %-3s %-32s %-14s %10s %9s %9s\n", "#", "stage", "layer", "rejects", "reject%", "mean ns");
+        for (size_t i = 0; i < count_; ++i) {
+            const StageStats stats = stage_stats(i);
+            printf("  %-3zu %-32s %-14s %10llu %8.2f%% %9.1f\n", i + 1, stats.name, risk_layer_name(stats.layer),
+                   static_cast<unsigned long long>(stats.rejections), stats.reject_rate * 100.0, stats.mean_ns);
+        }
+    }
+};
+
+} // namespace risk
@@ -0,0 +1,161 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "../symbol_table.hpp"
+
+namespace risk {
+
+/**
+ * Stress Shock Matrix
+ *
+ * Stress scenarios compiled into a scenario x risk-factor matrix of
+ * fractional P&L shocks, and the book reduced to a dollar exposure per
+ * factor, so every scenario's P&L is one matrix-vector product pnl = S e.
+ *
+ * The product is kept current incrementally: a position change moves one
+ * symbol's exposure, which moves one factor's exposure by d, and that adds
+ * d * S[:, f] to pnl. S is stored factor-major so this is one contiguous
+ * pass over the scenarios; worst-case loss is re-derived in the same pass.
+ * rebuild() recomputes the full product to clear floating-point drift.
+ *
+ * Single writer: callers serialize updates (InstitutionalRiskManager holds
+ * its stress mutex).
+ */
+class StressShockMatrix {
+public:
+    static constexpr int NO_FACTOR = -1;      // Symbol mapped, but no stress factor applies
+    static constexpr int UNMAPPED = -2;       // Symbol not seen yet
+
+private:
+    std::vector<std::string> factor_names_;
+    std::vector<std::string> scenario_names_;
+    std::vector<double> shocks_;              // shocks_[factor * scenario_count + scenario]
+    std::vector<double> factor_exposure_;
+    std::vector<double> pnl_;                 // Per scenario, = S * factor_exposure_
+
+    std::vector<int16_t> factor_of_;          // Per SymbolId
+    std::vector<double> symbol_exposure_;     // Per SymbolId, last exposure applied
+
+    size_t worst_scenario_ = 0;
+    uint64_t updates_ = 0;
+
+    void find_worst() {
+        worst_scenario_ = 0;
+        for (size_t s = 1; s < pnl_.size(); ++s) {
+            if (pnl_[s] < pnl_[worst_scenario_]) worst_scenario_ = s;
+        }
+    }
+
+public:
+    StressShockMatrix()
+        : factor_of_(hft::SymbolTable::MAX_SYMBOLS, UNMAPPED),
+          symbol_exposure_(hft::SymbolTable::MAX_SYMBOLS, 0.0) {}
+
+    // Register a risk factor; all factors must be added before the first scenario
+    size_t add_factor(const std::string& name) {
+        factor_names_.push_back(name);
+        factor_exposure_.push_back(0.0);
+        return factor_names_.size() - 1;
+    }
+
+    /**
+     * Add one scenario row (one fractional shock per factor) and rebuild the
+     * product with the current exposures
+     */
+    size_t add_scenario(const std::string& name, const std::vector<double>& factor_shocks) {
+        const size_t old_count = scenario_names_.size();
+        const size_t new_count = old_count + 1;
+        std::vector<double> shocks(factor_names_.size() * new_count, 0.0);
+        for (size_t f = 0; f < factor_names_.size(); ++f) {
+            std::copy_n(shocks_.begin() + f * old_count, old_count, shocks.begin() + f * new_count);
+            shocks[f * new_count + old_count] = f < factor_shocks.size() ? factor_shocks[f] : 0.0;
+        }
+        shocks_ = std::move(shocks);
+        scenario_names_.push_back(name);
+        rebuild();
+        return old_count;
+    }
+
+    void map_symbol(hft::SymbolId symbol, int factor) {
+        if (symbol < factor_of_.size()) factor_of_[symbol] = static_cast<int16_t>(factor);
+    }
+
+    int factor_of(hft::SymbolId symbol) const {
+        return symbol < factor_of_.size() ? factor_of_[symbol] : NO_FACTOR;
+    }
+
+    // Add d dollars of exposure to one factor: pnl += d * S[:, factor]
+    void apply(size_t factor, double delta) {
+        if (factor >= factor_exposure_.size() || delta == 0.0) return;
+        factor_exposure_[factor] += delta;
+
+        const size_t count = scenario_names_.size();
+        const double* column = shocks_.data() + factor * count;
+        double* pnl = pnl_.data();
+        size_t worst = 0;
+        for (size_t s = 0; s < count; ++s) {
+            pnl[s] += delta * column[s];
+            if (pnl[s] < pnl[worst]) worst = s;
+        }
+        worst_scenario_ = worst;
+        ++updates_;
+    }
+
+    /**
+     * Set a mapped symbol's total dollar exposure, applying the change to its factor
+     *
+     * @return false if the symbol has not been mapped yet
+     */
+    bool set_exposure(hft::SymbolId symbol, double exposure) {
+        const int factor = factor_of(symbol);
+        if (factor == UNMAPPED) return false;
+        const double delta = exposure - symbol_exposure_[symbol];
+        symbol_exposure_[symbol] = exposure;
+        if (factor >= 0) apply(static_cast<size_t>(factor), delta);
+        return true;
+    }
+
+    // Recompute pnl = S e from the factor exposures
+    void rebuild() {
+        const size_t count = scenario_names_.size();
+        pnl_.assign(count, 0.0);
+        for (size_t f = 0; f < factor_exposure_.size(); ++f) {
+            const double e = factor_exposure_[f];
+            if (e == 0.0) continue;
+            const double* column = shocks_.data() + f * count;
+            for (size_t s = 0; s < count; ++s) pnl_[s] += e * column[s];
+        }
+        find_worst();
+    }
+
+    // Re-derive factor exposures from per-symbol exposures, then rebuild
+    void resync() {
+        std::fill(factor_exposure_.begin(), factor_exposure_.end(), 0.0);
+        for (size_t symbol = 0; symbol < factor_of_.size(); ++symbol) {
+            if (factor_of_[symbol] >= 0) factor_exposure_[factor_of_[symbol]] += symbol_exposure_[symbol];
+        }
+        rebuild();
+    }
+
+    double scenario_pnl(size_t scenario) const { return pnl_[scenario]; }
+    double shock(size_t scenario, size_t factor) const { return shocks_[factor * scenario_names_.size() + scenario]; }
+    double factor_exposure(size_t factor) const { return factor_exposure_[factor]; }
+    double symbol_exposure(hft::SymbolId symbol) const {
+        return symbol < symbol_exposure_.size() ? symbol_exposure_[symbol] : 0.0;
+    }
+
+    // Largest loss across scenarios (0 if every scenario gains)
+    double worst_loss() const { return pnl_.empty() ? 0.0 : std::max(0.0, -pnl_[worst_scenario_]); }
+    size_t worst_scenario() const { return worst_scenario_; }
+
+    size_t scenario_count() const { return scenario_names_.size(); }
+    size_t factor_count() const { return factor_names_.size(); }
+    const std::string& scenario_name(size_t scenario) const { return scenario_names_[scenario]; }
+    const std::string& factor_name(size_t factor) const { return factor_names_[factor]; }
+    uint64_t updates() const { return updates_; }
+};
+
+} // namespace risk
@@ -11,8 +11,11 @@
 #include "comprehensive_risk_manager.hpp"
 #include "../monitor/system_health_monitor.hpp"
 #include "enhanced_risk_manager.hpp"
+#include "risk_pipeline.hpp"
+#include "risk_event_coalescer.hpp"
 #include "../position_tracker.hpp"
 #include "../messages.hpp"
+#include "../io_service.hpp"
 
 namespace risk {
 
@@ -55,6 +58,20 @@ struct TradingAuthorizationResponse {
  * Central coordination point for all risk management components.
  * Provides a single interface for trading systems to check risk controls
  * and get comprehensive risk assessment before executing trades.
+ *
+ * Its own checks (status, system health, risk score) and every check of
+ * the comprehensive and enhanced layers are compiled into one RiskPipeline,
+ * so an authorization is a single ordered pass over one shared context.
+ *
+ * Market data, fills and control actions post events to a
+ * RiskEventCoalescer; its risk thread re-derives the control status and
+ * recompiles the pipeline order once per coalesced batch, plus a timer
+ * pass every monitoring interval for health changes that arrive without
+ * an event.
+ *
+ * Disabling trading and emergency stops are also published to the
+ * process-wide kill switch, and a kill set elsewhere (another process,
+ * the hft_kill CLI) rejects orders here too.
  */
 class UnifiedRiskController {
 private:
@@ -67,16 +84,17 @@ private:
     std::atomic<RiskControlStatus> current_status_{RiskControlStatus::NORMAL};
     std::atomic<bool> trading_enabled_{true};
     std::atomic<bool> emergency_override_active_{false};
+    hft::KillSwitch& kill_switch_ = hft::KillSwitch::instance();
+    const std::atomic<uint64_t>* kill_word_ = kill_switch_.word();
     
     // Event logging
     std::vector<RiskControlEvent> recent_events_;
     mutable std::mutex events_mutex_;
     static constexpr size_t MAX_RECENT_EVENTS = 1000;
     
-    // Monitoring thread
-    std::atomic<bool> monitoring_active_{false};
-    std::thread monitoring_thread_;
-    std::atomic<uint32_t> monitoring_interval_ms_{500}; // 500ms monitoring interval
+    // Event-driven monitoring: status recomputed per coalesced batch, timer pass every interval
+    std::atomic<uint32_t> monitoring_interval_ms_{500}; // 500ms timer pass when idle
+    RiskEventCoalescer events_;
     
     // Risk scoring weights
     struct RiskWeights {
@@ -90,15 +108,43 @@ private:
     // Callback functions for risk events
     std::vector<std::function<void(const RiskControlEvent&)>> event_callbacks_;
     std::mutex callbacks_mutex_;
+    
+    // Stage names; rejections are told apart by pointer
+    static constexpr const char* STATUS_STAGE = "unified.status";
+    static constexpr const char* SYSTEM_HEALTH_STAGE = "unified.system_health";
+    static constexpr const char* RISK_SCORE_STAGE = "unified.risk_score";
+    RiskPipeline pipeline_;
 
 public:
-    UnifiedRiskController(PositionTracker* position_tracker) 
+    /**
+     * @param risk_thread_cpu Core for the coalesced risk thread (-1 = unpinned).
+     *        Give it the same core as InstitutionalRiskLimits::risk_thread_cpu
+     *        so all risk recomputation shares the one dedicated risk core.
+     */
+    explicit UnifiedRiskController(PositionTracker* position_tracker, int risk_thread_cpu = -1)
         : position_tracker_(position_tracker),
           comprehensive_risk_manager_(std::make_unique<ComprehensiveRiskManager>(position_tracker)),
-          system_health_monitor_(std::make_unique<SystemHealthMonitor>()) {
+          system_health_monitor_(std::make_unique<SystemHealthMonitor>()),
+          events_(RiskEventCoalescer::Config{1000000, monitoring_interval_ms_.load() * 1000000ULL,
+                                            risk_thread_cpu}),
+          pipeline_(position_tracker) {
+        
+        pipeline_.add_stage<&UnifiedRiskController::check_control_status>(
+            STATUS_STAGE, RiskLayer::UNIFIED, this, 2.0, 0.01);
+        pipeline_.add_stage<&UnifiedRiskController::check_system_health>(
+            SYSTEM_HEALTH_STAGE, RiskLayer::UNIFIED, this, 3.0, 0.005);
+        pipeline_.add_stage<&UnifiedRiskController::check_risk_score>(
+            RISK_SCORE_STAGE, RiskLayer::UNIFIED, this, 10.0, 0.01);
+        comprehensive_risk_manager_->append_risk_stages(pipeline_);
+        pipeline_.compile();
         
         printf("🎛️ Unified Risk Controller initialized\n");
         printf("   Monitoring interval: %dms\n", monitoring_interval_ms_.load());
+        if (risk_thread_cpu >= 0) {
+            printf("   Risk thread core: %d\n", risk_thread_cpu);
+        } else {
+            printf("   Risk thread core: unpinned\n");
+        }
         printf("   Trading status: %s\n", trading_enabled_ ? "ENABLED" : "DISABLED");
         
         // Start monitoring threads
@@ -122,97 +168,21 @@ public:
         double price,
         double current_spread_bps = 0.0) {
         
-        TradingAuthorizationResponse response;
-        response.system_status = current_status_.load();
-        
-        // 1. Check if trading is globally enabled
-        if (!trading_enabled_) {
-            response.authorized = false;
-            response.rejection_reason = "Trading globally disabled";
-            response.confidence_score = 0.0;
-            return response;
-        }
-        
-        // 2. Check emergency override
-        if (emergency_override_active_) {
-            response.authorized = false;
-            response.rejection_reason = "Emergency override active - manual intervention required";
-            response.confidence_score = 0.0;
-            return response;
-        }
-        
-        // 3. Check system status
-        if (current_status_ == RiskControlStatus::EMERGENCY_STOP) {
-            response.authorized = false;
-            response.rejection_reason = "Emergency stop active";
-            response.confidence_score = 0.0;
-            return response;
+        hft::Venue venue;
+        if (!hft::venue_from_name(exchange.c_str(), venue)) {
+            venue = static_cast<hft::Venue>(hft::VENUE_COUNT);
         }
-        
-        if (current_status_ == RiskControlStatus::CRITICAL) {
-            response.authorized = false;
-            response.rejection_reason = "Critical risk conditions detected";
-            response.confidence_score = 0.0;
-            return response;
-        }
-        
-        // 4. Run comprehensive risk checks
-        bool comprehensive_check = comprehensive_risk_manager_->can_execute_trade(
-            exchange, symbol, quantity, price, current_spread_bps);
-        
-        if (!comprehensive_check) {
-            response.authorized = false;
-            response.rejection_reason = "Comprehensive risk manager rejected trade";
-            response.confidence_score = 0.2;
-            return response;
-        }
-        
-        // 5. Check system health
-        if (!system_health_monitor_->is_system_healthy()) {
-            response.authorized = false;
-            response.rejection_reason = "System health concerns detected";
-            response.confidence_score = 0.3;
-            return response;
-        }
-        
-        // 6. Calculate risk score and confidence
-        double risk_score = calculate_trade_risk_score(exchange, symbol, quantity, price);
-        response.confidence_score = std::max(0.0, 1.0 - risk_score);
-        
-        // 7. Add warnings for elevated risk conditions
-        collect_risk_warnings(response.warnings);
-        
-        // 8. Final authorization decision
-        if (risk_score < 0.8 && response.confidence_score > 0.5) {
-            response.authorized = true;
-            
-            // Log successful authorization
-            log_risk_event(RiskControlEvent{
-                static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
-                    std::chrono::high_resolution_clock::now().time_since_epoch()).count()),
-                current_status_.load(),
-                "UNIFIED_CONTROLLER",
-                "Trade authorized: " + symbol + " qty=" + std::to_string(quantity),
-                "AUTHORIZED",
-                risk_score
-            });
-        } else {
-            response.authorized = false;
-            response.rejection_reason = "Risk score too high: " + std::to_string(risk_score);
-            
-            // Log rejection
-            log_risk_event(RiskControlEvent{
-                static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
-                    std::chrono::high_resolution_clock::now().time_since_epoch()).count()),
-                current_status_.load(),
-                "UNIFIED_CONTROLLER",
-                "Trade rejected: " + symbol + " risk_score=" + std::to_string(risk_score),
-                "REJECTED",
-                risk_score
-            });
-        }
-        
-        return response;
+        RiskCheckContext ctx(venue, hft::SymbolTable::instance().intern(symbol), quantity, price,
+                             current_spread_bps, 0, exchange.c_str());
+        return authorize(ctx);
+    }
+    
+    // Same check keyed by (Venue, SymbolId), stamped with the triggering event's time (0 reads the clock)
+    TradingAuthorizationResponse authorize_trade(hft::Venue venue, hft::SymbolId symbol, double quantity,
+                                                 double price, double current_spread_bps = 0.0,
+                                                 uint64_t timestamp_ns = 0) {
+        RiskCheckContext ctx(venue, symbol, quantity, price, current_spread_bps, timestamp_ns);
+        return authorize(ctx);
     }
     
     /**
@@ -229,6 +199,11 @@ public:
         
         // Update system health monitor with exchange heartbeat
         system_health_monitor_->update_exchange_heartbeat(exchange);
+        
+        hft::Venue venue;
+        if (hft::venue_from_name(exchange.c_str(), venue)) {
+            events_.post_mark(venue, hft::SymbolTable::instance().intern(symbol), price);
+        }
     }
     
     /**
@@ -240,6 +215,11 @@ public:
         // Update position tracker
         position_tracker_->add_trade(exchange, symbol, quantity, price);
         
+        hft::Venue venue;
+        if (hft::venue_from_name(exchange.c_str(), venue)) {
+            events_.post_fill(venue, hft::SymbolTable::instance().intern(symbol), quantity, price);
+        }
+        
         // Log trade event
         log_risk_event(RiskControlEvent{
             static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
@@ -258,6 +238,7 @@ public:
     void emergency_stop(const std::string& reason) {
         current_status_ = RiskControlStatus::EMERGENCY_STOP;
         trading_enabled_ = false;
+        kill_switch_.halt(hft::KillSwitch::EMERGENCY_STOP | hft::KillSwitch::TRADING_DISABLED, reason.c_str());
         
         // Trigger emergency stop in all components
         comprehensive_risk_manager_->emergency_shutdown(reason);
@@ -276,6 +257,7 @@ public:
         
         // Notify all callbacks
         notify_event_callbacks();
+        events_.post_limit_change();
     }
     
     void reset_emergency_stop() {
@@ -283,6 +265,8 @@ public:
             current_status_ = RiskControlStatus::NORMAL;
             trading_enabled_ = true;
             emergency_override_active_ = false;
+            kill_switch_.resume(hft::KillSwitch::EMERGENCY_STOP | hft::KillSwitch::TRADING_DISABLED,
+                                "emergency stop reset");
             
             // Reset in components
             comprehensive_risk_manager_->get_enhanced_risk_manager()->reset_emergency_stop();
@@ -298,17 +282,20 @@ public:
                 "RESET",
                 0.0
             });
+            events_.post_limit_change();
         }
     }
     
     void enable_emergency_override() {
         emergency_override_active_ = true;
         printf("🔒 Emergency override activated - manual control required\n");
+        events_.post_limit_change();
     }
     
     void disable_emergency_override() {
         emergency_override_active_ = false;
         printf("🔓 Emergency override deactivated\n");
+        events_.post_limit_change();
     }
     
     /**
@@ -317,13 +304,17 @@ public:
     void enable_trading() {
         if (current_status_ != RiskControlStatus::EMERGENCY_STOP) {
             trading_enabled_ = true;
+            kill_switch_.resume(hft::KillSwitch::TRADING_DISABLED, "trading enabled");
             printf("✅ Trading enabled\n");
+            events_.post_limit_change();
         }
     }
     
     void disable_trading() {
         trading_enabled_ = false;
+        kill_switch_.halt(hft::KillSwitch::TRADING_DISABLED, "trading disabled");
         printf("🛑 Trading disabled\n");
+        events_.post_limit_change();
     }
     
     /**
@@ -364,6 +355,7 @@ public:
         comprehensive_risk_manager_->generate_risk_report();
         system_health_monitor_->print_health_summary();
         position_tracker_->print_status();
+        pipeline_.print_stats("Unified");
         
         // Recent events
         printf("\n📋 Recent Risk Events (last 10):\n");
@@ -390,29 +382,25 @@ public:
     SystemHealthMonitor* get_system_health_monitor() { 
         return system_health_monitor_.get(); 
     }
+    
+    RiskPipeline& get_risk_pipeline() { return pipeline_; }
+    RiskEventCoalescer& get_risk_events() { return events_; }
 
 private:
     void start_monitoring() {
-        monitoring_active_ = true;
         system_health_monitor_->start_monitoring();
         
-        monitoring_thread_ = std::thread([this]() {
-            while (monitoring_active_) {
-                update_overall_status();
-                std::this_thread::sleep_for(
-                    std::chrono::milliseconds(monitoring_interval_ms_.load()));
-            }
+        events_.subscribe([this](const RiskDirtySet&) {
+            update_overall_status();
+            pipeline_.maybe_recompile();
         });
+        events_.start();
         
         printf("🔄 Unified risk monitoring started\n");
     }
     
     void stop_monitoring() {
-        monitoring_active_ = false;
-        
-        if (monitoring_thread_.joinable()) {
-            monitoring_thread_.join();
-        }
+        events_.stop();
         
         system_health_monitor_->stop_monitoring();
         printf("🛑 Unified risk monitoring stopped\n");
@@ -460,25 +448,100 @@ private:
         }
     }
     
-    double calculate_trade_risk_score(const std::string& exchange, const std::string& symbol,
-                                     double quantity, double price) {
-        double total_score = 0.0;
+    /**
+     * One pipeline pass; the rejecting stage's layer picks the reason and
+     * confidence. Approvals build no strings and log no event.
+     */
+    TradingAuthorizationResponse authorize(RiskCheckContext& ctx) {
+        TradingAuthorizationResponse response;
+        response.system_status = current_status_.load();
+        
+        const RiskStage* rejected = pipeline_.run(ctx);
+        if (rejected == nullptr) {
+            response.authorized = true;
+            response.confidence_score = std::max(0.0, 1.0 - ctx.risk_score);
+            collect_risk_warnings(response.warnings);
+            return response;
+        }
+        
+        response.authorized = false;
+        if (rejected->name == RISK_SCORE_STAGE) {
+            response.rejection_reason = "Risk score too high: " + std::to_string(ctx.risk_score);
+            response.confidence_score = std::max(0.0, 1.0 - ctx.risk_score);
+            collect_risk_warnings(response.warnings);
+            log_risk_event(RiskControlEvent{
+                static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                    std::chrono::high_resolution_clock::now().time_since_epoch()).count()),
+                current_status_.load(),
+                "UNIFIED_CONTROLLER",
+                "Trade rejected: " + hft::SymbolTable::instance().name(ctx.symbol) +
+                    " risk_score=" + std::to_string(ctx.risk_score),
+                "REJECTED",
+                ctx.risk_score
+            });
+        } else if (rejected->layer == RiskLayer::UNIFIED) {
+            response.rejection_reason = ctx.reject_reason ? ctx.reject_reason : rejected->name;
+            response.confidence_score = rejected->name == SYSTEM_HEALTH_STAGE ? 0.3 : 0.0;
+        } else {
+            response.rejection_reason = "Comprehensive risk manager rejected trade";
+            response.confidence_score = 0.2;
+        }
+        return response;
+    }
+    
+    // Pipeline stages
+    bool check_control_status(RiskCheckContext& ctx) {
+        if (!trading_enabled_.load(std::memory_order_relaxed)) {
+            ctx.reject_reason = "Trading globally disabled";
+            return false;
+        }
+        if (emergency_override_active_.load(std::memory_order_relaxed)) {
+            ctx.reject_reason = "Emergency override active - manual intervention required";
+            return false;
+        }
         
+        const RiskControlStatus status = current_status_.load(std::memory_order_relaxed);
+        if (status == RiskControlStatus::EMERGENCY_STOP) {
+            ctx.reject_reason = "Emergency stop active";
+            return false;
+        }
+        if (status == RiskControlStatus::CRITICAL) {
+            ctx.reject_reason = "Critical risk conditions detected";
+            return false;
+        }
+        if (hft::KillSwitch::is_halted(kill_word_->load(std::memory_order_acquire))) {
+            ctx.reject_reason = "Kill switch set";
+            return false;
+        }
+        return true;
+    }
+    
+    bool check_system_health(RiskCheckContext& ctx) {
+        if (!system_health_monitor_->is_system_healthy()) {
+            ctx.reject_reason = "System health concerns detected";
+            return false;
+        }
+        return true;
+    }
+    
+    // Authorize below a 0.8 score with confidence above 0.5
+    bool check_risk_score(RiskCheckContext& ctx) {
+        ctx.risk_score = calculate_trade_risk_score(ctx);
+        return ctx.risk_score < 0.8 && 1.0 - ctx.risk_score > 0.5;
+    }
+    
+    double calculate_trade_risk_score(const RiskCheckContext& ctx) const {
         // Market risk component
-        auto market_metrics = comprehensive_risk_manager_->get_market_risk_metrics(symbol);
-        double market_risk = market_metrics.volatility_1h * risk_weights_.market_risk_weight;
+        double market_risk = comprehensive_risk_manager_->market_volatility(ctx.symbol) * risk_weights_.market_risk_weight;
         
         // Position risk component  
-        auto position = position_tracker_->get_position(exchange, symbol);
-        double position_risk = (std::abs(position.quantity + quantity) / 10.0) * risk_weights_.position_risk_weight;
+        double position_risk = (std::abs(ctx.new_position) / 10.0) * risk_weights_.position_risk_weight;
         
         // System risk component
-        auto perf_metrics = system_health_monitor_->get_performance_metrics();
-        double system_risk = (perf_metrics.cpu_usage_percent / 100.0) * risk_weights_.system_risk_weight;
-        
-        total_score = market_risk + position_risk + system_risk;
+        double system_risk = (system_health_monitor_->get_performance_metrics().cpu_usage_percent / 100.0) *
+                             risk_weights_.system_risk_weight;
         
-        return std::min(1.0, total_score);
+        return std::min(1.0, market_risk + position_risk + system_risk);
     }
     
     void collect_risk_warnings(std::vector<std::string>& warnings) {
@@ -514,16 +577,16 @@ private:
             recent_events_.erase(recent_events_.begin());
         }
         
-        // Log to file
-        std::ofstream log_file("unified_risk_events.log", std::ios::app);
-        if (log_file.is_open()) {
-            log_file << event.timestamp_ns << ","
-                    << static_cast<int>(event.status) << ","
-                    << event.component << ","
-                    << event.description << ","
-                    << event.action_taken << ","
-                    << event.severity_score << "\n";
-        }
+        // Log to file (queued for the I/O thread)
+        static const hft::IoFileId log_file = hft::IoService::instance().open("unified_risk_events.log");
+        hft::IoLine line;
+        line << event.timestamp_ns << ","
+             << static_cast<int>(event.status) << ","
+             << event.component << ","
+             << event.description << ","
+             << event.action_taken << ","
+             << event.severity_score << "\n";
+        hft::IoService::instance().write(log_file, line);
     }
     
     void notify_event_callbacks() {
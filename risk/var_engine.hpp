@@ -0,0 +1,368 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <memory>
+#include <random>
+#include <vector>
+#include "covariance_engine.hpp"
+#include "../symbol_table.hpp"
+#include "../work_stealing_pool.hpp"
+
+namespace risk {
+
+enum class VarMethod : uint8_t {
+    HISTORICAL,
+    MONTE_CARLO
+};
+
+inline const char* var_method_name(VarMethod method) {
+    return method == VarMethod::HISTORICAL ? "historical" : "monte_carlo";
+}
+
+// Horizon loss statistics in dollars (positive = loss)
+struct VarEstimate {
+    double var_95 = 0.0;
+    double var_99 = 0.0;
+    double expected_shortfall_95 = 0.0;   // Mean loss at or beyond var_95
+    size_t scenarios = 0;
+    bool valid = false;
+};
+
+/**
+ * Immutable scenario set with the portfolio revalued under it
+ *
+ * returns holds horizon simple returns asset-major (returns[asset *
+ * scenarios + s]) so revaluing one position, or adding a proposed order to
+ * the cached pnl vector, is a contiguous pass over one column. Revaluing
+ * new exposures shares the returns of the set it replaces.
+ */
+struct VarScenarioSet {
+    VarMethod method = VarMethod::HISTORICAL;
+    size_t scenarios = 0;
+    size_t assets = 0;
+    std::shared_ptr<const std::vector<double>> returns;
+    std::vector<hft::SymbolId> symbols;   // Asset index -> symbol
+    std::vector<double> exposures;        // Dollar exposure per asset the pnl reflects
+    std::vector<double> pnl;              // Portfolio P&L per scenario
+    VarEstimate estimate;
+
+    const double* column(size_t asset) const { return returns->data() + asset * scenarios; }
+
+    int asset_index(hft::SymbolId symbol) const {
+        for (size_t a = 0; a < symbols.size(); ++a) {
+            if (symbols[a] == symbol) return static_cast<int>(a);
+        }
+        return -1;
+    }
+};
+
+// VaR of one proposed exposure change against a published scenario set
+struct MarginalVar {
+    double var_before = 0.0;
+    double var_after = 0.0;
+    bool valid = false;
+
+    double change() const { return var_after - var_before; }
+};
+
+/**
+ * Scenario VaR Engine
+ *
+ * Revalues a book of dollar exposures under two scenario sets and reports
+ * 95%/99% VaR and 95% expected shortfall at a fixed horizon:
+ *
+ * - Historical: the last history_length grid return vectors recorded from
+ *   the covariance engine, each scaled to the horizon by sqrt(time).
+ * - Monte Carlo: correlated normal draws from the Cholesky factor of the
+ *   EWMA covariance scaled to the horizon, seeded per block of scenarios
+ *   so results do not depend on the worker count.
+ *
+ * Scenario generation and revaluation split the scenario axis into chunks
+ * run on a WorkStealingPool. Each result is published as a shared_ptr to
+ * an immutable VarScenarioSet, so marginal_var() answers a pre-trade
+ * question from any thread with one pass over the cached pnl vector and a
+ * selection, without touching the writer.
+ *
+ * Single writer: record_returns, generate and revalue are serialized by
+ * the caller (InstitutionalRiskManager holds its risk mutex).
+ */
+class VarEngine {
+public:
+    struct Config {
+        size_t history_length = 1000;             // Grid return vectors kept for historical scenarios
+        size_t min_history = 100;                 // Before historical VaR is reported
+        size_t monte_carlo_scenarios = 2000;
+        uint64_t horizon_ns = 24ULL * 3600 * 1000000000ULL;
+        size_t threads = 0;                       // Worker threads (0 = hardware concurrency, 1 = inline)
+        uint64_t seed = 0x5eed;
+    };
+
+    static constexpr size_t SCENARIO_BLOCK = 256;   // Scenarios per parallel chunk and per RNG stream
+
+private:
+    Config config_;
+    std::unique_ptr<hft::WorkStealingPool> pool_;
+
+    std::vector<std::vector<double>> history_;   // Ring of grid return vectors
+    size_t history_head_ = 0;                    // Next slot to write
+    size_t history_size_ = 0;
+    uint64_t generation_ = 0;                    // Monte Carlo regenerations, mixed into the seed
+
+    std::atomic<std::shared_ptr<const VarScenarioSet>> historical_;
+    std::atomic<std::shared_ptr<const VarScenarioSet>> monte_carlo_;
+
+    std::atomic<std::shared_ptr<const VarScenarioSet>>& slot(VarMethod method) {
+        return method == VarMethod::HISTORICAL ? historical_ : monte_carlo_;
+    }
+    const std::atomic<std::shared_ptr<const VarScenarioSet>>& slot(VarMethod method) const {
+        return method == VarMethod::HISTORICAL ? historical_ : monte_carlo_;
+    }
+
+    // fn(begin, end) over [0, count) in SCENARIO_BLOCK-aligned chunks
+    template<typename Fn>
+    void parallel_for(size_t count, const Fn& fn) {
+        const size_t blocks = (count + SCENARIO_BLOCK - 1) / SCENARIO_BLOCK;
+        const bool parallel = pool_ && blocks > 1;
+        for (size_t b = 0; b < blocks; ++b) {
+            const size_t begin = b * SCENARIO_BLOCK;
+            const size_t end = std::min(count, begin + SCENARIO_BLOCK);
+            if (parallel) {
+                pool_->submit([&fn, begin, end] { fn(begin, end); });
+            } else {
+                fn(begin, end);
+            }
+        }
+        if (parallel) pool_->wait_idle();
+    }
+
+    // Loss exceeded in (1 - confidence) of scenarios; reorders losses
+    static double loss_quantile(std::vector<double>& losses, double confidence) {
+        const size_t n = losses.size();
+        const size_t k = std::min(n - 1, static_cast<size_t>(std::ceil(confidence * n)) - 1);
+        std::nth_element(losses.begin(), losses.begin() + k, losses.end());
+        return losses[k];
+    }
+
+    static VarEstimate estimate_from(const std::vector<double>& pnl) {
+        VarEstimate estimate;
+        const size_t n = pnl.size();
+        if (n == 0) return estimate;
+
+        std::vector<double> losses(n);
+        for (size_t s = 0; s < n; ++s) losses[s] = -pnl[s];
+        std::sort(losses.begin(), losses.end());
+
+        const size_t k95 = std::min(n - 1, static_cast<size_t>(std::ceil(0.95 * n)) - 1);
+        const size_t k99 = std::min(n - 1, static_cast<size_t>(std::ceil(0.99 * n)) - 1);
+        double tail = 0.0;
+        for (size_t s = k95; s < n; ++s) tail += losses[s];
+
+        estimate.var_95 = std::max(0.0, losses[k95]);
+        estimate.var_99 = std::max(0.0, losses[k99]);
+        estimate.expected_shortfall_95 = std::max(0.0, tail / static_cast<double>(n - k95));
+        estimate.scenarios = n;
+        estimate.valid = true;
+        return estimate;
+    }
+
+    // pnl = sum over assets of exposure * column, chunked over scenarios
+    void revalue_into(VarScenarioSet& set, const std::vector<double>& exposures) {
+        set.exposures.assign(set.assets, 0.0);
+        for (size_t a = 0; a < set.assets && a < exposures.size(); ++a) set.exposures[a] = exposures[a];
+        set.pnl.assign(set.scenarios, 0.0);
+
+        parallel_for(set.scenarios, [&set](size_t begin, size_t end) {
+            double* pnl = set.pnl.data();
+            for (size_t a = 0; a < set.assets; ++a) {
+                const double w = set.exposures[a];
+                if (w == 0.0) continue;
+                const double* r = set.column(a);
+                for (size_t s = begin; s < end; ++s) pnl[s] += w * r[s];
+            }
+        });
+        set.estimate = estimate_from(set.pnl);
+    }
+
+    // Empty set over the covariance engine's assets; returns is filled through `returns`
+    static std::shared_ptr<VarScenarioSet> make_set(VarMethod method, const EwmaCovarianceEngine& covariance,
+                                                    size_t scenarios, double*& returns) {
+        auto set = std::make_shared<VarScenarioSet>();
+        set->method = method;
+        set->scenarios = scenarios;
+        set->assets = covariance.asset_count();
+        auto storage = std::make_shared<std::vector<double>>(set->assets * scenarios, 0.0);
+        returns = storage->data();
+        set->returns = std::move(storage);
+        set->symbols.resize(set->assets);
+        for (size_t a = 0; a < set->assets; ++a) set->symbols[a] = covariance.symbol_at(a);
+        return set;
+    }
+
+    /**
+     * Lower-triangular L with L L^T = C (row-major n x n)
+     *
+     * Pivots that vanish (flat or perfectly collinear assets) zero their
+     * column instead of failing, so a positive semi-definite EWMA matrix
+     * always factors.
+     */
+    static void cholesky(const EwmaCovarianceEngine& covariance, size_t n, std::vector<double>& L) {
+        L.assign(n * n, 0.0);
+        for (size_t j = 0; j < n; ++j) {
+            const double cjj = covariance.covariance(j, j);
+            double d = cjj;
+            for (size_t k = 0; k < j; ++k) d -= L[j * n + k] * L[j * n + k];
+            if (!(d > cjj * 1e-12) || d <= 0.0) continue;
+            const double ljj = std::sqrt(d);
+            L[j * n + j] = ljj;
+            for (size_t i = j + 1; i < n; ++i) {
+                double s = covariance.covariance(i, j);
+                for (size_t k = 0; k < j; ++k) s -= L[i * n + k] * L[j * n + k];
+                L[i * n + j] = s / ljj;
+            }
+        }
+    }
+
+public:
+    VarEngine() : VarEngine(Config{}) {}
+
+    explicit VarEngine(const Config& config) : config_(config), history_(config.history_length) {
+        if (config_.threads != 1) {
+            pool_ = std::make_unique<hft::WorkStealingPool>(config_.threads);
+        }
+    }
+
+    VarEngine(const VarEngine&) = delete;
+    VarEngine& operator=(const VarEngine&) = delete;
+
+    // Append one grid return vector (log returns by covariance index) to the history
+    void record_returns(const double* returns, size_t count) {
+        if (history_.empty()) return;
+        history_[history_head_].assign(returns, returns + count);
+        history_head_ = (history_head_ + 1) % history_.size();
+        history_size_ = std::min(history_size_ + 1, history_.size());
+    }
+
+    /**
+     * Rebuild both scenario sets from the recorded history and current
+     * covariance model, revalue exposures under them and publish
+     *
+     * A method without enough data publishes nothing and keeps its previous set.
+     */
+    void generate(const EwmaCovarianceEngine& covariance, const std::vector<double>& exposures) {
+        const double horizon_intervals = covariance.intervals_per(config_.horizon_ns);
+        const double scale = std::sqrt(horizon_intervals);
+
+        if (history_size_ >= config_.min_history && covariance.asset_count() > 0) {
+            double* returns = nullptr;
+            auto set = make_set(VarMethod::HISTORICAL, covariance, history_size_, returns);
+            const size_t oldest = (history_head_ + history_.size() - history_size_) % history_.size();
+            parallel_for(history_size_, [&](size_t begin, size_t end) {
+                for (size_t s = begin; s < end; ++s) {
+                    const std::vector<double>& r = history_[(oldest + s) % history_.size()];
+                    const size_t known = std::min(r.size(), set->assets);
+                    for (size_t a = 0; a < known; ++a) {
+                        returns[a * set->scenarios + s] = std::expm1(r[a] * scale);
+                    }
+                }
+            });
+            revalue_into(*set, exposures);
+            historical_.store(std::move(set), std::memory_order_release);
+        }
+
+        if (covariance.is_warm() && covariance.asset_count() > 0 && config_.monte_carlo_scenarios > 0) {
+            double* returns = nullptr;
+            auto set = make_set(VarMethod::MONTE_CARLO, covariance, config_.monte_carlo_scenarios, returns);
+            const size_t n = set->assets;
+            std::vector<double> L;
+            cholesky(covariance, n, L);
+
+            const uint64_t seed = config_.seed + 0x9e3779b97f4a7c15ULL * ++generation_;
+            parallel_for(set->scenarios, [&](size_t begin, size_t end) {
+                std::mt19937_64 rng(seed ^ (begin / SCENARIO_BLOCK + 1) * 0xbf58476d1ce4e5b9ULL);
+                std::normal_distribution<double> normal;
+                std::vector<double> z(n);
+                for (size_t s = begin; s < end; ++s) {
+                    for (size_t a = 0; a < n; ++a) z[a] = normal(rng);
+                    for (size_t a = 0; a < n; ++a) {
+                        const double* row = L.data() + a * n;
+                        double x = 0.0;
+                        for (size_t b = 0; b <= a; ++b) x += row[b] * z[b];
+                        returns[a * set->scenarios + s] = std::expm1(x * scale);
+                    }
+                }
+            });
+            revalue_into(*set, exposures);
+            monte_carlo_.store(std::move(set), std::memory_order_release);
+        }
+    }
+
+    /**
+     * Revalue new exposures under the published scenarios without
+     * regenerating them (O(held assets x scenarios))
+     */
+    void revalue(const std::vector<double>& exposures) {
+        for (VarMethod method : {VarMethod::HISTORICAL, VarMethod::MONTE_CARLO}) {
+            auto current = slot(method).load(std::memory_order_acquire);
+            if (!current) continue;
+            auto set = std::make_shared<VarScenarioSet>(*current);
+            revalue_into(*set, exposures);
+            slot(method).store(std::move(set), std::memory_order_release);
+        }
+    }
+
+    /**
+     * VaR before and after adding exposure_delta dollars of one asset
+     *
+     * One pass of pnl + delta * column over the cached scenarios plus a
+     * selection; safe from any thread.
+     */
+    MarginalVar marginal_var(VarMethod method, hft::SymbolId symbol, double exposure_delta,
+                             double confidence = 0.95) const {
+        MarginalVar result;
+        const auto set = slot(method).load(std::memory_order_acquire);
+        if (!set || set->scenarios == 0) return result;
+
+        thread_local std::vector<double> losses;
+        losses.resize(set->scenarios);
+        if (confidence == 0.95) {
+            result.var_before = set->estimate.var_95;
+        } else {
+            for (size_t s = 0; s < set->scenarios; ++s) losses[s] = -set->pnl[s];
+            result.var_before = std::max(0.0, loss_quantile(losses, confidence));
+        }
+
+        const int asset = set->asset_index(symbol);
+        if (asset < 0 || exposure_delta == 0.0) {
+            result.var_after = result.var_before;
+        } else {
+            const double* r = set->column(static_cast<size_t>(asset));
+            for (size_t s = 0; s < set->scenarios; ++s) losses[s] = -(set->pnl[s] + exposure_delta * r[s]);
+            result.var_after = std::max(0.0, loss_quantile(losses, confidence));
+        }
+        result.valid = true;
+        return result;
+    }
+
+    std::shared_ptr<const VarScenarioSet> scenarios(VarMethod method) const {
+        return slot(method).load(std::memory_order_acquire);
+    }
+
+    VarEstimate estimate(VarMethod method) const {
+        const auto set = scenarios(method);
+        return set ? set->estimate : VarEstimate{};
+    }
+
+    // VaR scaled from the engine horizon to another by sqrt(time)
+    double scale_to(double var, uint64_t horizon_ns) const {
+        return var * std::sqrt(static_cast<double>(horizon_ns) / static_cast<double>(config_.horizon_ns));
+    }
+
+    size_t history_size() const { return history_size_; }
+    size_t thread_count() const { return pool_ ? pool_->thread_count() : 1; }
+    const Config& config() const { return config_; }
+};
+
+} // namespace risk
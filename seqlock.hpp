@@ -0,0 +1,114 @@
+// seqlock.hpp - Sequence-lock protected values for wait-free readers
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <type_traits>
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define HAS_X86_INTRINSICS 1
+#endif
+
+namespace hft {
+
+/**
+ * SeqLock
+ *
+ * Holds a trivially copyable value that one writer updates in place and
+ * any number of readers copy out without blocking it. The writer makes the
+ * sequence odd, writes, then makes it even again; a reader retries if it
+ * saw an odd sequence or the sequence moved while it was copying.
+ *
+ * Meant for a single writer per value. The writer takes the odd sequence
+ * with a CAS, so a rare second writer serializes behind the first instead
+ * of corrupting the value, but it spins while doing so.
+ */
+template<typename T>
+class alignas(64) SeqLock {
+    static_assert(std::is_trivially_copyable_v<T>, "SeqLock value must be trivially copyable");
+
+private:
+    std::atomic<uint32_t> seq_{0};
+    T value_{};
+
+    static void relax() noexcept {
+#ifdef HAS_X86_INTRINSICS
+        _mm_pause();
+#endif
+    }
+
+public:
+    SeqLock() = default;
+    explicit SeqLock(const T& value) : value_(value) {}
+
+    SeqLock(const SeqLock&) = delete;
+    SeqLock& operator=(const SeqLock&) = delete;
+
+    /**
+     * Modify the value in place
+     * @param fn Called as fn(T&) while the sequence is odd; must not throw
+     */
+    template<typename Fn>
+    void write(Fn&& fn) noexcept {
+        uint32_t seq = seq_.load(std::memory_order_relaxed);
+        for (;;) {
+            if ((seq & 1) == 0 &&
+                seq_.compare_exchange_weak(seq, seq + 1, std::memory_order_acquire, std::memory_order_relaxed)) {
+                break;
+            }
+            relax();
+            seq = seq_.load(std::memory_order_relaxed);
+        }
+        std::atomic_thread_fence(std::memory_order_release);
+        fn(value_);
+        seq_.store(seq + 2, std::memory_order_release);
+    }
+
+    void store(const T& value) noexcept {
+        write([&](T& current) { current = value; });
+    }
+
+    /**
+     * Consistent copy of the value (retries while a write is in progress)
+     */
+    T load() const noexcept {
+        T copy;
+        for (;;) {
+            const uint32_t before = seq_.load(std::memory_order_acquire);
+            if (before & 1) {
+                relax();
+                continue;
+            }
+            copy = value_;
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (seq_.load(std::memory_order_relaxed) == before) return copy;
+        }
+    }
+
+    /**
+     * Consistent copy, giving up after a bounded number of attempts
+     *
+     * For readers that must not hang on a writer that stopped mid-write
+     * (another process's shared-memory block).
+     */
+    bool try_load(T& out, uint32_t attempts = 64) const noexcept {
+        for (uint32_t i = 0; i < attempts; ++i) {
+            const uint32_t before = seq_.load(std::memory_order_acquire);
+            if (before & 1) {
+                relax();
+                continue;
+            }
+            out = value_;
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (seq_.load(std::memory_order_relaxed) == before) return true;
+        }
+        return false;
+    }
+
+    // Number of completed writes
+    uint32_t version() const noexcept {
+        return seq_.load(std::memory_order_acquire) >> 1;
+    }
+};
+
+} // namespace hft
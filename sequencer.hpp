@@ -9,6 +9,10 @@
 #include <type_traits>
 #include <vector>
 #include <algorithm>
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
 #ifdef HAS_NUMA
 #include <numa.h>
 #endif
@@ -37,6 +41,28 @@ inline uint64_t rdtsc() noexcept {
 #endif
 }
 
+/**
+ * Pin the calling thread to a CPU core
+ *
+ * Hot-path threads (strategy shards, risk, I/O) are pinned so their
+ * state stays in one core's caches. No-op where affinity is unsupported.
+ *
+ * @param cpu Core index (negative leaves the thread unpinned)
+ * @return true if the affinity was applied
+ */
+inline bool pin_current_thread(int cpu) noexcept {
+#ifdef __linux__
+    if (cpu < 0) return false;
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    return pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0;
+#else
+    (void)cpu;
+    return false;
+#endif
+}
+
 /**
  * Cache-line aligned wrapper to prevent false sharing
  *
@@ -10,6 +10,7 @@
 #include <sstream>
 #include <cstdlib>
 #include <iostream>
+#include "io_service.hpp"
 #include "position_tracker.hpp"
 
 namespace hft {
@@ -144,7 +145,7 @@ private:
     SystemMonitor system_monitor_;
     
     mutable std::mutex mutex_;
-    std::ofstream session_log_;
+    hft::IoFileId session_log_ = hft::INVALID_IO_FILE;
     
     std::chrono::steady_clock::time_point session_start_;
     std::chrono::steady_clock::time_point last_status_check_;
@@ -173,9 +174,6 @@ public:
             end_session("Destructor called");
         }
         system_monitor_.stop_monitoring();
-        if (session_log_.is_open()) {
-            session_log_.close();
-        }
     }
     
     /**
@@ -408,22 +406,16 @@ public:
     
 private:
     void init_session_logging() {
-        // Create CSV header if file doesn't exist
-        std::ifstream check_file(config_.session_log_file);
-        bool file_exists = check_file.good();
-        check_file.close();
-        
-        session_log_.open(config_.session_log_file, std::ios::app);
-        
-        if (session_log_.is_open() && !file_exists) {
-            session_log_ << "timestamp,start_time,end_time,duration_hours,starting_balance,ending_balance,"
-                        << "session_pnl,max_profit,max_drawdown,total_trades,winning_trades,losing_trades,"
-                        << "win_rate,gross_profit,gross_loss,total_fees,stop_reason,emergency_stop\n";
-        }
+        // CSV header if the file is new
+        hft::IoService::FileOptions options;
+        options.header = "timestamp,start_time,end_time,duration_hours,starting_balance,ending_balance,"
+                         "session_pnl,max_profit,max_drawdown,total_trades,winning_trades,losing_trades,"
+                         "win_rate,gross_profit,gross_loss,total_fees,stop_reason,emergency_stop\n";
+        session_log_ = hft::IoService::instance().open(config_.session_log_file, options);
     }
     
     void log_session_summary() {
-        if (!session_log_.is_open()) return;
+        if (session_log_ == hft::INVALID_IO_FILE) return;
         
         auto duration = std::chrono::duration<double, std::ratio<3600>>(
             current_session_.end_time - current_session_.start_time);
@@ -431,26 +423,26 @@ private:
         double win_rate = current_session_.total_trades > 0 ? 
                          (double)current_session_.winning_trades / current_session_.total_trades * 100 : 0.0;
         
-        session_log_ << get_timestamp_string() << ","
-                    << get_time_string(current_session_.start_time) << ","
-                    << get_time_string(current_session_.end_time) << ","
-                    << std::fixed << std::setprecision(2) << duration.count() << ","
-                    << current_session_.starting_balance << ","
-                    << current_session_.ending_balance << ","
-                    << current_session_.session_pnl << ","
-                    << current_session_.max_profit << ","
-                    << current_session_.max_drawdown << ","
-                    << current_session_.total_trades << ","
-                    << current_session_.winning_trades << ","
-                    << current_session_.losing_trades << ","
-                    << std::setprecision(1) << win_rate << ","
-                    << std::setprecision(2) << current_session_.gross_profit << ","
-                    << current_session_.gross_loss << ","
-                    << current_session_.total_fees << ","
-                    << current_session_.stop_reason << ","
-                    << (current_session_.emergency_stop ? "true" : "false") << "\n";
-        
-        session_log_.flush();
+        hft::IoLine line;
+        line << get_timestamp_string() << ","
+             << get_time_string(current_session_.start_time) << ","
+             << get_time_string(current_session_.end_time) << ","
+             << hft::io_fixed(2) << duration.count() << ","
+             << current_session_.starting_balance << ","
+             << current_session_.ending_balance << ","
+             << current_session_.session_pnl << ","
+             << current_session_.max_profit << ","
+             << current_session_.max_drawdown << ","
+             << current_session_.total_trades << ","
+             << current_session_.winning_trades << ","
+             << current_session_.losing_trades << ","
+             << hft::io_fixed(1) << win_rate << ","
+             << hft::io_fixed(2) << current_session_.gross_profit << ","
+             << current_session_.gross_loss << ","
+             << current_session_.total_fees << ","
+             << current_session_.stop_reason << ","
+             << (current_session_.emergency_stop ? "true" : "false") << "\n";
+        hft::IoService::instance().write(session_log_, line);
     }
     
     std::string get_current_time_string() const {
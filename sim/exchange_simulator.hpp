@@ -8,6 +8,7 @@
 #include <string>
 #include <atomic>
 #include "../messages.hpp"
+#include "../rate_limiter.hpp"
 #include "../market_data_generator.hpp"
 
 namespace hft::simulator {
@@ -170,15 +171,9 @@ private:
             return orders_filled > 0 ? static_cast<double>(orders_cancelled) / orders_filled : 0.0;
         }
         
-        bool is_rate_limited(uint64_t current_time, double max_rate) const {
-            uint64_t window_ns = 1000000000ULL; // 1 second window
-            if (current_time - last_message_time < window_ns) {
-                double elapsed_seconds = (current_time - last_message_time) / 1e9;
-                double current_rate = messages_sent / elapsed_seconds;
-                return current_rate > max_rate;
-            }
-            return false;
-        }
+        // Per-trader order and cancel budgets (configured from the LatencyProfile)
+        hft::TokenBucket order_rate;
+        hft::TokenBucket cancel_rate;
     };
     
 public:
@@ -251,6 +246,9 @@ public:
     
     void set_latency_profile(const LatencyProfile& profile) {
         latency_profile_ = profile;
+        for (auto& [trader_id, stats] : trader_stats_) {
+            configure_rate_limits(stats);
+        }
     }
     
     void set_fee_structure(const FeeStructure& fees) {
@@ -270,11 +268,11 @@ public:
     }
     
     OrderId submit_order(const Order& order) {
-        auto& stats = trader_stats_[order.trader_id];
+        auto& stats = trader_stats_for(order.trader_id);
         uint64_t current_time = get_timestamp_ns();
         
         // Rate limiting check
-        if (stats.is_rate_limited(current_time, latency_profile_.max_order_rate)) {
+        if (!stats.order_rate.try_acquire(current_time)) {
             if (order_reject_callback_) {
                 order_reject_callback_(order, "Rate limit exceeded");
             }
@@ -309,11 +307,11 @@ public:
     }
     
     bool cancel_order(OrderId id, const std::string& trader_id) {
-        auto& stats = trader_stats_[trader_id];
+        auto& stats = trader_stats_for(trader_id);
         uint64_t current_time = get_timestamp_ns();
         
         // Rate limiting check
-        if (stats.is_rate_limited(current_time, latency_profile_.max_cancel_ratio)) {
+        if (!stats.cancel_rate.try_acquire(current_time)) {
             return false;
         }
         
@@ -430,7 +428,19 @@ private:
     };
     
     std::vector<PendingOperation> pending_operations_;
-    
+
+    void configure_rate_limits(TraderStats& stats) const {
+        stats.order_rate.configure({latency_profile_.max_order_rate, latency_profile_.max_order_rate});
+        // max_cancel_ratio doubles as the per-second cancel budget
+        stats.cancel_rate.configure({latency_profile_.max_cancel_ratio, latency_profile_.max_cancel_ratio});
+    }
+
+    TraderStats& trader_stats_for(const std::string& trader_id) {
+        auto [it, inserted] = trader_stats_.try_emplace(trader_id);
+        if (inserted) configure_rate_limits(it->second);
+        return it->second;
+    }
+
     bool validate_order(const Order& order, std::string& reject_reason) const {
         if (order.quantity == 0) {
             reject_reason = "Invalid quantity";
@@ -584,8 +594,8 @@ private:
             // Update statistics
             total_trades_.fetch_add(1);
             total_volume_.fetch_add(match_quantity);
-            trader_stats_[best_bid.trader_id].orders_filled++;
-            trader_stats_[best_ask.trader_id].orders_filled++;
+            trader_stats_for(best_bid.trader_id).orders_filled++;
+            trader_stats_for(best_ask.trader_id).orders_filled++;
             
             // Remove fully filled orders
             if (best_bid.is_fully_filled()) {
@@ -677,7 +687,7 @@ private:
     ) {
         // Adjust latency and fill probability based on trader's toxicity
         // Higher toxicity = more adverse selection = worse fills
-        auto& stats = trader_stats_[trader_id];
+        auto& stats = trader_stats_for(trader_id);
         
         if (toxicity_score > 0.7) {
             // High toxicity trader gets worse latency and partial fills
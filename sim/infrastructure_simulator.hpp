@@ -9,6 +9,7 @@
 #include <atomic>
 #include <chrono>
 #include "../messages.hpp"
+#include "../rate_limiter.hpp"
 
 namespace hft::simulator {
 
@@ -164,23 +165,11 @@ private:
     
     // Rate limiting state
     struct RateLimiter {
-        uint64_t messages_per_second = 1000;
-        uint64_t current_count = 0;
-        uint64_t window_start = 0;
-        const uint64_t window_duration_ns = 1000000000ULL; // 1 second
+        static constexpr uint64_t DEFAULT_MESSAGES_PER_SECOND = 1000;
+        hft::SlidingWindowCounter<10> window{DEFAULT_MESSAGES_PER_SECOND, 1000000000ULL}; // 1 second
         
         bool is_rate_limited(uint64_t current_time) {
-            if (current_time - window_start >= window_duration_ns) {
-                window_start = current_time;
-                current_count = 0;
-            }
-            
-            if (current_count >= messages_per_second) {
-                return true;
-            }
-            
-            current_count++;
-            return false;
+            return !window.try_acquire(current_time);
         }
     };
     
@@ -589,9 +578,9 @@ private:
     void simulate_gateway_overload(const FailureScenario& scenario) {
         // Reduce rate limits dramatically
         for (auto& [path_name, rate_limiter] : rate_limiters_) {
-            rate_limiter.messages_per_second = static_cast<uint64_t>(
-                rate_limiter.messages_per_second * (1.0 - scenario.severity)
-            );
+            rate_limiter.window.set_limit(static_cast<uint64_t>(
+                rate_limiter.window.limit() * (1.0 - scenario.severity)
+            ));
         }
     }
     
@@ -608,7 +597,7 @@ private:
         }
         
         auto& limiter = rate_limiters_[affected_path];
-        limiter.messages_per_second = static_cast<uint64_t>(100 * (1.0 - scenario.severity));
+        limiter.window.set_limit(static_cast<uint64_t>(100 * (1.0 - scenario.severity)));
     }
     
     void simulate_market_data_gap(const FailureScenario& scenario) {
@@ -645,7 +634,7 @@ private:
             case FailureScenario::GATEWAY_OVERLOAD:
                 // Restore rate limits
                 for (auto& [path_name, rate_limiter] : rate_limiters_) {
-                    rate_limiter.messages_per_second = 1000; // Default rate
+                    rate_limiter.window.set_limit(RateLimiter::DEFAULT_MESSAGES_PER_SECOND);
                 }
                 break;
             case FailureScenario::DDOS_ATTACK:
@@ -0,0 +1,444 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <numeric>
+#include <sstream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "../work_stealing_pool.hpp"
+#include "intraday_strategies.hpp"
+#include "intraday_risk_manager.hpp"
+#include "simple_executor.hpp"
+#include "performance_tracker.hpp"
+#include "execution_pipeline.hpp"
+#include "simulated_gateway.hpp"
+#include "session_clock.hpp"
+
+namespace hft::strategies {
+
+// Recorded tick files
+//
+// One CSV file per trading day, one EnhancedMarketData snapshot per line:
+// timestamp_ns,symbol,bid,ask,last,bid_size,ask_size,vwap,day_open,prev_close,
+// cumulative_volume,average_volume_30d,rsi_5,rsi_14,std_dev_20,distance_from_vwap_percent
+inline constexpr const char* TICK_FILE_HEADER =
+    "timestamp_ns,symbol,bid,ask,last,bid_size,ask_size,vwap,day_open,prev_close,"
+    "cumulative_volume,average_volume_30d,rsi_5,rsi_14,std_dev_20,distance_from_vwap_percent";
+
+inline bool parse_tick_line(const std::string& line, EnhancedMarketData& data) {
+    std::stringstream ss(line);
+    std::string field;
+    std::vector<std::string> fields;
+    fields.reserve(16);
+    while (std::getline(ss, field, ',')) fields.push_back(field);
+    if (fields.size() < 15) return false;
+
+    try {
+        data.timestamp_ns = std::stoull(fields[0]);
+        data.symbol = fields[1];
+        data.bid = std::stod(fields[2]);
+        data.ask = std::stod(fields[3]);
+        data.last = std::stod(fields[4]);
+        data.bid_size = std::stoull(fields[5]);
+        data.ask_size = std::stoull(fields[6]);
+        data.vwap = std::stod(fields[7]);
+        data.day_open = std::stod(fields[8]);
+        data.prev_close = std::stod(fields[9]);
+        data.cumulative_volume = std::stoull(fields[10]);
+        data.average_volume_30d = std::stoull(fields[11]);
+        data.rsi_5 = std::stod(fields[12]);
+        data.rsi_14 = std::stod(fields[13]);
+        data.std_dev_20 = std::stod(fields[14]);
+        data.distance_from_vwap_percent = fields.size() > 15 ? std::stod(fields[15]) : 0.0;
+    } catch (const std::exception&) {
+        return false;
+    }
+    return true;
+}
+
+inline bool load_tick_file(const std::string& path, std::vector<EnhancedMarketData>& ticks) {
+    std::ifstream file(path);
+    if (!file.is_open()) return false;
+
+    std::string line;
+    EnhancedMarketData data;
+    while (std::getline(file, line)) {
+        if (line.empty() || line[0] == '#' || line.compare(0, 12, "timestamp_ns") == 0) continue;
+        if (parse_tick_line(line, data)) ticks.push_back(data);
+    }
+
+    // Replay in time order even if the recorder interleaved symbols out of order
+    std::stable_sort(ticks.begin(), ticks.end(), [](const auto& a, const auto& b) {
+        return a.timestamp_ns < b.timestamp_ns;
+    });
+    return !ticks.empty();
+}
+
+inline bool write_tick_file(const std::string& path, const std::vector<EnhancedMarketData>& ticks) {
+    std::ofstream file(path);
+    if (!file.is_open()) return false;
+
+    file << TICK_FILE_HEADER << "\n";
+    file << std::setprecision(10);
+    for (const auto& t : ticks) {
+        file << t.timestamp_ns << "," << t.symbol << ","
+             << t.bid << "," << t.ask << "," << t.last << ","
+             << t.bid_size << "," << t.ask_size << ","
+             << t.vwap << "," << t.day_open << "," << t.prev_close << ","
+             << t.cumulative_volume << "," << t.average_volume_30d << ","
+             << t.rsi_5 << "," << t.rsi_14 << "," << t.std_dev_20 << ","
+             << t.distance_from_vwap_percent << "\n";
+    }
+    return true;
+}
+
+// One parameter set under test
+struct BacktestParams {
+    std::string name = "default";
+    VWAPReversionStrategy::VWAPConfig vwap;
+    OpeningDriveStrategy::OpeningConfig opening;
+    PairDivergenceStrategy::PairConfig pair;
+    IntradayRiskLimits limits;
+
+    // Set a parameter by dotted name (e.g. "vwap.min_distance_from_vwap")
+    bool set(const std::string& key, double value) {
+        static const std::unordered_map<std::string, std::function<void(BacktestParams&, double)>> fields = {
+            {"vwap.min_distance_from_vwap",   [](BacktestParams& p, double v) { p.vwap.min_distance_from_vwap = v; }},
+            {"vwap.rsi_oversold_threshold",   [](BacktestParams& p, double v) { p.vwap.rsi_oversold_threshold = v; }},
+            {"vwap.rsi_overbought_threshold", [](BacktestParams& p, double v) { p.vwap.rsi_overbought_threshold = v; }},
+            {"vwap.min_volume_ratio",         [](BacktestParams& p, double v) { p.vwap.min_volume_ratio = v; }},
+            {"vwap.max_spread_bps",           [](BacktestParams& p, double v) { p.vwap.max_spread_bps = v; }},
+            {"vwap.stop_loss_percent",        [](BacktestParams& p, double v) { p.vwap.stop_loss_percent = v; }},
+            {"vwap.target_profit_percent",    [](BacktestParams& p, double v) { p.vwap.target_profit_percent = v; }},
+            {"opening.min_gap_percent",       [](BacktestParams& p, double v) { p.opening.min_gap_percent = v; }},
+            {"opening.max_gap_percent",       [](BacktestParams& p, double v) { p.opening.max_gap_percent = v; }},
+            {"opening.volume_threshold_ratio",[](BacktestParams& p, double v) { p.opening.volume_threshold_ratio = v; }},
+            {"opening.stop_loss_percent",     [](BacktestParams& p, double v) { p.opening.stop_loss_percent = v; }},
+            {"opening.target_profit_percent", [](BacktestParams& p, double v) { p.opening.target_profit_percent = v; }},
+            {"opening.max_spread_bps",        [](BacktestParams& p, double v) { p.opening.max_spread_bps = v; }},
+            {"pair.min_zscore",               [](BacktestParams& p, double v) { p.pair.min_zscore = v; }},
+            {"pair.correlation_threshold",    [](BacktestParams& p, double v) { p.pair.correlation_threshold = v; }},
+            {"pair.stop_loss_percent",        [](BacktestParams& p, double v) { p.pair.stop_loss_percent = v; }},
+            {"pair.target_profit_percent",    [](BacktestParams& p, double v) { p.pair.target_profit_percent = v; }},
+            {"pair.max_spread_bps",           [](BacktestParams& p, double v) { p.pair.max_spread_bps = v; }},
+            {"pair.history_window",           [](BacktestParams& p, double v) { p.pair.history_window = static_cast<size_t>(v); }},
+            {"pair.min_history",              [](BacktestParams& p, double v) { p.pair.min_history = static_cast<size_t>(v); }},
+            {"risk.max_trades_per_day",       [](BacktestParams& p, double v) { p.limits.max_trades_per_day = static_cast<uint32_t>(v); }},
+            {"risk.min_seconds_between_trades",[](BacktestParams& p, double v) { p.limits.min_seconds_between_trades = static_cast<uint32_t>(v); }},
+            {"risk.daily_loss_limit",         [](BacktestParams& p, double v) { p.limits.daily_loss_limit = v; }},
+            {"risk.daily_profit_target",      [](BacktestParams& p, double v) { p.limits.daily_profit_target = v; }},
+        };
+
+        auto it = fields.find(key);
+        if (it == fields.end()) return false;
+        it->second(*this, value);
+        return true;
+    }
+};
+
+// Cartesian parameter grid built from named sweep axes
+class ParameterGrid {
+private:
+    struct Axis {
+        std::string key;
+        std::vector<double> values;
+    };
+
+    BacktestParams base_;
+    std::vector<Axis> axes_;
+
+public:
+    explicit ParameterGrid(const BacktestParams& base = BacktestParams()) : base_(base) {}
+
+    // Add an axis; unknown keys are rejected
+    bool sweep(const std::string& key, const std::vector<double>& values) {
+        BacktestParams probe = base_;
+        if (values.empty() || !probe.set(key, values.front())) return false;
+        axes_.push_back({key, values});
+        return true;
+    }
+
+    // Inclusive range sweep
+    bool sweep(const std::string& key, double from, double to, double step) {
+        std::vector<double> values;
+        if (step <= 0.0) return false;
+        for (double v = from; v <= to + step * 1e-9; v += step) values.push_back(v);
+        return sweep(key, values);
+    }
+
+    size_t size() const {
+        size_t n = 1;
+        for (const auto& axis : axes_) n *= axis.values.size();
+        return n;
+    }
+
+    std::vector<BacktestParams> build() const {
+        std::vector<BacktestParams> grid;
+        grid.reserve(size());
+
+        std::vector<size_t> index(axes_.size(), 0);
+        for (size_t n = 0; n < size(); ++n) {
+            BacktestParams params = base_;
+            std::ostringstream name;
+            for (size_t a = 0; a < axes_.size(); ++a) {
+                const double value = axes_[a].values[index[a]];
+                params.set(axes_[a].key, value);
+                name << (a ? "," : "") << axes_[a].key << "=" << value;
+            }
+            params.name = axes_.empty() ? base_.name : name.str();
+            grid.push_back(std::move(params));
+
+            // Odometer increment, last axis fastest
+            for (size_t a = axes_.size(); a-- > 0;) {
+                if (++index[a] < axes_[a].values.size()) break;
+                index[a] = 0;
+            }
+        }
+        return grid;
+    }
+};
+
+struct BacktestDay {
+    std::string date;
+    std::vector<EnhancedMarketData> ticks;
+};
+
+// Outcome of one (day, parameter set) job
+struct BacktestDayResult {
+    std::vector<TradeRecord> trades;
+    uint32_t signals = 0;
+    uint32_t rejected = 0;
+    double net_pnl = 0.0;
+};
+
+// Outcome of one parameter set across all days
+struct BacktestResult {
+    BacktestParams params;
+    DailyStats stats;                 // Reduced over every trade of every day
+    std::vector<double> daily_pnl;    // In day order
+    uint32_t signals = 0;
+    uint32_t rejected = 0;
+    uint32_t winning_days = 0;
+};
+
+struct BacktestConfig {
+    size_t threads = 0;                 // 0 = all cores
+    bool pin_threads = false;
+    double min_confidence = 0.7;        // Same gate as the live loop
+    uint32_t seed = 42;                 // Executor slippage noise, mixed with the day index
+    std::vector<std::pair<std::string, std::string>> pairs = {{"SPY", "QQQ"}};
+};
+
+// Parallel backtest engine
+//
+// Replays recorded days through IntradayStrategyEngine and the live
+// ExecutionPipeline (IntradayRiskManager, OrderManager and a zero-latency
+// SimulatedGateway over SimpleExecutor) on a private virtual SessionClock.
+// Every (day, parameter set) pair is an independent job on a work-stealing
+// pool; results are written to per-job slots and reduced per parameter set
+// once the pool drains, so the outcome does not depend on scheduling.
+class BacktestEngine {
+private:
+    static constexpr size_t BACKTEST_ORDER_CAPACITY = 256;   // Open orders per job (one position per symbol)
+
+    BacktestConfig config_;
+    SessionCalendar calendar_;
+    std::vector<BacktestDay> days_;
+    WorkStealingPool pool_;
+
+public:
+    explicit BacktestEngine(const BacktestConfig& config = BacktestConfig(),
+                            const SessionCalendar& calendar = SessionClock::instance().calendar())
+        : config_(config), calendar_(calendar), pool_(config.threads, config.pin_threads) {}
+
+    void add_day(BacktestDay day) {
+        days_.push_back(std::move(day));
+    }
+
+    // Load tick files in parallel; the day label is the file name stem
+    size_t load_days(const std::vector<std::string>& paths) {
+        std::vector<BacktestDay> loaded(paths.size());
+        std::vector<uint8_t> ok(paths.size(), 0);
+
+        for (size_t i = 0; i < paths.size(); ++i) {
+            pool_.submit([&, i] {
+                const std::string& path = paths[i];
+                size_t slash = path.find_last_of('/');
+                size_t dot = path.find_last_of('.');
+                size_t begin = slash == std::string::npos ? 0 : slash + 1;
+                loaded[i].date = path.substr(begin, dot == std::string::npos || dot < begin
+                                                        ? std::string::npos : dot - begin);
+                ok[i] = load_tick_file(path, loaded[i].ticks);
+            });
+        }
+        pool_.wait_idle();
+
+        size_t count = 0;
+        for (size_t i = 0; i < paths.size(); ++i) {
+            if (ok[i]) {
+                days_.push_back(std::move(loaded[i]));
+                ++count;
+            } else {
+                printf("⚠️  Could not load tick file: %s\n", paths[i].c_str());
+            }
+        }
+
+        std::sort(days_.begin(), days_.end(), [](const auto& a, const auto& b) {
+            return a.date < b.date;
+        });
+        return count;
+    }
+
+    size_t day_count() const { return days_.size(); }
+    size_t thread_count() const { return pool_.thread_count(); }
+
+    // Run every parameter set over every day
+    std::vector<BacktestResult> run(const std::vector<BacktestParams>& grid) {
+        const size_t num_days = days_.size();
+        std::vector<BacktestDayResult> jobs(grid.size() * num_days);
+
+        // Longest days first so stragglers do not end the run
+        std::vector<size_t> day_order(num_days);
+        std::iota(day_order.begin(), day_order.end(), 0);
+        std::sort(day_order.begin(), day_order.end(), [this](size_t a, size_t b) {
+            return days_[a].ticks.size() > days_[b].ticks.size();
+        });
+
+        for (size_t d : day_order) {
+            for (size_t p = 0; p < grid.size(); ++p) {
+                const size_t slot = p * num_days + d;
+                pool_.submit([this, &grid, &jobs, slot, p, d] {
+                    // Same noise stream per day for every parameter set (common random numbers)
+                    jobs[slot] = run_day(days_[d], grid[p], config_, calendar_,
+                                         config_.seed ^ static_cast<uint32_t>((d + 1) * 2654435761u));
+                });
+            }
+        }
+        pool_.wait_idle();
+
+        std::vector<BacktestResult> results(grid.size());
+        for (size_t p = 0; p < grid.size(); ++p) {
+            BacktestResult& result = results[p];
+            result.params = grid[p];
+
+            std::vector<TradeRecord> trades;
+            for (size_t d = 0; d < num_days; ++d) {
+                const BacktestDayResult& day = jobs[p * num_days + d];
+                trades.insert(trades.end(), day.trades.begin(), day.trades.end());
+                result.daily_pnl.push_back(day.net_pnl);
+                result.signals += day.signals;
+                result.rejected += day.rejected;
+                if (day.net_pnl > 0) result.winning_days++;
+            }
+            result.stats = PerformanceTracker::summarize_trades(trades, grid[p].limits.capital);
+            result.stats.date = num_days ? days_.front().date + ".." + days_.back().date : "";
+        }
+        return results;
+    }
+
+    // Replay one day with one parameter set (self-contained; safe to run concurrently)
+    static BacktestDayResult run_day(const BacktestDay& day, const BacktestParams& params,
+                                     const BacktestConfig& config, const SessionCalendar& calendar,
+                                     uint32_t seed) {
+        BacktestDayResult result;
+        if (day.ticks.empty()) return result;
+
+        SessionClock clock(calendar);
+        clock.set_virtual_time(day.ticks.front().timestamp_ns);
+
+        IntradayStrategyEngine engine(&clock);
+        engine.vwap_reversion().set_config(params.vwap);
+        engine.opening_drive().set_config(params.opening);
+        engine.pair_divergence().set_config(params.pair);
+        engine.pair_divergence().clear_pairs();
+        for (const auto& [a, b] : config.pairs) engine.pair_divergence().add_pair(a, b);
+
+        IntradayRiskManager risk(nullptr, &clock, false);
+        risk.update_limits(params.limits);
+        SimpleExecutor executor(&clock, seed);
+
+        // Zero-latency venue: every pump() settles the orders sent since the last one
+        OrderManager oms(BACKTEST_ORDER_CAPACITY);
+        SimulatedGateway gateway(oms, executor, &clock);
+        ExecutionPipeline pipeline(risk, oms, &clock, config.min_confidence);
+        auto pump = [&]() {
+            oms.poll();
+            gateway.poll();
+            oms.poll();
+            pipeline.poll();
+        };
+
+        pipeline.set_exit_callback([&result](const ManagedPosition& position, const OrderResult& exit_order,
+                                             double net_pnl, ExitReason) {
+            result.trades.emplace_back(position.signal, position.entry, exit_order);
+            result.net_pnl += net_pnl;
+        });
+
+        for (const EnhancedMarketData& tick : day.ticks) {
+            clock.advance_to(tick.timestamp_ns);
+            gateway.on_market_data(tick.symbol, tick.bid, tick.ask);
+            pipeline.on_market_data(tick.symbol, tick.bid, tick.ask, tick.last);
+            pipeline.on_timer(tick.timestamp_ns);
+            pump();
+
+            Signal signal = engine.process_market_data(tick);
+            if (!signal.is_valid) continue;
+
+            SignalOutcome outcome = pipeline.on_signal(signal);
+            pump();
+            if (outcome == SignalOutcome::BELOW_CONFIDENCE) continue;
+            result.signals++;
+            if (outcome != SignalOutcome::ENTERED) result.rejected++;
+        }
+
+        // Flat at the end of the day
+        pipeline.flatten_all();
+        pump();
+
+        return result;
+    }
+
+    // Rank by net P&L and print the top configurations
+    static void print_results(std::vector<BacktestResult> results, size_t top_n = 10) {
+        std::sort(results.begin(), results.end(), [](const auto& a, const auto& b) {
+            return a.stats.net_pnl > b.stats.net_pnl;
+        });
+
+        printf("\n=== 📊 BACKTEST RESULTS (%zu configurations) ===\n", results.size());
+        printf("%-4s %10s %7s %7s %8s %7s %7s %6s  %s\n",
+               "#", "Net P&L", "Trades", "Win%", "PF", "MaxDD%", "Sharpe", "Days+", "Parameters");
+        for (size_t i = 0; i < std::min(top_n, results.size()); ++i) {
+            const auto& r = results[i];
+            printf("%-4zu %10.2f %7u %6.1f%% %8.2f %6.2f%% %7.2f %3u/%-2zu  %s\n",
+                   i + 1, r.stats.net_pnl, r.stats.trades_taken, r.stats.win_rate,
+                   r.stats.profit_factor, r.stats.max_drawdown * 100.0, r.stats.sharpe_ratio,
+                   r.winning_days, r.daily_pnl.size(), r.params.name.c_str());
+        }
+        printf("=====================================\n\n");
+    }
+
+    static bool write_results_csv(const std::string& path, const std::vector<BacktestResult>& results) {
+        std::ofstream file(path);
+        if (!file.is_open()) return false;
+
+        file << "parameters,days,trades,winning_trades,net_pnl,gross_pnl,commissions,win_rate,"
+             << "profit_factor,max_drawdown,sharpe_ratio,signals,rejected,winning_days\n";
+        for (const auto& r : results) {
+            file << "\"" << r.params.name << "\"," << r.daily_pnl.size() << ","
+                 << r.stats.trades_taken << "," << r.stats.winning_trades << ","
+                 << std::fixed << std::setprecision(2) << r.stats.net_pnl << ","
+                 << r.stats.gross_pnl << "," << r.stats.commissions << ","
+                 << r.stats.win_rate << "," << r.stats.profit_factor << ","
+                 << (r.stats.max_drawdown * 100) << "," << r.stats.sharpe_ratio << ","
+                 << r.signals << "," << r.rejected << "," << r.winning_days << "\n";
+        }
+        return true;
+    }
+};
+
+} // namespace hft::strategies
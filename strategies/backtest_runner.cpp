@@ -0,0 +1,155 @@
+#include <iostream>
+#include <chrono>
+#include <cstdio>
+#include <string>
+#include <vector>
+#include "backtest_engine.hpp"
+
+using namespace hft::strategies;
+
+void print_usage(const char* program) {
+    std::cout << "Usage: " << program << " [options] <tick_file.csv>...\n"
+              << "  --threads N            Worker threads (default: all cores)\n"
+              << "  --pin                  Pin workers to cores\n"
+              << "  --calendar PATH        Market calendar (default: config/market_calendar.csv)\n"
+              << "  --pairs PATH           Strategy config with a \"pairs\" array\n"
+              << "  --sweep KEY=A:B:STEP   Inclusive range sweep (repeatable)\n"
+              << "  --grid KEY=V1,V2,...   Explicit value list (repeatable)\n"
+              << "  --min-confidence X     Signal confidence gate (default: 0.7)\n"
+              << "  --seed N               Slippage noise seed (default: 42)\n"
+              << "  --top N                Configurations to print (default: 10)\n"
+              << "  --csv PATH             Write all results to CSV\n\n"
+              << "Example:\n  " << program
+              << " --sweep vwap.min_distance_from_vwap=0.005:0.02:0.005"
+              << " --grid pair.min_zscore=1.5,2,2.5 ticks/*.csv\n";
+}
+
+std::vector<double> parse_values(const std::string& spec) {
+    std::vector<double> values;
+    size_t pos = 0;
+    while (pos <= spec.size()) {
+        size_t comma = spec.find(',', pos);
+        if (comma == std::string::npos) comma = spec.size();
+        if (comma > pos) values.push_back(std::stod(spec.substr(pos, comma - pos)));
+        pos = comma + 1;
+    }
+    return values;
+}
+
+// KEY=A:B:STEP (range) or KEY=V1,V2,... (list)
+bool add_axis(ParameterGrid& grid, const std::string& spec, bool range) {
+    size_t eq = spec.find('=');
+    if (eq == std::string::npos) return false;
+    const std::string key = spec.substr(0, eq);
+    const std::string values = spec.substr(eq + 1);
+
+    if (range) {
+        double from = 0, to = 0, step = 0;
+        return std::sscanf(values.c_str(), "%lf:%lf:%lf", &from, &to, &step) == 3 &&
+               grid.sweep(key, from, to, step);
+    }
+    return grid.sweep(key, parse_values(values));
+}
+
+int main(int argc, char** argv) {
+    BacktestConfig config;
+    std::string calendar_path = "config/market_calendar.csv";
+    std::string pairs_path;
+    std::string csv_path;
+    size_t top_n = 10;
+    std::vector<std::string> files;
+    ParameterGrid grid;
+
+    try {
+        for (int i = 1; i < argc; ++i) {
+            std::string arg = argv[i];
+            auto next = [&]() -> std::string {
+                if (i + 1 >= argc) throw std::invalid_argument("missing value for " + arg);
+                return argv[++i];
+            };
+
+            if (arg == "--help" || arg == "-h") {
+                print_usage(argv[0]);
+                return 0;
+            } else if (arg == "--threads") {
+                config.threads = std::stoul(next());
+            } else if (arg == "--pin") {
+                config.pin_threads = true;
+            } else if (arg == "--calendar") {
+                calendar_path = next();
+            } else if (arg == "--pairs") {
+                pairs_path = next();
+            } else if (arg == "--min-confidence") {
+                config.min_confidence = std::stod(next());
+            } else if (arg == "--seed") {
+                config.seed = static_cast<uint32_t>(std::stoul(next()));
+            } else if (arg == "--top") {
+                top_n = std::stoul(next());
+            } else if (arg == "--csv") {
+                csv_path = next();
+            } else if (arg == "--sweep" || arg == "--grid") {
+                std::string spec = next();
+                if (!add_axis(grid, spec, arg == "--sweep")) {
+                    std::cerr << "❌ Invalid parameter axis: " << spec << "\n";
+                    return 1;
+                }
+            } else {
+                files.push_back(arg);
+            }
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "❌ Error: " << e.what() << "\n";
+        print_usage(argv[0]);
+        return 1;
+    }
+
+    if (files.empty()) {
+        print_usage(argv[0]);
+        return 1;
+    }
+
+    SessionCalendar calendar;
+    if (!calendar.load(calendar_path)) {
+        std::cout << "⚠️  Market calendar not found - assuming regular weekday sessions\n";
+    }
+
+    if (!pairs_path.empty()) {
+        std::vector<std::pair<std::string, std::string>> pairs;
+        if (PairDivergenceStrategy::parse_pairs_config(pairs_path, pairs)) {
+            config.pairs = pairs;
+        } else {
+            std::cout << "⚠️  No pairs in " << pairs_path << " - using SPY/QQQ\n";
+        }
+    }
+
+    BacktestEngine engine(config, calendar);
+
+    auto start = std::chrono::steady_clock::now();
+    size_t loaded = engine.load_days(files);
+    if (loaded == 0) {
+        std::cerr << "❌ No tick files could be loaded\n";
+        return 1;
+    }
+
+    auto params = grid.build();
+    std::cout << "🧪 Backtesting " << params.size() << " configurations x " << loaded
+              << " days = " << params.size() * loaded << " jobs on "
+              << engine.thread_count() << " threads\n";
+
+    auto results = engine.run(params);
+    auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - start);
+
+    BacktestEngine::print_results(results, top_n);
+    std::cout << "⏱️  Completed in " << elapsed.count() << " ms\n";
+
+    if (!csv_path.empty()) {
+        if (BacktestEngine::write_results_csv(csv_path, results)) {
+            std::cout << "💾 Results written to " << csv_path << "\n";
+        } else {
+            std::cerr << "❌ Could not write " << csv_path << "\n";
+        }
+    }
+
+    return 0;
+}
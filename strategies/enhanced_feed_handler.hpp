@@ -4,6 +4,7 @@
 #include <atomic>
 #include <chrono>
 #include <iostream>
+#include <iomanip>
 #include <unordered_map>
 #include <memory>
 #include <random>
@@ -0,0 +1,398 @@
+// execution_algos.hpp - Timer-wheel driven TWAP/VWAP/POV parent-order execution algorithms
+#pragma once
+
+#include <cstdio>
+#include <functional>
+#include <memory>
+#include <vector>
+#include "../order_manager.hpp"
+#include "../symbol_table.hpp"
+#include "../timer_wheel.hpp"
+#include "technical_indicators.hpp"
+#include "session_clock.hpp"
+
+namespace hft::strategies {
+
+enum class AlgoType : uint8_t {
+    TWAP = 0,       // Even schedule between start and end
+    VWAP = 1,       // Schedule follows the symbol's intraday volume curve
+    POV = 2         // Fixed share of market volume traded since start
+};
+
+inline const char* algo_type_name(AlgoType algo) {
+    switch (algo) {
+        case AlgoType::TWAP: return "TWAP";
+        case AlgoType::VWAP: return "VWAP";
+        case AlgoType::POV: return "POV";
+    }
+    return "UNKNOWN";
+}
+
+// Parent order handed to the algo engine
+struct ParentOrderSpec {
+    AlgoType algo = AlgoType::TWAP;
+    SymbolId symbol = 0;
+    Side side = Side::BUY;
+    Venue venue = Venue::NYSE;
+    StrategyId strategy = 0;
+    uint64_t client_tag = 0;            // Echoed in the ParentResult
+    double quantity = 0.0;
+    double limit_price = 0.0;           // Children are skipped while the touch is worse (0 = none)
+    uint64_t duration_ns = 300000000000ULL;
+    uint64_t slice_interval_ns = 10000000000ULL;
+    double participation = 0.1;         // POV share of market volume
+    double min_child = 1.0;             // Smaller catch-up amounts wait for the next slice
+};
+
+// Final state of a parent order
+struct ParentResult {
+    uint64_t parent_id;
+    uint64_t client_tag;
+    SymbolId symbol;
+    Side side;
+    AlgoType algo;
+    bool cancelled;
+    double requested;
+    Quantity filled;
+    double notional;                    // Sum of fill price * quantity
+    int64_t fees;                       // Fixed point (PRICE_MULTIPLIER)
+    uint32_t children;
+
+    double avg_price() const {
+        return filled > 0 ? notional / to_float_quantity(filled) : 0.0;
+    }
+};
+
+// Timer-driven execution algorithms
+//
+// Each parent order owns one slot in a preallocated pool and at most one
+// working child order. A shared TimerWheel wakes a parent only when its next
+// slice is due, and market data only updates per-symbol state (touch,
+// cumulative volume, volume curve), so per-tick cost does not grow with the
+// number of parents. Every slice sends the gap between the algo's target
+// (time-, volume-curve- or participation-based) and what has filled so far,
+// which re-plans child sizes on each fill: short fills are made up on the next
+// slice, overfills shrink it. Children go to the OMS as market orders tagged
+// ALGO_TAG | parent slot; feed OMS updates through on_order_update(), which
+// claims the ones that belong to the engine. Single-threaded.
+class ExecutionAlgoEngine {
+public:
+    static constexpr uint64_t ALGO_TAG = 1ULL << 63;
+    static constexpr uint32_t MAX_LATE_SLICES = 3;
+    static constexpr size_t DEFAULT_CAPACITY = 4096;
+    static constexpr uint64_t DEFAULT_TICK_NS = 100000000ULL;  // 100 ms wheel resolution
+
+    using DoneCallback = std::function<void(const ParentResult&)>;
+
+    struct Stats {
+        uint64_t parents = 0;
+        uint64_t completed = 0;
+        uint64_t cancelled = 0;
+        uint64_t children = 0;
+        uint64_t skipped_slices = 0;    // Nothing to send, limit breached or child still working
+        uint64_t timer_fires = 0;
+    };
+
+private:
+    struct Parent {
+        ParentOrderSpec spec;
+        uint64_t start_ns = 0;
+        uint64_t end_ns = 0;
+        double start_minute = 0.0;      // Exchange minute of day at start (VWAP)
+        double curve_start = 0.0;       // Volume-curve fraction at start and end (VWAP)
+        double curve_span = 1.0;
+        uint64_t volume_base = 0;       // Symbol cumulative volume at start (POV)
+        Quantity total = 0;
+        Quantity filled = 0;
+        double notional = 0.0;
+        int64_t fees = 0;
+        OrderId working_order = 0;
+        TimerWheel::TimerId timer = TimerWheel::INVALID_TIMER;
+        uint32_t children = 0;
+        uint32_t late_slices = 0;       // Slices after end_ns spent finishing the remainder
+        uint32_t generation = 0;
+        bool active = false;
+        bool cancel_requested = false;
+    };
+
+    struct SymbolState {
+        double bid = 0.0;
+        double ask = 0.0;
+        uint64_t cumulative_volume = 0;
+        indicators::VolumeProfile* profile = nullptr;
+    };
+
+    OrderManager& oms_;
+    SessionClock* clock_;
+    TimerWheel wheel_;
+    std::vector<Parent> parents_;
+    std::vector<uint32_t> free_list_;
+    std::vector<SymbolState> symbols_;
+    std::vector<std::unique_ptr<indicators::VolumeProfile>> profiles_;
+    indicators::VolumeProfile default_profile_;
+    size_t active_count_ = 0;
+
+    DoneCallback on_done_;
+    Stats stats_;
+
+public:
+    ExecutionAlgoEngine(OrderManager& oms, SessionClock* clock = &SessionClock::instance(),
+                        size_t capacity = DEFAULT_CAPACITY, uint64_t tick_ns = DEFAULT_TICK_NS)
+        : oms_(oms), clock_(clock), wheel_(tick_ns, 1024, capacity), parents_(capacity),
+          symbols_(SymbolTable::MAX_SYMBOLS),
+          default_profile_(clock->calendar().market_open_minute, clock->calendar().market_close_minute) {
+        free_list_.reserve(capacity);
+        for (size_t i = capacity; i-- > 0;) {
+            free_list_.push_back(static_cast<uint32_t>(i));
+        }
+    }
+
+    void set_done_callback(DoneCallback callback) { on_done_ = std::move(callback); }
+
+    // Per-symbol intraday volume curve for VWAP (learned from on_market_data volume)
+    indicators::VolumeProfile& volume_profile(SymbolId symbol) {
+        SymbolState& state = symbols_[symbol];
+        if (!state.profile) {
+            profiles_.push_back(std::make_unique<indicators::VolumeProfile>(
+                clock_->calendar().market_open_minute, clock_->calendar().market_close_minute));
+            state.profile = profiles_.back().get();
+        }
+        return *state.profile;
+    }
+
+    // Start a parent order; returns its id (0 if the pool is full or the spec is empty)
+    uint64_t submit(const ParentOrderSpec& spec) {
+        if (free_list_.empty() || spec.quantity <= 0.0 || spec.symbol >= symbols_.size()) return 0;
+
+        const uint32_t slot = free_list_.back();
+        free_list_.pop_back();
+
+        Parent& parent = parents_[slot];
+        const uint32_t generation = parent.generation + 1;
+        parent = Parent{};
+        parent.generation = generation;
+        parent.spec = spec;
+        parent.spec.slice_interval_ns = std::max(spec.slice_interval_ns, wheel_.tick_ns());
+        parent.start_ns = clock_->now_ns();
+        parent.end_ns = parent.start_ns + std::max(spec.duration_ns, parent.spec.slice_interval_ns);
+        parent.total = to_fixed_quantity(spec.quantity);
+        parent.active = true;
+
+        const SymbolState& state = symbols_[spec.symbol];
+        parent.volume_base = state.cumulative_volume;
+        if (spec.algo == AlgoType::VWAP) {
+            const indicators::VolumeProfile& profile = state.profile ? *state.profile : default_profile_;
+            parent.start_minute = clock_->current().minute_of_day();
+            parent.curve_start = profile.cumulative_fraction(parent.start_minute);
+            const double end_minute = parent.start_minute + (parent.end_ns - parent.start_ns) / 60e9;
+            parent.curve_span = profile.cumulative_fraction(end_minute) - parent.curve_start;
+        }
+
+        active_count_++;
+        stats_.parents++;
+
+        schedule_next(slot, parent.start_ns);
+        return make_id(slot, generation);
+    }
+
+    // Stop scheduling; the parent completes once any working child is done
+    bool cancel(uint64_t parent_id) {
+        Parent* parent = find(parent_id);
+        if (!parent) return false;
+        parent->cancel_requested = true;
+        if (parent->working_order == 0) finish(slot_of(parent_id));
+        return true;
+    }
+
+    // O(1): touch and cumulative volume feed the next slices of every parent on the symbol
+    void on_market_data(SymbolId symbol, double bid, double ask, uint64_t cumulative_volume) {
+        if (symbol >= symbols_.size()) return;
+        SymbolState& state = symbols_[symbol];
+        state.bid = bid;
+        state.ask = ask;
+        if (cumulative_volume > state.cumulative_volume) {
+            if (state.profile) {
+                state.profile->add_volume(clock_->current().minute_of_day(),
+                                          cumulative_volume - state.cumulative_volume);
+            }
+            state.cumulative_volume = cumulative_volume;
+        }
+    }
+
+    // Fire due slices
+    size_t on_timer(uint64_t now_ns) {
+        return wheel_.advance(now_ns, [this](uint64_t payload) {
+            stats_.timer_fires++;
+            const uint32_t slot = static_cast<uint32_t>(payload);
+            const uint32_t generation = static_cast<uint32_t>(payload >> 32);
+            if (parents_[slot].active && parents_[slot].generation == generation) {
+                parents_[slot].timer = TimerWheel::INVALID_TIMER;
+                slice(slot);
+            }
+        });
+    }
+
+    // Returns true if the update belongs to one of the engine's child orders
+    bool on_order_update(const OrderUpdate& update) {
+        if (!(update.client_tag & ALGO_TAG)) return false;
+        Parent* parent = find(update.client_tag & ~ALGO_TAG);
+        if (!parent || update.order_id != parent->working_order || !update.is_terminal()) return true;
+
+        parent->filled += update.filled_quantity;
+        parent->notional += to_float_price(update.avg_fill_price) * to_float_quantity(update.filled_quantity);
+        parent->fees += update.fees;
+        parent->working_order = 0;
+
+        const uint32_t slot = slot_of(update.client_tag & ~ALGO_TAG);
+        if (parent->filled >= parent->total || parent->cancel_requested ||
+            (clock_->now_ns() >= parent->end_ns && parent->spec.algo == AlgoType::POV)) {
+            finish(slot);
+        }
+        return true;
+    }
+
+    size_t active_parents() const { return active_count_; }
+    size_t pending_timers() const { return wheel_.size(); }
+    const Stats& get_stats() const { return stats_; }
+
+    void print_status() const {
+        printf("\n⏱️  Execution Algo Status:\n");
+        printf("   Parents: %lu (active %zu, completed %lu, cancelled %lu)\n",
+               static_cast<unsigned long>(stats_.parents), active_count_,
+               static_cast<unsigned long>(stats_.completed), static_cast<unsigned long>(stats_.cancelled));
+        printf("   Children: %lu, Skipped slices: %lu, Timer fires: %lu\n",
+               static_cast<unsigned long>(stats_.children), static_cast<unsigned long>(stats_.skipped_slices),
+               static_cast<unsigned long>(stats_.timer_fires));
+    }
+
+private:
+    static uint64_t make_id(uint32_t slot, uint32_t generation) {
+        return (static_cast<uint64_t>(generation) << 32) | slot;
+    }
+
+    static uint32_t slot_of(uint64_t id) { return static_cast<uint32_t>(id); }
+
+    Parent* find(uint64_t id) {
+        const uint32_t slot = slot_of(id);
+        if (slot >= parents_.size()) return nullptr;
+        Parent& parent = parents_[slot];
+        return parent.active && parent.generation == static_cast<uint32_t>(id >> 32) ? &parent : nullptr;
+    }
+
+    // Cumulative quantity the schedule calls for at `now`
+    Quantity target(const Parent& parent, uint64_t now) const {
+        if (now >= parent.end_ns && parent.spec.algo != AlgoType::POV) return parent.total;
+
+        double fraction = 0.0;
+        switch (parent.spec.algo) {
+            case AlgoType::TWAP:
+                fraction = static_cast<double>(now - parent.start_ns) / (parent.end_ns - parent.start_ns);
+                break;
+            case AlgoType::VWAP: {
+                const SymbolState& state = symbols_[parent.spec.symbol];
+                const indicators::VolumeProfile& profile = state.profile ? *state.profile : default_profile_;
+                const double minute = parent.start_minute + (now - parent.start_ns) / 60e9;
+                fraction = parent.curve_span > 0.0
+                    ? (profile.cumulative_fraction(minute) - parent.curve_start) / parent.curve_span
+                    : static_cast<double>(now - parent.start_ns) / (parent.end_ns - parent.start_ns);
+                break;
+            }
+            case AlgoType::POV: {
+                const uint64_t traded = symbols_[parent.spec.symbol].cumulative_volume - parent.volume_base;
+                return std::min(parent.total, to_fixed_quantity(parent.spec.participation * traded));
+            }
+        }
+        fraction = std::min(1.0, std::max(0.0, fraction));
+        return std::min(parent.total, static_cast<Quantity>(fraction * parent.total));
+    }
+
+    void slice(uint32_t slot) {
+        Parent& parent = parents_[slot];
+        const uint64_t now = clock_->now_ns();
+        const bool final_slice = now >= parent.end_ns;
+
+        if (parent.working_order == 0 && !parent.cancel_requested) {
+            const Quantity goal = target(parent, now);
+            const Quantity child = goal > parent.filled ? goal - parent.filled : 0;
+            const SymbolState& state = symbols_[parent.spec.symbol];
+            const double touch = parent.spec.side == Side::BUY ? state.ask : state.bid;
+            const bool limit_ok = parent.spec.limit_price <= 0.0 || touch <= 0.0 ||
+                                  (parent.spec.side == Side::BUY ? touch <= parent.spec.limit_price
+                                                                 : touch >= parent.spec.limit_price);
+
+            if (child > 0 && limit_ok && (final_slice || child >= to_fixed_quantity(parent.spec.min_child))) {
+                send_child(slot, child);
+            } else {
+                stats_.skipped_slices++;
+            }
+        } else {
+            stats_.skipped_slices++;
+        }
+
+        // Past the end only the remainder is chased, for a bounded number of slices
+        if (final_slice && (parent.working_order == 0 || ++parent.late_slices > MAX_LATE_SLICES)) {
+            if (parent.working_order == 0) {
+                finish(slot);
+            } else {
+                parent.cancel_requested = true;     // Finish when the last child reports back
+            }
+            return;
+        }
+        schedule_next(slot, now);
+    }
+
+    void schedule_next(uint32_t slot, uint64_t now) {
+        Parent& parent = parents_[slot];
+        const uint64_t next = now + parent.spec.slice_interval_ns;
+        parent.timer = wheel_.schedule(now >= parent.end_ns ? next : std::min(next, parent.end_ns),
+                                       make_id(slot, parent.generation));
+    }
+
+    void send_child(uint32_t slot, Quantity quantity) {
+        Parent& parent = parents_[slot];
+
+        OrderRequest request{};
+        request.action = OrderRequest::Action::NEW;
+        request.order_id = oms_.reserve_order_id();
+        request.client_tag = ALGO_TAG | make_id(slot, parent.generation);
+        request.timestamp_ns = clock_->now_ns();
+        request.quantity = quantity;
+        request.symbol = parent.spec.symbol;
+        request.strategy = parent.spec.strategy;
+        request.side = parent.spec.side;
+        request.type = OrderType::MARKET;
+        request.tif = TimeInForce::IOC;
+        request.venue = parent.spec.venue;
+        if (!oms_.submit(request)) return;
+
+        parent.working_order = request.order_id;
+        parent.children++;
+        stats_.children++;
+    }
+
+    void finish(uint32_t slot) {
+        Parent& parent = parents_[slot];
+        if (parent.timer != TimerWheel::INVALID_TIMER) {
+            wheel_.cancel(parent.timer);
+            parent.timer = TimerWheel::INVALID_TIMER;
+        }
+        parent.active = false;
+        active_count_--;
+        free_list_.push_back(slot);
+
+        const bool cancelled = parent.cancel_requested;
+        if (cancelled) {
+            stats_.cancelled++;
+        } else {
+            stats_.completed++;
+        }
+
+        if (on_done_) {
+            on_done_(ParentResult{make_id(slot, parent.generation), parent.spec.client_tag, parent.spec.symbol,
+                                  parent.spec.side, parent.spec.algo, cancelled, parent.spec.quantity,
+                                  parent.filled, parent.notional, parent.fees, parent.children});
+        }
+    }
+};
+
+} // namespace hft::strategies
@@ -0,0 +1,705 @@
+#pragma once
+
+#include <cstdio>
+#include <functional>
+#include <queue>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "intraday_strategies.hpp"
+#include "intraday_risk_manager.hpp"
+#include "simple_executor.hpp"
+#include "../order_manager.hpp"
+#include "../basket_order.hpp"
+#include "../smart_order_router.hpp"
+#include "execution_algos.hpp"
+#include "../symbol_table.hpp"
+#include "session_clock.hpp"
+
+namespace hft::strategies {
+
+// Why a position was closed
+enum class ExitReason : uint8_t {
+    STOP = 0,
+    TARGET = 1,
+    TIME = 2,       // Expected hold time elapsed
+    FLATTEN = 3     // Session end / shutdown
+};
+
+inline const char* exit_reason_name(ExitReason reason) {
+    switch (reason) {
+        case ExitReason::STOP: return "STOP";
+        case ExitReason::TARGET: return "TARGET";
+        case ExitReason::TIME: return "TIME";
+        case ExitReason::FLATTEN: return "FLATTEN";
+    }
+    return "UNKNOWN";
+}
+
+// Result of handing a signal to the pipeline (ENTERED = entry order submitted)
+enum class SignalOutcome : uint8_t {
+    ENTERED,
+    BELOW_CONFIDENCE,
+    POSITION_OPEN,
+    RISK_REJECTED,
+    SIZE_REJECTED,
+    SUBMIT_REJECTED     // OMS request ring full
+};
+
+// Price update carried from the feed thread to the event loop
+struct MarketUpdate {
+    uint64_t timestamp_ns;
+    SymbolId symbol;
+    Venue venue;
+    double bid;
+    double ask;
+    double last;
+    double bid_size;
+    double ask_size;
+    uint64_t cumulative_volume;
+};
+
+// Position tracked by the pipeline
+struct ManagedPosition {
+    enum class State : uint8_t { PENDING_ENTRY, OPEN, EXITING, CLOSED };
+
+    uint64_t id = 0;
+    State state = State::PENDING_ENTRY;
+    std::string symbol;             // Traded symbol (leg A for pair signals)
+    SymbolId symbol_id = 0;
+    Signal signal;
+    PositionSize size;
+    OrderResult entry;
+    Venue venue = Venue::NYSE;      // Venue of the largest entry child order
+    uint64_t entry_parent = 0;      // Algo parent working the entry (0 = direct orders)
+    uint64_t basket = 0;            // Basket working a pair entry/exit (0 = none)
+    std::string hedge_symbol;       // Pair leg B when the pair was entered as a basket
+    SymbolId hedge_symbol_id = 0;
+    double hedge_quantity = 0.0;    // Leg B shares still held (opposite side to the signal)
+    double hedge_entry_price = 0.0;
+    double hedge_pnl = 0.0;         // Realized on leg B as it is closed (fees stay in the leg totals)
+    uint8_t working_orders = 0;     // Child orders of the current entry/exit still open
+    Quantity leg_filled = 0;        // Current entry/exit fills summed across child orders
+    double leg_notional = 0.0;
+    int64_t leg_fees = 0;
+    double exit_reference_price = 0.0;  // Quote when the exit was sent (slippage)
+    double partial_exit_pnl = 0.0;      // Realized by earlier partially filled exits, net of their fees
+    ExitReason exit_reason = ExitReason::FLATTEN;
+    bool flatten_on_open = false;   // flatten_all() arrived before the entry filled
+    uint64_t exit_deadline_ns = 0;
+};
+
+// Event-driven signal-to-order pipeline
+//
+// Signals are risk-checked, sized and sent to the OMS as soon as they arrive;
+// nothing waits for the venue. With a SmartOrderRouter attached, each entry
+// and exit is split into child orders across venues (and ack round trips are
+// fed back to the router); otherwise everything goes to the default venue.
+// With an entry algo set, entries are worked as TWAP/VWAP/POV parent orders
+// and the position opens once the parent completes. Exits stay immediate.
+// With a BasketManager attached, pair signals trade both legs as one basket
+// (dollar-neutral hedge leg, unwound if either leg fails) and exit the same
+// way; an unwound entry's P&L and fees go to the risk manager like any other
+// trade, and a basket that cannot be unwound halts the session. Each position is a small state machine:
+// PENDING_ENTRY until the entry fill comes back through poll(), OPEN while
+// price triggers (stop/target on every market update for its symbol) and a
+// deadline heap (expected hold time) watch it, EXITING until the exit fill
+// arrives. Every execution the OMS reports (entries, exits, partial exits,
+// basket legs, unwinds and hedges) is passed to the fill callback as it
+// arrives, so the book of record never waits for a position to close.
+// Single-threaded; the owning event loop feeds it signals, market
+// data, OMS updates and the current time.
+class ExecutionPipeline {
+public:
+    using EntryCallback = std::function<void(const ManagedPosition&)>;
+    using ExitCallback = std::function<void(const ManagedPosition&, const OrderResult& exit_order,
+                                            double net_pnl, ExitReason reason)>;
+    // One execution: signed quantity (positive = bought) at its fill price
+    using FillCallback = std::function<void(Venue venue, SymbolId symbol, double quantity, double price)>;
+
+    struct Stats {
+        uint64_t signals = 0;
+        uint64_t entries = 0;
+        uint64_t rejected = 0;
+        uint64_t order_rejects = 0;         // Entry/exit orders refused by OMS or venue
+        uint64_t exits[4] = {0, 0, 0, 0};   // Indexed by ExitReason
+        uint64_t latency_samples = 0;
+        uint64_t total_latency_ns = 0;      // Signal timestamp -> entry fill (live only)
+        uint64_t max_latency_ns = 0;
+    };
+
+private:
+    static constexpr uint64_t EXIT_RETRY_NS = 1000000000ULL;
+
+    struct Deadline {
+        uint64_t due_ns;
+        uint64_t position_id;
+        bool operator>(const Deadline& other) const { return due_ns > other.due_ns; }
+    };
+
+    struct Quote {
+        double bid = 0.0;
+        double ask = 0.0;
+    };
+
+    using PositionMap = std::unordered_map<std::string, ManagedPosition>;
+
+    IntradayRiskManager& risk_;
+    OrderManager& oms_;
+    SessionClock* clock_;
+    double min_confidence_;
+    Venue venue_;
+    SmartOrderRouter* router_ = nullptr;
+    ExecutionAlgoEngine* algos_ = nullptr;
+    ParentOrderSpec entry_algo_;
+    BasketManager* baskets_ = nullptr;
+
+    PositionMap positions_;                                          // By traded symbol
+    std::unordered_map<uint64_t, std::string> position_symbols_;    // By position id (= order client tag)
+    std::unordered_map<std::string, Quote> quotes_;
+    std::priority_queue<Deadline, std::vector<Deadline>, std::greater<Deadline>> deadlines_;
+    uint64_t next_position_id_ = 1;
+
+    EntryCallback on_entry_;
+    ExitCallback on_exit_;
+    FillCallback on_fill_;
+    Stats stats_;
+
+public:
+    ExecutionPipeline(IntradayRiskManager& risk, OrderManager& oms,
+                      SessionClock* clock = &SessionClock::instance(),
+                      double min_confidence = 0.7, Venue venue = Venue::NYSE)
+        : risk_(risk), oms_(oms), clock_(clock), min_confidence_(min_confidence), venue_(venue) {}
+
+    void set_entry_callback(EntryCallback callback) { on_entry_ = std::move(callback); }
+    void set_exit_callback(ExitCallback callback) { on_exit_ = std::move(callback); }
+    void set_fill_callback(FillCallback callback) { on_fill_ = std::move(callback); }
+    void set_router(SmartOrderRouter* router) { router_ = router; }
+
+    // Work entries through the algo engine; the template supplies algo, duration, slicing and
+    // participation. Takes over the engine's done callback.
+    void set_entry_algo(ExecutionAlgoEngine* algos, const ParentOrderSpec& entry_template) {
+        algos_ = algos;
+        entry_algo_ = entry_template;
+        algos_->set_done_callback([this](const ParentResult& result) { on_parent_done(result); });
+    }
+
+    // Trade pair signals as two-leg baskets. Takes over the manager's done callback.
+    void set_basket_manager(BasketManager* baskets) {
+        baskets_ = baskets;
+        baskets_->set_done_callback([this](const BasketResult& result) { on_basket_done(result); });
+    }
+
+    // Pair signals ("A/B") trade leg A (and hedge with leg B when baskets are enabled)
+    static std::string trade_symbol(const Signal& signal) {
+        return signal.symbol.substr(0, signal.symbol.find('/'));
+    }
+
+    // Risk-check, size and send the entry order
+    SignalOutcome on_signal(const Signal& signal) {
+        stats_.signals++;
+
+        if (!signal.is_valid || signal.confidence <= min_confidence_) {
+            return SignalOutcome::BELOW_CONFIDENCE;
+        }
+
+        std::string symbol = trade_symbol(signal);
+        if (positions_.count(symbol)) {
+            stats_.rejected++;
+            return SignalOutcome::POSITION_OPEN;
+        }
+
+        if (!risk_.can_trade(signal)) {
+            stats_.rejected++;
+            return SignalOutcome::RISK_REJECTED;
+        }
+
+        PositionSize size = risk_.calculate_position_size(signal);
+        if (!size.is_valid) {
+            stats_.rejected++;
+            return SignalOutcome::SIZE_REJECTED;
+        }
+
+        ManagedPosition position;
+        position.id = next_position_id_++;
+        position.symbol = symbol;
+        position.symbol_id = SymbolTable::instance().intern(symbol);
+        position.signal = signal;
+        position.size = size;
+        position.entry.symbol = symbol;
+        position.entry.direction = signal.direction;
+        position.entry.requested_quantity = size.shares;
+        position.entry.requested_price = reference_price(symbol, signal.direction);
+
+        const size_t pair_separator = signal.symbol.find('/');
+        if (baskets_ && pair_separator != std::string::npos) {
+            const SignalOutcome outcome = send_basket_entry(position, signal.symbol.substr(pair_separator + 1));
+            if (outcome != SignalOutcome::ENTERED) {
+                stats_.rejected++;
+                return outcome;
+            }
+        } else if (algos_) {
+            ParentOrderSpec spec = entry_algo_;
+            spec.symbol = position.symbol_id;
+            spec.side = signal.direction == Signal::LONG ? Side::BUY : Side::SELL;
+            spec.venue = venue_;
+            spec.client_tag = position.id;
+            spec.quantity = size.shares;
+            position.entry_parent = algos_->submit(spec);
+            if (position.entry_parent == 0) {
+                stats_.rejected++;
+                return SignalOutcome::SUBMIT_REJECTED;
+            }
+            position.venue = venue_;
+            position.working_orders = 1;
+            position.entry.order_id = std::string(algo_type_name(spec.algo)) + "_" +
+                                      std::to_string(position.entry_parent);
+        } else {
+            OrderId first_order = 0;
+            if (send_orders(position, signal.direction, size.shares, first_order, position.venue) == 0) {
+                stats_.rejected++;
+                return SignalOutcome::SUBMIT_REJECTED;
+            }
+            position.entry.order_id = std::to_string(first_order);
+        }
+
+        position_symbols_.emplace(position.id, symbol);
+        positions_.emplace(symbol, std::move(position));
+        return SignalOutcome::ENTERED;
+    }
+
+    // Track quotes and fire stop/target triggers for this symbol
+    void on_market_data(const std::string& symbol, double bid, double ask, double last) {
+        Quote& quote = quotes_[symbol];
+        quote.bid = bid;
+        quote.ask = ask;
+
+        auto it = positions_.find(symbol);
+        if (it == positions_.end() || it->second.state != ManagedPosition::State::OPEN) return;
+
+        const Signal& s = it->second.signal;
+        const bool long_side = s.direction == Signal::LONG;
+        if (long_side ? last <= s.stop_price : last >= s.stop_price) {
+            exit_position(it->second, ExitReason::STOP);
+        } else if (long_side ? last >= s.target_price : last <= s.target_price) {
+            exit_position(it->second, ExitReason::TARGET);
+        }
+    }
+
+    // Apply order updates from the OMS; returns the number processed
+    size_t poll() {
+        size_t work = 0;
+        OrderUpdate update;
+        while (oms_.poll_update(update)) {
+            if (router_ && update.round_trip_ns > 0) {
+                router_->record_round_trip(update.venue, update.round_trip_ns);
+            }
+            if (on_fill_ && update.last_fill_quantity > 0) {
+                const double quantity = to_float_quantity(update.last_fill_quantity);
+                on_fill_(update.venue, update.symbol, update.side == Side::BUY ? quantity : -quantity,
+                         to_float_price(update.last_fill_price));
+            }
+            if (baskets_ && baskets_->on_order_update(update)) {
+                ++work;
+                continue;
+            }
+            if (algos_ && algos_->on_order_update(update)) {
+                ++work;
+                continue;
+            }
+            on_order_update(update);
+            ++work;
+        }
+        return work;
+    }
+
+    // Fire hold-time exits that are due
+    void on_timer(uint64_t now_ns) {
+        if (baskets_) baskets_->on_timer(now_ns);
+        while (!deadlines_.empty() && deadlines_.top().due_ns <= now_ns) {
+            const uint64_t id = deadlines_.top().position_id;
+            deadlines_.pop();
+
+            ManagedPosition* position = find_position(id);
+            if (position && position->state == ManagedPosition::State::OPEN) {
+                exit_position(*position, ExitReason::TIME);
+            }
+        }
+    }
+
+    // Close everything (end of session, shutdown, halts); pending entries exit once filled
+    void flatten_all() {
+        std::vector<uint64_t> ids;
+        for (const auto& [symbol, position] : positions_) ids.push_back(position.id);
+        for (uint64_t id : ids) {
+            ManagedPosition* position = find_position(id);
+            if (!position) continue;
+            if (position->state == ManagedPosition::State::OPEN) {
+                exit_position(*position, ExitReason::FLATTEN);
+            } else if (position->state == ManagedPosition::State::PENDING_ENTRY) {
+                position->flatten_on_open = true;
+                // Stop working an algo entry; whatever filled is flattened when the parent reports back
+                if (position->entry_parent != 0) algos_->cancel(position->entry_parent);
+            }
+        }
+    }
+
+    size_t open_positions() const { return positions_.size(); }
+    const Stats& get_stats() const { return stats_; }
+
+    // Earliest pending hold-time exit (0 if none); lets the loop size its idle wait
+    uint64_t next_deadline_ns() const {
+        return deadlines_.empty() ? 0 : deadlines_.top().due_ns;
+    }
+
+    void print_status() const {
+        printf("\n⚡ Execution Pipeline Status:\n");
+        printf("   Signals: %lu, Entries: %lu, Rejected: %lu, Order rejects: %lu, Open: %zu\n",
+               static_cast<unsigned long>(stats_.signals), static_cast<unsigned long>(stats_.entries),
+               static_cast<unsigned long>(stats_.rejected), static_cast<unsigned long>(stats_.order_rejects),
+               positions_.size());
+        printf("   Exits: stop %lu, target %lu, time %lu, flatten %lu\n",
+               static_cast<unsigned long>(stats_.exits[0]), static_cast<unsigned long>(stats_.exits[1]),
+               static_cast<unsigned long>(stats_.exits[2]), static_cast<unsigned long>(stats_.exits[3]));
+        if (stats_.latency_samples > 0) {
+            printf("   Signal->fill latency: avg %.1f us, max %.1f us\n",
+                   stats_.total_latency_ns / 1000.0 / stats_.latency_samples,
+                   stats_.max_latency_ns / 1000.0);
+        }
+    }
+
+private:
+    ManagedPosition* find_position(uint64_t id) {
+        auto sym = position_symbols_.find(id);
+        if (sym == position_symbols_.end()) return nullptr;
+        auto it = positions_.find(sym->second);
+        return it != positions_.end() ? &it->second : nullptr;
+    }
+
+    void erase_position(const ManagedPosition& position) {
+        const std::string symbol = position.symbol;
+        position_symbols_.erase(position.id);
+        positions_.erase(symbol);
+    }
+
+    double reference_price(const std::string& symbol, Signal::Direction direction) const {
+        auto it = quotes_.find(symbol);
+        if (it == quotes_.end()) return 0.0;
+        return direction == Signal::LONG ? it->second.ask : it->second.bid;
+    }
+
+    // Send a taker order (split by the router when attached); returns child orders submitted
+    uint8_t send_orders(ManagedPosition& position, Signal::Direction direction, double shares,
+                        OrderId& first_order, Venue& primary_venue) {
+        const Side side = direction == Signal::LONG ? Side::BUY : Side::SELL;
+        const Quantity total = to_fixed_quantity(shares);
+
+        RouteDecision decision;
+        if (router_) decision = router_->route(position.symbol_id, side, shares, 0.0, clock_->now_ns());
+        if (decision.empty()) {
+            decision.slices[0] = RouteSlice{venue_, shares, 0.0, 0.0};
+            decision.count = 1;
+        }
+
+        position.working_orders = 0;
+        position.leg_filled = 0;
+        position.leg_notional = 0.0;
+        position.leg_fees = 0;
+        first_order = 0;
+
+        Quantity assigned = 0;
+        double largest = 0.0;
+        for (size_t i = 0; i < decision.count; ++i) {
+            const RouteSlice& slice = decision.slices[i];
+            // Last child takes the rounding remainder so children sum exactly to the parent
+            const Quantity quantity = i + 1 == decision.count
+                ? total - assigned : std::min(to_fixed_quantity(slice.quantity), total - assigned);
+            if (quantity == 0) continue;
+
+            OrderRequest request{};
+            request.action = OrderRequest::Action::NEW;
+            request.order_id = oms_.reserve_order_id();
+            request.client_tag = position.id;
+            request.timestamp_ns = clock_->now_ns();
+            request.quantity = quantity;
+            request.symbol = position.symbol_id;
+            request.side = side;
+            request.type = OrderType::MARKET;
+            request.tif = TimeInForce::DAY;
+            request.venue = slice.venue;
+            if (!oms_.submit(request)) break;
+
+            assigned += quantity;
+            position.working_orders++;
+            if (first_order == 0) first_order = request.order_id;
+            if (slice.quantity > largest) {
+                largest = slice.quantity;
+                primary_venue = slice.venue;
+            }
+        }
+        return position.working_orders;
+    }
+
+    // Leg of a pair basket, on the venue the router ranks best when one is attached
+    void add_basket_leg(BasketOrder& basket, SymbolId symbol, Signal::Direction direction,
+                        double shares, double price) {
+        const Side side = direction == Signal::LONG ? Side::BUY : Side::SELL;
+        Venue venue = venue_;
+        if (router_) router_->best_venue(symbol, side, 0.0, clock_->now_ns(), venue);
+        basket.add_leg(symbol, side, venue, to_fixed_quantity(shares), price);
+    }
+
+    // Pair entry: leg A as signalled plus a dollar-neutral leg B the other way, all or nothing
+    SignalOutcome send_basket_entry(ManagedPosition& position, const std::string& hedge_symbol) {
+        const auto hedge_direction = position.signal.direction == Signal::LONG ? Signal::SHORT : Signal::LONG;
+        const double price = position.entry.requested_price > 0.0 ? position.entry.requested_price
+                                                                  : position.signal.entry_price;
+        const double hedge_price = reference_price(hedge_symbol, hedge_direction);
+        if (price <= 0.0 || hedge_price <= 0.0) return SignalOutcome::SIZE_REJECTED;
+
+        position.hedge_symbol = hedge_symbol;
+        position.hedge_symbol_id = SymbolTable::instance().intern(hedge_symbol);
+
+        BasketOrder basket;
+        basket.client_tag = position.id;
+        basket.on_leg_failure = LegFailurePolicy::UNWIND;
+        add_basket_leg(basket, position.symbol_id, position.signal.direction, position.size.shares, price);
+        add_basket_leg(basket, position.hedge_symbol_id, hedge_direction,
+                       std::max(1.0, std::round(position.size.shares * price / hedge_price)), hedge_price);
+
+        BasketReject reject = BasketReject::NONE;
+        position.basket = baskets_->submit(basket, clock_->now_ns(), &reject);
+        if (position.basket == 0) {
+            return reject == BasketReject::SUBMIT_FAILED || reject == BasketReject::POOL_FULL
+                ? SignalOutcome::SUBMIT_REJECTED : SignalOutcome::RISK_REJECTED;
+        }
+        position.venue = basket.legs[0].venue;
+        position.working_orders = 1;
+        position.entry.order_id = "BASKET_" + std::to_string(position.basket);
+        return SignalOutcome::ENTERED;
+    }
+
+    // Pair exit: close what is still held on both legs together, re-sending any leg that comes back short
+    bool send_basket_exit(ManagedPosition& position, Signal::Direction exit_direction) {
+        const auto hedge_exit = exit_direction == Signal::LONG ? Signal::SHORT : Signal::LONG;
+        BasketOrder basket;
+        basket.client_tag = position.id;
+        basket.on_leg_failure = LegFailurePolicy::HEDGE;
+        basket.reduce_only = true;
+        add_basket_leg(basket, position.symbol_id, exit_direction, position.entry.filled_quantity,
+                       position.exit_reference_price);
+        add_basket_leg(basket, position.hedge_symbol_id, hedge_exit, position.hedge_quantity,
+                       reference_price(position.hedge_symbol, hedge_exit));
+
+        position.basket = baskets_->submit(basket, clock_->now_ns());
+        if (position.basket == 0) return false;
+        position.working_orders = 1;
+        position.leg_filled = 0;
+        position.leg_notional = 0.0;
+        position.leg_fees = 0;
+        return true;
+    }
+
+    void on_basket_done(const BasketResult& result) {
+        ManagedPosition* position = find_position(result.client_tag);
+        if (!position || position->basket != result.basket_id) return;
+        position->basket = 0;
+        position->working_orders = 0;
+
+        // Residual exposure nobody is managing: stop the session until an operator flattens it
+        if (result.status == BasketStatus::BROKEN) {
+            risk_.emergency_halt("Pair basket " + position->signal.symbol +
+                                 " could not be unwound - residual exposure");
+        }
+
+        if (position->state == ManagedPosition::State::PENDING_ENTRY) {
+            position->leg_filled = 0;
+            position->leg_notional = 0.0;
+            position->leg_fees = 0;
+            if (result.status != BasketStatus::COMPLETED) {
+                // The entry failed, but whatever filled and was unwound still made or lost money
+                double fees = 0.0;
+                bool traded = false;
+                for (size_t i = 0; i < result.leg_count; ++i) {
+                    fees += static_cast<double>(result.legs[i].fees) / PRICE_MULTIPLIER;
+                    traded |= result.legs[i].filled > 0;
+                }
+                if (traded) {
+                    risk_.update_trade_result(position->signal, position->size, result.unwind_pnl() + fees, fees);
+                }
+            } else {
+                for (size_t i = 0; i < result.leg_count; ++i) {
+                    const BasketLegResult& leg = result.legs[i];
+                    position->leg_fees += leg.fees;
+                    if (leg.symbol == position->symbol_id) {
+                        position->leg_filled = leg.filled;
+                        position->leg_notional = leg.notional;
+                    } else {
+                        position->hedge_quantity = to_float_quantity(leg.filled);
+                        position->hedge_entry_price = leg.avg_price();
+                    }
+                }
+            }
+            on_entry_done(*position);
+        } else if (position->state == ManagedPosition::State::EXITING) {
+            // Leg B's fills are realized here; leg A settles through on_exit_done()
+            const double hedge_sign = position->signal.direction == Signal::LONG ? -1.0 : 1.0;
+            for (size_t i = 0; i < result.leg_count; ++i) {
+                const BasketLegResult& leg = result.legs[i];
+                position->leg_fees += leg.fees;
+                if (leg.symbol == position->symbol_id) {
+                    position->leg_filled = leg.filled;
+                    position->leg_notional = leg.notional;
+                } else if (leg.filled > 0) {
+                    const double closed = to_float_quantity(leg.filled);
+                    position->hedge_pnl += hedge_sign * (leg.avg_price() - position->hedge_entry_price) * closed;
+                    position->hedge_quantity -= closed;
+                }
+            }
+            on_exit_done(*position);
+        }
+    }
+
+    // Build the strategy-facing fill summary from the fills of the leg just completed
+    OrderResult fill_result(const ManagedPosition& position, Signal::Direction direction, double reference) const {
+        OrderResult result;
+        result.symbol = position.symbol;
+        result.direction = direction;
+        result.filled_quantity = to_float_quantity(position.leg_filled);
+        result.requested_price = reference;
+        result.fill_price = result.filled_quantity > 0 ? position.leg_notional / result.filled_quantity : 0.0;
+        result.fill_time = clock_->now_ns();
+        result.commission = static_cast<double>(position.leg_fees) / PRICE_MULTIPLIER;
+        if (reference > 0.0) {
+            const double diff = direction == Signal::LONG ? result.fill_price - reference
+                                                          : reference - result.fill_price;
+            result.slippage_bps = diff / reference * 10000.0;
+        }
+        result.status = result.filled_quantity > 0 ? OrderResult::FILLED : OrderResult::REJECTED;
+        return result;
+    }
+
+    void on_order_update(const OrderUpdate& update) {
+        ManagedPosition* position = find_position(update.client_tag);
+        if (!position || !update.is_terminal()) return;   // Partial fills settle on the terminal update
+        if (position->working_orders == 0) return;
+
+        position->leg_filled += update.filled_quantity;
+        position->leg_notional += to_float_price(update.avg_fill_price) * to_float_quantity(update.filled_quantity);
+        position->leg_fees += update.fees;
+        if (--position->working_orders > 0) return;
+
+        if (position->state == ManagedPosition::State::PENDING_ENTRY) {
+            on_entry_done(*position);
+        } else if (position->state == ManagedPosition::State::EXITING) {
+            on_exit_done(*position);
+        }
+    }
+
+    void on_parent_done(const ParentResult& result) {
+        ManagedPosition* position = find_position(result.client_tag);
+        if (!position || position->state != ManagedPosition::State::PENDING_ENTRY ||
+            position->entry_parent != result.parent_id) {
+            return;
+        }
+        position->leg_filled = result.filled;
+        position->leg_notional = result.notional;
+        position->leg_fees = result.fees;
+        position->working_orders = 0;
+        on_entry_done(*position);
+    }
+
+    void on_entry_done(ManagedPosition& position) {
+        if (position.leg_filled == 0) {
+            stats_.order_rejects++;
+            erase_position(position);
+            return;
+        }
+
+        const double requested = position.entry.requested_quantity;
+        const std::string order_id = position.entry.order_id;
+        position.entry = fill_result(position, position.signal.direction, position.entry.requested_price);
+        position.entry.requested_quantity = requested;
+        position.entry.order_id = order_id;
+
+        if (!clock_->is_virtual() && position.signal.timestamp_ns > 0) {
+            const uint64_t now = get_timestamp_ns();
+            const uint64_t latency = now > position.signal.timestamp_ns ? now - position.signal.timestamp_ns : 0;
+            stats_.latency_samples++;
+            stats_.total_latency_ns += latency;
+            stats_.max_latency_ns = std::max(stats_.max_latency_ns, latency);
+        }
+
+        position.state = ManagedPosition::State::OPEN;
+        position.exit_deadline_ns = clock_->now_ns() +
+                                    static_cast<uint64_t>(position.signal.hold_time_ms) * 1000000ULL;
+        deadlines_.push({position.exit_deadline_ns, position.id});
+        stats_.entries++;
+
+        if (on_entry_) on_entry_(position);
+        if (position.flatten_on_open) exit_position(position, ExitReason::FLATTEN);
+    }
+
+    void on_exit_done(ManagedPosition& position) {
+        const auto exit_direction = position.signal.direction == Signal::LONG ? Signal::SHORT : Signal::LONG;
+        if (position.leg_filled < to_fixed_quantity(position.entry.filled_quantity) || position.hedge_quantity > 0.0) {
+            // Not (fully) filled; stay open, price triggers keep firing and the timer retries shortly.
+            // A partial exit realizes its share of the P&L and shrinks the position to what is still held
+            // (for a pair, until both legs are flat).
+            stats_.order_rejects++;
+            if (position.leg_filled > 0) {
+                const double closed = to_float_quantity(position.leg_filled);
+                const double sign = position.signal.direction == Signal::LONG ? 1.0 : -1.0;
+                position.partial_exit_pnl += sign * (position.leg_notional / closed - position.entry.fill_price) *
+                                             closed;
+                position.entry.filled_quantity -= closed;
+            }
+            // Fees include a hedge leg that traded even when leg A did not
+            position.partial_exit_pnl -= static_cast<double>(position.leg_fees) / PRICE_MULTIPLIER;
+            position.state = ManagedPosition::State::OPEN;
+            deadlines_.push({clock_->now_ns() + EXIT_RETRY_NS, position.id});
+            return;
+        }
+
+        OrderResult exit_order = fill_result(position, exit_direction, position.exit_reference_price);
+        exit_order.requested_quantity = position.entry.filled_quantity;
+
+        const double direction = position.signal.direction == Signal::LONG ? 1.0 : -1.0;
+        const double fees = position.entry.commission + exit_order.commission;
+        const double gross = direction * (exit_order.fill_price - position.entry.fill_price) *
+                             position.entry.filled_quantity;
+        const double net_pnl = gross - fees + position.partial_exit_pnl + position.hedge_pnl;
+        risk_.update_trade_result(position.signal, position.size, net_pnl + fees, fees);
+
+        position.state = ManagedPosition::State::CLOSED;
+        stats_.exits[static_cast<size_t>(position.exit_reason)]++;
+        if (on_exit_) on_exit_(position, exit_order, net_pnl, position.exit_reason);
+
+        erase_position(position);
+    }
+
+    void exit_position(ManagedPosition& position, ExitReason reason) {
+        const auto exit_direction = position.signal.direction == Signal::LONG ? Signal::SHORT : Signal::LONG;
+        position.exit_reference_price = reference_price(position.symbol, exit_direction);
+        position.exit_reason = reason;
+
+        if (baskets_ && !position.hedge_symbol.empty()) {
+            if (!send_basket_exit(position, exit_direction)) {
+                deadlines_.push({clock_->now_ns() + EXIT_RETRY_NS, position.id});
+                return;
+            }
+            position.state = ManagedPosition::State::EXITING;
+            return;
+        }
+
+        OrderId first_order = 0;
+        Venue exit_venue = position.venue;
+        if (send_orders(position, exit_direction, position.entry.filled_quantity, first_order, exit_venue) == 0) {
+            deadlines_.push({clock_->now_ns() + EXIT_RETRY_NS, position.id});
+            return;
+        }
+        position.state = ManagedPosition::State::EXITING;
+    }
+};
+
+} // namespace hft::strategies
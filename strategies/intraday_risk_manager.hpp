@@ -5,6 +5,8 @@
 #include <string>
 #include <mutex>
 #include <fstream>
+#include "../io_service.hpp"
+#include "../kill_switch.hpp"
 #include "../position_tracker.hpp"
 #include "intraday_strategies.hpp"
 
@@ -91,68 +93,77 @@ private:
     IntradayRiskLimits limits_;
     SessionRisk session_;
     PositionTracker* position_tracker_;
+    SessionClock* clock_;
+    hft::TradeJournal* journal_ = nullptr;
     
     mutable std::mutex mutex_;
     std::atomic<bool> emergency_halt_{false};
+    hft::KillSwitch& kill_switch_ = hft::KillSwitch::instance();
+    const std::atomic<uint64_t>* kill_word_ = kill_switch_.word();
     
-    // Logging
-    std::ofstream trade_log_;
-    std::ofstream risk_log_;
+    // Logging (disabled for backtests)
+    bool logging_enabled_;
+    hft::IoFileId trade_log_ = hft::INVALID_IO_FILE;
+    hft::IoFileId risk_log_ = hft::INVALID_IO_FILE;
     
+    // Caller holds mutex_
     void log_risk_event(IntradayRiskEvent event, const std::string& description, 
                        double value = 0.0) {
-        auto timestamp = get_timestamp_ns();
-        
-        std::lock_guard<std::mutex> lock(mutex_);
-        if (risk_log_.is_open()) {
-            risk_log_ << timestamp << ","
-                     << static_cast<int>(event) << ","
-                     << description << ","
-                     << value << ","
-                     << session_.daily_pnl << ","
-                     << session_.trades_today << "\n";
-            risk_log_.flush();
+        auto timestamp = clock_->now_ns();
+        
+        if (risk_log_ != hft::INVALID_IO_FILE) {
+            hft::IoLine line;
+            line << timestamp << ","
+                 << static_cast<int>(event) << ","
+                 << description << ","
+                 << value << ","
+                 << session_.daily_pnl << ","
+                 << session_.trades_today << "\n";
+            hft::IoService::instance().write(risk_log_, line);
         }
     }
     
+    // Caller holds mutex_
     void log_trade(const Signal& signal, const PositionSize& size, bool approved) {
-        auto timestamp = get_timestamp_ns();
-        
-        std::lock_guard<std::mutex> lock(mutex_);
-        if (trade_log_.is_open()) {
-            trade_log_ << timestamp << ","
-                      << signal.strategy_type << ","
-                      << signal.symbol << ","
-                      << (signal.direction == Signal::LONG ? "LONG" : "SHORT") << ","
-                      << signal.entry_price << ","
-                      << signal.stop_price << ","
-                      << signal.target_price << ","
-                      << size.shares << ","
-                      << size.risk_amount << ","
-                      << signal.confidence << ","
-                      << (approved ? "APPROVED" : "REJECTED") << ","
-                      << session_.daily_pnl << "\n";
-            trade_log_.flush();
+        auto timestamp = clock_->now_ns();
+        
+        if (trade_log_ != hft::INVALID_IO_FILE) {
+            hft::IoLine line;
+            line << timestamp << ","
+                 << signal.strategy_type << ","
+                 << signal.symbol << ","
+                 << (signal.direction == Signal::LONG ? "LONG" : "SHORT") << ","
+                 << signal.entry_price << ","
+                 << signal.stop_price << ","
+                 << signal.target_price << ","
+                 << size.shares << ","
+                 << size.risk_amount << ","
+                 << signal.confidence << ","
+                 << (approved ? "APPROVED" : "REJECTED") << ","
+                 << session_.daily_pnl << "\n";
+            hft::IoService::instance().write(trade_log_, line);
         }
     }
 
 public:
-    explicit IntradayRiskManager(PositionTracker* position_tracker = nullptr) 
-        : position_tracker_(position_tracker) {
+    explicit IntradayRiskManager(PositionTracker* position_tracker = nullptr,
+                                 SessionClock* clock = &SessionClock::instance(),
+                                 bool logging_enabled = true) 
+        : position_tracker_(position_tracker), clock_(clock), logging_enabled_(logging_enabled) {
         
-        session_.session_start_time = get_timestamp_ns();
+        session_.session_start_time = clock_->now_ns();
         
-        // Initialize log files
-        trade_log_.open("intraday_trades.csv", std::ios::app);
-        if (trade_log_.is_open()) {
-            trade_log_ << "timestamp,strategy,symbol,direction,entry_price,stop_price,"
-                      << "target_price,shares,risk_amount,confidence,status,daily_pnl\n";
-        }
+        if (!logging_enabled_) return;
         
-        risk_log_.open("intraday_risk.csv", std::ios::app);
-        if (risk_log_.is_open()) {
-            risk_log_ << "timestamp,event_type,description,value,daily_pnl,trades_today\n";
-        }
+        // Initialize log files (headers start each new file)
+        hft::IoService::FileOptions trades;
+        trades.header = "timestamp,strategy,symbol,direction,entry_price,stop_price,"
+                        "target_price,shares,risk_amount,confidence,status,daily_pnl\n";
+        trade_log_ = hft::IoService::instance().open("intraday_trades.csv", trades);
+        
+        hft::IoService::FileOptions risk;
+        risk.header = "timestamp,event_type,description,value,daily_pnl,trades_today\n";
+        risk_log_ = hft::IoService::instance().open("intraday_risk.csv", risk);
         
         printf("🛡️ Intraday Risk Manager initialized\n");
         printf("   Capital: $%.0f\n", limits_.capital);
@@ -162,17 +173,12 @@ public:
         printf("   Max Trades Per Day: %u\n", limits_.max_trades_per_day);
     }
     
-    ~IntradayRiskManager() {
-        if (trade_log_.is_open()) trade_log_.close();
-        if (risk_log_.is_open()) risk_log_.close();
-    }
-    
     // Main risk check - called before every trade
     bool can_trade(const Signal& signal = Signal()) {
         std::lock_guard<std::mutex> lock(mutex_);
         
-        // Emergency halt check
-        if (emergency_halt_) {
+        // Emergency halt check (this session's, or the process-wide kill switch)
+        if (emergency_halt_ || hft::KillSwitch::is_halted(kill_word_->load(std::memory_order_acquire))) {
             return false;
         }
         
@@ -218,7 +224,7 @@ public:
         }
         
         // Time between trades
-        uint64_t current_time = get_timestamp_ns();
+        uint64_t current_time = clock_->now_ns();
         if (session_.last_trade_time > 0) {
             uint64_t time_since_last = (current_time - session_.last_trade_time) / 1000000000ULL;
             if (time_since_last < limits_.min_seconds_between_trades) {
@@ -293,40 +299,26 @@ public:
                            double actual_pnl, double fees = 0.0) {
         std::lock_guard<std::mutex> lock(mutex_);
         
-        session_.trades_today++;
-        session_.daily_pnl += actual_pnl - fees;
-        session_.total_fees += fees;
-        session_.last_trade_time = get_timestamp_ns();
+        const uint64_t now = clock_->now_ns();
+        if (journal_) journal_->append_session_trade(actual_pnl, fees, now);
         
-        // Track win/loss streaks
-        if (actual_pnl > 0) {
-            session_.winning_trades++;
-            session_.consecutive_losses = 0; // Reset loss streak
-            session_.largest_win = std::max(session_.largest_win, actual_pnl);
-        } else if (actual_pnl < 0) {
-            session_.losing_trades++;
-            session_.consecutive_losses++;
-            session_.largest_loss = std::min(session_.largest_loss, actual_pnl);
-        }
+        apply_trade_result(actual_pnl, fees, now);
         
         log_trade(signal, size, true);
         log_risk_event(IntradayRiskEvent::TRADE_EXECUTED, 
                       "Trade completed: " + signal.symbol, actual_pnl);
         
-        // Check if we should halt trading after this trade
-        if (session_.daily_pnl <= -limits_.daily_loss_limit) {
-            halt_trading("Daily loss limit reached after trade");
-        } else if (session_.daily_pnl >= limits_.daily_profit_target) {
-            halt_trading("Daily profit target reached after trade");
-        }
+        check_halt_after_trade();
     }
     
     // Manual controls
     void halt_trading(const std::string& reason) {
         session_.trading_halted = true;
         session_.halt_reason = reason;
-        session_.halt_time = get_timestamp_ns();
+        session_.halt_time = clock_->now_ns();
+        if (journal_) journal_->append_session_halt(true, reason, session_.halt_time);
         
+        if (!logging_enabled_) return;
         printf("🛑 TRADING HALTED: %s\n", reason.c_str());
         printf("   Session P&L: $%.2f\n", session_.daily_pnl);
         printf("   Trades Today: %u\n", session_.trades_today);
@@ -336,11 +328,14 @@ public:
         std::lock_guard<std::mutex> lock(mutex_);
         session_.trading_halted = false;
         session_.halt_reason.clear();
-        printf("✅ Trading resumed\n");
+        if (journal_) journal_->append_session_halt(false, "", clock_->now_ns());
+        if (logging_enabled_) printf("✅ Trading resumed\n");
     }
     
     void emergency_halt(const std::string& reason) {
+        std::lock_guard<std::mutex> lock(mutex_);
         emergency_halt_ = true;
+        kill_switch_.halt(hft::KillSwitch::SESSION_HALT, reason.c_str());
         halt_trading("EMERGENCY: " + reason);
         log_risk_event(IntradayRiskEvent::EMERGENCY_HALT, reason);
         printf("🚨 EMERGENCY HALT: %s\n", reason.c_str());
@@ -348,6 +343,7 @@ public:
     
     void reset_emergency_halt() {
         emergency_halt_ = false;
+        kill_switch_.resume(hft::KillSwitch::SESSION_HALT, "emergency halt reset");
         resume_trading();
     }
     
@@ -376,13 +372,43 @@ public:
     void update_limits(const IntradayRiskLimits& new_limits) {
         std::lock_guard<std::mutex> lock(mutex_);
         limits_ = new_limits;
-        printf("🔧 Intraday risk limits updated\n");
+        if (logging_enabled_) printf("🔧 Intraday risk limits updated\n");
     }
     
     const IntradayRiskLimits& get_limits() const {
         return limits_;
     }
     
+    // Journal that trade results and halts are appended to (nullptr to detach)
+    void set_journal(hft::TradeJournal* journal) { journal_ = journal; }
+    hft::TradeJournal* journal() const { return journal_; }
+    
+    // Consistent copy of the session state (for snapshots)
+    SessionRisk session_snapshot() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return session_;
+    }
+    
+    // ========== Recovery (journal detached, before trading starts) ==========
+    
+    void restore_session(const SessionRisk& session) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        session_ = session;
+    }
+    
+    void replay_trade_result(double actual_pnl, double fees, uint64_t timestamp_ns) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        apply_trade_result(actual_pnl, fees, timestamp_ns);
+        check_halt_after_trade();
+    }
+    
+    void replay_halt(bool halted, const std::string& reason, uint64_t timestamp_ns) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        session_.trading_halted = halted;
+        session_.halt_reason = halted ? reason : std::string();
+        if (halted) session_.halt_time = timestamp_ns;
+    }
+    
     // Status reporting
     void print_risk_status() const {
         std::lock_guard<std::mutex> lock(mutex_);
@@ -404,7 +430,7 @@ public:
                session_.consecutive_losses, limits_.max_consecutive_losses);
         
         printf("⏱️  Session Duration: %.1f hours\n", 
-               (get_timestamp_ns() - session_.session_start_time) / 3600000000000.0);
+               (clock_->now_ns() - session_.session_start_time) / 3600000000000.0);
         
         printf("💸 Total Fees: $%.2f\n", session_.total_fees);
         printf("📈 Largest Win: $%.2f\n", session_.largest_win);
@@ -413,6 +439,34 @@ public:
     }
     
 private:
+    // Caller holds mutex_
+    void apply_trade_result(double actual_pnl, double fees, uint64_t timestamp_ns) {
+        session_.trades_today++;
+        session_.daily_pnl += actual_pnl - fees;
+        session_.total_fees += fees;
+        session_.last_trade_time = timestamp_ns;
+        
+        // Track win/loss streaks
+        if (actual_pnl > 0) {
+            session_.winning_trades++;
+            session_.consecutive_losses = 0; // Reset loss streak
+            session_.largest_win = std::max(session_.largest_win, actual_pnl);
+        } else if (actual_pnl < 0) {
+            session_.losing_trades++;
+            session_.consecutive_losses++;
+            session_.largest_loss = std::min(session_.largest_loss, actual_pnl);
+        }
+    }
+    
+    // Caller holds mutex_
+    void check_halt_after_trade() {
+        if (session_.daily_pnl <= -limits_.daily_loss_limit) {
+            halt_trading("Daily loss limit reached after trade");
+        } else if (session_.daily_pnl >= limits_.daily_profit_target) {
+            halt_trading("Daily profit target reached after trade");
+        }
+    }
+    
     double get_strategy_risk_amount(const std::string& strategy_type) {
         if (strategy_type == "OPENING_DRIVE") {
             return limits_.opening_drive_risk;
@@ -3,7 +3,13 @@
 #include <string>
 #include <chrono>
 #include <cmath>
+#include <fstream>
+#include <sstream>
+#include <unordered_map>
+#include <vector>
 #include "../messages.hpp"
+#include "session_clock.hpp"
+#include "technical_indicators.hpp"
 
 namespace hft::strategies {
 
@@ -28,11 +34,10 @@ struct TimeOfDay {
                (hour == 15 && minute == 0);
     }
     
+    // Exchange-local time from the session clock word (no localtime() call)
     static TimeOfDay get_market_time() {
-        auto now = std::chrono::system_clock::now();
-        auto time_t = std::chrono::system_clock::to_time_t(now);
-        auto tm = *std::localtime(&time_t);
-        return TimeOfDay(tm.tm_hour, tm.tm_min);
+        SessionTime now = SessionClock::instance().current();
+        return TimeOfDay(now.hour(), now.minute());
     }
 };
 
@@ -96,7 +101,7 @@ struct Signal {
 
 // VWAP Reversion Strategy Implementation
 class VWAPReversionStrategy {
-private:
+public:
     struct VWAPConfig {
         double min_distance_from_vwap = 0.01;  // 1% minimum distance
         double rsi_oversold_threshold = 30.0;
@@ -105,15 +110,24 @@ private:
         double max_spread_bps = 20.0;          // Maximum spread to trade
         double stop_loss_percent = 0.005;      // 0.5% stop loss
         double target_profit_percent = 0.008;  // 0.8% target
-    } config_;
+    };
+    
+private:
+    VWAPConfig config_;
     
 public:
-    Signal evaluate(const EnhancedMarketData& data) {
+    VWAPReversionStrategy() = default;
+    explicit VWAPReversionStrategy(const VWAPConfig& config) : config_(config) {}
+    
+    const VWAPConfig& get_config() const { return config_; }
+    void set_config(const VWAPConfig& config) { config_ = config; }
+    
+    Signal evaluate(const EnhancedMarketData& data,
+                    SessionTime session = SessionClock::instance().current()) {
         Signal signal("VWAP_REVERSION", data.symbol);
         
         // Check if we're in the appropriate time window
-        TimeOfDay current_time = TimeOfDay::get_market_time();
-        if (!current_time.is_between_1030_and_1500()) {
+        if (!session.is_between_1030_and_1500()) {
             return signal; // Invalid signal outside time window
         }
         
@@ -139,7 +153,7 @@ public:
             signal.stop_price = data.last - (data.last * config_.stop_loss_percent);
             signal.target_price = data.vwap;  // Target VWAP return
             signal.stop_distance_points = signal.entry_price - signal.stop_price;
-            signal.confidence = calculate_confidence(data, distance_from_vwap);
+            signal.confidence = calculate_confidence(data, distance_from_vwap, session);
             signal.expected_edge_bps = std::abs(distance_from_vwap) * 10000.0;
             signal.hold_time_ms = 300000; // 5 minutes expected hold
         }
@@ -155,7 +169,7 @@ public:
             signal.stop_price = data.last + (data.last * config_.stop_loss_percent);
             signal.target_price = data.vwap;  // Target VWAP return
             signal.stop_distance_points = signal.stop_price - signal.entry_price;
-            signal.confidence = calculate_confidence(data, distance_from_vwap);
+            signal.confidence = calculate_confidence(data, distance_from_vwap, session);
             signal.expected_edge_bps = std::abs(distance_from_vwap) * 10000.0;
             signal.hold_time_ms = 300000; // 5 minutes expected hold
         }
@@ -165,7 +179,8 @@ public:
     }
     
 private:
-    double calculate_confidence(const EnhancedMarketData& data, double vwap_distance) {
+    double calculate_confidence(const EnhancedMarketData& data, double vwap_distance,
+                                SessionTime session) {
         double confidence = 0.5; // Base confidence
         
         // Increase confidence for stronger signals
@@ -173,8 +188,7 @@ private:
         if (data.cumulative_volume > data.average_volume_30d * 1.2) confidence += 0.1; // High volume
         if (data.rsi_14 < 40 || data.rsi_14 > 60) confidence += 0.1; // Longer-term confirmation
         
-        TimeOfDay current_time = TimeOfDay::get_market_time();
-        if (current_time.is_between_1030_and_1500()) confidence += 0.1; // Optimal time
+        if (session.is_between_1030_and_1500()) confidence += 0.1; // Optimal time
         
         return std::min(confidence, 0.9);
     }
@@ -182,7 +196,7 @@ private:
 
 // Opening Drive Strategy Implementation  
 class OpeningDriveStrategy {
-private:
+public:
     struct OpeningConfig {
         double min_gap_percent = 0.005;        // 0.5% minimum gap
         double max_gap_percent = 0.03;         // 3% maximum gap (avoid gaps too large)
@@ -190,15 +204,24 @@ private:
         double stop_loss_percent = 0.008;      // 0.8% stop loss
         double target_profit_percent = 0.015;  // 1.5% target
         double max_spread_bps = 25.0;
-    } config_;
+    };
+    
+private:
+    OpeningConfig config_;
     
 public:
-    Signal evaluate(const EnhancedMarketData& data) {
+    OpeningDriveStrategy() = default;
+    explicit OpeningDriveStrategy(const OpeningConfig& config) : config_(config) {}
+    
+    const OpeningConfig& get_config() const { return config_; }
+    void set_config(const OpeningConfig& config) { config_ = config; }
+    
+    Signal evaluate(const EnhancedMarketData& data,
+                    SessionTime session = SessionClock::instance().current()) {
         Signal signal("OPENING_DRIVE", data.symbol);
         
         // Only trade in opening hour
-        TimeOfDay current_time = TimeOfDay::get_market_time();
-        if (!current_time.is_opening_hour()) {
+        if (!session.is_opening_hour()) {
             return signal;
         }
         
@@ -264,124 +287,280 @@ private:
     }
 };
 
-// Pair Divergence Strategy (SPY vs QQQ)
+// Pair Divergence Strategy
+//
+// Tracks any number of configured pairs. Each leg is interned once; every pair keeps
+// an O(1) rolling mean/variance of its log price ratio and a rolling correlation of
+// leg returns over a bounded window. A pair is sampled once both legs have ticked
+// since its last sample, and only those pairs are evaluated.
 class PairDivergenceStrategy {
-private:
-    struct PairData {
-        EnhancedMarketData spy_data;
-        EnhancedMarketData qqq_data;
-        bool has_both = false;
-    } pair_data_;
-    
+public:
     struct PairConfig {
         double min_zscore = 2.0;              // Minimum Z-score for divergence
-        double correlation_threshold = 0.8;    // Minimum correlation
+        double correlation_threshold = 0.8;    // Minimum rolling return correlation
         double stop_loss_percent = 0.006;     // 0.6% stop loss (hedged position)
         double target_profit_percent = 0.012; // 1.2% target  
         double max_spread_bps = 30.0;
-    } config_;
+        size_t history_window = 100;          // Samples in the rolling window
+        size_t min_history = 20;              // Samples required before trading
+    };
+    
+private:
+    struct LegState {
+        std::string symbol;
+        double bid = 0.0;
+        double ask = 0.0;
+        double last = 0.0;
+        double spread_bps = 0.0;
+        std::vector<uint32_t> pairs;   // Pairs this leg belongs to
+    };
+    
+    struct PairState {
+        uint32_t leg_a;
+        uint32_t leg_b;
+        std::string name;              // "A/B", built once
+        indicators::RollingMeanVariance log_ratio;
+        indicators::RollingCorrelation returns;
+        double last_a = 0.0;           // Leg prices at the previous sample
+        double last_b = 0.0;
+        double current_log_ratio = 0.0;
+        uint8_t ticked = 0;            // Bit 0: leg A ticked, bit 1: leg B ticked
+        bool dirty = false;
+        
+        PairState(uint32_t a, uint32_t b, std::string n, size_t window)
+            : leg_a(a), leg_b(b), name(std::move(n)), log_ratio(window), returns(window) {}
+    };
     
-    // Historical price ratio tracking (simplified)
-    std::vector<double> ratio_history_;
-    static constexpr size_t MAX_HISTORY = 100;
+    PairConfig config_;
+    std::vector<LegState> legs_;
+    std::unordered_map<std::string, uint32_t> leg_index_;
+    std::vector<PairState> pairs_;
+    std::vector<uint32_t> dirty_pairs_;
     
 public:
-    void update_pair_data(const EnhancedMarketData& data) {
-        if (data.symbol == "SPY") {
-            pair_data_.spy_data = data;
-        } else if (data.symbol == "QQQ") {
-            pair_data_.qqq_data = data;
+    PairDivergenceStrategy() {
+        add_pair("SPY", "QQQ");
+    }
+    
+    explicit PairDivergenceStrategy(const PairConfig& config) : config_(config) {
+        add_pair("SPY", "QQQ");
+    }
+    
+    // Register a pair; signals trade leg A against leg B
+    void add_pair(const std::string& symbol_a, const std::string& symbol_b) {
+        uint32_t a = intern_leg(symbol_a);
+        uint32_t b = intern_leg(symbol_b);
+        for (const auto& pair : pairs_) {
+            if (pair.leg_a == a && pair.leg_b == b) return;
         }
         
-        pair_data_.has_both = (pair_data_.spy_data.timestamp_ns > 0 && 
-                              pair_data_.qqq_data.timestamp_ns > 0);
+        uint32_t id = static_cast<uint32_t>(pairs_.size());
+        pairs_.emplace_back(a, b, symbol_a + "/" + symbol_b, config_.history_window);
+        legs_[a].pairs.push_back(id);
+        legs_[b].pairs.push_back(id);
+        dirty_pairs_.reserve(pairs_.size());
+    }
+    
+    void clear_pairs() {
+        legs_.clear();
+        leg_index_.clear();
+        pairs_.clear();
+        dirty_pairs_.clear();
+    }
+    
+    // Parse the "pairs" array of a strategy config file
+    // (e.g. config/intraday_config.json: "pairs": ["SPY/QQQ", ...])
+    static bool parse_pairs_config(const std::string& path,
+                                   std::vector<std::pair<std::string, std::string>>& pairs) {
+        std::ifstream file(path);
+        if (!file.is_open()) return false;
+        
+        std::stringstream buffer;
+        buffer << file.rdbuf();
+        const std::string text = buffer.str();
+        
+        size_t key = text.find("\"pairs\"");
+        if (key == std::string::npos) return false;
+        size_t open = text.find('[', key);
+        size_t close = text.find(']', open);
+        if (open == std::string::npos || close == std::string::npos) return false;
+        
+        size_t pos = open;
+        size_t parsed = 0;
+        while (true) {
+            size_t q1 = text.find('"', pos + 1);
+            if (q1 == std::string::npos || q1 > close) break;
+            size_t q2 = text.find('"', q1 + 1);
+            if (q2 == std::string::npos || q2 > close) break;
+            
+            std::string entry = text.substr(q1 + 1, q2 - q1 - 1);
+            size_t slash = entry.find('/');
+            if (slash != std::string::npos && slash > 0 && slash + 1 < entry.size()) {
+                pairs.emplace_back(entry.substr(0, slash), entry.substr(slash + 1));
+                ++parsed;
+            }
+            pos = q2;
+        }
         
-        // Update ratio history
-        if (pair_data_.has_both) {
-            double ratio = pair_data_.spy_data.last / pair_data_.qqq_data.last;
-            ratio_history_.push_back(ratio);
-            if (ratio_history_.size() > MAX_HISTORY) {
-                ratio_history_.erase(ratio_history_.begin());
+        return parsed > 0;
+    }
+    
+    // Replace the pair set with the pairs of a strategy config file
+    bool load_pairs_from_config(const std::string& path) {
+        std::vector<std::pair<std::string, std::string>> parsed;
+        if (!parse_pairs_config(path, parsed)) return false;
+        
+        clear_pairs();
+        for (const auto& [a, b] : parsed) add_pair(a, b);
+        return true;
+    }
+    
+    void update_pair_data(const EnhancedMarketData& data) {
+        auto it = leg_index_.find(data.symbol);
+        if (it == leg_index_.end() || data.last <= 0.0) return;
+        
+        LegState& leg = legs_[it->second];
+        leg.bid = data.bid;
+        leg.ask = data.ask;
+        leg.last = data.last;
+        leg.spread_bps = data.spread_bps();
+        
+        for (uint32_t id : leg.pairs) {
+            PairState& pair = pairs_[id];
+            pair.ticked |= (pair.leg_a == it->second) ? 1 : 2;
+            if (pair.ticked == 3) {
+                sample_pair(pair);
+                pair.ticked = 0;
+                if (!pair.dirty) {
+                    pair.dirty = true;
+                    dirty_pairs_.push_back(id);
+                }
             }
         }
     }
     
+    // Evaluate pairs sampled since the last call; returns the strongest signal
     Signal evaluate() {
-        Signal signal("PAIR_DIVERGENCE", "SPY/QQQ");
+        Signal best("PAIR_DIVERGENCE", "");
+        double best_abs_z = 0.0;
         
-        if (!pair_data_.has_both || ratio_history_.size() < 20) {
-            return signal; // Need sufficient data
+        for (uint32_t id : dirty_pairs_) {
+            PairState& pair = pairs_[id];
+            pair.dirty = false;
+            
+            double zscore = 0.0;
+            if (!tradeable(pair, zscore)) continue;
+            if (std::abs(zscore) > best_abs_z) {
+                best = build_signal(pair, zscore);
+                best_abs_z = std::abs(zscore);
+            }
         }
+        dirty_pairs_.clear();
         
-        // Calculate current ratio and Z-score
-        double current_ratio = pair_data_.spy_data.last / pair_data_.qqq_data.last;
-        double mean_ratio = calculate_mean();
-        double std_dev = calculate_std_dev(mean_ratio);
-        
-        if (std_dev == 0.0) return signal;
+        return best;
+    }
+    
+    // Evaluate pairs sampled since the last call; appends every valid signal
+    void evaluate_all(std::vector<Signal>& signals) {
+        for (uint32_t id : dirty_pairs_) {
+            PairState& pair = pairs_[id];
+            pair.dirty = false;
+            
+            double zscore = 0.0;
+            if (tradeable(pair, zscore)) {
+                signals.push_back(build_signal(pair, zscore));
+            }
+        }
+        dirty_pairs_.clear();
+    }
+    
+    size_t pair_count() const { return pairs_.size(); }
+    const PairConfig& get_config() const { return config_; }
+    
+    // Window sizes only apply to pairs added after the change
+    void set_config(const PairConfig& config) { config_ = config; }
+    
+private:
+    uint32_t intern_leg(const std::string& symbol) {
+        auto it = leg_index_.find(symbol);
+        if (it != leg_index_.end()) return it->second;
+        
+        uint32_t id = static_cast<uint32_t>(legs_.size());
+        legs_.push_back(LegState{symbol, 0.0, 0.0, 0.0, 0.0, {}});
+        leg_index_.emplace(symbol, id);
+        return id;
+    }
+    
+    void sample_pair(PairState& pair) {
+        const LegState& a = legs_[pair.leg_a];
+        const LegState& b = legs_[pair.leg_b];
         
-        double zscore = (current_ratio - mean_ratio) / std_dev;
+        pair.current_log_ratio = std::log(a.last / b.last);
+        pair.log_ratio.add(pair.current_log_ratio);
         
-        // Check spreads
-        if (pair_data_.spy_data.spread_bps() > config_.max_spread_bps || 
-            pair_data_.qqq_data.spread_bps() > config_.max_spread_bps) {
-            return signal;
+        if (pair.last_a > 0.0 && pair.last_b > 0.0) {
+            pair.returns.add(std::log(a.last / pair.last_a), std::log(b.last / pair.last_b));
         }
+        pair.last_a = a.last;
+        pair.last_b = b.last;
+    }
+    
+    bool tradeable(const PairState& pair, double& zscore) const {
+        if (pair.log_ratio.size() < config_.min_history) return false;
         
-        // SPY relatively expensive vs QQQ (short SPY, long QQQ)
-        if (zscore > config_.min_zscore) {
-            signal.is_valid = true;
-            signal.direction = Signal::SHORT; // Short the expensive one (SPY)
-            signal.entry_price = pair_data_.spy_data.bid; // Short SPY at bid
-            signal.stop_price = pair_data_.spy_data.last + (pair_data_.spy_data.last * config_.stop_loss_percent);
-            signal.target_price = pair_data_.spy_data.last - (pair_data_.spy_data.last * config_.target_profit_percent);
-            signal.stop_distance_points = signal.stop_price - signal.entry_price;
-            signal.confidence = calculate_pair_confidence(std::abs(zscore));
-            signal.expected_edge_bps = std::abs(zscore) * 50.0; // Rough edge estimate
-            signal.hold_time_ms = 900000; // 15 minutes expected hold
+        double std_dev = pair.log_ratio.std_dev();
+        if (std_dev == 0.0) return false;
+        
+        // Correlation gate: diverging legs that no longer co-move are not a pair trade
+        if (pair.returns.size() >= config_.min_history &&
+            pair.returns.correlation() < config_.correlation_threshold) {
+            return false;
         }
         
-        // SPY relatively cheap vs QQQ (long SPY, short QQQ)  
-        else if (zscore < -config_.min_zscore) {
-            signal.is_valid = true;
-            signal.direction = Signal::LONG; // Long the cheap one (SPY)
-            signal.entry_price = pair_data_.spy_data.ask; // Long SPY at ask
-            signal.stop_price = pair_data_.spy_data.last - (pair_data_.spy_data.last * config_.stop_loss_percent);
-            signal.target_price = pair_data_.spy_data.last + (pair_data_.spy_data.last * config_.target_profit_percent);
-            signal.stop_distance_points = signal.entry_price - signal.stop_price;
-            signal.confidence = calculate_pair_confidence(std::abs(zscore));
-            signal.expected_edge_bps = std::abs(zscore) * 50.0;
-            signal.hold_time_ms = 900000; // 15 minutes expected hold
+        if (legs_[pair.leg_a].spread_bps > config_.max_spread_bps ||
+            legs_[pair.leg_b].spread_bps > config_.max_spread_bps) {
+            return false;
         }
         
-        signal.timestamp_ns = get_timestamp_ns();
-        return signal;
+        zscore = (pair.current_log_ratio - pair.log_ratio.mean()) / std_dev;
+        return std::abs(zscore) > config_.min_zscore;
     }
     
-private:
-    double calculate_mean() const {
-        double sum = 0.0;
-        for (double ratio : ratio_history_) {
-            sum += ratio;
+    Signal build_signal(const PairState& pair, double zscore) const {
+        const LegState& a = legs_[pair.leg_a];
+        Signal signal("PAIR_DIVERGENCE", pair.name);
+        signal.is_valid = true;
+        
+        // Leg A relatively expensive vs leg B (short A, long B)
+        if (zscore > 0) {
+            signal.direction = Signal::SHORT;
+            signal.entry_price = a.bid;
+            signal.stop_price = a.last + (a.last * config_.stop_loss_percent);
+            signal.target_price = a.last - (a.last * config_.target_profit_percent);
+            signal.stop_distance_points = signal.stop_price - signal.entry_price;
         }
-        return sum / ratio_history_.size();
-    }
-    
-    double calculate_std_dev(double mean) const {
-        double sum_sq_diff = 0.0;
-        for (double ratio : ratio_history_) {
-            double diff = ratio - mean;
-            sum_sq_diff += diff * diff;
+        // Leg A relatively cheap vs leg B (long A, short B)
+        else {
+            signal.direction = Signal::LONG;
+            signal.entry_price = a.ask;
+            signal.stop_price = a.last - (a.last * config_.stop_loss_percent);
+            signal.target_price = a.last + (a.last * config_.target_profit_percent);
+            signal.stop_distance_points = signal.entry_price - signal.stop_price;
         }
-        return std::sqrt(sum_sq_diff / ratio_history_.size());
+        
+        signal.confidence = calculate_pair_confidence(std::abs(zscore), pair.log_ratio.size());
+        signal.expected_edge_bps = std::abs(zscore) * 50.0; // Rough edge estimate
+        signal.hold_time_ms = 900000; // 15 minutes expected hold
+        signal.timestamp_ns = get_timestamp_ns();
+        return signal;
     }
     
-    double calculate_pair_confidence(double abs_zscore) const {
+    double calculate_pair_confidence(double abs_zscore, size_t history) const {
         double confidence = 0.5;
         
         if (abs_zscore > 2.5) confidence += 0.1; // Strong divergence
         if (abs_zscore > 3.0) confidence += 0.1; // Very strong divergence
-        if (ratio_history_.size() >= 50) confidence += 0.1; // Sufficient data
+        if (history >= 50) confidence += 0.1; // Sufficient data
         
         return std::min(confidence, 0.8); // Cap at 80% for pairs
     }
@@ -390,19 +569,16 @@ private:
 // Strategy Scheduler and Coordinator
 class StrategyScheduler {
 public:
-    bool should_run_vwap_reversion() const {
-        TimeOfDay current = TimeOfDay::get_market_time();
-        return current.is_between_1030_and_1500();
+    bool should_run_vwap_reversion(SessionTime session) const {
+        return session.is_between_1030_and_1500();
     }
     
-    bool should_run_opening_drive() const {
-        TimeOfDay current = TimeOfDay::get_market_time();
-        return current.is_opening_hour();
+    bool should_run_opening_drive(SessionTime session) const {
+        return session.is_opening_hour();
     }
     
-    bool should_run_pair_divergence() const {
-        TimeOfDay current = TimeOfDay::get_market_time();
-        return current.is_regular_hours();
+    bool should_run_pair_divergence(SessionTime session) const {
+        return session.is_regular_hours();
     }
 };
 
@@ -413,27 +589,36 @@ private:
     VWAPReversionStrategy vwap_reversion_;
     PairDivergenceStrategy pair_divergence_;
     StrategyScheduler scheduler_;
+    SessionClock* clock_;
     
 public:
+    explicit IntradayStrategyEngine(SessionClock* clock = &SessionClock::instance())
+        : clock_(clock) {}
+    
+    OpeningDriveStrategy& opening_drive() { return opening_drive_; }
+    VWAPReversionStrategy& vwap_reversion() { return vwap_reversion_; }
+    PairDivergenceStrategy& pair_divergence() { return pair_divergence_; }
+    
     Signal process_market_data(const EnhancedMarketData& data) {
         // Update pair strategy with new data
         pair_divergence_.update_pair_data(data);
         
-        TimeOfDay current_time = TimeOfDay::get_market_time();
+        // One session word read per tick, shared by the scheduler and strategies
+        const SessionTime session = clock_->current();
         
         // Route to appropriate strategy based on time and conditions
-        if (current_time.is_opening_hour() && scheduler_.should_run_opening_drive()) {
-            auto signal = opening_drive_.evaluate(data);
+        if (scheduler_.should_run_opening_drive(session)) {
+            auto signal = opening_drive_.evaluate(data, session);
             if (signal.is_valid) return signal;
         }
         
-        if (current_time.is_regular_hours() && scheduler_.should_run_vwap_reversion()) {
-            auto signal = vwap_reversion_.evaluate(data);
+        if (session.is_regular_hours() && scheduler_.should_run_vwap_reversion(session)) {
+            auto signal = vwap_reversion_.evaluate(data, session);
             if (signal.is_valid) return signal;
         }
         
         // Pairs can run anytime during regular hours
-        if (scheduler_.should_run_pair_divergence()) {
+        if (scheduler_.should_run_pair_divergence(session)) {
             auto signal = pair_divergence_.evaluate();
             if (signal.is_valid) return signal;
         }
@@ -442,6 +627,17 @@ public:
         return Signal();
     }
     
+    // Feed a tick that is only needed as a pair leg (replicated from another shard)
+    Signal process_pair_leg(const EnhancedMarketData& data) {
+        pair_divergence_.update_pair_data(data);
+        
+        if (scheduler_.should_run_pair_divergence(clock_->current())) {
+            auto signal = pair_divergence_.evaluate();
+            if (signal.is_valid) return signal;
+        }
+        return Signal();
+    }
+    
     // Method to process multiple symbols simultaneously
     std::vector<Signal> process_multiple_symbols(const std::vector<EnhancedMarketData>& market_data_list) {
         std::vector<Signal> signals;
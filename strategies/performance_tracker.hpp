@@ -9,6 +9,7 @@
 #include <algorithm>
 #include <numeric>
 #include <map>
+#include "../io_service.hpp"
 #include "intraday_strategies.hpp"
 #include "simple_executor.hpp"
 
@@ -104,8 +105,8 @@ struct DailyStats {
 class PerformanceTracker {
 private:
     std::vector<TradeRecord> trades_;
-    std::ofstream trade_csv_file_;
-    std::ofstream daily_csv_file_;
+    hft::IoFileId trade_csv_file_ = hft::INVALID_IO_FILE;
+    hft::IoFileId daily_csv_file_ = hft::INVALID_IO_FILE;
     
     // Running statistics
     double starting_capital_;
@@ -133,11 +134,6 @@ public:
         printf("   Daily Log: daily_performance.csv\n");
     }
     
-    ~PerformanceTracker() {
-        if (trade_csv_file_.is_open()) trade_csv_file_.close();
-        if (daily_csv_file_.is_open()) daily_csv_file_.close();
-    }
-    
     // Record a completed trade
     void record_trade(const TradeRecord& trade) {
         trades_.push_back(trade);
@@ -244,107 +240,26 @@ public:
         return ((current_capital_ - starting_capital_) / starting_capital_) * 100.0;
     }
     
-    // Configuration
-    void set_logging_directory(const std::string& directory) {
-        log_directory_ = directory;
-    }
-    
-    void enable_logging(bool enabled) {
-        logging_enabled_ = enabled;
-    }
-    
-    // Reset for new session
-    void reset_session(double new_starting_capital = 0.0) {
-        if (new_starting_capital > 0) {
-            starting_capital_ = new_starting_capital;
-            current_capital_ = new_starting_capital;
-        }
-        
-        trades_.clear();
-        peak_capital_ = current_capital_;
-        max_drawdown_ = 0.0;
-        daily_returns_.clear();
-        
-        printf("🔄 Performance tracker reset. Starting Capital: $%.2f\n", current_capital_);
-    }
-    
-private:
-    void initialize_logging() {
-        if (!logging_enabled_) return;
-        
-        // Initialize trade CSV
-        trade_csv_file_.open(log_directory_ + "trades.csv", std::ios::app);
-        if (trade_csv_file_.is_open()) {
-            // Write header if file is new
-            trade_csv_file_ << "timestamp,strategy,symbol,direction,entry_price,exit_price,"
-                           << "quantity,gross_pnl,commission,net_pnl,hold_time_seconds,"
-                           << "slippage_bps,entry_order_id,exit_order_id,notes\n";
-        }
-        
-        // Initialize daily CSV
-        daily_csv_file_.open(log_directory_ + "daily_performance.csv", std::ios::app);
-        if (daily_csv_file_.is_open()) {
-            daily_csv_file_ << "date,starting_capital,ending_capital,trades_taken,"
-                           << "winning_trades,net_pnl,max_drawdown,win_rate,profit_factor,"
-                           << "sharpe_ratio,largest_win,largest_loss,avg_slippage_bps\n";
-        }
-    }
-    
-    void write_trade_to_csv(const TradeRecord& trade) {
-        if (!trade_csv_file_.is_open()) return;
-        
-        trade_csv_file_ << trade.timestamp << ","
-                       << trade.strategy << ","
-                       << trade.symbol << ","
-                       << (trade.direction == Signal::LONG ? "LONG" : "SHORT") << ","
-                       << std::fixed << std::setprecision(4) << trade.entry_price << ","
-                       << trade.exit_price << ","
-                       << trade.quantity << ","
-                       << trade.gross_pnl << ","
-                       << trade.commission << ","
-                       << trade.net_pnl << ","
-                       << trade.hold_time_seconds << ","
-                       << trade.slippage_bps << ","
-                       << trade.entry_order_id << ","
-                       << trade.exit_order_id << ","
-                       << trade.notes << "\n";
-        
-        trade_csv_file_.flush();
-    }
-    
-    void write_daily_stats_to_csv(const DailyStats& stats) {
-        if (!daily_csv_file_.is_open()) return;
-        
-        daily_csv_file_ << stats.date << ","
-                       << std::fixed << std::setprecision(2) << stats.starting_capital << ","
-                       << stats.ending_capital << ","
-                       << stats.trades_taken << ","
-                       << stats.winning_trades << ","
-                       << stats.net_pnl << ","
-                       << (stats.max_drawdown * 100) << ","
-                       << stats.win_rate << ","
-                       << stats.profit_factor << ","
-                       << stats.sharpe_ratio << ","
-                       << stats.largest_win << ","
-                       << stats.largest_loss << ","
-                       << (stats.trades_taken > 0 ? stats.total_slippage_bps / stats.trades_taken : 0.0) << "\n";
-        
-        daily_csv_file_.flush();
-    }
-    
-    DailyStats calculate_daily_stats() const {
+    // Stats for a sequence of trades from a starting capital (used to reduce backtest runs)
+    static DailyStats summarize_trades(const std::vector<TradeRecord>& trades, double starting_capital) {
         DailyStats stats;
-        stats.date = get_current_date();
-        stats.starting_capital = starting_capital_;
-        stats.ending_capital = current_capital_;
-        stats.net_pnl = current_capital_ - starting_capital_;
-        stats.max_drawdown = max_drawdown_;
+        stats.starting_capital = starting_capital;
+        stats.ending_capital = starting_capital;
         
-        if (trades_.empty()) {
+        if (trades.empty()) {
             return stats;
         }
         
-        stats.trades_taken = trades_.size();
+        stats.trades_taken = trades.size();
+        
+        // Replay the equity curve for drawdown
+        double peak = starting_capital;
+        for (const auto& trade : trades) {
+            stats.ending_capital += trade.net_pnl;
+            peak = std::max(peak, stats.ending_capital);
+            stats.max_drawdown = std::max(stats.max_drawdown, (peak - stats.ending_capital) / peak);
+        }
+        stats.net_pnl = stats.ending_capital - starting_capital;
         
         // Calculate trade statistics
         double total_gross_pnl = 0.0;
@@ -353,7 +268,7 @@ private:
         double total_wins = 0.0;
         double total_losses = 0.0;
         
-        for (const auto& trade : trades_) {
+        for (const auto& trade : trades) {
             total_gross_pnl += trade.gross_pnl;
             total_commissions += trade.commission;
             total_slippage += trade.slippage_bps;
@@ -394,8 +309,8 @@ private:
         // Calculate Sharpe ratio (simplified)
         if (stats.trades_taken > 1) {
             std::vector<double> returns;
-            for (const auto& trade : trades_) {
-                double return_pct = trade.net_pnl / starting_capital_;
+            for (const auto& trade : trades) {
+                double return_pct = trade.net_pnl / starting_capital;
                 returns.push_back(return_pct);
             }
             
@@ -413,6 +328,100 @@ private:
         return stats;
     }
     
+    // Configuration
+    void set_logging_directory(const std::string& directory) {
+        log_directory_ = directory;
+    }
+    
+    void enable_logging(bool enabled) {
+        logging_enabled_ = enabled;
+    }
+    
+    // Reset for new session
+    void reset_session(double new_starting_capital = 0.0) {
+        if (new_starting_capital > 0) {
+            starting_capital_ = new_starting_capital;
+            current_capital_ = new_starting_capital;
+        }
+        
+        trades_.clear();
+        peak_capital_ = current_capital_;
+        max_drawdown_ = 0.0;
+        daily_returns_.clear();
+        
+        printf("🔄 Performance tracker reset. Starting Capital: $%.2f\n", current_capital_);
+    }
+    
+private:
+    void initialize_logging() {
+        if (!logging_enabled_) return;
+        
+        // Initialize trade CSV (header if the file is new)
+        hft::IoService::FileOptions trades;
+        trades.header = "timestamp,strategy,symbol,direction,entry_price,exit_price,"
+                        "quantity,gross_pnl,commission,net_pnl,hold_time_seconds,"
+                        "slippage_bps,entry_order_id,exit_order_id,notes\n";
+        trade_csv_file_ = hft::IoService::instance().open(log_directory_ + "trades.csv", trades);
+        
+        // Initialize daily CSV
+        hft::IoService::FileOptions daily;
+        daily.header = "date,starting_capital,ending_capital,trades_taken,"
+                       "winning_trades,net_pnl,max_drawdown,win_rate,profit_factor,"
+                       "sharpe_ratio,largest_win,largest_loss,avg_slippage_bps\n";
+        daily_csv_file_ = hft::IoService::instance().open(log_directory_ + "daily_performance.csv", daily);
+    }
+    
+    void write_trade_to_csv(const TradeRecord& trade) {
+        if (trade_csv_file_ == hft::INVALID_IO_FILE) return;
+        
+        hft::IoLine line;
+        line << trade.timestamp << ","
+             << trade.strategy << ","
+             << trade.symbol << ","
+             << (trade.direction == Signal::LONG ? "LONG" : "SHORT") << ","
+             << hft::io_fixed(4) << trade.entry_price << ","
+             << trade.exit_price << ","
+             << trade.quantity << ","
+             << trade.gross_pnl << ","
+             << trade.commission << ","
+             << trade.net_pnl << ","
+             << trade.hold_time_seconds << ","
+             << trade.slippage_bps << ","
+             << trade.entry_order_id << ","
+             << trade.exit_order_id << ","
+             << trade.notes << "\n";
+        hft::IoService::instance().write(trade_csv_file_, line);
+    }
+    
+    void write_daily_stats_to_csv(const DailyStats& stats) {
+        if (daily_csv_file_ == hft::INVALID_IO_FILE) return;
+        
+        hft::IoLine line;
+        line << stats.date << ","
+             << hft::io_fixed(2) << stats.starting_capital << ","
+             << stats.ending_capital << ","
+             << stats.trades_taken << ","
+             << stats.winning_trades << ","
+             << stats.net_pnl << ","
+             << (stats.max_drawdown * 100) << ","
+             << stats.win_rate << ","
+             << stats.profit_factor << ","
+             << stats.sharpe_ratio << ","
+             << stats.largest_win << ","
+             << stats.largest_loss << ","
+             << (stats.trades_taken > 0 ? stats.total_slippage_bps / stats.trades_taken : 0.0) << "\n";
+        hft::IoService::instance().write(daily_csv_file_, line);
+    }
+    
+    DailyStats calculate_daily_stats() const {
+        DailyStats stats = summarize_trades(trades_, starting_capital_);
+        stats.date = get_current_date();
+        stats.ending_capital = current_capital_;
+        stats.net_pnl = current_capital_ - starting_capital_;
+        stats.max_drawdown = max_drawdown_;
+        return stats;
+    }
+    
     std::string get_current_date() const {
         auto now = std::chrono::system_clock::now();
         auto time_t = std::chrono::system_clock::to_time_t(now);
@@ -0,0 +1,366 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <unordered_map>
+#include "../messages.hpp"
+#include "../sequencer.hpp"
+
+namespace hft::strategies {
+
+// Session window bits published in the session word
+enum SessionWindow : uint8_t {
+    WINDOW_SESSION_OPEN  = 1 << 0,  // Between market open and close
+    WINDOW_OPENING_HOUR  = 1 << 1,  // 09:30-10:29
+    WINDOW_MIDDAY        = 1 << 2,  // 10:30-15:00
+    WINDOW_REGULAR_HOURS = 1 << 3,  // 10:00-15:00
+    WINDOW_HALF_DAY      = 1 << 4,  // Early close session
+    WINDOW_CLOSED_DAY    = 1 << 5   // Holiday or weekend
+};
+
+// Decoded view of the session word. Layout:
+//   bits  0-10: exchange-local minute of day
+//   bits 11-13: weekday (0 = Sunday)
+//   bits 16-23: SessionWindow flags
+//   bits 32-63: exchange-local date as YYYYMMDD
+struct SessionTime {
+    uint64_t word = 0;
+
+    SessionTime() = default;
+    explicit SessionTime(uint64_t w) : word(w) {}
+
+    static constexpr uint64_t encode(uint32_t yyyymmdd, uint32_t minute_of_day,
+                                     uint32_t weekday, uint8_t windows) {
+        return (static_cast<uint64_t>(yyyymmdd) << 32) |
+               (static_cast<uint64_t>(windows) << 16) |
+               (static_cast<uint64_t>(weekday & 0x7) << 11) |
+               (minute_of_day & 0x7FF);
+    }
+
+    uint32_t minute_of_day() const { return static_cast<uint32_t>(word & 0x7FF); }
+    int hour() const { return static_cast<int>(minute_of_day() / 60); }
+    int minute() const { return static_cast<int>(minute_of_day() % 60); }
+    uint32_t weekday() const { return static_cast<uint32_t>((word >> 11) & 0x7); }
+    uint8_t windows() const { return static_cast<uint8_t>(word >> 16); }
+    uint32_t date() const { return static_cast<uint32_t>(word >> 32); }
+
+    bool is_session_open() const { return windows() & WINDOW_SESSION_OPEN; }
+    bool is_opening_hour() const { return windows() & WINDOW_OPENING_HOUR; }
+    bool is_between_1030_and_1500() const { return windows() & WINDOW_MIDDAY; }
+    bool is_regular_hours() const { return windows() & WINDOW_REGULAR_HOURS; }
+    bool is_half_day() const { return windows() & WINDOW_HALF_DAY; }
+    bool is_closed_day() const { return windows() & WINDOW_CLOSED_DAY; }
+};
+
+// Exchange session hours and holiday calendar
+class SessionCalendar {
+public:
+    enum class DayType : uint8_t { REGULAR, HALF_DAY, CLOSED };
+
+    // Exchange timezone (America/New_York by default)
+    int utc_offset_minutes = -300;      // Standard time offset
+    bool observes_us_dst = true;        // Second Sunday of March to first Sunday of November
+
+    // Session hours in exchange-local minutes of day
+    uint32_t market_open_minute = 9 * 60 + 30;
+    uint32_t market_close_minute = 16 * 60;
+    uint32_t half_day_close_minute = 13 * 60;
+
+    // Load holidays and half-days from a CSV of "YYYY-MM-DD,CLOSED|HALF[,HH:MM]" lines.
+    // Must be called before the calendar is shared with a running SessionClock.
+    bool load(const std::string& path) {
+        std::ifstream file(path);
+        if (!file.is_open()) {
+            return false;
+        }
+
+        std::string line;
+        while (std::getline(file, line)) {
+            if (line.empty() || line[0] == '#' || line.rfind("date", 0) == 0) {
+                continue;
+            }
+
+            std::stringstream ss(line);
+            std::string date_str, type_str, close_str;
+            std::getline(ss, date_str, ',');
+            std::getline(ss, type_str, ',');
+            std::getline(ss, close_str, ',');
+
+            int y = 0, m = 0, d = 0;
+            if (std::sscanf(date_str.c_str(), "%d-%d-%d", &y, &m, &d) != 3) {
+                continue;
+            }
+            uint32_t key = static_cast<uint32_t>(y * 10000 + m * 100 + d);
+
+            if (type_str == "CLOSED") {
+                days_[key] = {DayType::CLOSED, 0};
+            } else if (type_str == "HALF") {
+                int hh = 0, mm = 0;
+                uint32_t close = half_day_close_minute;
+                if (std::sscanf(close_str.c_str(), "%d:%d", &hh, &mm) == 2) {
+                    close = static_cast<uint32_t>(hh * 60 + mm);
+                }
+                days_[key] = {DayType::HALF_DAY, close};
+            }
+        }
+        return true;
+    }
+
+    void add_day(uint32_t yyyymmdd, DayType type, uint32_t close_minute = 0) {
+        days_[yyyymmdd] = {type, close_minute ? close_minute : half_day_close_minute};
+    }
+
+    DayType day_type(uint32_t yyyymmdd, uint32_t weekday, uint32_t* close_minute) const {
+        *close_minute = market_close_minute;
+        if (weekday == 0 || weekday == 6) {
+            return DayType::CLOSED;
+        }
+        auto it = days_.find(yyyymmdd);
+        if (it == days_.end()) {
+            return DayType::REGULAR;
+        }
+        if (it->second.type == DayType::HALF_DAY) {
+            *close_minute = it->second.close_minute;
+        }
+        return it->second.type;
+    }
+
+    size_t size() const { return days_.size(); }
+
+private:
+    struct DayEntry {
+        DayType type;
+        uint32_t close_minute;
+    };
+    std::unordered_map<uint32_t, DayEntry> days_;
+};
+
+// Session clock service
+//
+// Computes exchange-local time of day and the session window bitmask once per
+// minute and publishes it as a single atomic word. Hot paths call current(),
+// which is one TSC read and compare in live mode and a plain load in virtual
+// mode; neither touches localtime() or the TZ database.
+class SessionClock {
+private:
+    static constexpr uint64_t NS_PER_MINUTE = 60ULL * 1000000000ULL;
+
+    SessionCalendar calendar_;
+
+    alignas(64) std::atomic<uint64_t> word_{0};
+    std::atomic<uint64_t> next_refresh_tsc_{0};
+    std::atomic<bool> virtual_mode_{false};
+
+    // Virtual (backtest) time
+    std::atomic<uint64_t> virtual_now_ns_{0};
+    uint64_t virtual_next_boundary_ns_ = 0;
+
+    // Live mode TSC anchoring, only touched while holding refresh_lock_
+    std::atomic_flag refresh_lock_ = ATOMIC_FLAG_INIT;
+    uint64_t anchor_tsc_ = 0;
+    uint64_t anchor_ns_ = 0;
+    double tsc_per_ns_ = 0.5;   // Conservative until measured; refreshes early, never late
+    bool rate_measured_ = false;
+
+public:
+    SessionClock() = default;
+    explicit SessionClock(const SessionCalendar& calendar) : calendar_(calendar) {}
+
+    static SessionClock& instance() {
+        static SessionClock clock;
+        return clock;
+    }
+
+    // Replace the calendar; call before the clock is read by other threads
+    void set_calendar(const SessionCalendar& calendar) {
+        calendar_ = calendar;
+        next_refresh_tsc_.store(0, std::memory_order_release);
+        if (virtual_mode_.load(std::memory_order_acquire)) {
+            set_virtual_time(virtual_now_ns_.load(std::memory_order_relaxed));
+        }
+    }
+
+    bool load_calendar(const std::string& path) {
+        SessionCalendar calendar = calendar_;
+        if (!calendar.load(path)) {
+            return false;
+        }
+        set_calendar(calendar);
+        return true;
+    }
+
+    const SessionCalendar& calendar() const { return calendar_; }
+
+    // Hot path read
+    [[gnu::hot]]
+    SessionTime current() noexcept {
+        if (!virtual_mode_.load(std::memory_order_relaxed)) {
+            if (::hft::rdtsc() >= next_refresh_tsc_.load(std::memory_order_relaxed)) {
+                refresh_live();
+            }
+        }
+        return SessionTime(word_.load(std::memory_order_acquire));
+    }
+
+    // Last published word without refreshing
+    SessionTime peek() const noexcept {
+        return SessionTime(word_.load(std::memory_order_acquire));
+    }
+
+    // Switch to virtual time (backtests) and publish the session word for epoch_ns
+    void set_virtual_time(uint64_t epoch_ns) {
+        virtual_mode_.store(true, std::memory_order_release);
+        virtual_now_ns_.store(epoch_ns, std::memory_order_relaxed);
+        virtual_next_boundary_ns_ = (epoch_ns / NS_PER_MINUTE + 1) * NS_PER_MINUTE;
+        word_.store(compute_word(epoch_ns), std::memory_order_release);
+    }
+
+    // Advance virtual time; recomputes only when a minute boundary is crossed.
+    // Single writer (the replay thread).
+    void advance_to(uint64_t epoch_ns) {
+        virtual_now_ns_.store(epoch_ns, std::memory_order_relaxed);
+        if (epoch_ns >= virtual_next_boundary_ns_ || epoch_ns + NS_PER_MINUTE < virtual_next_boundary_ns_) {
+            virtual_next_boundary_ns_ = (epoch_ns / NS_PER_MINUTE + 1) * NS_PER_MINUTE;
+            word_.store(compute_word(epoch_ns), std::memory_order_release);
+        }
+    }
+
+    void use_live_time() {
+        virtual_mode_.store(false, std::memory_order_release);
+        next_refresh_tsc_.store(0, std::memory_order_release);
+    }
+
+    bool is_virtual() const { return virtual_mode_.load(std::memory_order_relaxed); }
+
+    // Current epoch time in ns as seen by this clock
+    uint64_t now_ns() const {
+        return virtual_mode_.load(std::memory_order_relaxed)
+            ? virtual_now_ns_.load(std::memory_order_relaxed)
+            : get_timestamp_ns();
+    }
+
+    // Compute the session word for an epoch time (UTC ns). Pure arithmetic, no libc.
+    uint64_t compute_word(uint64_t epoch_ns) const {
+        int64_t utc_minutes = static_cast<int64_t>(epoch_ns / NS_PER_MINUTE);
+        int64_t local_minutes = utc_minutes + utc_offset_minutes(utc_minutes);
+
+        int64_t days = floor_div(local_minutes, 24 * 60);
+        uint32_t minute_of_day = static_cast<uint32_t>(local_minutes - days * 24 * 60);
+        uint32_t weekday = static_cast<uint32_t>(floor_mod(days + 4, 7)); // 1970-01-01 was a Thursday
+
+        int y; unsigned m, d;
+        civil_from_days(days, y, m, d);
+        uint32_t yyyymmdd = static_cast<uint32_t>(y * 10000 + m * 100 + d);
+
+        uint32_t close_minute = calendar_.market_close_minute;
+        auto day_type = calendar_.day_type(yyyymmdd, weekday, &close_minute);
+
+        uint8_t windows = 0;
+        if (day_type == SessionCalendar::DayType::CLOSED) {
+            windows |= WINDOW_CLOSED_DAY;
+        } else {
+            if (day_type == SessionCalendar::DayType::HALF_DAY) windows |= WINDOW_HALF_DAY;
+
+            // Strategy windows (exchange-local minutes), clipped to the day's close
+            const uint32_t mod = minute_of_day;
+            const bool before_close = mod < close_minute;
+            if (mod >= calendar_.market_open_minute && before_close) windows |= WINDOW_SESSION_OPEN;
+            if (mod >= 570 && mod < 630 && before_close) windows |= WINDOW_OPENING_HOUR;   // 09:30-10:29
+            if (mod >= 630 && mod <= 900 && before_close) windows |= WINDOW_MIDDAY;        // 10:30-15:00
+            if (mod >= 600 && mod <= 900 && before_close) windows |= WINDOW_REGULAR_HOURS; // 10:00-15:00
+        }
+
+        return SessionTime::encode(yyyymmdd, minute_of_day, weekday, windows);
+    }
+
+private:
+    void refresh_live() noexcept {
+        if (refresh_lock_.test_and_set(std::memory_order_acquire)) {
+            return; // Another thread is refreshing; the current word is still valid
+        }
+
+        const uint64_t tsc = ::hft::rdtsc();
+        const uint64_t now = get_timestamp_ns();
+
+        // Measure the TSC rate from the previous anchor (needs >1ms of baseline)
+        if (anchor_tsc_ != 0 && now > anchor_ns_ + 1000000ULL && tsc > anchor_tsc_) {
+            tsc_per_ns_ = static_cast<double>(tsc - anchor_tsc_) / static_cast<double>(now - anchor_ns_);
+            rate_measured_ = true;
+        }
+        anchor_tsc_ = tsc;
+        anchor_ns_ = now;
+
+        word_.store(compute_word(now), std::memory_order_release);
+
+        const uint64_t ns_to_boundary = (now / NS_PER_MINUTE + 1) * NS_PER_MINUTE - now;
+        // Until the rate is measured, recheck within 10ms so calibration converges quickly
+        const uint64_t wait_ns = rate_measured_ ? ns_to_boundary
+                                                : std::min<uint64_t>(ns_to_boundary, 10000000ULL);
+        next_refresh_tsc_.store(tsc + static_cast<uint64_t>(wait_ns * tsc_per_ns_),
+                                std::memory_order_relaxed);
+
+        refresh_lock_.clear(std::memory_order_release);
+    }
+
+    // Exchange offset from UTC in minutes, including US daylight saving time
+    int utc_offset_minutes(int64_t utc_minutes) const {
+        const int standard = calendar_.utc_offset_minutes;
+        if (!calendar_.observes_us_dst) {
+            return standard;
+        }
+
+        int y; unsigned m, d;
+        civil_from_days(floor_div(utc_minutes, 24 * 60), y, m, d);
+
+        // DST starts 02:00 local standard time on the second Sunday of March,
+        // ends 02:00 local daylight time on the first Sunday of November
+        const int64_t start = (nth_sunday(y, 3, 2) * 24 * 60) + 120 - standard;
+        const int64_t end = (nth_sunday(y, 11, 1) * 24 * 60) + 120 - (standard + 60);
+
+        return (utc_minutes >= start && utc_minutes < end) ? standard + 60 : standard;
+    }
+
+    // Days since epoch of the nth Sunday of a month
+    static int64_t nth_sunday(int y, unsigned m, unsigned n) {
+        const int64_t first = days_from_civil(y, m, 1);
+        const int64_t weekday = floor_mod(first + 4, 7);
+        return first + (7 - weekday) % 7 + 7 * (n - 1);
+    }
+
+    static int64_t floor_div(int64_t a, int64_t b) {
+        return a / b - ((a % b != 0) && ((a < 0) != (b < 0)));
+    }
+
+    static int64_t floor_mod(int64_t a, int64_t b) {
+        return a - floor_div(a, b) * b;
+    }
+
+    // Howard Hinnant's civil calendar algorithms
+    static int64_t days_from_civil(int y, unsigned m, unsigned d) {
+        y -= m <= 2;
+        const int64_t era = (y >= 0 ? y : y - 399) / 400;
+        const unsigned yoe = static_cast<unsigned>(y - era * 400);
+        const unsigned doy = (153 * (m + (m > 2 ? -3 : 9)) + 2) / 5 + d - 1;
+        const unsigned doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+        return era * 146097 + static_cast<int64_t>(doe) - 719468;
+    }
+
+    static void civil_from_days(int64_t z, int& y, unsigned& m, unsigned& d) {
+        z += 719468;
+        const int64_t era = (z >= 0 ? z : z - 146096) / 146097;
+        const unsigned doe = static_cast<unsigned>(z - era * 146097);
+        const unsigned yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+        const unsigned doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+        const unsigned mp = (5 * doy + 2) / 153;
+        d = doy - (153 * mp + 2) / 5 + 1;
+        m = mp < 10 ? mp + 3 : mp - 9;
+        y = static_cast<int>(yoe) + static_cast<int>(era * 400) + (m <= 2);
+    }
+};
+
+} // namespace hft::strategies
@@ -0,0 +1,367 @@
+#pragma once
+
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <fcntl.h>
+#include <unistd.h>
+#include "../journal.hpp"
+#include "../position_tracker.hpp"
+#include "../symbol_table.hpp"
+#include "intraday_risk_manager.hpp"
+
+namespace hft::strategies {
+
+// What recover() found
+struct RecoveryStats {
+    bool snapshot_loaded = false;
+    size_t positions_restored = 0;
+    size_t records_replayed = 0;        // Journal records applied on top of the snapshot
+    uint64_t last_sequence = 0;
+    double elapsed_ms = 0.0;
+};
+
+// Compact snapshots of PositionTracker and IntradayRiskManager state, plus
+// replay of the journal tail written since the last one. A snapshot covers
+// every journal record up to its sequence, after which the journal starts over.
+// Snapshots must be taken on the thread that books fills and trade results.
+class SessionRecovery {
+public:
+    static constexpr uint64_t DEFAULT_SNAPSHOT_INTERVAL_NS = 60ULL * 1000000000ULL;
+    static constexpr double SNAPSHOT_UTILIZATION = 0.5;     // Snapshot early once the journal is half full
+
+private:
+    static constexpr uint64_t MAGIC = 0x31504E5354464848ULL;   // "HHFTSNP1"
+    static constexpr uint32_t VERSION = 1;
+
+    struct FileHeader {
+        uint64_t magic;
+        uint32_t version;
+        uint32_t session_id;
+        uint64_t last_sequence;
+        uint64_t timestamp_ns;
+        uint32_t position_count;
+        uint32_t balance_venues;
+        double peak_equity;
+        double max_drawdown;
+        uint8_t has_session;
+        uint8_t reserved[7];
+    };
+
+    struct FilePosition {
+        Venue venue;
+        char symbol[39];
+        Position position;
+        double mark_price;
+    };
+
+    struct FileSession {
+        double daily_pnl;
+        uint32_t trades_today;
+        uint32_t consecutive_losses;
+        uint64_t last_trade_time;
+        uint64_t session_start_time;
+        uint64_t halt_time;
+        uint32_t winning_trades;
+        uint32_t losing_trades;
+        double largest_win;
+        double largest_loss;
+        double total_fees;
+        uint8_t trading_halted;
+        char halt_reason[95];
+    };
+
+    hft::TradeJournal& journal_;
+    std::string path_;
+    uint64_t interval_ns_;
+    uint64_t last_snapshot_ns_ = 0;
+    uint64_t snapshots_ = 0;
+
+    // Scratch reused by every snapshot
+    PortfolioSnapshot portfolio_;
+    std::vector<char> buffer_;
+
+    static uint32_t checksum(const char* data, size_t size) {
+        uint32_t hash = 2166136261u;
+        for (size_t i = 0; i < size; ++i) hash = (hash ^ static_cast<uint8_t>(data[i])) * 16777619u;
+        return hash;
+    }
+
+    template<typename T>
+    void put(const T& value) {
+        const char* bytes = reinterpret_cast<const char*>(&value);
+        buffer_.insert(buffer_.end(), bytes, bytes + sizeof(T));
+    }
+
+    template<typename T>
+    static bool get(const std::vector<char>& data, size_t& offset, T& value) {
+        if (offset + sizeof(T) > data.size()) return false;
+        std::memcpy(&value, data.data() + offset, sizeof(T));
+        offset += sizeof(T);
+        return true;
+    }
+
+    static uint64_t now_ns() {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    // Write to a temp file, sync, then rename over the old snapshot
+    bool write_file() {
+        const std::string temp = path_ + ".tmp";
+        const int fd = ::open(temp.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        if (fd < 0) return false;
+
+        size_t written = 0;
+        while (written < buffer_.size()) {
+            const ssize_t n = ::write(fd, buffer_.data() + written, buffer_.size() - written);
+            if (n <= 0) break;
+            written += static_cast<size_t>(n);
+        }
+        const bool ok = written == buffer_.size() && ::fsync(fd) == 0;
+        ::close(fd);
+        if (!ok || std::rename(temp.c_str(), path_.c_str()) != 0) {
+            std::remove(temp.c_str());
+            return false;
+        }
+
+        // Make the rename itself durable
+        const size_t slash = path_.find_last_of('/');
+        const std::string dir = slash == std::string::npos ? "." : path_.substr(0, slash + 1);
+        const int dir_fd = ::open(dir.c_str(), O_RDONLY);
+        if (dir_fd >= 0) {
+            ::fsync(dir_fd);
+            ::close(dir_fd);
+        }
+        return true;
+    }
+
+    bool read_file(std::vector<char>& data) const {
+        FILE* file = std::fopen(path_.c_str(), "rb");
+        if (!file) return false;
+        std::fseek(file, 0, SEEK_END);
+        const long size = std::ftell(file);
+        std::fseek(file, 0, SEEK_SET);
+        data.resize(size > 0 ? static_cast<size_t>(size) : 0);
+        const bool ok = size > 0 && std::fread(data.data(), 1, data.size(), file) == data.size();
+        std::fclose(file);
+        return ok;
+    }
+
+    // Parse and apply a snapshot; nothing is applied unless the whole file checks out
+    bool load_snapshot(PositionTracker& tracker, IntradayRiskManager* risk, RecoveryStats& stats) {
+        std::vector<char> data;
+        if (!read_file(data) || data.size() < sizeof(FileHeader) + sizeof(uint32_t)) return false;
+
+        uint32_t stored = 0;
+        std::memcpy(&stored, data.data() + data.size() - sizeof(uint32_t), sizeof(uint32_t));
+        if (stored != checksum(data.data(), data.size() - sizeof(uint32_t))) return false;
+
+        size_t offset = 0;
+        FileHeader header;
+        get(data, offset, header);
+        if (header.magic != MAGIC || header.version != VERSION || header.session_id != journal_.session_id()) {
+            return false;
+        }
+
+        PortfolioSnapshot portfolio;
+        portfolio.balance_venues = header.balance_venues;
+        for (auto& balance : portfolio.balances) {
+            if (!get(data, offset, balance)) return false;
+        }
+        portfolio.positions.resize(header.position_count);
+        for (auto& entry : portfolio.positions) {
+            FilePosition record;
+            if (!get(data, offset, record)) return false;
+            record.symbol[sizeof(record.symbol) - 1] = '\0';
+            entry.venue = record.venue;
+            entry.symbol = SymbolTable::instance().intern(record.symbol);
+            entry.position = record.position;
+            entry.mark_price = record.mark_price;
+        }
+        FileSession session_record;
+        if (header.has_session && !get(data, offset, session_record)) return false;
+
+        tracker.restore(portfolio, header.peak_equity, header.max_drawdown);
+        if (risk && header.has_session) {
+            SessionRisk session;
+            session.daily_pnl = session_record.daily_pnl;
+            session.trades_today = session_record.trades_today;
+            session.consecutive_losses = session_record.consecutive_losses;
+            session.last_trade_time = session_record.last_trade_time;
+            session.session_start_time = session_record.session_start_time;
+            session.trading_halted = session_record.trading_halted != 0;
+            session_record.halt_reason[sizeof(session_record.halt_reason) - 1] = '\0';
+            session.halt_reason = session_record.halt_reason;
+            session.halt_time = session_record.halt_time;
+            session.winning_trades = session_record.winning_trades;
+            session.losing_trades = session_record.losing_trades;
+            session.largest_win = session_record.largest_win;
+            session.largest_loss = session_record.largest_loss;
+            session.total_fees = session_record.total_fees;
+            risk->restore_session(session);
+        }
+
+        stats.snapshot_loaded = true;
+        stats.positions_restored = portfolio.positions.size();
+        stats.last_sequence = header.last_sequence;
+        return true;
+    }
+
+public:
+    SessionRecovery(hft::TradeJournal& journal, const std::string& snapshot_path,
+                    uint64_t snapshot_interval_ns = DEFAULT_SNAPSHOT_INTERVAL_NS)
+        : journal_(journal), path_(snapshot_path), interval_ns_(snapshot_interval_ns) {}
+
+    /**
+     * Rebuild tracker and risk state: load the last snapshot for this
+     * session, then replay journal records written after it. Call before
+     * trading starts and before attaching the journal.
+     */
+    RecoveryStats recover(PositionTracker& tracker, IntradayRiskManager* risk) {
+        const auto start = std::chrono::steady_clock::now();
+        RecoveryStats stats;
+
+        hft::TradeJournal* tracker_journal = tracker.journal();
+        hft::TradeJournal* risk_journal = risk ? risk->journal() : nullptr;
+        const bool tracker_logging = tracker.logging_enabled();
+        tracker.set_journal(nullptr);
+        tracker.set_logging_enabled(false);
+        if (risk) risk->set_journal(nullptr);
+
+        load_snapshot(tracker, risk, stats);
+        const uint64_t covered = stats.last_sequence;
+
+        // Journal symbol ids belong to the process that wrote them
+        std::vector<SymbolId> symbols(SymbolTable::MAX_SYMBOLS, SymbolTable::INVALID_SYMBOL);
+        journal_.replay([&](const hft::JournalRecord& record) {
+            if (record.type == hft::JournalRecordType::SYMBOL) {
+                char name[sizeof(record.symbol.name) + 1] = {};
+                std::memcpy(name, record.symbol.name, sizeof(record.symbol.name));
+                if (record.symbol.symbol < symbols.size()) {
+                    symbols[record.symbol.symbol] = SymbolTable::instance().intern(name);
+                }
+                return;
+            }
+            if (record.sequence <= covered) return;
+
+            switch (record.type) {
+                case hft::JournalRecordType::FILL:
+                    if (record.fill.symbol < symbols.size() &&
+                        symbols[record.fill.symbol] != SymbolTable::INVALID_SYMBOL) {
+                        tracker.add_trade(record.fill.venue, symbols[record.fill.symbol],
+                                          record.fill.quantity, record.fill.price);
+                    }
+                    break;
+                case hft::JournalRecordType::BALANCE: {
+                    char asset[sizeof(record.balance.asset) + 1] = {};
+                    std::memcpy(asset, record.balance.asset, sizeof(record.balance.asset));
+                    tracker.adjust_balance(record.balance.venue, asset,
+                                           record.balance.delta_total, record.balance.delta_available);
+                    break;
+                }
+                case hft::JournalRecordType::SESSION_TRADE:
+                    if (risk) risk->replay_trade_result(record.trade.pnl, record.trade.fees, record.timestamp_ns);
+                    break;
+                case hft::JournalRecordType::SESSION_HALT: {
+                    char reason[sizeof(record.halt.reason) + 1] = {};
+                    std::memcpy(reason, record.halt.reason, sizeof(record.halt.reason));
+                    if (risk) risk->replay_halt(record.halt.halted != 0, reason, record.timestamp_ns);
+                    break;
+                }
+                default:
+                    break;
+            }
+            stats.records_replayed++;
+            stats.last_sequence = record.sequence;
+        });
+
+        tracker.set_logging_enabled(tracker_logging);
+        tracker.set_journal(tracker_journal);
+        if (risk) risk->set_journal(risk_journal);
+
+        stats.elapsed_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        last_snapshot_ns_ = now_ns();
+        return stats;
+    }
+
+    /**
+     * Snapshot tracker and risk state, then start the journal over
+     * @return false if the snapshot could not be written (the journal is kept)
+     */
+    bool write_snapshot(const PositionTracker& tracker, const IntradayRiskManager* risk) {
+        journal_.commit();
+        const uint64_t last_sequence = journal_.last_sequence();
+        tracker.read_snapshot(portfolio_);
+
+        buffer_.clear();
+        FileHeader header{};
+        header.magic = MAGIC;
+        header.version = VERSION;
+        header.session_id = journal_.session_id();
+        header.last_sequence = last_sequence;
+        header.timestamp_ns = portfolio_.timestamp_ns;
+        header.position_count = static_cast<uint32_t>(portfolio_.positions.size());
+        header.balance_venues = portfolio_.balance_venues;
+        header.peak_equity = tracker.get_peak_equity();
+        header.max_drawdown = tracker.get_max_drawdown();
+        header.has_session = risk ? 1 : 0;
+        put(header);
+
+        for (const auto& balance : portfolio_.balances) put(balance);
+        for (const auto& entry : portfolio_.positions) {
+            FilePosition record{};
+            record.venue = entry.venue;
+            std::strncpy(record.symbol, SymbolTable::instance().name(entry.symbol).c_str(), sizeof(record.symbol) - 1);
+            record.position = entry.position;
+            record.mark_price = entry.mark_price;
+            put(record);
+        }
+        if (risk) {
+            const SessionRisk session = risk->session_snapshot();
+            FileSession record{};
+            record.daily_pnl = session.daily_pnl;
+            record.trades_today = session.trades_today;
+            record.consecutive_losses = session.consecutive_losses;
+            record.last_trade_time = session.last_trade_time;
+            record.session_start_time = session.session_start_time;
+            record.halt_time = session.halt_time;
+            record.winning_trades = session.winning_trades;
+            record.losing_trades = session.losing_trades;
+            record.largest_win = session.largest_win;
+            record.largest_loss = session.largest_loss;
+            record.total_fees = session.total_fees;
+            record.trading_halted = session.trading_halted ? 1 : 0;
+            std::strncpy(record.halt_reason, session.halt_reason.c_str(), sizeof(record.halt_reason) - 1);
+            put(record);
+        }
+        put(checksum(buffer_.data(), buffer_.size()));
+
+        if (!write_file()) return false;
+        journal_.reset(last_sequence + 1);
+        last_snapshot_ns_ = now_ns();
+        snapshots_++;
+        return true;
+    }
+
+    // Snapshot when the interval has passed or the journal is filling up
+    bool maybe_snapshot(const PositionTracker& tracker, const IntradayRiskManager* risk) {
+        const uint64_t now = now_ns();
+        if (journal_.size() == 0) return false;
+        if (now - last_snapshot_ns_ < interval_ns_ && journal_.utilization() < SNAPSHOT_UTILIZATION) return false;
+        return write_snapshot(tracker, risk);
+    }
+
+    uint64_t snapshots() const { return snapshots_; }
+
+    static void print_stats(const RecoveryStats& stats) {
+        printf("💾 Recovery: %s, %zu positions, %zu journal records replayed (seq %lu) in %.2f ms\n",
+               stats.snapshot_loaded ? "snapshot loaded" : "no snapshot",
+               stats.positions_restored, stats.records_replayed,
+               static_cast<unsigned long>(stats.last_sequence), stats.elapsed_ms);
+    }
+};
+
+} // namespace hft::strategies
@@ -3,7 +3,9 @@
 #include <random>
 #include <chrono>
 #include <string>
+#include <iomanip>
 #include "intraday_strategies.hpp"
+#include "session_clock.hpp"
 
 namespace hft::strategies {
 
@@ -58,13 +60,18 @@ private:
     
     uint64_t next_order_id_ = 1;
     
+    // Session clock for time-of-day slippage adjustments
+    SessionClock* clock_;
+    
     // Current market state (simplified)
     std::unordered_map<std::string, double> current_bids_;
     std::unordered_map<std::string, double> current_asks_;
     std::unordered_map<std::string, double> current_spreads_bps_;
     
 public:
-    SimpleExecutor() : rng_(std::random_device{}()), slippage_noise_(-0.5, 0.5) {
+    explicit SimpleExecutor(SessionClock* clock = &SessionClock::instance(),
+                            uint32_t seed = std::random_device{}())
+        : rng_(seed), slippage_noise_(-0.5, 0.5), clock_(clock) {
         // Initialize with some market data
         update_market_data("SPY", 450.00, 450.02);
         update_market_data("QQQ", 375.00, 375.02);
@@ -88,7 +95,7 @@ public:
         result.symbol = symbol;
         result.direction = direction;
         result.requested_quantity = quantity;
-        result.fill_time = get_timestamp_ns();
+        result.fill_time = clock_->now_ns();
         
         // Check if we have market data
         if (current_bids_.find(symbol) == current_bids_.end()) {
@@ -137,7 +144,7 @@ public:
         result.direction = direction;
         result.requested_quantity = quantity;
         result.requested_price = limit_price;
-        result.fill_time = get_timestamp_ns();
+        result.fill_time = clock_->now_ns();
         
         // Check market data
         if (current_bids_.find(symbol) == current_bids_.end()) {
@@ -235,13 +242,8 @@ private:
     double calculate_slippage(const std::string& symbol, double quantity, double spread_bps) {
         double slippage = slippage_model_.base_slippage_bps;
         
-        // Time-based slippage adjustment
-        auto now = std::chrono::system_clock::now();
-        auto time_t = std::chrono::system_clock::to_time_t(now);
-        auto tm = *std::localtime(&time_t);
-        
         // Higher slippage during opening hour
-        if ((tm.tm_hour == 9 && tm.tm_min >= 30) || (tm.tm_hour == 10 && tm.tm_min < 30)) {
+        if (clock_->current().is_opening_hour()) {
             slippage *= slippage_model_.opening_hour_multiplier;
         }
         
@@ -0,0 +1,216 @@
+#pragma once
+
+#include <deque>
+#include <string>
+#include <vector>
+#include "../order_manager.hpp"
+#include "../symbol_table.hpp"
+#include "simple_executor.hpp"
+#include "session_clock.hpp"
+
+namespace hft::strategies {
+
+// Simulated venue behind the OMS
+//
+// Consumes NEW/CANCEL/REPLACE messages from the OrderManager's outbound ring
+// and answers on its inbound ring. Fill prices, slippage and commissions come
+// from SimpleExecutor; marketable orders fill on arrival, other limit orders
+// rest until on_market_data() crosses them. Responses are held back by a fixed
+// venue latency (0 in backtests, so each poll() answers immediately).
+class SimulatedGateway {
+public:
+    struct Stats {
+        uint64_t orders = 0;
+        uint64_t fills = 0;
+        uint64_t rejects = 0;
+        uint64_t cancels = 0;
+        uint64_t replaces = 0;
+    };
+
+private:
+    struct PendingMessage {
+        uint64_t due_ns;
+        SequencedMessage msg;
+    };
+
+    struct RestingOrder {
+        OrderId order_id;
+        SymbolId symbol;
+        Side side;
+        Venue venue;
+        StrategyId strategy;
+        double price;
+        double quantity;
+    };
+
+    OrderManager& oms_;
+    SimpleExecutor& executor_;
+    SessionClock* clock_;
+    uint64_t latency_ns_;
+
+    std::deque<PendingMessage> outbound_;       // Due times are monotonic with a fixed latency
+    std::vector<RestingOrder> resting_;
+    uint64_t next_trade_id_ = 1;
+    Stats stats_;
+
+public:
+    SimulatedGateway(OrderManager& oms, SimpleExecutor& executor,
+                     SessionClock* clock = &SessionClock::instance(), uint64_t latency_ns = 0)
+        : oms_(oms), executor_(executor), clock_(clock), latency_ns_(latency_ns) {}
+
+    // Update execution prices and fill resting limit orders the quote now crosses
+    void on_market_data(const std::string& symbol, double bid, double ask) {
+        executor_.update_market_data(symbol, bid, ask);
+
+        for (size_t i = 0; i < resting_.size();) {
+            RestingOrder& order = resting_[i];
+            if (SymbolTable::instance().name(order.symbol) != symbol ||
+                !(order.side == Side::BUY ? ask <= order.price : bid >= order.price)) {
+                ++i;
+                continue;
+            }
+            OrderResult result = executor_.execute_limit_order(symbol, direction(order.side),
+                                                               order.quantity, order.price);
+            if (result.is_filled()) {
+                queue_fill(order.order_id, order, result);
+                resting_[i] = resting_.back();
+                resting_.pop_back();
+            } else {
+                ++i;
+            }
+        }
+    }
+
+    // Handle OMS requests and deliver responses that are due
+    size_t poll() {
+        size_t work = 0;
+
+        SequencedMessage msg;
+        while (oms_.poll_outbound(msg)) {
+            handle(msg);
+            ++work;
+        }
+
+        const uint64_t now = clock_->now_ns();
+        while (!outbound_.empty() && outbound_.front().due_ns <= now) {
+            if (!oms_.deliver(outbound_.front().msg)) break;   // Inbound ring full; retry next poll
+            outbound_.pop_front();
+            ++work;
+        }
+        return work;
+    }
+
+    size_t resting_orders() const { return resting_.size(); }
+    size_t pending_responses() const { return outbound_.size(); }
+    const Stats& get_stats() const { return stats_; }
+
+private:
+    static Signal::Direction direction(Side side) {
+        return side == Side::BUY ? Signal::LONG : Signal::SHORT;
+    }
+
+    void handle(const SequencedMessage& msg) {
+        switch (msg.type) {
+            case MessageType::NEW_ORDER: on_new(msg); break;
+            case MessageType::CANCEL_ORDER: on_cancel(msg); break;
+            case MessageType::REPLACE_ORDER: on_replace(msg); break;
+            default: break;
+        }
+    }
+
+    void on_new(const SequencedMessage& msg) {
+        stats_.orders++;
+        const std::string& symbol = SymbolTable::instance().name(msg.symbol_id);
+        const double quantity = to_float_quantity(msg.order.quantity);
+        const double price = to_float_price(msg.order.price);
+
+        RestingOrder order{msg.order.order_id, msg.symbol_id, msg.order.side, msg.venue,
+                           msg.strategy_id, price, quantity};
+
+        OrderResult result;
+        if (msg.order.order_type == OrderType::MARKET) {
+            result = executor_.execute_market_order(symbol, direction(order.side), quantity);
+        } else {
+            result = executor_.execute_limit_order(symbol, direction(order.side), quantity, price);
+            const bool immediate = msg.order.order_type == OrderType::LIMIT_IOC ||
+                                   msg.order.order_type == OrderType::LIMIT_FOK ||
+                                   msg.order.tif == TimeInForce::IOC || msg.order.tif == TimeInForce::FOK;
+            if (!result.is_filled() && !immediate && result.rejection_reason != "No market data available") {
+                queue(make_response(msg, MessageType::ORDER_ACK));
+                resting_.push_back(order);
+                return;
+            }
+        }
+
+        if (!result.is_filled()) {
+            stats_.rejects++;
+            queue(make_response(msg, MessageType::ORDER_REJECT));
+            return;
+        }
+
+        queue(make_response(msg, MessageType::ORDER_ACK));
+        queue_fill(order.order_id, order, result);
+    }
+
+    void on_cancel(const SequencedMessage& msg) {
+        auto it = find_resting(msg.order.order_id);
+        if (it == resting_.end()) {
+            queue(make_response(msg, MessageType::CANCEL_REJECT, OrderRecord::FLAG_CANCEL));
+            return;
+        }
+        resting_.erase(it);
+        stats_.cancels++;
+        queue(make_response(msg, MessageType::CANCEL_ACK, OrderRecord::FLAG_CANCEL));
+    }
+
+    void on_replace(const SequencedMessage& msg) {
+        auto it = find_resting(msg.order.order_id);
+        if (it == resting_.end()) {
+            queue(make_response(msg, MessageType::CANCEL_REJECT, OrderRecord::FLAG_REPLACE));
+            return;
+        }
+        // Resting orders are never partially filled here, so the new total is all open
+        it->price = to_float_price(msg.order.price);
+        it->quantity = to_float_quantity(msg.order.quantity);
+        stats_.replaces++;
+        queue(make_response(msg, MessageType::ORDER_ACK, OrderRecord::FLAG_REPLACE));
+    }
+
+    std::vector<RestingOrder>::iterator find_resting(OrderId id) {
+        for (auto it = resting_.begin(); it != resting_.end(); ++it) {
+            if (it->order_id == id) return it;
+        }
+        return resting_.end();
+    }
+
+    SequencedMessage make_response(const SequencedMessage& request, MessageType type, uint8_t flags = 0) {
+        SequencedMessage response = request;
+        response.type = type;
+        response.timestamp_ns = clock_->now_ns();
+        response.order.flags = flags;
+        return response;
+    }
+
+    void queue_fill(OrderId id, const RestingOrder& order, const OrderResult& result) {
+        SequencedMessage fill{};
+        fill.timestamp_ns = clock_->now_ns();
+        fill.type = MessageType::FILL;
+        fill.venue = order.venue;
+        fill.symbol_id = order.symbol;
+        fill.strategy_id = order.strategy;
+        fill.correlation_id = id;
+        fill.fill.order_id = id;
+        fill.fill.fill_price = to_fixed_price(result.fill_price);
+        fill.fill.fill_quantity = to_fixed_quantity(result.filled_quantity);
+        fill.fill.trade_id = next_trade_id_++;
+        fill.fill.fee = static_cast<int64_t>(result.commission * PRICE_MULTIPLIER + 0.5);
+        stats_.fills++;
+        queue(fill);
+    }
+
+    void queue(const SequencedMessage& msg) {
+        outbound_.push_back({clock_->now_ns() + latency_ns_, msg});
+    }
+};
+
+} // namespace hft::strategies
@@ -0,0 +1,442 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <memory>
+#include <numeric>
+#include <string>
+#include <thread>
+#include <vector>
+#include "../ring_buffer.hpp"
+#include "../sequencer.hpp"
+#include "../symbol_table.hpp"
+#include "intraday_strategies.hpp"
+
+namespace hft::strategies {
+
+enum class StrategyKind : uint8_t {
+    NONE = 0,
+    OPENING_DRIVE = 1,
+    VWAP_REVERSION = 2,
+    PAIR_DIVERGENCE = 3
+};
+
+inline StrategyKind strategy_kind_from_name(const std::string& name) {
+    if (name == "OPENING_DRIVE") return StrategyKind::OPENING_DRIVE;
+    if (name == "VWAP_REVERSION") return StrategyKind::VWAP_REVERSION;
+    if (name == "PAIR_DIVERGENCE") return StrategyKind::PAIR_DIVERGENCE;
+    return StrategyKind::NONE;
+}
+
+inline const char* strategy_kind_name(StrategyKind kind) {
+    switch (kind) {
+        case StrategyKind::OPENING_DRIVE: return "OPENING_DRIVE";
+        case StrategyKind::VWAP_REVERSION: return "VWAP_REVERSION";
+        case StrategyKind::PAIR_DIVERGENCE: return "PAIR_DIVERGENCE";
+        default: return "UNKNOWN";
+    }
+}
+
+// Market data tick as carried on shard input rings (no strings)
+struct StrategyTick {
+    uint64_t timestamp_ns;
+    SymbolId symbol;
+    uint64_t bid_size;
+    uint64_t ask_size;
+    uint64_t cumulative_volume;
+    uint64_t average_volume_30d;
+    double bid;
+    double ask;
+    double last;
+    double vwap;
+    double day_open;
+    double prev_close;
+    double rsi_5;
+    double rsi_14;
+    double std_dev_20;
+    double distance_from_vwap_percent;
+};
+
+// Strategy output as carried on the order-intent ring (no strings)
+struct OrderIntent {
+    uint64_t timestamp_ns;
+    SymbolId symbol;          // Traded leg
+    SymbolId hedge_symbol;    // Second leg for pairs, INVALID_SYMBOL otherwise
+    StrategyKind strategy;
+    uint8_t direction;        // Signal::Direction
+    uint8_t shard;
+    uint32_t hold_time_ms;
+    double entry_price;
+    double stop_price;
+    double target_price;
+    double stop_distance_points;
+    double confidence;
+    double expected_edge_bps;
+};
+
+struct StrategyHostConfig {
+    enum class PairPlacement {
+        COLOCATE,    // Both legs of a pair are owned by the same shard
+        REPLICATE    // Legs placed independently; the pair's shard subscribes to the remote leg
+    };
+
+    size_t num_shards = 2;
+    std::vector<int> shard_cpus;        // Core per shard (empty = unpinned)
+    PairPlacement pair_placement = PairPlacement::COLOCATE;
+    uint32_t idle_spins = 1000;         // Pause-spins before yielding on an empty ring
+};
+
+// Symbol-sharded strategy host
+//
+// Symbols (and therefore strategy instances) are partitioned across N worker
+// threads. The feed thread dispatches each tick into the owning shard's SPSC
+// ring; each shard owns its own IntradayStrategyEngine, so strategy state is
+// never shared. Every shard publishes into one MPSC order-intent ring.
+class StrategyHost {
+public:
+    static constexpr size_t INPUT_RING_SIZE = 4096;
+    static constexpr size_t INTENT_RING_SIZE = 8192;
+    static constexpr size_t MAX_SHARDS = 64;
+
+private:
+    struct alignas(64) Shard {
+        SPSCQueue<StrategyTick, INPUT_RING_SIZE> input;
+        std::unique_ptr<IntradayStrategyEngine> engine;
+        std::vector<uint8_t> owned;                 // Indexed by SymbolId
+        std::vector<std::pair<SymbolId, SymbolId>> pairs;
+        size_t symbol_count = 0;
+        int cpu = -1;
+        std::thread thread;
+
+        alignas(64) std::atomic<uint64_t> ticks_processed{0};
+        std::atomic<uint64_t> intents_published{0};
+        std::atomic<uint64_t> intents_dropped{0};
+    };
+
+    StrategyHostConfig config_;
+    SymbolTable& symbols_;
+    SessionClock* clock_;
+
+    std::vector<SymbolId> host_symbols_;
+    std::vector<std::pair<SymbolId, SymbolId>> host_pairs_;
+    std::vector<std::unique_ptr<Shard>> shards_;
+    MPSCQueue<OrderIntent, INTENT_RING_SIZE> intents_;
+
+    // Dispatcher state (feed thread only)
+    std::unordered_map<std::string, SymbolId> dispatch_ids_;
+    std::vector<uint64_t> route_mask_;              // Indexed by SymbolId: shards subscribed
+    uint64_t ticks_dispatched_ = 0;
+    uint64_t ticks_dropped_ = 0;
+
+    std::atomic<bool> running_{false};
+
+public:
+    explicit StrategyHost(const StrategyHostConfig& config = StrategyHostConfig(),
+                          SessionClock* clock = &SessionClock::instance(),
+                          SymbolTable& symbols = SymbolTable::instance())
+        : config_(config), symbols_(symbols), clock_(clock) {
+        config_.num_shards = std::clamp<size_t>(config_.num_shards, 1, MAX_SHARDS);
+    }
+
+    ~StrategyHost() {
+        stop();
+    }
+
+    StrategyHost(const StrategyHost&) = delete;
+    StrategyHost& operator=(const StrategyHost&) = delete;
+
+    // ---- Setup (before start) ----
+
+    SymbolId add_symbol(const std::string& symbol) {
+        SymbolId id = symbols_.intern(symbol);
+        if (id != SymbolTable::INVALID_SYMBOL &&
+            std::find(host_symbols_.begin(), host_symbols_.end(), id) == host_symbols_.end()) {
+            host_symbols_.push_back(id);
+        }
+        return id;
+    }
+
+    void add_pair(const std::string& symbol_a, const std::string& symbol_b) {
+        SymbolId a = add_symbol(symbol_a);
+        SymbolId b = add_symbol(symbol_b);
+        if (a == SymbolTable::INVALID_SYMBOL || b == SymbolTable::INVALID_SYMBOL) return;
+        host_pairs_.emplace_back(a, b);
+    }
+
+    bool load_pairs_from_config(const std::string& path) {
+        std::vector<std::pair<std::string, std::string>> parsed;
+        if (!PairDivergenceStrategy::parse_pairs_config(path, parsed)) return false;
+        for (const auto& [a, b] : parsed) add_pair(a, b);
+        return true;
+    }
+
+    // Partition symbols across shards and launch the pinned workers
+    void start() {
+        if (running_.exchange(true)) return;
+
+        build_shards();
+
+        for (size_t i = 0; i < shards_.size(); ++i) {
+            Shard* s = shards_[i].get();
+            s->thread = std::thread([this, s, i] { worker_loop(*s, static_cast<uint8_t>(i)); });
+        }
+
+        printf("🧵 Strategy host started: %zu shards, %zu symbols, %zu pairs (%s placement)\n",
+               shards_.size(), host_symbols_.size(), host_pairs_.size(),
+               config_.pair_placement == StrategyHostConfig::PairPlacement::COLOCATE
+                   ? "colocated" : "replicated");
+    }
+
+    void stop() {
+        if (!running_.exchange(false)) return;
+
+        for (auto& shard : shards_) {
+            if (shard->thread.joinable()) shard->thread.join();
+        }
+    }
+
+    // ---- Feed thread ----
+
+    // Route a tick to every shard subscribed to its symbol
+    [[gnu::hot]]
+    bool dispatch(const EnhancedMarketData& data) {
+        auto it = dispatch_ids_.find(data.symbol);
+        if (it == dispatch_ids_.end()) return false;
+
+        const SymbolId id = it->second;
+        StrategyTick tick{
+            data.timestamp_ns, id,
+            data.bid_size, data.ask_size, data.cumulative_volume, data.average_volume_30d,
+            data.bid, data.ask, data.last, data.vwap, data.day_open, data.prev_close,
+            data.rsi_5, data.rsi_14, data.std_dev_20, data.distance_from_vwap_percent
+        };
+
+        uint64_t mask = route_mask_[id];
+        while (mask) {
+            const int shard = __builtin_ctzll(mask);
+            mask &= mask - 1;
+            if (!shards_[shard]->input.push(tick)) {
+                ++ticks_dropped_;
+            }
+        }
+        ++ticks_dispatched_;
+        return true;
+    }
+
+    // ---- Order intent consumer ----
+
+    bool poll_intent(OrderIntent& intent) {
+        return intents_.pop(intent);
+    }
+
+    // Rebuild a Signal from an intent for the risk/execution path
+    Signal to_signal(const OrderIntent& intent) const {
+        std::string symbol = symbols_.name(intent.symbol);
+        if (intent.hedge_symbol != SymbolTable::INVALID_SYMBOL) {
+            symbol += "/" + symbols_.name(intent.hedge_symbol);
+        }
+
+        Signal signal(strategy_kind_name(intent.strategy), symbol);
+        signal.is_valid = true;
+        signal.direction = static_cast<Signal::Direction>(intent.direction);
+        signal.entry_price = intent.entry_price;
+        signal.stop_price = intent.stop_price;
+        signal.target_price = intent.target_price;
+        signal.stop_distance_points = intent.stop_distance_points;
+        signal.confidence = intent.confidence;
+        signal.expected_edge_bps = intent.expected_edge_bps;
+        signal.hold_time_ms = intent.hold_time_ms;
+        signal.timestamp_ns = intent.timestamp_ns;
+        return signal;
+    }
+
+    // ---- Introspection ----
+
+    size_t shard_count() const { return shards_.size(); }
+
+    int shard_of(const std::string& symbol) const {
+        SymbolId id = symbols_.find(symbol);
+        if (id == SymbolTable::INVALID_SYMBOL) return -1;
+        for (size_t i = 0; i < shards_.size(); ++i) {
+            if (id < shards_[i]->owned.size() && shards_[i]->owned[id]) return static_cast<int>(i);
+        }
+        return -1;
+    }
+
+    void print_status() const {
+        printf("\n🧵 Strategy Host Status:\n");
+        printf("   Ticks dispatched: %lu (dropped: %lu)\n",
+               static_cast<unsigned long>(ticks_dispatched_),
+               static_cast<unsigned long>(ticks_dropped_));
+        for (size_t i = 0; i < shards_.size(); ++i) {
+            const Shard& s = *shards_[i];
+            printf("   Shard %zu (cpu %d): %zu symbols, %zu pairs, %lu ticks, %lu intents (%lu dropped), ring %zu\n",
+                   i, s.cpu, s.symbol_count, s.pairs.size(),
+                   static_cast<unsigned long>(s.ticks_processed.load(std::memory_order_relaxed)),
+                   static_cast<unsigned long>(s.intents_published.load(std::memory_order_relaxed)),
+                   static_cast<unsigned long>(s.intents_dropped.load(std::memory_order_relaxed)),
+                   s.input.size());
+        }
+    }
+
+private:
+    void build_shards() {
+        const size_t n = config_.num_shards;
+        const size_t table_size = symbols_.size();
+
+        shards_.clear();
+        for (size_t i = 0; i < n; ++i) {
+            auto shard = std::make_unique<Shard>();
+            shard->engine = std::make_unique<IntradayStrategyEngine>(clock_);
+            shard->engine->pair_divergence().clear_pairs();
+            shard->owned.assign(table_size, 0);
+            shard->cpu = i < config_.shard_cpus.size() ? config_.shard_cpus[i] : -1;
+            shards_.push_back(std::move(shard));
+        }
+
+        route_mask_.assign(table_size, 0);
+        std::vector<int> owner(table_size, -1);
+
+        // Group symbols: colocated pairs merge their legs into one placement unit
+        std::vector<SymbolId> parent(table_size);
+        std::iota(parent.begin(), parent.end(), 0);
+        auto root = [&parent](SymbolId x) {
+            while (parent[x] != x) x = parent[x] = parent[parent[x]];
+            return x;
+        };
+        if (config_.pair_placement == StrategyHostConfig::PairPlacement::COLOCATE) {
+            for (const auto& [a, b] : host_pairs_) parent[root(a)] = root(b);
+        }
+
+        std::unordered_map<SymbolId, std::vector<SymbolId>> groups;
+        for (SymbolId id : host_symbols_) groups[root(id)].push_back(id);
+
+        std::vector<std::vector<SymbolId>> ordered;
+        for (auto& [r, members] : groups) ordered.push_back(std::move(members));
+        std::sort(ordered.begin(), ordered.end(), [](const auto& x, const auto& y) {
+            return x.size() != y.size() ? x.size() > y.size() : x.front() < y.front();
+        });
+
+        // Largest groups first onto the least-loaded shard
+        for (const auto& members : ordered) {
+            size_t target = 0;
+            for (size_t i = 1; i < n; ++i) {
+                if (shards_[i]->symbol_count < shards_[target]->symbol_count) target = i;
+            }
+            for (SymbolId id : members) {
+                owner[id] = static_cast<int>(target);
+                shards_[target]->owned[id] = 1;
+                route_mask_[id] |= 1ULL << target;
+                ++shards_[target]->symbol_count;
+            }
+        }
+
+        // Pairs live on the shard owning leg A; replicate leg B there if needed
+        for (const auto& [a, b] : host_pairs_) {
+            Shard& shard = *shards_[owner[a]];
+            shard.pairs.emplace_back(a, b);
+            shard.engine->pair_divergence().add_pair(symbols_.name(a), symbols_.name(b));
+            route_mask_[b] |= 1ULL << owner[a];
+        }
+
+        dispatch_ids_.clear();
+        for (SymbolId id : host_symbols_) dispatch_ids_.emplace(symbols_.name(id), id);
+    }
+
+    void worker_loop(Shard& shard, uint8_t shard_index) {
+        if (shard.cpu >= 0) pin_current_thread(shard.cpu);
+
+        constexpr size_t BATCH = 64;
+        StrategyTick batch[BATCH];
+        EnhancedMarketData data;
+        uint32_t idle = 0;
+
+        while (running_.load(std::memory_order_relaxed)) {
+            const size_t count = shard.input.pop_batch(batch, BATCH);
+            if (count == 0) {
+                if (++idle < config_.idle_spins) {
+#ifdef HAS_X86_INTRINSICS
+                    _mm_pause();
+#endif
+                } else {
+                    std::this_thread::yield();
+                }
+                continue;
+            }
+            idle = 0;
+
+            for (size_t i = 0; i < count; ++i) {
+                const StrategyTick& tick = batch[i];
+                fill_market_data(tick, data);
+
+                Signal signal = shard.owned[tick.symbol]
+                    ? shard.engine->process_market_data(data)
+                    : shard.engine->process_pair_leg(data);
+
+                if (signal.is_valid) {
+                    publish_intent(shard, shard_index, tick.symbol, signal);
+                }
+            }
+            shard.ticks_processed.fetch_add(count, std::memory_order_relaxed);
+        }
+    }
+
+    void fill_market_data(const StrategyTick& tick, EnhancedMarketData& data) const {
+        data.symbol = symbols_.name(tick.symbol);  // Short tickers stay in the SSO buffer
+        data.bid = tick.bid;
+        data.ask = tick.ask;
+        data.last = tick.last;
+        data.bid_size = tick.bid_size;
+        data.ask_size = tick.ask_size;
+        data.vwap = tick.vwap;
+        data.day_open = tick.day_open;
+        data.prev_close = tick.prev_close;
+        data.cumulative_volume = tick.cumulative_volume;
+        data.average_volume_30d = tick.average_volume_30d;
+        data.rsi_5 = tick.rsi_5;
+        data.rsi_14 = tick.rsi_14;
+        data.std_dev_20 = tick.std_dev_20;
+        data.distance_from_vwap_percent = tick.distance_from_vwap_percent;
+        data.timestamp_ns = tick.timestamp_ns;
+    }
+
+    void publish_intent(Shard& shard, uint8_t shard_index, SymbolId tick_symbol, const Signal& signal) {
+        OrderIntent intent{};
+        intent.timestamp_ns = signal.timestamp_ns;
+        intent.strategy = strategy_kind_from_name(signal.strategy_type);
+        intent.direction = static_cast<uint8_t>(signal.direction);
+        intent.shard = shard_index;
+        intent.hold_time_ms = signal.hold_time_ms;
+        intent.entry_price = signal.entry_price;
+        intent.stop_price = signal.stop_price;
+        intent.target_price = signal.target_price;
+        intent.stop_distance_points = signal.stop_distance_points;
+        intent.confidence = signal.confidence;
+        intent.expected_edge_bps = signal.expected_edge_bps;
+        intent.symbol = tick_symbol;
+        intent.hedge_symbol = SymbolTable::INVALID_SYMBOL;
+
+        // Pair signals name both legs ("A/B"); resolve them against the shard's pair list
+        const size_t slash = signal.symbol.find('/');
+        if (slash != std::string::npos) {
+            for (const auto& [a, b] : shard.pairs) {
+                const std::string& name_a = symbols_.name(a);
+                if (signal.symbol.compare(0, slash, name_a) == 0 &&
+                    signal.symbol.compare(slash + 1, std::string::npos, symbols_.name(b)) == 0) {
+                    intent.symbol = a;
+                    intent.hedge_symbol = b;
+                    break;
+                }
+            }
+        }
+
+        if (intents_.push(intent)) {
+            shard.intents_published.fetch_add(1, std::memory_order_relaxed);
+        } else {
+            shard.intents_dropped.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+};
+
+} // namespace hft::strategies
@@ -35,6 +35,142 @@ public:
     void clear() { data_.clear(); }
 };
 
+// Rolling mean/variance over a fixed window in O(1) per sample
+// (sliding Welford update over a preallocated ring, rebuilt once per window to cancel drift)
+class RollingMeanVariance {
+private:
+    std::vector<double> ring_;
+    size_t head_ = 0;
+    size_t count_ = 0;
+    size_t slides_ = 0;
+    double mean_ = 0.0;
+    double m2_ = 0.0;
+
+    void rebuild() {
+        mean_ = 0.0;
+        m2_ = 0.0;
+        for (size_t i = 0; i < count_; ++i) {
+            double x = ring_[i];
+            double delta = x - mean_;
+            mean_ += delta / (i + 1);
+            m2_ += delta * (x - mean_);
+        }
+        slides_ = 0;
+    }
+
+public:
+    explicit RollingMeanVariance(size_t window) : ring_(window, 0.0) {}
+
+    void add(double x) {
+        const size_t n = ring_.size();
+        if (count_ < n) {
+            ring_[head_] = x;
+            head_ = (head_ + 1) % n;
+            ++count_;
+            double delta = x - mean_;
+            mean_ += delta / count_;
+            m2_ += delta * (x - mean_);
+            return;
+        }
+
+        // Window full: replace the oldest sample
+        double old = ring_[head_];
+        ring_[head_] = x;
+        head_ = (head_ + 1) % n;
+        double old_mean = mean_;
+        mean_ += (x - old) / n;
+        m2_ += (x - old) * (x - mean_ + old - old_mean);
+
+        if (++slides_ >= n) rebuild();
+    }
+
+    size_t size() const { return count_; }
+    size_t capacity() const { return ring_.size(); }
+    bool is_full() const { return count_ == ring_.size(); }
+    double mean() const { return mean_; }
+    double variance() const { return count_ > 0 ? std::max(m2_, 0.0) / count_ : 0.0; }
+    double std_dev() const { return std::sqrt(variance()); }
+
+    void clear() {
+        head_ = count_ = slides_ = 0;
+        mean_ = m2_ = 0.0;
+    }
+};
+
+// Rolling Pearson correlation of two paired series over a fixed window in O(1) per sample
+class RollingCorrelation {
+private:
+    std::vector<double> ring_x_;
+    std::vector<double> ring_y_;
+    size_t head_ = 0;
+    size_t count_ = 0;
+    size_t slides_ = 0;
+    double mean_x_ = 0.0, mean_y_ = 0.0;
+    double m2_x_ = 0.0, m2_y_ = 0.0, c_xy_ = 0.0;
+
+    void push(double x, double y) {
+        ++count_;
+        double dx = x - mean_x_;
+        double dy = y - mean_y_;
+        mean_x_ += dx / count_;
+        mean_y_ += dy / count_;
+        m2_x_ += dx * (x - mean_x_);
+        m2_y_ += dy * (y - mean_y_);
+        c_xy_ += dx * (y - mean_y_);
+    }
+
+    void pop(double x, double y) {
+        if (--count_ == 0) {
+            mean_x_ = mean_y_ = m2_x_ = m2_y_ = c_xy_ = 0.0;
+            return;
+        }
+        double with_x = mean_x_, with_y = mean_y_;
+        mean_x_ = with_x - (x - with_x) / count_;
+        mean_y_ = with_y - (y - with_y) / count_;
+        m2_x_ -= (x - mean_x_) * (x - with_x);
+        m2_y_ -= (y - mean_y_) * (y - with_y);
+        c_xy_ -= (x - mean_x_) * (y - with_y);
+    }
+
+    void rebuild() {
+        size_t n = count_;
+        count_ = 0;
+        mean_x_ = mean_y_ = m2_x_ = m2_y_ = c_xy_ = 0.0;
+        for (size_t i = 0; i < n; ++i) push(ring_x_[i], ring_y_[i]);
+        slides_ = 0;
+    }
+
+public:
+    explicit RollingCorrelation(size_t window) : ring_x_(window, 0.0), ring_y_(window, 0.0) {}
+
+    void add(double x, double y) {
+        const size_t n = ring_x_.size();
+        if (count_ == n) {
+            pop(ring_x_[head_], ring_y_[head_]);
+            ++slides_;
+        }
+        ring_x_[head_] = x;
+        ring_y_[head_] = y;
+        head_ = (head_ + 1) % n;
+        push(x, y);
+
+        if (slides_ >= n) rebuild();
+    }
+
+    size_t size() const { return count_; }
+    bool is_full() const { return count_ == ring_x_.size(); }
+
+    double correlation() const {
+        double denom = std::sqrt(std::max(m2_x_, 0.0) * std::max(m2_y_, 0.0));
+        return denom > 0.0 ? c_xy_ / denom : 0.0;
+    }
+
+    void clear() {
+        head_ = count_ = slides_ = 0;
+        mean_x_ = mean_y_ = m2_x_ = m2_y_ = c_xy_ = 0.0;
+    }
+};
+
 // RSI (Relative Strength Index) Calculator
 class RSI {
 private:
@@ -154,6 +290,73 @@ public:
     }
 };
 
+// Intraday volume curve for VWAP scheduling
+// Fixed-width buckets over the regular session. The historical curve (U-shaped
+// prior until real sessions are rolled in) drives cumulative_fraction(); the
+// current session's volume accumulates separately and is blended in by
+// roll_session() at the close.
+class VolumeProfile {
+private:
+    uint32_t open_minute_;
+    uint32_t bucket_minutes_;
+    std::vector<double> historical_;    // Normalized bucket weights
+    std::vector<double> prefix_;        // prefix_[i] = weight of buckets before i
+    std::vector<uint64_t> today_;
+    
+    void rebuild_prefix() {
+        double total = std::accumulate(historical_.begin(), historical_.end(), 0.0);
+        prefix_.assign(historical_.size() + 1, 0.0);
+        for (size_t i = 0; i < historical_.size(); ++i) {
+            historical_[i] /= total;
+            prefix_[i + 1] = prefix_[i] + historical_[i];
+        }
+    }
+    
+public:
+    explicit VolumeProfile(uint32_t open_minute = 9 * 60 + 30, uint32_t close_minute = 16 * 60,
+                           uint32_t bucket_minutes = 5)
+        : open_minute_(open_minute), bucket_minutes_(bucket_minutes) {
+        size_t buckets = std::max<uint32_t>(1, (close_minute - open_minute) / bucket_minutes);
+        historical_.resize(buckets);
+        today_.assign(buckets, 0);
+        for (size_t i = 0; i < buckets; ++i) {
+            double x = (i + 0.5) / buckets * 2.0 - 1.0;     // -1 at the open, +1 at the close
+            historical_[i] = 1.0 + 2.0 * x * x;             // Heavy open and close, quiet midday
+        }
+        rebuild_prefix();
+    }
+    
+    void add_volume(uint32_t minute_of_day, uint64_t volume) {
+        if (minute_of_day < open_minute_) return;
+        size_t bucket = (minute_of_day - open_minute_) / bucket_minutes_;
+        if (bucket < today_.size()) today_[bucket] += volume;
+    }
+    
+    // Blend the finished session into the historical curve and start a new one
+    void roll_session(double weight = 0.2) {
+        uint64_t total = std::accumulate(today_.begin(), today_.end(), uint64_t{0});
+        if (total > 0) {
+            for (size_t i = 0; i < historical_.size(); ++i) {
+                historical_[i] = (1.0 - weight) * historical_[i] + weight * (double(today_[i]) / total);
+            }
+            rebuild_prefix();
+        }
+        std::fill(today_.begin(), today_.end(), 0);
+    }
+    
+    // Expected share of the session's volume traded before this (fractional) minute of day
+    double cumulative_fraction(double minute_of_day) const {
+        double position = (minute_of_day - open_minute_) / bucket_minutes_;
+        if (position <= 0.0) return 0.0;
+        if (position >= historical_.size()) return 1.0;
+        size_t bucket = static_cast<size_t>(position);
+        return prefix_[bucket] + historical_[bucket] * (position - bucket);
+    }
+    
+    size_t bucket_count() const { return historical_.size(); }
+    uint64_t today_volume(size_t bucket) const { return bucket < today_.size() ? today_[bucket] : 0; }
+};
+
 // Standard Deviation Calculator (for volatility)
 class StandardDeviation {
 private:
@@ -0,0 +1,88 @@
+// symbol_table.hpp - Process-wide symbol name <-> SymbolId registry
+#pragma once
+
+#include <atomic>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "messages.hpp"
+
+namespace hft {
+
+/**
+ * Symbol Table
+ *
+ * Interns instrument names into dense SymbolIds so hot paths can index
+ * flat arrays instead of hashing strings. Symbols are registered at
+ * startup (or rarely afterwards); registration takes a mutex, while
+ * name() lookups by id are lock-free because the name storage is sized
+ * once and never reallocated.
+ */
+class SymbolTable {
+public:
+    static constexpr size_t MAX_SYMBOLS = 8192;
+    static constexpr SymbolId INVALID_SYMBOL = 0xFFFF;
+
+private:
+    std::vector<std::string> names_;
+    std::unordered_map<std::string, SymbolId> ids_;
+    std::atomic<size_t> count_{0};
+    mutable std::mutex mutex_;
+
+public:
+    SymbolTable() : names_(MAX_SYMBOLS) {}
+
+    static SymbolTable& instance() {
+        static SymbolTable table;
+        return table;
+    }
+
+    /**
+     * Register a symbol (or return its existing id)
+     *
+     * @return Dense id, or INVALID_SYMBOL if the table is full
+     */
+    SymbolId intern(const std::string& symbol) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = ids_.find(symbol);
+        if (it != ids_.end()) {
+            return it->second;
+        }
+
+        const size_t id = count_.load(std::memory_order_relaxed);
+        if (id >= MAX_SYMBOLS) {
+            return INVALID_SYMBOL;
+        }
+
+        names_[id] = symbol;
+        ids_.emplace(symbol, static_cast<SymbolId>(id));
+        count_.store(id + 1, std::memory_order_release);
+        return static_cast<SymbolId>(id);
+    }
+
+    /**
+     * Look up a registered symbol (cold path - takes the registry mutex)
+     *
+     * @return Symbol id, or INVALID_SYMBOL if unknown
+     */
+    SymbolId find(const std::string& symbol) const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = ids_.find(symbol);
+        return it != ids_.end() ? it->second : INVALID_SYMBOL;
+    }
+
+    /**
+     * Name of a registered symbol (lock-free)
+     */
+    const std::string& name(SymbolId id) const {
+        static const std::string unknown = "UNKNOWN";
+        return id < count_.load(std::memory_order_acquire) ? names_[id] : unknown;
+    }
+
+    size_t size() const {
+        return count_.load(std::memory_order_acquire);
+    }
+};
+
+} // namespace hft
@@ -1,11 +1,35 @@
 #include <iostream>
 #include <cassert>
 #include <cmath>
+#include <thread>
+#include <filesystem>
+#include <random>
+#include <sys/wait.h>
 #include "strategies/technical_indicators.hpp"
 #include "strategies/intraday_risk_manager.hpp"
 #include "strategies/intraday_strategies.hpp"
 #include "strategies/enhanced_feed_handler.hpp"
+#include "strategies/session_clock.hpp"
+#include "strategies/strategy_host.hpp"
+#include "strategies/backtest_engine.hpp"
+#include "strategies/execution_pipeline.hpp"
+#include "strategies/simulated_gateway.hpp"
+#include "strategies/session_recovery.hpp"
+#include "risk/enhanced_risk_manager.hpp"
+#include "risk/comprehensive_risk_manager.hpp"
+#include "risk/risk_pipeline.hpp"
+#include "risk/covariance_engine.hpp"
+#include "risk/var_engine.hpp"
+#include "risk/stress_matrix.hpp"
+#include "risk/risk_event_coalescer.hpp"
 #include "messages.hpp"
+#include "kill_switch.hpp"
+#include "io_service.hpp"
+#include "logger.hpp"
+#include "latency_histogram.hpp"
+#include "metrics_registry.hpp"
+#include "metrics_segment.hpp"
+#include "monitor/monitoring_integration.hpp"
 #include "position_tracker.hpp"
 
 using namespace hft::indicators;
@@ -137,6 +161,2003 @@ void test_signal_generation() {
     print_test_result("Signal Structure Validation", signal_valid);
 }
 
+// Test session clock windows against virtual time
+void test_session_clock() {
+    SessionCalendar calendar;
+    calendar.add_day(20261127, SessionCalendar::DayType::HALF_DAY, 13 * 60);
+    calendar.add_day(20261225, SessionCalendar::DayType::CLOSED);
+    SessionClock clock(calendar);
+    
+    // 2026-10-15 13:45 UTC = 09:45 EDT (Thursday)
+    clock.set_virtual_time(1792071900ULL * 1000000000ULL);
+    SessionTime t = clock.current();
+    bool opening = (t.hour() == 9 && t.minute() == 45 && t.date() == 20261015 &&
+                    t.is_opening_hour() && !t.is_regular_hours());
+    
+    // Advance to 15:45 UTC = 11:45 EDT
+    clock.advance_to((1792071900ULL + 2 * 3600) * 1000000000ULL);
+    t = clock.current();
+    bool midday = (t.hour() == 11 && t.is_between_1030_and_1500() && t.is_regular_hours());
+    print_test_result("Session Clock - EDT Windows", opening && midday);
+    
+    // 2026-11-27 19:00 UTC = 14:00 EST on a half day (closed at 13:00)
+    clock.advance_to(1795806000ULL * 1000000000ULL);
+    t = clock.current();
+    bool half_day = (t.hour() == 14 && t.is_half_day() && !t.is_session_open() &&
+                     !t.is_regular_hours());
+    
+    // 2026-12-25 16:00 UTC = 11:00 EST on a holiday
+    clock.advance_to(1798214400ULL * 1000000000ULL);
+    t = clock.current();
+    bool holiday = (t.hour() == 11 && t.is_closed_day() && !t.is_regular_hours());
+    print_test_result("Session Clock - Calendar Half Day and Holiday", half_day && holiday);
+}
+
+// Test rolling window statistics and multi-pair divergence
+void test_pair_divergence() {
+    RollingMeanVariance rolling(20);
+    RollingCorrelation corr(20);
+    std::vector<double> window;
+    for (int i = 0; i < 500; i++) {
+        double x = 0.2 + 0.001 * std::sin(i * 0.7) + 0.0001 * (i % 7);
+        rolling.add(x);
+        corr.add(x, 2.0 * x + 1.0);
+        window.push_back(x);
+        if (window.size() > 20) window.erase(window.begin());
+    }
+    double mean = 0.0, var = 0.0;
+    for (double x : window) mean += x;
+    mean /= window.size();
+    for (double x : window) var += (x - mean) * (x - mean);
+    var /= window.size();
+    
+    bool stats_match = std::abs(rolling.mean() - mean) < 1e-12 &&
+                       std::abs(rolling.variance() - var) < 1e-12 &&
+                       std::abs(corr.correlation() - 1.0) < 1e-9;
+    print_test_result("Rolling Mean/Variance/Correlation", stats_match);
+    
+    PairDivergenceStrategy::PairConfig config;
+    config.correlation_threshold = 0.5;
+    PairDivergenceStrategy pairs(config);
+    pairs.add_pair("AAPL", "QQQ");
+    
+    auto tick = [&pairs](const std::string& symbol, double price) {
+        EnhancedMarketData data;
+        data.symbol = symbol;
+        data.last = price;
+        data.bid = price - 0.01;
+        data.ask = price + 0.01;
+        pairs.update_pair_data(data);
+    };
+    
+    // Co-moving legs with small ratio noise, then an SPY-only jump
+    for (int i = 0; i < 60; i++) {
+        double drift = 1.0 + 0.002 * std::sin(i * 0.3);
+        tick("SPY", 450.0 * drift * (1.0 + 0.0001 * (i % 3)));
+        tick("QQQ", 375.0 * drift);
+        tick("AAPL", 175.0 * drift);
+        pairs.evaluate();
+    }
+    tick("SPY", 450.0 * 1.01);
+    tick("QQQ", 375.0);
+    Signal signal = pairs.evaluate();
+    
+    bool diverged = signal.is_valid && signal.symbol == "SPY/QQQ" &&
+                    signal.direction == Signal::SHORT && pairs.pair_count() == 2;
+    print_test_result("Pair Divergence - Multi-Pair Z-Score Signal", diverged);
+}
+
+void test_strategy_host() {
+    hft::SPSCQueue<StrategyTick, 8> queue;
+    StrategyTick in{};
+    in.symbol = 3;
+    bool fifo = true;
+    for (int i = 0; i < 8; i++) {
+        in.timestamp_ns = i;
+        fifo &= queue.push(in);
+    }
+    fifo &= !queue.push(in);
+    StrategyTick out[8];
+    fifo &= queue.pop_batch(out, 8) == 8 && out[0].timestamp_ns == 0 && out[7].timestamp_ns == 7;
+    
+    StrategyHostConfig config;
+    config.num_shards = 3;
+    StrategyHost host(config);
+    for (const char* symbol : {"SPY", "QQQ", "AAPL", "XLF", "KRE", "MSFT"}) {
+        host.add_symbol(symbol);
+    }
+    host.add_pair("SPY", "QQQ");
+    host.add_pair("XLF", "KRE");
+    host.start();
+    bool colocated = host.shard_of("SPY") == host.shard_of("QQQ") &&
+                     host.shard_of("XLF") == host.shard_of("KRE") &&
+                     host.shard_of("SPY") != host.shard_of("XLF");
+    host.stop();
+
+    print_test_result("Strategy Host - Ring FIFO and Pair Colocation", fifo && colocated);
+
+    // 2026-10-15 15:45 UTC = 11:45 EDT: pairs run, VWAP reversion needs a VWAP
+    SessionClock clock;
+    clock.set_virtual_time(1792079100ULL * 1000000000ULL);
+
+    auto run_host = [&clock](StrategyHostConfig::PairPlacement placement,
+                             std::vector<OrderIntent>& intents, int& spy_shard, int& qqq_shard) {
+        StrategyHostConfig host_config;
+        host_config.num_shards = 3;
+        host_config.pair_placement = placement;
+        StrategyHost pair_host(host_config, &clock);
+        pair_host.add_symbol("MSFT");
+        pair_host.add_pair("SPY", "QQQ");
+        pair_host.start();
+        spy_shard = pair_host.shard_of("SPY");
+        qqq_shard = pair_host.shard_of("QQQ");
+
+        auto tick = [&pair_host](const char* symbol, double price) {
+            EnhancedMarketData data;
+            data.symbol = symbol;
+            data.last = price;
+            data.bid = price - 0.01;
+            data.ask = price + 0.01;
+            pair_host.dispatch(data);
+        };
+
+        // Strongly co-moving legs with tiny ratio noise, then a SPY-only jump
+        for (int i = 0; i <= 60; i++) {
+            double drift = 1.0 + 0.05 * std::sin(i * 0.3);
+            double noise = i < 60 ? 1e-5 * (i % 3) : 0.01;
+            tick("MSFT", 420.0 * drift);
+            tick("SPY", 450.0 * drift * (1.0 + noise));
+            tick("QQQ", 375.0 * drift);
+        }
+
+        OrderIntent intent;
+        for (int spins = 0; spins < 2000 && intents.empty(); spins++) {
+            while (pair_host.poll_intent(intent)) intents.push_back(intent);
+            if (intents.empty()) std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        pair_host.stop();
+        while (pair_host.poll_intent(intent)) intents.push_back(intent);
+    };
+
+    auto pair_intent = [](const std::vector<OrderIntent>& intents, int shard) {
+        const hft::SymbolId spy = hft::SymbolTable::instance().find("SPY");
+        const hft::SymbolId qqq = hft::SymbolTable::instance().find("QQQ");
+        return intents.size() == 1 &&
+               intents[0].symbol == spy && intents[0].hedge_symbol == qqq &&
+               intents[0].strategy == StrategyKind::PAIR_DIVERGENCE &&
+               intents[0].direction == Signal::SHORT &&
+               intents[0].shard == shard;
+    };
+
+    std::vector<OrderIntent> colocated_intents, replicated_intents;
+    int spy_shard = -1, qqq_shard = -1;
+    run_host(StrategyHostConfig::PairPlacement::COLOCATE, colocated_intents, spy_shard, qqq_shard);
+    bool colocate_path = spy_shard == qqq_shard && pair_intent(colocated_intents, spy_shard);
+
+    run_host(StrategyHostConfig::PairPlacement::REPLICATE, replicated_intents, spy_shard, qqq_shard);
+    bool replicate_path = spy_shard >= 0 && qqq_shard >= 0 && spy_shard != qqq_shard &&
+                          pair_intent(replicated_intents, spy_shard);
+
+    print_test_result("Strategy Host - Tick Dispatch to Intents, Colocated and Replicated",
+                      colocate_path && replicate_path);
+}
+
+void test_execution_pipeline() {
+    SessionClock clock;
+    clock.set_virtual_time(1773754200ULL * 1000000000ULL + 3600ULL * 1000000000ULL); // 10:30 EDT
+    IntradayRiskManager risk(nullptr, &clock, false);
+    SimpleExecutor executor(&clock, 7);
+    hft::OrderManager oms(64);
+    SimulatedGateway gateway(oms, executor, &clock);
+    ExecutionPipeline pipeline(risk, oms, &clock);
+    
+    auto pump = [&]() {
+        oms.poll();
+        gateway.poll();
+        oms.poll();
+        pipeline.poll();
+    };
+    auto quote = [&](const std::string& symbol, double bid, double ask, double last) {
+        gateway.on_market_data(symbol, bid, ask);
+        pipeline.on_market_data(symbol, bid, ask, last);
+        pump();
+    };
+    
+    std::vector<ExitReason> exits;
+    pipeline.set_exit_callback([&exits](const ManagedPosition&, const OrderResult&, double, ExitReason reason) {
+        exits.push_back(reason);
+    });
+    // Fills reach the book as they happen, not when the trade closes
+    std::unordered_map<hft::SymbolId, double> booked;
+    pipeline.set_fill_callback([&booked](hft::Venue, hft::SymbolId symbol, double quantity, double) {
+        booked[symbol] += quantity;
+    });
+    
+    Signal signal("VWAP_REVERSION", "SPY");
+    signal.is_valid = true;
+    signal.direction = Signal::LONG;
+    signal.entry_price = 450.02;
+    signal.stop_price = 447.0;
+    signal.target_price = 452.0;
+    signal.stop_distance_points = 3.02;
+    signal.confidence = 0.8;
+    signal.hold_time_ms = 60000;
+    
+    quote("SPY", 450.00, 450.02, 450.01);
+    bool entered = pipeline.on_signal(signal) == SignalOutcome::ENTERED &&
+                   pipeline.on_signal(signal) == SignalOutcome::POSITION_OPEN;
+    pump();
+    quote("SPY", 451.00, 451.02, 451.01);  // Between stop and target
+    bool held = exits.empty() && pipeline.open_positions() == 1 &&
+                booked[hft::SymbolTable::instance().intern("SPY")] > 0.0;
+    quote("SPY", 452.10, 452.12, 452.11);  // Target
+    
+    // Second position leaves on its hold-time deadline
+    signal.symbol = "QQQ/SPY";
+    signal.entry_price = 375.02;
+    signal.stop_price = 372.0;
+    signal.target_price = 378.0;
+    signal.stop_distance_points = 3.02;
+    clock.advance_to(clock.now_ns() + 400ULL * 1000000000ULL);  // Past the 5-minute trade spacing
+    quote("QQQ", 375.00, 375.02, 375.01);
+    bool pair_leg = pipeline.on_signal(signal) == SignalOutcome::ENTERED;
+    pump();
+    pipeline.on_timer(clock.now_ns() + 30ULL * 1000000000ULL);
+    pump();
+    bool early = exits.size() == 1;
+    pipeline.on_timer(clock.now_ns() + 61ULL * 1000000000ULL);
+    pump();
+    
+    bool passed = entered && held && pair_leg && early && exits.size() == 2 &&
+                  exits[0] == ExitReason::TARGET && exits[1] == ExitReason::TIME &&
+                  pipeline.open_positions() == 0 && risk.get_trades_today() == 2 &&
+                  oms.open_orders() == 0 && booked.size() == 2;
+    for (const auto& [symbol, quantity] : booked) passed &= std::abs(quantity) < 1e-9;
+    print_test_result("Execution Pipeline - Price and Timer Exits", passed);
+}
+
+void test_order_manager() {
+    // Open-order table: colliding inserts, erase with backward shift, reuse
+    hft::OrderTable table(8);
+    bool table_ok = true;
+    for (hft::OrderId id = 1; id <= 8; id++) table_ok &= table.insert(id * 16) != nullptr;
+    table_ok &= table.insert(999) == nullptr && table.size() == 8;   // Pool exhausted
+    table_ok &= table.erase(48) && !table.erase(48) && table.find(48) == nullptr;
+    for (hft::OrderId id = 1; id <= 8; id++) table_ok &= (id == 3) == (table.find(id * 16) == nullptr);
+    table_ok &= table.insert(48) != nullptr && table.insert(48) == nullptr;
+    
+    // Lifecycle: strategy -> OMS -> venue -> OMS -> strategy, driven by hand
+    hft::OrderManager oms(16);
+    hft::SymbolId spy = hft::SymbolTable::instance().intern("SPY");
+    hft::OrderRequest request{};
+    request.action = hft::OrderRequest::Action::NEW;
+    request.order_id = oms.reserve_order_id();
+    request.client_tag = 77;
+    request.symbol = spy;
+    request.side = hft::Side::BUY;
+    request.type = hft::OrderType::LIMIT;
+    request.price = hft::to_fixed_price(450.0);
+    request.quantity = hft::to_fixed_quantity(100);
+    oms.submit(request);
+    oms.poll();
+    
+    hft::SequencedMessage msg;
+    bool sent = oms.poll_outbound(msg) && msg.type == hft::MessageType::NEW_ORDER &&
+                msg.order.order_id == request.order_id;
+    
+    auto reply = [&](hft::MessageType type, uint8_t flags = 0) {
+        hft::SequencedMessage response = msg;
+        response.type = type;
+        response.order.flags = flags;
+        oms.deliver(response);
+        oms.poll();
+    };
+    auto fill = [&](double qty) {
+        hft::SequencedMessage response = msg;
+        response.type = hft::MessageType::FILL;
+        response.fill.order_id = request.order_id;
+        response.fill.fill_price = hft::to_fixed_price(450.0);
+        response.fill.fill_quantity = hft::to_fixed_quantity(qty);
+        response.fill.fee = 0;
+        oms.deliver(response);
+        oms.poll();
+    };
+    
+    reply(hft::MessageType::ORDER_ACK);
+    fill(40);
+    const hft::OrderRecord* order = oms.find(request.order_id);
+    bool partial = order && order->status == hft::OrderStatus::PARTIALLY_FILLED &&
+                   order->leaves() == hft::to_fixed_quantity(60) && order->acked_ns > 0;
+    
+    // Replace up to 150 total, then cancel the rest
+    request.action = hft::OrderRequest::Action::REPLACE;
+    request.price = hft::to_fixed_price(449.5);
+    request.quantity = hft::to_fixed_quantity(150);
+    oms.submit(request);
+    oms.poll();
+    bool replace_sent = oms.poll_outbound(msg) && msg.type == hft::MessageType::REPLACE_ORDER;
+    reply(hft::MessageType::ORDER_ACK, hft::OrderRecord::FLAG_REPLACE);
+    bool replaced = order->price == hft::to_fixed_price(449.5) && order->leaves() == hft::to_fixed_quantity(110);
+    
+    request.action = hft::OrderRequest::Action::CANCEL;
+    oms.submit(request);
+    oms.poll();
+    bool cancel_sent = oms.poll_outbound(msg) && msg.type == hft::MessageType::CANCEL_ORDER;
+    reply(hft::MessageType::CANCEL_ACK, hft::OrderRecord::FLAG_CANCEL);
+    
+    std::vector<hft::OrderUpdate> updates;
+    hft::OrderUpdate update;
+    while (oms.poll_update(update)) updates.push_back(update);
+    bool lifecycle = updates.size() == 4 &&
+                     updates[0].event == hft::MessageType::ORDER_ACK &&
+                     updates[1].event == hft::MessageType::FILL && updates[1].client_tag == 77 &&
+                     updates[2].flags == hft::OrderRecord::FLAG_REPLACE &&
+                     updates[3].status == hft::OrderStatus::CANCELLED &&
+                     updates[3].filled_quantity == hft::to_fixed_quantity(40) &&
+                     oms.open_orders() == 0;
+    
+    // Replace down to 60 races a fill of 60: the replace ack completes the order
+    request.action = hft::OrderRequest::Action::NEW;
+    request.order_id = oms.reserve_order_id();
+    request.quantity = hft::to_fixed_quantity(100);
+    oms.submit(request);
+    oms.poll();
+    oms.poll_outbound(msg);
+    reply(hft::MessageType::ORDER_ACK);
+    request.action = hft::OrderRequest::Action::REPLACE;
+    request.quantity = hft::to_fixed_quantity(60);
+    oms.submit(request);
+    oms.poll();
+    oms.poll_outbound(msg);
+    fill(60);
+    reply(hft::MessageType::ORDER_ACK, hft::OrderRecord::FLAG_REPLACE);
+    
+    updates.clear();
+    while (oms.poll_update(update)) updates.push_back(update);
+    bool raced_replace = updates.size() == 3 &&
+                         updates[1].status == hft::OrderStatus::PARTIALLY_FILLED &&
+                         updates[2].flags == hft::OrderRecord::FLAG_REPLACE &&
+                         updates[2].status == hft::OrderStatus::FILLED && updates[2].is_terminal() &&
+                         updates[2].filled_quantity == hft::to_fixed_quantity(60) &&
+                         updates[2].leaves_quantity == 0 && oms.open_orders() == 0;
+    
+    print_test_result("Order Manager - Table, Partial Fill, Replace and Cancel",
+                      table_ok && sent && partial && replace_sent && replaced && cancel_sent && lifecycle &&
+                      raced_replace);
+    
+    // More fills than the update ring holds while the strategy is not draining:
+    // the OMS holds the overflowing fill and back-pressures the venue ring
+    constexpr size_t fills = hft::OrderManager::UPDATE_RING_SIZE + 1000;
+    hft::OrderManager slow(16);
+    request.action = hft::OrderRequest::Action::NEW;
+    request.order_id = slow.reserve_order_id();
+    request.quantity = hft::to_fixed_quantity(static_cast<double>(fills));
+    slow.submit(request);
+    slow.poll();
+    slow.poll_outbound(msg);
+    
+    hft::SequencedMessage partial_fill = msg;
+    partial_fill.type = hft::MessageType::PARTIAL_FILL;
+    partial_fill.fill.order_id = request.order_id;
+    partial_fill.fill.fill_price = hft::to_fixed_price(450.0);
+    partial_fill.fill.fill_quantity = hft::to_fixed_quantity(1);
+    partial_fill.fill.fee = 0;
+    
+    size_t delivered = 0;
+    bool stalled = false;
+    while (!stalled) {
+        while (delivered < fills && slow.deliver(partial_fill)) ++delivered;
+        stalled = slow.poll() == 0;
+    }
+    stalled &= slow.get_stats().held_updates == 1;
+    
+    size_t fill_updates = 0;
+    bool terminal = false;
+    do {
+        while (slow.poll_update(update)) {
+            fill_updates += update.event == hft::MessageType::PARTIAL_FILL;
+            terminal = update.status == hft::OrderStatus::FILLED;
+        }
+        while (delivered < fills && slow.deliver(partial_fill)) ++delivered;
+    } while (slow.poll() > 0 || delivered < fills);
+    while (slow.poll_update(update)) {
+        fill_updates += update.event == hft::MessageType::PARTIAL_FILL;
+        terminal = update.status == hft::OrderStatus::FILLED;
+    }
+    
+    bool no_drops = stalled && fill_updates == fills && terminal &&
+                    slow.get_stats().dropped_updates == 0 && slow.open_orders() == 0;
+    print_test_result("Order Manager - Fill and Terminal Updates Held, Never Dropped", no_drops);
+    
+    // More orders than the venue ring holds with the gateway drained on this thread:
+    // poll() holds the overflowing order and returns instead of spinning on the ring
+    const size_t orders = hft::OrderManager::VENUE_RING_SIZE + 100;
+    hft::OrderManager stuck(2 * hft::OrderManager::VENUE_RING_SIZE);
+    request.quantity = hft::to_fixed_quantity(1);
+    size_t queued = 0;
+    for (int round = 0; round < 3; ++round) {
+        while (queued < orders) {
+            request.order_id = stuck.reserve_order_id();
+            if (!stuck.submit(request)) break;
+            ++queued;
+        }
+        stuck.poll();
+    }
+    bool held = queued == orders && stuck.get_stats().held_outbound == 1;
+    
+    size_t sent_out = 0;
+    hft::OrderId last_sent = 0;
+    bool in_order = true;
+    do {
+        while (stuck.poll_outbound(msg)) {
+            in_order &= msg.order.order_id > last_sent;
+            last_sent = msg.order.order_id;
+            ++sent_out;
+        }
+    } while (stuck.poll() > 0);
+    held &= in_order && sent_out == orders && stuck.get_stats().orders_sent == orders;
+    print_test_result("Order Manager - Full Venue Ring Holds the Order, Never Spins", held);
+}
+
+void test_smart_order_router() {
+    hft::SmartOrderRouter router;
+    hft::VenueFees standard;
+    hft::VenueFees discount;
+    discount.taker_fee = 0.00025;
+    router.add_venue(hft::Venue::NYSE, standard, 100000);     // 3.0 + 0.1 bps
+    router.add_venue(hft::Venue::BATS, discount, 1000000);    // 2.5 + 1.0 bps
+    router.add_venue(hft::Venue::NASDAQ, standard, 50000);    // 3.0 + 0.05 bps, one tick worse
+    
+    const hft::SymbolId sym = hft::SymbolTable::instance().intern("SPY");
+    const uint64_t now = 1000000000000ULL;
+    router.on_quote(hft::Venue::NYSE, sym, 99.98, 100.00, 300, 200, now);
+    router.on_quote(hft::Venue::BATS, sym, 99.98, 100.00, 300, 200, now);
+    router.on_quote(hft::Venue::NASDAQ, sym, 99.99, 100.01, 300, 1000, now);
+    
+    hft::RouteDecision split = router.route(sym, hft::Side::BUY, 500, 0.0, now);
+    bool ranked = split.count == 3 &&
+                  split.slices[0].venue == hft::Venue::NYSE && split.slices[0].quantity == 200 &&
+                  split.slices[1].venue == hft::Venue::BATS && split.slices[1].quantity == 200 &&
+                  split.slices[2].venue == hft::Venue::NASDAQ && split.slices[2].quantity == 100 &&
+                  split.routed_quantity == 500;
+    
+    // Limit excludes the worse venue; the residual goes to the best venue
+    hft::RouteDecision limited = router.route(sym, hft::Side::BUY, 500, 100.00, now);
+    bool limit_ok = limited.count == 2 && limited.slices[0].quantity == 300 && limited.slices[1].quantity == 200;
+    
+    // A slow measured round trip pushes NYSE behind BATS
+    router.record_round_trip(hft::Venue::NYSE, 5000000);
+    hft::RouteDecision slowed = router.route(sym, hft::Side::BUY, 100, 0.0, now);
+    bool latency_aware = slowed.count == 1 && slowed.slices[0].venue == hft::Venue::BATS;
+    
+    // Venue selection ranks the same way but books no routed slices
+    const uint64_t bats_slices = router.venue_state(hft::Venue::BATS).routed_slices;
+    hft::Venue picked = hft::Venue::NYSE;
+    bool selection = router.best_venue(sym, hft::Side::BUY, 0.0, now, picked) &&
+                     picked == hft::Venue::BATS &&
+                     router.venue_state(hft::Venue::BATS).routed_slices == bats_slices &&
+                     !router.best_venue(sym, hft::Side::BUY, 0.0, now + 3000000000ULL, picked);
+    
+    // Stale quotes drop out; the consolidated touch follows the fresh venues
+    router.on_quote(hft::Venue::NASDAQ, sym, 99.99, 100.01, 300, 1000, now + 3000000000ULL);
+    hft::RouteDecision stale = router.route(sym, hft::Side::SELL, 100, 0.0, now + 3000000000ULL);
+    bool freshness = stale.count == 1 && stale.slices[0].venue == hft::Venue::NASDAQ &&
+                     router.best_ask(sym, now) == 100.00 && router.best_bid(sym, now + 3000000000ULL) == 99.99;
+    
+    print_test_result("Smart Order Router - Cost Ranking, Depth, Latency and Staleness",
+                      ranked && limit_ok && latency_aware && selection && freshness);
+}
+
+void test_execution_algos() {
+    // Timer wheel: every timer fires exactly once, no earlier than due and within one tick
+    hft::TimerWheel wheel(1000, 64, 4096);
+    std::vector<uint64_t> due(3000);
+    std::vector<int> fired(due.size(), 0);
+    bool on_time = true;
+    for (size_t i = 0; i < due.size(); i++) {
+        due[i] = 1000 + (i * 7919) % 500000;       // Spans many rotations of the wheel
+        wheel.schedule(due[i], i);
+    }
+    bool cancelled = wheel.cancel(wheel.schedule(250000, 99999)) && wheel.size() == due.size();
+    for (uint64_t now = 0; now <= 520000; now += 3000) {
+        wheel.advance(now, [&](uint64_t i) {
+            fired[i]++;
+            on_time &= i < due.size() && due[i] <= now && now - due[i] < 3000 + 1000;
+        });
+    }
+    bool wheel_ok = cancelled && on_time && wheel.size() == 0 &&
+                    std::all_of(fired.begin(), fired.end(), [](int n) { return n == 1; });
+    
+    // Engine: TWAP, VWAP and POV parents through the OMS and a zero-latency venue
+    SessionClock clock;
+    clock.set_virtual_time(1773754200ULL * 1000000000ULL + 3600ULL * 1000000000ULL); // 10:30 EDT
+    SimpleExecutor executor(&clock, 11);
+    hft::OrderManager oms(8192);
+    SimulatedGateway gateway(oms, executor, &clock);
+    ExecutionAlgoEngine algos(oms, &clock, 4096);
+    
+    std::vector<ParentResult> done;
+    algos.set_done_callback([&done](const ParentResult& result) { done.push_back(result); });
+    auto pump = [&]() {
+        oms.poll();
+        gateway.poll();
+        oms.poll();
+        hft::OrderUpdate update;
+        while (oms.poll_update(update)) algos.on_order_update(update);
+    };
+    
+    const hft::SymbolId spy = hft::SymbolTable::instance().intern("SPY");
+    uint64_t volume = 0;
+    auto step = [&](uint64_t seconds) {
+        clock.advance_to(clock.now_ns() + seconds * 1000000000ULL);
+        volume += 5000;
+        gateway.on_market_data("SPY", 450.00, 450.02);
+        algos.on_market_data(spy, 450.00, 450.02, volume);
+        algos.on_timer(clock.now_ns());
+        pump();
+    };
+    step(1);
+    
+    ParentOrderSpec twap;
+    twap.symbol = spy;
+    twap.quantity = 100;
+    twap.duration_ns = 60ULL * 1000000000ULL;
+    twap.slice_interval_ns = 10ULL * 1000000000ULL;
+    twap.client_tag = 1;
+    algos.submit(twap);
+    
+    ParentOrderSpec vwap = twap;
+    vwap.algo = AlgoType::VWAP;
+    vwap.client_tag = 2;
+    algos.submit(vwap);
+    
+    ParentOrderSpec pov = twap;
+    pov.algo = AlgoType::POV;
+    pov.quantity = 1000000;                        // Unreachable: runs to its end time
+    pov.participation = 0.1;
+    pov.client_tag = 3;
+    const uint64_t pov_volume_base = volume;
+    algos.submit(pov);
+    
+    // Many concurrent parents share the wheel
+    ParentOrderSpec many = twap;
+    many.quantity = 10;
+    many.client_tag = 100;
+    for (int i = 0; i < 2000; i++) algos.submit(many);
+    bool concurrent = algos.active_parents() == 2003;
+    
+    step(30);
+    const uint64_t halfway = oms.get_stats().fills;
+    bool twap_paced = halfway > 0 && done.empty();
+    for (int i = 0; i < 8; i++) step(10);
+    
+    auto result_for = [&done](uint64_t tag) -> const ParentResult* {
+        for (const auto& r : done) if (r.client_tag == tag) return &r;
+        return nullptr;
+    };
+    const ParentResult* t = result_for(1);
+    const ParentResult* v = result_for(2);
+    const ParentResult* p = result_for(3);
+    bool schedules = t && v && p &&
+                     t->filled == hft::to_fixed_quantity(100) && t->children >= 4 &&
+                     v->filled == hft::to_fixed_quantity(100) && v->children >= 3;
+    // POV filled its share of the volume traded during its 60s window (4 updates of 5000)
+    bool participation = p && pov_volume_base > 0 &&
+                         std::abs(hft::to_float_quantity(p->filled) - 0.1 * 4 * 5000) <= 0.1 * 5000;
+    bool drained = done.size() == 2003 && algos.active_parents() == 0 && algos.pending_timers() == 0 &&
+                   oms.open_orders() == 0;
+    
+    print_test_result("Execution Algos - Timer Wheel, TWAP/VWAP/POV and 2000 Parents",
+                      wheel_ok && concurrent && twap_paced && schedules && participation && drained);
+}
+
+void test_rate_limiter() {
+    const uint64_t t0 = 1000000000000ULL;
+    
+    // Token bucket: burst back to back, then one token per interval
+    hft::TokenBucket bucket({10.0, 5.0});
+    int burst = 0;
+    while (bucket.try_acquire(t0)) burst++;
+    bool refill = !bucket.try_acquire(t0 + 50000000) && bucket.try_acquire(t0 + 100000000) &&
+                  !bucket.try_acquire(t0 + 100000000);
+    bool bucket_ok = burst == 5 && refill;
+    
+    // Threads share one bucket without a lock and never overdraw it
+    hft::TokenBucket shared({1000.0, 1000.0});
+    std::atomic<int> granted{0};
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; t++) {
+        threads.emplace_back([&]() {
+            for (int i = 0; i < 1000; i++) {
+                if (shared.try_acquire(t0)) granted.fetch_add(1);
+            }
+        });
+    }
+    for (auto& thread : threads) thread.join();
+    bool concurrent_ok = granted.load() == 1000;
+    
+    // Limits change while threads acquire: a decision never mixes the old rate with the new
+    // burst (1 ms x 1 s of tolerance would let ~1000 through at one instant)
+    hft::TokenBucket live({1000.0, 10.0});
+    std::atomic<bool> reconfiguring{true};
+    std::atomic<int> live_granted{0};
+    std::thread reconfigure([&]() {
+        for (int i = 0; reconfiguring.load(); i++) {
+            live.configure(i & 1 ? hft::RateLimit{1.0, 1.0} : hft::RateLimit{1000.0, 10.0});
+        }
+    });
+    threads.clear();
+    for (int t = 0; t < 3; t++) {
+        threads.emplace_back([&]() {
+            for (int i = 0; i < 20000; i++) {
+                if (live.try_acquire(t0)) live_granted.fetch_add(1);
+            }
+        });
+    }
+    for (auto& thread : threads) thread.join();
+    reconfiguring.store(false);
+    reconfigure.join();
+    concurrent_ok &= live_granted.load() >= 1 && live_granted.load() <= 10;
+    
+    // Sliding window: 3 per second, counted in 100ms buckets
+    hft::SlidingWindowCounter<10> window(3, 1000000000ULL);
+    bool window_ok = window.try_acquire(t0) && window.try_acquire(t0 + 300000000) &&
+                     window.try_acquire(t0 + 600000000) && !window.try_acquire(t0 + 900000000) &&
+                     window.try_acquire(t0 + 1000000000) && window.count(t0 + 1000000000) == 3 &&
+                     window.count(t0 + 5000000000ULL) == 0;
+
+    // Leased acquires take 4 at a time and spend locally; the window never overshoots
+    hft::SlidingWindowCounter<10> leased(10, 1000000000ULL);
+    hft::SlidingWindowCounter<10>::Lease a, b, c;
+    bool lease_ok = leased.try_acquire(t0, a, 4) && leased.count(t0) == 4;
+    for (int i = 0; i < 3; i++) lease_ok &= leased.try_acquire(t0, a, 4);
+    lease_ok &= leased.count(t0) == 4 && leased.try_acquire(t0, b, 4) &&
+                leased.try_acquire(t0, c, 4) && leased.count(t0) == 10 &&
+                leased.try_acquire(t0, c, 4) && !leased.try_acquire(t0, c, 4) &&
+                !leased.try_acquire(t0, a, 4) && leased.count(t0) == 10 &&
+                leased.try_acquire(t0 + 1000000000, a, 4) && leased.count(t0 + 1000000000) == 4;
+    window_ok &= lease_ok;
+
+    // Hierarchy: a venue refusal refunds the strategy bucket
+    hft::HierarchicalRateLimiter limiter;
+    limiter.set_strategy_limit(1, {1.0, 2.0});
+    limiter.set_venue_limit(hft::Venue::NYSE, {1.0, 1.0});
+    using Result = hft::HierarchicalRateLimiter::Result;
+    bool hierarchy_ok = limiter.try_acquire(1, hft::Venue::NYSE, t0) == Result::ALLOWED &&
+                        limiter.try_acquire(1, hft::Venue::NYSE, t0) == Result::VENUE_LIMITED &&
+                        limiter.try_acquire(1, hft::Venue::NASDAQ, t0) == Result::ALLOWED &&
+                        limiter.try_acquire(1, hft::Venue::NASDAQ, t0) == Result::STRATEGY_LIMITED &&
+                        limiter.try_acquire(2, hft::Venue::NASDAQ, t0) == Result::ALLOWED;
+    
+    // OMS refuses new orders over budget but always accepts cancels
+    hft::OrderManager oms(64);
+    hft::HierarchicalRateLimiter oms_limiter;
+    oms_limiter.set_global_limit({1.0, 1.0});
+    oms.set_rate_limiter(&oms_limiter);
+    hft::OrderRequest request{};
+    request.action = hft::OrderRequest::Action::NEW;
+    request.order_id = oms.reserve_order_id();
+    request.timestamp_ns = t0;
+    request.quantity = hft::to_fixed_quantity(10);
+    request.venue = hft::Venue::NYSE;
+    bool first = oms.submit(request);
+    request.order_id = oms.reserve_order_id();
+    bool second = oms.submit(request);
+    request.action = hft::OrderRequest::Action::CANCEL;
+    bool cancel = oms.submit(request);
+    bool oms_ok = first && !second && cancel && oms.rate_limited() == 1;
+    
+    // A request refused by a full request ring gives its token back
+    hft::OrderManager backed_up(64);
+    hft::HierarchicalRateLimiter ring_limiter;
+    ring_limiter.set_global_limit({1.0, 10000.0});
+    backed_up.set_rate_limiter(&ring_limiter);
+    request.action = hft::OrderRequest::Action::NEW;
+    size_t queued = 0;
+    while (queued < 10000) {
+        request.order_id = backed_up.reserve_order_id();
+        if (!backed_up.submit(request)) break;
+        queued++;
+    }
+    for (int i = 0; i < 100; i++) backed_up.submit(request);
+    bool refunded = queued < 10000 && backed_up.rate_limited() == 0 &&
+                    ring_limiter.global_available(t0) == 10000.0 - queued;
+    
+    // ... and so does every leg of a batch refused by the full ring
+    hft::OrderRequest legs[4] = {request, request, request, request};
+    legs[3].action = hft::OrderRequest::Action::CANCEL;
+    for (int i = 0; i < 100; i++) refunded &= !backed_up.submit_batch(legs, 4);
+    refunded &= backed_up.rate_limited() == 0 &&
+                ring_limiter.global_available(t0) == 10000.0 - queued;
+    
+    print_test_result("Rate Limiter - Token Bucket, Sliding Window, Hierarchy and OMS",
+                      bucket_ok && concurrent_ok && window_ok && hierarchy_ok && oms_ok && refunded);
+}
+
+void test_basket_orders() {
+    SessionClock clock;
+    clock.set_virtual_time(1773754200ULL * 1000000000ULL + 3600ULL * 1000000000ULL); // 10:30 EDT
+    SimpleExecutor executor(&clock, 7);
+    hft::OrderManager oms(64);
+    SimulatedGateway gateway(oms, executor, &clock);
+    hft::BasketRiskLimits limits;
+    limits.max_leg_failure_exposure = 1500.0;
+    hft::BasketManager baskets(oms, limits);
+    
+    std::vector<hft::BasketResult> done;
+    baskets.set_done_callback([&done](const hft::BasketResult& result) { done.push_back(result); });
+    auto pump = [&](int rounds) {
+        for (int i = 0; i < rounds; i++) {
+            oms.poll();
+            gateway.poll();
+            oms.poll();
+            hft::OrderUpdate update;
+            while (oms.poll_update(update)) baskets.on_order_update(update);
+        }
+    };
+    auto& symbols = hft::SymbolTable::instance();
+    const hft::SymbolId a = symbols.intern("BSKT_A");
+    const hft::SymbolId b = symbols.intern("BSKT_B");
+    const hft::SymbolId c = symbols.intern("BSKT_C");
+    gateway.on_market_data("BSKT_A", 100.00, 100.02);
+    gateway.on_market_data("BSKT_B", 50.00, 50.02);
+    
+    // Combined exposure in one pass: +1000 / -1000 / +500 -> worst single failure leaves 1000 + 500
+    hft::BasketOrder basket;
+    basket.add_leg(a, hft::Side::BUY, hft::Venue::NYSE, hft::to_fixed_quantity(10), 100.0);
+    basket.add_leg(b, hft::Side::SELL, hft::Venue::NYSE, hft::to_fixed_quantity(20), 50.0);
+    basket.add_leg(a, hft::Side::BUY, hft::Venue::NASDAQ, hft::to_fixed_quantity(5), 100.0);
+    hft::BasketExposure exposure = hft::basket_exposure(basket);
+    hft::BasketReject reject = hft::BasketReject::NONE;
+    bool risk_ok = exposure.gross == 2500.0 && exposure.net == 500.0 && exposure.worst_leg_failure == 1500.0 &&
+                   baskets.submit(basket, clock.now_ns(), &reject) != 0;
+    limits.max_leg_failure_exposure = 1000.0;
+    baskets.set_limits(limits);
+    risk_ok &= baskets.submit(basket, clock.now_ns(), &reject) == 0 &&
+               reject == hft::BasketReject::LEG_FAILURE_LIMIT;
+    
+    // All legs leave in one OMS pass and complete together
+    oms.poll();
+    gateway.poll();
+    bool back_to_back = gateway.get_stats().orders == 3;
+    pump(3);
+    bool completed = done.size() == 1 && done[0].status == hft::BasketStatus::COMPLETED &&
+                     done[0].legs[1].filled == hft::to_fixed_quantity(20);
+    
+    // A leg without a market is rejected: the filled leg is unwound
+    hft::BasketOrder unwind;
+    unwind.add_leg(a, hft::Side::BUY, hft::Venue::NYSE, hft::to_fixed_quantity(10), 100.0);
+    unwind.add_leg(c, hft::Side::SELL, hft::Venue::NYSE, hft::to_fixed_quantity(10), 50.0);
+    baskets.submit(unwind, clock.now_ns());
+    pump(3);
+    bool unwound = done.size() == 2 && done[1].status == hft::BasketStatus::UNWOUND &&
+                   done[1].legs[0].unwound == hft::to_fixed_quantity(10) && done[1].unwind_pnl() < 0.0;
+    
+    // HEDGE policy re-sends the missing leg; the re-send fills once the leg can trade
+    unwind.on_leg_failure = hft::LegFailurePolicy::HEDGE;
+    baskets.submit(unwind, clock.now_ns());
+    pump(1);
+    bool hedging = done.size() == 2 && baskets.active_baskets() == 1;
+    gateway.on_market_data("BSKT_C", 50.00, 50.02);
+    pump(3);
+    bool hedged = done.size() == 3 && done[2].status == hft::BasketStatus::COMPLETED &&
+                  baskets.get_stats().hedge_orders >= 1 && oms.open_orders() == 0;
+    
+    // Pipeline: a pair signal enters and exits both legs as baskets
+    IntradayRiskManager risk(nullptr, &clock, false);
+    ExecutionPipeline pipeline(risk, oms, &clock);
+    hft::BasketManager pair_baskets(oms);
+    pipeline.set_basket_manager(&pair_baskets);
+    double pnl = 0.0;
+    pipeline.set_exit_callback([&pnl](const ManagedPosition&, const OrderResult&, double net_pnl, ExitReason) {
+        pnl = net_pnl;
+    });
+    auto quote = [&](const std::string& symbol, double bid, double ask) {
+        gateway.on_market_data(symbol, bid, ask);
+        pipeline.on_market_data(symbol, bid, ask, (bid + ask) / 2);
+    };
+    auto pump_pipeline = [&]() {
+        for (int i = 0; i < 3; i++) {
+            oms.poll();
+            gateway.poll();
+            oms.poll();
+            pipeline.poll();
+        }
+    };
+    quote("BSKT_A", 100.00, 100.02);
+    quote("BSKT_B", 50.00, 50.02);
+    Signal signal("PAIR_DIVERGENCE", "BSKT_A/BSKT_B");
+    signal.is_valid = true;
+    signal.direction = Signal::LONG;
+    signal.entry_price = 100.02;
+    signal.stop_price = 99.0;
+    signal.target_price = 101.0;
+    signal.stop_distance_points = 1.02;
+    signal.confidence = 0.8;
+    signal.hold_time_ms = 60000;
+    bool pair_entered = pipeline.on_signal(signal) == SignalOutcome::ENTERED;
+    pump_pipeline();
+    bool pair_open = pipeline.open_positions() == 1 && pair_baskets.get_stats().completed == 1;
+    quote("BSKT_B", 49.50, 49.52);      // Hedge leg gains
+    quote("BSKT_A", 101.10, 101.12);    // Target on leg A
+    pump_pipeline();
+    bool pair_closed = pipeline.open_positions() == 0 && pair_baskets.get_stats().completed == 2 &&
+                       pair_baskets.get_stats().legs_sent == 4 && pnl > 0.0 && oms.open_orders() == 0;
+    
+    // A pair whose hedge leg cannot trade is unwound, and the unwind's cost reaches risk
+    clock.advance_to(clock.now_ns() + 400ULL * 1000000000ULL);  // Past the trade spacing
+    pipeline.on_market_data("BSKT_D", 25.00, 25.02, 25.01);    // Quoted to the pipeline, no venue market
+    const double pnl_before = risk.get_daily_pnl();
+    signal.symbol = "BSKT_A/BSKT_D";
+    bool failed_entry = pipeline.on_signal(signal) == SignalOutcome::ENTERED;
+    pump_pipeline();
+    failed_entry &= pipeline.open_positions() == 0 && pair_baskets.get_stats().unwound == 1 &&
+                    risk.get_trades_today() == 2 && risk.get_daily_pnl() < pnl_before &&
+                    !risk.is_trading_halted() && oms.open_orders() == 0;
+    
+    print_test_result("Basket Orders - Combined Risk, Batch Dispatch, Unwind and Hedge",
+                      risk_ok && back_to_back && completed && unwound && hedging && hedged &&
+                      pair_entered && pair_open && pair_closed && failed_entry);
+}
+
+void test_position_tracker() {
+    using hft::Venue;
+    PositionTracker tracker;
+    tracker.set_logging_enabled(false);
+    const hft::SymbolId btc = hft::SymbolTable::instance().intern("BTC/USD");
+    const hft::SymbolId spy = hft::SymbolTable::instance().intern("SPY");
+    
+    // Fast path and string path address the same slot
+    tracker.add_trade(Venue::COINBASE, btc, 0.5, 40000.0);
+    tracker.add_trade("COINBASE", "BTC/USD", -0.25, 42000.0);
+    tracker.update_market_price(Venue::COINBASE, btc, 44000.0);
+    Position pos = tracker.get_position("COINBASE", "BTC/USD");
+    bool position_ok = std::abs(pos.quantity - 0.25) < 1e-9 && std::abs(pos.realized_pnl - 500.0) < 1e-6 &&
+                       std::abs(pos.unrealized_pnl - 1000.0) < 1e-6 &&
+                       std::abs(tracker.get_total_realized_pnl() - 500.0) < 1e-6 &&
+                       std::abs(tracker.get_balance("COINBASE").btc_balance - 1.25) < 1e-9 &&
+                       tracker.get_position(Venue::BINANCE, btc).quantity == 0.0;
+    
+    // Snapshots: new epoch only when the book changed
+    PortfolioSnapshot snapshot;
+    bool read = tracker.read_snapshot(snapshot);
+    const uint64_t epoch = snapshot.epoch;
+    tracker.read_snapshot(snapshot);
+    bool unchanged = snapshot.epoch == epoch;
+    tracker.add_trade(Venue::NYSE, spy, 100, 450.0);
+    tracker.read_snapshot(snapshot);
+    bool snapshot_ok = read && unchanged && snapshot.epoch == epoch + 1 && snapshot.positions.size() == 2 &&
+                       std::abs(snapshot.realized_pnl - 500.0) < 1e-6 &&
+                       tracker.get_all_positions()["NYSE"]["SPY"].quantity == 100;
+    
+    // Readers never see a half-written slot or snapshot while a fill thread writes
+    std::atomic<bool> done{false};
+    std::atomic<int> torn{0};
+    std::thread writer([&]() {
+        for (int i = 0; i < 20000; i++) tracker.add_trade(Venue::NYSE, spy, 1, 450.0);
+        done.store(true);
+    });
+    std::thread reader([&]() {
+        PortfolioSnapshot view;
+        while (!done.load()) {
+            Position p = tracker.get_position(Venue::NYSE, spy);
+            if (p.quantity != p.total_volume) torn.fetch_add(1);
+            tracker.read_snapshot(view);
+            for (const auto& entry : view.positions) {
+                if (entry.symbol == spy && entry.position.quantity != entry.position.total_volume) torn.fetch_add(1);
+            }
+        }
+    });
+    writer.join();
+    reader.join();
+    bool concurrent_ok = torn.load() == 0 && tracker.get_position(Venue::NYSE, spy).quantity == 20100;
+    
+    // A symbol without volume history trades at the quote rather than at inf/NaN
+    tracker.add_trade_with_slippage("NYSE", "NOVOL", 10, 25.0);
+    Position novol = tracker.get_position("NYSE", "NOVOL");
+    bool slippage_ok = novol.quantity == 10 && novol.avg_price == 25.0 &&
+                       std::isfinite(tracker.get_total_equity());
+    
+    print_test_result("Position Tracker - Seqlock Slots and Epoch Snapshots",
+                      position_ok && snapshot_ok && concurrent_ok && slippage_ok);
+}
+
+void test_portfolio_aggregates() {
+    using hft::Venue;
+    PositionTracker tracker;
+    tracker.set_logging_enabled(false);
+    const hft::SymbolId btc = hft::SymbolTable::instance().intern("BTC/USD");
+    const hft::SymbolId qqq = hft::SymbolTable::instance().intern("QQQ");
+    
+    // Starting balances: $50k on each of two venues, unmarked coins count for nothing
+    bool start_ok = std::abs(tracker.get_total_equity() - 100000.0) < 1e-6;
+    
+    // Marking BTC revalues the venue's coin balance by delta
+    tracker.update_market_price(Venue::COINBASE, btc, 40000.0);
+    bool mark_ok = std::abs(tracker.get_total_equity() - 140000.0) < 1e-6;
+    
+    // Long 0.5 BTC @ 40k: USD -20k, BTC +0.5 -> equity unchanged; then mark to 42k
+    tracker.add_trade(Venue::COINBASE, btc, 0.5, 40000.0);
+    tracker.add_trade(Venue::NASDAQ, qqq, -100, 380.0);
+    tracker.update_market_price(Venue::COINBASE, btc, 42000.0);
+    tracker.update_market_price(Venue::NASDAQ, qqq, 379.0);
+    auto agg = tracker.get_aggregates();
+    bool running_ok = std::abs(agg.total_equity - (30000.0 + 1.5 * 42000.0 + 50000.0)) < 1e-6 &&
+                      std::abs(agg.unrealized_pnl - (1000.0 + 100.0)) < 1e-6 &&
+                      std::abs(agg.gross_exposure - (21000.0 + 37900.0)) < 1e-6 &&
+                      std::abs(agg.net_exposure - (21000.0 - 37900.0)) < 1e-6 &&
+                      std::abs(tracker.get_symbol_exposure(qqq) + 37900.0) < 1e-6 &&
+                      std::abs(tracker.get_daily_pnl() - (agg.total_equity - 100000.0)) < 1e-6;
+    
+    // Many fills and marks from two threads; a full recomputation finds no drift
+    std::thread fills([&]() {
+        for (int i = 0; i < 20000; i++) tracker.add_trade(Venue::NASDAQ, qqq, (i % 3) ? 10 : -25, 379.0 + (i % 7) * 0.01);
+    });
+    std::thread marks([&]() {
+        for (int i = 0; i < 20000; i++) tracker.update_market_price(Venue::COINBASE, btc, 42000.0 + (i % 11));
+    });
+    fills.join();
+    marks.join();
+    bool verify_ok = tracker.verify_aggregates() && tracker.aggregate_corrections() == 0;
+    
+    print_test_result("Portfolio Aggregates - Delta Maintained Equity, P&L and Exposure",
+                      start_ok && mark_ok && running_ok && verify_ok);
+}
+
+void test_session_recovery() {
+    using hft::Venue;
+    const std::string dir = std::filesystem::temp_directory_path().string();
+    const std::string journal_path = dir + "/hft_test_journal.bin";
+    const std::string snapshot_path = dir + "/hft_test_snapshot.bin";
+    std::remove(journal_path.c_str());
+    std::remove(snapshot_path.c_str());
+    const uint32_t session = 20260317;
+    const hft::SymbolId spy = hft::SymbolTable::instance().intern("SPY");
+    
+    Signal signal;
+    signal.symbol = "SPY";
+    PositionSize size;
+    
+    // Session 1: trade, snapshot, trade some more, then "crash" without a final snapshot
+    double equity = 0.0, realized = 0.0;
+    SessionRisk expected;
+    size_t tail_records = 0;
+    {
+        hft::TradeJournal journal;
+        journal.open(journal_path, session, 1 << 20);
+        SessionRecovery recovery(journal, snapshot_path);
+        PositionTracker tracker;
+        tracker.set_logging_enabled(false);
+        IntradayRiskManager risk(&tracker, &SessionClock::instance(), false);
+        tracker.set_journal(&journal);
+        risk.set_journal(&journal);
+        
+        tracker.add_trade(Venue::NYSE, spy, 100, 450.0);
+        tracker.update_market_price(Venue::NYSE, spy, 451.0);
+        risk.update_trade_result(signal, size, -20.0, 1.0);
+        recovery.write_snapshot(tracker, &risk);
+        
+        tracker.add_trade(Venue::NYSE, spy, -40, 452.0);
+        tracker.adjust_balance(Venue::COINBASE, "USD", 1000.0, 1000.0);
+        risk.update_trade_result(signal, size, 15.0, 1.0);
+        journal.commit();
+        
+        tail_records = journal.size();
+        equity = tracker.get_total_equity();
+        realized = tracker.get_total_realized_pnl();
+        expected = risk.session_snapshot();
+    }
+    
+    // Session 1 restarted: snapshot plus journal tail
+    bool recovered_ok = false;
+    {
+        hft::TradeJournal journal;
+        journal.open(journal_path, session, 1 << 20);
+        SessionRecovery recovery(journal, snapshot_path);
+        PositionTracker tracker;
+        tracker.set_logging_enabled(false);
+        IntradayRiskManager risk(&tracker, &SessionClock::instance(), false);
+        auto stats = recovery.recover(tracker, &risk);
+        
+        const Position pos = tracker.get_position(Venue::NYSE, spy);
+        const SessionRisk session_state = risk.session_snapshot();
+        recovered_ok = stats.snapshot_loaded && stats.positions_restored == 1 && stats.records_replayed == 3 &&
+                       journal.size() == tail_records && pos.quantity == 60 &&
+                       std::abs(tracker.get_total_realized_pnl() - realized) < 1e-9 &&
+                       std::abs(realized - 80.0) < 1e-9 &&
+                       std::abs(tracker.get_total_equity() - equity) < 1e-6 &&
+                       session_state.trades_today == expected.trades_today && session_state.trades_today == 2 &&
+                       std::abs(session_state.daily_pnl - expected.daily_pnl) < 1e-9 &&
+                       tracker.verify_aggregates();
+    }
+    
+    // A record torn by the crash ends the replay
+    {
+        FILE* file = std::fopen(journal_path.c_str(), "r+b");
+        std::fseek(file, static_cast<long>(64 + (tail_records - 1) * 64 + 30), SEEK_SET);
+        std::fputc(0x5A, file);
+        std::fclose(file);
+    }
+    bool torn_ok = false;
+    {
+        hft::TradeJournal journal;
+        journal.open(journal_path, session, 1 << 20);
+        SessionRecovery recovery(journal, snapshot_path);
+        PositionTracker tracker;
+        tracker.set_logging_enabled(false);
+        IntradayRiskManager risk(&tracker, &SessionClock::instance(), false);
+        auto stats = recovery.recover(tracker, &risk);
+        torn_ok = journal.size() == tail_records - 1 && stats.records_replayed == 2 &&
+                  risk.session_snapshot().trades_today == 1 && tracker.get_position(Venue::NYSE, spy).quantity == 60;
+    }
+    
+    // The next trading day starts clean
+    bool new_day_ok = false;
+    {
+        hft::TradeJournal journal;
+        journal.open(journal_path, session + 1, 1 << 20);
+        SessionRecovery recovery(journal, snapshot_path);
+        PositionTracker tracker;
+        tracker.set_logging_enabled(false);
+        auto stats = recovery.recover(tracker, nullptr);
+        new_day_ok = !stats.snapshot_loaded && journal.size() == 0 &&
+                     tracker.get_position(Venue::NYSE, spy).quantity == 0;
+    }
+    
+    std::remove(journal_path.c_str());
+    std::remove(snapshot_path.c_str());
+    print_test_result("Session Recovery - Journal Replay over Snapshot, Torn Tail and New Day",
+                      recovered_ok && torn_ok && new_day_ok);
+}
+
+void test_risk_fast_path() {
+    using hft::Venue;
+    PositionTracker tracker;
+    tracker.set_logging_enabled(false);
+    EnhancedRiskManager risk(&tracker);
+    risk.set_logging_enabled(false);
+    RiskLimits limits;
+    limits.min_ms_between_orders = 0;
+    limits.max_orders_per_minute = 1000;
+    risk.update_limits(limits);
+    const hft::SymbolId btc = hft::SymbolTable::instance().intern("BTC/USD");
+    tracker.update_market_price(Venue::BINANCE, btc, 50000.0);
+    
+    // First check compiles the instrument entry on the slow path; later ones stay on the fast path
+    bool compiled = risk.can_execute_trade(Venue::BINANCE, btc, 0.005, 50000.0, 50.0);
+    const uint64_t slow = risk.slow_path_checks();
+    bool fast = compiled && slow == 1;
+    for (int i = 0; i < 100; i++) fast &= risk.can_execute_trade(Venue::BINANCE, btc, i % 2 ? 0.005 : -0.005, 50000.0, 50.0);
+    fast &= risk.slow_path_checks() == slow;
+    
+    // Within 10% of the order size limit: accepted, but decided by the slow path
+    bool near = risk.can_execute_trade(Venue::BINANCE, btc, 0.0095, 50000.0, 50.0) &&
+                risk.slow_path_checks() == slow + 1;
+    
+    // Over the size, spread and position limits: rejected
+    tracker.add_trade(Venue::BINANCE, btc, 0.045, 50000.0);
+    bool rejected = !risk.can_execute_trade(Venue::BINANCE, btc, 0.02, 40000.0, 50.0) &&
+                    !risk.can_execute_trade(Venue::BINANCE, btc, 0.001, 50000.0, 10.0) &&
+                    !risk.can_execute_trade(Venue::BINANCE, btc, 0.008, 50000.0, 50.0) &&
+                    risk.can_execute_trade(Venue::BINANCE, btc, -0.008, 50000.0, 50.0);
+    
+    // Emergency stop is a state word bit: everything halts until reset
+    risk.emergency_stop("fast path test");
+    bool halted = (risk.risk_state() & EnhancedRiskManager::STATE_EMERGENCY_STOP) &&
+                  !risk.can_execute_trade(Venue::BINANCE, btc, -0.001, 50000.0, 50.0);
+    risk.reset_emergency_stop();
+    halted &= risk.risk_state() == 0 && risk.can_execute_trade(Venue::BINANCE, btc, -0.001, 50000.0, 50.0);
+    
+    // New limits bump the generation; stale entries recompile and the string API agrees
+    limits.max_order_size_btc = 0.002;
+    risk.update_limits(limits);
+    bool recompiled = !risk.can_execute_trade(Venue::BINANCE, btc, -0.003, 50000.0, 50.0) &&
+                      risk.can_execute_trade("BINANCE", "BTC/USD", -0.001, 50000.0, 50.0) &&
+                      !risk.can_execute_trade("KRAKEN", "BTC/USD", -0.001, 50000.0, 50.0);
+    
+    print_test_result("Risk Fast Path - Compiled Limits, State Word and Near-Limit Slow Path",
+                      fast && near && rejected && halted && recompiled);
+}
+
+// Stages for the pipeline test: call counts and switchable rejections
+struct PipelineProbe {
+    int cheap_calls = 0, picky_calls = 0, budget_calls = 0;
+    bool cheap_rejects = false, picky_rejects = false;
+    double seen_new_position = 0.0;
+    uint8_t seen_assets = 0;
+    
+    bool cheap(risk::RiskCheckContext&) { ++cheap_calls; return !cheap_rejects; }
+    bool picky(risk::RiskCheckContext& ctx) {
+        ++picky_calls;
+        seen_new_position = ctx.new_position;
+        seen_assets = ctx.assets;
+        if (picky_rejects) ctx.reject_reason = "picky";
+        return !picky_rejects;
+    }
+    bool budget(risk::RiskCheckContext&) { ++budget_calls; return true; }
+};
+
+void test_risk_pipeline() {
+    using hft::Venue;
+    PositionTracker tracker;
+    tracker.set_logging_enabled(false);
+    const hft::SymbolId btc = hft::SymbolTable::instance().intern("BTC/USD");
+    tracker.update_market_price(Venue::BINANCE, btc, 50000.0);
+    tracker.add_trade(Venue::BINANCE, btc, 0.01, 50000.0);
+    
+    // Hints order the stages: most rejections per ns first, the budget stage pinned last
+    PipelineProbe probe;
+    risk::RiskPipeline pipeline(&tracker);
+    pipeline.add_stage<&PipelineProbe::budget>("budget", risk::RiskLayer::ENHANCED, &probe, 1.0, 0.5, true);
+    pipeline.add_stage<&PipelineProbe::cheap>("cheap", risk::RiskLayer::UNIFIED, &probe, 1.0, 0.001);
+    pipeline.add_stage<&PipelineProbe::picky>("picky", risk::RiskLayer::COMPREHENSIVE, &probe, 5.0, 0.1);
+    
+    // Uncompiled: fails closed without running any stage
+    risk::RiskCheckContext early(Venue::BINANCE, btc, 0.002, 50000.0);
+    const risk::RiskStage* refused = pipeline.run(early);
+    bool fail_closed = refused && std::string(refused->name) == "uncompiled" && early.reject_reason &&
+                       probe.budget_calls == 0 && probe.cheap_calls == 0 && pipeline.checks() == 0;
+    
+    pipeline.compile();
+    bool ordered = std::string(pipeline.stage_stats(0).name) == "picky" &&
+                   std::string(pipeline.stage_stats(1).name) == "cheap" &&
+                   std::string(pipeline.stage_stats(2).name) == "budget";
+    
+    // Shared context is loaded once; a rejection stops the pass before the budget stage
+    bool passed = true;
+    for (int i = 0; i < 16384; i++) {
+        risk::RiskCheckContext ctx(Venue::BINANCE, btc, 0.002, 50000.0);
+        passed &= pipeline.run(ctx) == nullptr;
+    }
+    probe.picky_rejects = true;
+    risk::RiskCheckContext ctx(Venue::BINANCE, btc, 0.002, 50000.0);
+    const risk::RiskStage* rejected = pipeline.run(ctx);
+    bool stopped = rejected && std::string(rejected->name) == "picky" && ctx.reject_reason &&
+                   probe.cheap_calls == 16384 && probe.budget_calls == 16384 &&
+                   std::abs(probe.seen_new_position - 0.012) < 1e-9 && probe.seen_assets == risk::ASSET_BTC;
+    probe.picky_rejects = false;
+    
+    // Observed rejections reorder it: a stage that now rejects a third of orders moves first
+    for (int i = 0; i < 16384; i++) {
+        probe.cheap_rejects = i % 3 == 0;
+        risk::RiskCheckContext next(Venue::BINANCE, btc, 0.002, 50000.0);
+        pipeline.run(next);
+    }
+    bool recompiled = pipeline.maybe_recompile() &&
+                      std::string(pipeline.stage_stats(0).name) == "cheap" &&
+                      std::string(pipeline.stage_stats(2).name) == "budget" &&
+                      pipeline.stage_stats(0).rejections > 5000 && pipeline.checks() == 16384 * 2 + 1;
+    
+    // Layered manager: dynamic limits reject until market data publishes them, then one pass approves
+    risk::ComprehensiveRiskManager comprehensive(&tracker);
+    comprehensive.get_enhanced_risk_manager()->set_logging_enabled(false);
+    RiskLimits limits;
+    limits.min_ms_between_orders = 0;
+    comprehensive.get_enhanced_risk_manager()->update_limits(limits);
+    bool layered = !comprehensive.can_execute_trade(Venue::BINANCE, btc, -0.001, 50000.0, 50.0);
+    for (int i = 0; i < 3; i++) comprehensive.update_market_data("BINANCE", "BTC/USD", 50000.0, 49990.0, 50010.0, 1.0);
+    layered &= comprehensive.can_execute_trade(Venue::BINANCE, btc, -0.001, 50000.0, 50.0) &&
+               comprehensive.can_execute_trade("BINANCE", "BTC/USD", -0.001, 50000.0, 50.0) &&
+               !comprehensive.can_execute_trade(Venue::BINANCE, btc, -0.05, 50000.0, 50.0) &&
+               comprehensive.get_risk_pipeline().checks() == 4;
+    
+    print_test_result("Risk Pipeline - Compiled Stage Order, Shared Context and Layered Checks",
+                      fail_closed && ordered && passed && stopped && recompiled && layered);
+}
+
+void test_covariance_engine() {
+    // 20 assets (three blocks): factor-driven pairs, one independent, checked against a naive EWMA
+    constexpr size_t N = 20;
+    constexpr uint64_t SECOND = 1000000000ULL;
+    risk::EwmaCovarianceEngine::Config config;
+    config.max_assets = N;
+    config.lambda = 0.97;
+    config.min_samples = 10;
+    risk::EwmaCovarianceEngine engine(config);
+    
+    std::vector<hft::SymbolId> ids;
+    for (size_t i = 0; i < N; i++) ids.push_back(hft::SymbolTable::instance().intern("COV" + std::to_string(i)));
+    
+    std::mt19937 rng(7);
+    std::normal_distribution<double> noise(0.0, 0.001);
+    std::vector<double> price(N, 100.0), grid(N, 100.0), naive(N * N, 0.0);
+    double retained = 1.0;
+    uint64_t t = 1000 * SECOND;
+    for (size_t i = 0; i < N; i++) engine.update_price(ids[i], price[i], t);
+    
+    for (int step = 0; step < 400; step++) {
+        const double factor = noise(rng);
+        for (size_t i = 0; i < N; i++) {
+            const double move = i == N - 1 ? noise(rng) : factor * (1.0 + 0.1 * i) + 0.3 * noise(rng);
+            price[i] *= std::exp(move);
+            engine.update_price(ids[i], price[i], t + SECOND / 2);   // Mid-interval tick
+        }
+        t += SECOND;
+        engine.advance_to(t);
+        
+        // Reference: full dense matrix, same grid returns
+        for (size_t i = 0; i < N; i++) {
+            for (size_t j = 0; j < N; j++) {
+                naive[i * N + j] = 0.97 * naive[i * N + j] + 0.03 * std::log(price[i] / grid[i]) * std::log(price[j] / grid[j]);
+            }
+        }
+        for (size_t i = 0; i < N; i++) grid[i] = price[i];
+        retained *= 0.97;
+    }
+    
+    bool exact = engine.samples() == 400 && engine.is_warm();
+    for (size_t i = 0; i < N; i++) {
+        for (size_t j = 0; j < N; j++) {
+            const double expected = naive[i * N + j] / (1.0 - retained);
+            exact &= std::abs(engine.covariance(i, j) - expected) <= 1e-12 + 1e-9 * std::abs(expected);
+        }
+    }
+    bool correlated = engine.correlation(0, 1) > 0.9 && engine.correlation(0, 17) > 0.9 &&
+                      std::abs(engine.correlation(3, N - 1)) < 0.3 &&
+                      std::abs(engine.correlation(5, 12) - engine.correlation(12, 5)) < 1e-15;
+    std::vector<double> sub;
+    engine.correlation_matrix({0, 9, N - 1}, sub);
+    correlated &= sub.size() == 9 && sub[0] == 1.0 && std::abs(sub[1] - engine.correlation(0, 9)) < 1e-15 &&
+                  sub[3] == sub[1];
+    const auto summary = engine.correlation_summary();
+    correlated &= summary.pairs == N * (N - 1) / 2 && summary.average > 0.5 && summary.max <= 1.0;
+    
+    // Gap of 5 grid points decays by lambda^5 in one sample
+    const double before = engine.variance(0);
+    const double weight = 1.0 - retained;
+    engine.advance_to(t + 5 * SECOND);
+    const double gap_expected = before * weight * std::pow(0.97, 5) / (1.0 - retained * std::pow(0.97, 5));
+    bool gap = engine.samples() == 401 && std::abs(engine.variance(0) - gap_expected) < 1e-15;
+    
+    // Dollar portfolio variance: long asset 0, short asset 1 (hedge) vs long both
+    std::vector<double> hedge(N, 0.0), doubled(N, 0.0);
+    hedge[0] = 1000.0; hedge[1] = -1000.0;
+    doubled[0] = 1000.0; doubled[1] = 1000.0;
+    gap &= engine.portfolio_variance(hedge) < engine.portfolio_variance(doubled);
+    
+    // 1000 assets on a 1-second grid: every sample is one full rank-1 update
+    risk::EwmaCovarianceEngine::Config wide_config;
+    wide_config.max_assets = 1000;
+    risk::EwmaCovarianceEngine wide(wide_config);
+    for (size_t i = 0; i < 1000; i++) wide.add_asset(static_cast<hft::SymbolId>(i));
+    uint64_t wide_t = 1000 * SECOND;
+    wide.advance_to(wide_t);
+    const auto start = std::chrono::steady_clock::now();
+    for (int step = 0; step < 20; step++) {
+        for (size_t i = 0; i < 1000; i++) wide.update_price(static_cast<hft::SymbolId>(i), 100.0 + noise(rng), wide_t);
+        wide_t += SECOND;
+        wide.advance_to(wide_t);
+    }
+    const double ms_per_sample = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count() / 20;
+    bool scales = wide.samples() == 20 && wide.asset_count() == 1000 && ms_per_sample < 100.0;
+    
+    print_test_result("Covariance Engine - Blocked EWMA vs Naive, Gaps, Correlation and 1000 Assets",
+                      exact && correlated && gap && scales);
+}
+
+void test_var_engine() {
+    // Two correlated assets with 1% per-interval volatility; VaR horizon = one grid interval
+    constexpr uint64_t SECOND = 1000000000ULL;
+    risk::EwmaCovarianceEngine::Config cov_config;
+    cov_config.max_assets = 8;
+    cov_config.lambda = 0.995;
+    cov_config.min_samples = 100;
+    risk::EwmaCovarianceEngine covariance(cov_config);
+    const hft::SymbolId a = hft::SymbolTable::instance().intern("VAR_A");
+    const hft::SymbolId b = hft::SymbolTable::instance().intern("VAR_B");
+    const hft::SymbolId unknown = hft::SymbolTable::instance().intern("VAR_UNTRACKED");
+    
+    risk::VarEngine::Config config;
+    config.history_length = 500;
+    config.monte_carlo_scenarios = 4000;
+    config.horizon_ns = SECOND;
+    config.threads = 4;
+    risk::VarEngine engine(config);
+    config.threads = 1;
+    risk::VarEngine inline_engine(config);
+    
+    std::mt19937 rng(11);
+    std::normal_distribution<double> noise(0.0, 0.01);
+    double price_a = 100.0, price_b = 50.0;
+    uint64_t t = 1000 * SECOND;
+    covariance.update_price(a, price_a, t);
+    covariance.update_price(b, price_b, t);
+    for (int step = 0; step < 500; step++) {
+        const double common = noise(rng);
+        price_a *= std::exp(common);
+        price_b *= std::exp(0.9 * common + 0.436 * noise(rng));
+        covariance.update_price(a, price_a, t + SECOND / 2);
+        covariance.update_price(b, price_b, t + SECOND / 2);
+        t += SECOND;
+        covariance.advance_to(t);
+        engine.record_returns(covariance.last_returns(), covariance.asset_count());
+        inline_engine.record_returns(covariance.last_returns(), covariance.asset_count());
+    }
+    
+    // Long $100k of A: 95% VaR ~ 1.645 sigma, under both methods
+    std::vector<double> exposures = {100000.0, 0.0};
+    engine.generate(covariance, exposures);
+    inline_engine.generate(covariance, exposures);
+    const auto historical = engine.estimate(risk::VarMethod::HISTORICAL);
+    const auto monte_carlo = engine.estimate(risk::VarMethod::MONTE_CARLO);
+    const double expected = 100000.0 * -std::expm1(-1.645 * std::sqrt(covariance.variance(0)));
+    bool accurate = historical.valid && monte_carlo.valid && historical.scenarios == 500 &&
+                    monte_carlo.scenarios == 4000 &&
+                    std::abs(historical.var_95 / expected - 1.0) < 0.15 &&
+                    std::abs(monte_carlo.var_95 / expected - 1.0) < 0.08 &&
+                    monte_carlo.var_99 > monte_carlo.var_95 &&
+                    monte_carlo.expected_shortfall_95 > monte_carlo.var_95;
+    
+    // Same scenarios regardless of worker count
+    bool deterministic = engine.scenarios(risk::VarMethod::MONTE_CARLO)->pnl ==
+                         inline_engine.scenarios(risk::VarMethod::MONTE_CARLO)->pnl &&
+                         engine.scenarios(risk::VarMethod::HISTORICAL)->pnl ==
+                         inline_engine.scenarios(risk::VarMethod::HISTORICAL)->pnl;
+    
+    // Marginal VaR: doubling is exactly linear, flattening removes it, hedging with B cuts it
+    const auto doubled = engine.marginal_var(risk::VarMethod::MONTE_CARLO, a, 100000.0);
+    const auto flat = engine.marginal_var(risk::VarMethod::MONTE_CARLO, a, -100000.0);
+    const auto hedged = engine.marginal_var(risk::VarMethod::MONTE_CARLO, b, -100000.0);
+    const auto untracked = engine.marginal_var(risk::VarMethod::HISTORICAL, unknown, 100000.0);
+    bool marginal = doubled.valid && std::abs(doubled.var_before - monte_carlo.var_95) < 1e-9 &&
+                    std::abs(doubled.var_after - 2.0 * doubled.var_before) < 1e-6 &&
+                    std::abs(flat.var_after) < 1e-9 * hedged.var_before &&
+                    hedged.change() < -0.3 * hedged.var_before &&
+                    untracked.valid && untracked.change() == 0.0;
+    
+    // Revaluing under cached scenarios matches the marginal answer
+    engine.revalue({200000.0, 0.0});
+    marginal &= std::abs(engine.estimate(risk::VarMethod::MONTE_CARLO).var_95 - doubled.var_after) < 1e-6;
+    
+    // Pre-trade query cost over 4000 cached scenarios
+    const auto start = std::chrono::steady_clock::now();
+    double sink = 0.0;
+    for (int i = 0; i < 1000; i++) sink += engine.marginal_var(risk::VarMethod::MONTE_CARLO, b, 1000.0 + i).change();
+    const double us_per_query = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count() / 1000;
+    bool fast = std::isfinite(sink) && us_per_query < 200.0;
+    
+    print_test_result("VaR Engine - Historical/Monte Carlo Accuracy, Determinism and Marginal VaR",
+                      accurate && deterministic && marginal && fast);
+}
+
+void test_stress_matrix() {
+    // 3 factors x 500 scenarios, 40 symbols moving through random fills, checked against S e from scratch
+    risk::StressShockMatrix matrix;
+    for (const char* factor : {"BTC", "ETH", "SOL"}) matrix.add_factor(factor);
+    std::mt19937 rng(5);
+    std::uniform_real_distribution<double> shock(-0.4, 0.2);
+    std::vector<std::vector<double>> shocks;
+    for (int s = 0; s < 500; s++) {
+        shocks.push_back({shock(rng), shock(rng), shock(rng)});
+        matrix.add_scenario("S" + std::to_string(s), shocks.back());
+    }
+    
+    std::vector<hft::SymbolId> ids;
+    for (int i = 0; i < 40; i++) {
+        ids.push_back(hft::SymbolTable::instance().intern("STRESS" + std::to_string(i)));
+        matrix.map_symbol(ids.back(), i % 4 == 3 ? risk::StressShockMatrix::NO_FACTOR : i % 4);
+    }
+    const hft::SymbolId unmapped = hft::SymbolTable::instance().intern("STRESS_UNMAPPED");
+    bool mapping = !matrix.set_exposure(unmapped, 1000.0) && matrix.set_exposure(ids[3], 5000.0) &&
+                   matrix.factor_exposure(0) == 0.0 && matrix.worst_loss() == 0.0;
+    
+    std::uniform_int_distribution<int> pick(0, 39);
+    std::uniform_real_distribution<double> size(-20000.0, 20000.0);
+    std::vector<double> exposure(40, 0.0);
+    exposure[3] = 5000.0;
+    const auto start = std::chrono::steady_clock::now();
+    for (int fill = 0; fill < 20000; fill++) {
+        const int i = pick(rng);
+        exposure[i] += size(rng);
+        matrix.set_exposure(ids[i], exposure[i]);
+    }
+    const double us_per_fill = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count() / 20000;
+    
+    std::vector<double> factor(3, 0.0);
+    for (int i = 0; i < 40; i++) if (i % 4 != 3) factor[i % 4] += exposure[i];
+    bool exact = true;
+    double worst = 0.0;
+    for (int s = 0; s < 500; s++) {
+        const double pnl = shocks[s][0] * factor[0] + shocks[s][1] * factor[1] + shocks[s][2] * factor[2];
+        exact &= std::abs(matrix.scenario_pnl(s) - pnl) < 1e-6;
+        worst = std::max(worst, -pnl);
+    }
+    exact &= std::abs(matrix.worst_loss() - worst) < 1e-6 && matrix.updates() > 0;
+    
+    // Resync from per-symbol exposures agrees with the incremental state
+    const double before = matrix.worst_loss();
+    matrix.resync();
+    exact &= std::abs(matrix.worst_loss() - before) < 1e-6;
+    
+    print_test_result("Stress Matrix - Incremental Scenario P&L vs Full Product and Worst Loss",
+                      mapping && exact && us_per_fill < 50.0);
+}
+
+void test_risk_event_coalescer() {
+    // Two producers post 20000 marks for 4 symbols; batches coalesce them and keep each symbol's latest price
+    risk::RiskEventCoalescer::Config config;
+    config.min_interval_ns = 2000000;       // 2 ms
+    config.timer_interval_ns = 50000000;    // 50 ms
+    risk::RiskEventCoalescer events(config);
+    
+    std::mutex seen_mutex;
+    uint64_t seen_events = 0, seen_batches = 0, max_symbols = 0, limit_batches = 0;
+    std::vector<double> last_price(4, 0.0);
+    std::vector<hft::SymbolId> ids;
+    for (int i = 0; i < 4; i++) ids.push_back(hft::SymbolTable::instance().intern("COALESCE" + std::to_string(i)));
+    events.subscribe([&](const risk::RiskDirtySet& batch) {
+        std::lock_guard<std::mutex> lock(seen_mutex);
+        if (batch.empty()) return;
+        seen_events += batch.events();
+        seen_batches++;
+        max_symbols = std::max<uint64_t>(max_symbols, batch.symbols().size());
+        limit_batches += batch.limits_changed();
+        for (const auto& entry : batch.symbols()) {
+            for (int i = 0; i < 4; i++) if (ids[i] == entry.symbol) last_price[i] = entry.price;
+        }
+    });
+    events.start();
+    
+    std::vector<std::thread> producers;
+    for (int p = 0; p < 2; p++) {
+        producers.emplace_back([&, p] {
+            for (int n = 1; n <= 10000; n++) {
+                const int i = p * 2 + (n & 1);
+                while (!events.post_mark(hft::Venue::BINANCE, ids[i], 100.0 * (i + 1) + n, n)) std::this_thread::yield();
+            }
+        });
+    }
+    for (auto& producer : producers) producer.join();
+    events.post_limit_change();
+    events.flush();
+    
+    bool coalesced, latest = true;
+    {
+        std::lock_guard<std::mutex> lock(seen_mutex);
+        coalesced = seen_events == 20001 && seen_batches < 20001 && max_symbols <= 4 && limit_batches >= 1;
+        for (int i = 0; i < 4; i++) latest &= last_price[i] == 100.0 * (i + 1) + 10000 - ((i & 1) ? 1 : 0);
+    }
+    
+    // Idle: the thread sleeps and only timer passes run
+    const uint64_t timers = events.stats().timer_passes;
+    std::this_thread::sleep_for(std::chrono::milliseconds(180));
+    bool timer = events.stats().timer_passes >= timers + 2;
+    events.stop();
+    
+    // Ring overflow without a running thread: flush dispatches inline with the overflow flag
+    risk::RiskEventCoalescer stopped;
+    bool overflow_flagged = false;
+    uint64_t delivered = 0;
+    stopped.subscribe([&](const risk::RiskDirtySet& batch) {
+        overflow_flagged |= batch.overflowed();
+        delivered += batch.events();
+    });
+    bool all_queued = true;
+    for (size_t n = 0; n < risk::RiskEventCoalescer::RING_SIZE; n++) all_queued &= stopped.post_mark(hft::Venue::BINANCE, ids[0], 1.0);
+    const bool rejected = !stopped.post_mark(hft::Venue::BINANCE, ids[0], 1.0);
+    stopped.flush();
+    bool overflow = all_queued && rejected && overflow_flagged && delivered == risk::RiskEventCoalescer::RING_SIZE;
+    
+    print_test_result("Risk Event Coalescer - Batched Marks, Latest Price, Timer Passes and Overflow",
+                      coalesced && latest && timer && overflow);
+}
+
+void test_kill_switch() {
+    using hft::KillSwitch;
+    // Two mappings of one named page stand in for two processes; bits set before attach carry over
+    const std::string name = "/hft_test_kill_" + std::to_string(::getpid());
+    KillSwitch desk, trader;
+    const std::atomic<uint64_t>* cached = trader.word();
+    trader.halt(KillSwitch::SESSION_HALT, "before attach");
+    bool shared = desk.attach(name.c_str()) && trader.attach(name.c_str()) && trader.word() == cached &&
+                  KillSwitch::flags_of(desk.state()) == KillSwitch::SESSION_HALT && desk.reason() == "before attach";
+    trader.resume(KillSwitch::SESSION_HALT);
+    shared &= !desk.halted() && !KillSwitch::is_halted(cached->load());
+    
+    // Sources are independent bits and every change bumps the version
+    const uint32_t version = KillSwitch::version_of(desk.state());
+    desk.halt(KillSwitch::KILL, "desk kill");
+    trader.halt(KillSwitch::EMERGENCY_STOP);
+    trader.halt(KillSwitch::EMERGENCY_STOP);       // Already set: re-records the owner, bumps the version
+    trader.resume(KillSwitch::EMERGENCY_STOP);
+    bool sources = trader.halted() && KillSwitch::flags_of(trader.state()) == KillSwitch::KILL &&
+                   KillSwitch::version_of(trader.state()) == version + 4 && desk.changed_by() == ::getpid();
+    
+    // OMS gate: a request queued before the flip is refused on the OMS thread,
+    // new ones at submit; cancels still pass
+    hft::OrderManager oms(16);
+    oms.set_kill_switch(trader);
+    desk.resume(KillSwitch::KILL);
+    hft::OrderRequest request{};
+    request.action = hft::OrderRequest::Action::NEW;
+    request.order_id = oms.reserve_order_id();
+    request.symbol = hft::SymbolTable::instance().intern("SPY");
+    request.side = hft::Side::BUY;
+    request.type = hft::OrderType::LIMIT;
+    request.price = hft::to_fixed_price(450.0);
+    request.quantity = hft::to_fixed_quantity(10);
+    bool gated = oms.submit(request);
+    desk.halt(KillSwitch::KILL, "desk kill");
+    oms.poll();
+    hft::SequencedMessage msg;
+    hft::OrderUpdate update;
+    gated &= !oms.poll_outbound(msg) && oms.get_stats().halted_requests == 1 &&
+             oms.poll_update(update) && update.event == hft::MessageType::ORDER_REJECT;
+    request.order_id = oms.reserve_order_id();
+    gated &= !oms.submit(request) && oms.halted_submits() == 1;
+    hft::OrderRequest cancel = request;
+    cancel.action = hft::OrderRequest::Action::CANCEL;
+    gated &= oms.submit(cancel);
+    desk.resume(KillSwitch::KILL);
+    request.order_id = oms.reserve_order_id();
+    oms.submit(request);
+    oms.poll();
+    gated &= oms.poll_outbound(msg) && msg.type == hft::MessageType::NEW_ORDER;
+    
+    // Another process halting a source we already set takes it over: not ours to resume,
+    // reported stale once it exits, and only the operator override clears it
+    trader.halt(KillSwitch::EMERGENCY_STOP, "parent risk manager");
+    const pid_t child = ::fork();
+    if (child == 0) {
+        desk.halt(KillSwitch::EMERGENCY_STOP, "child risk manager");
+        ::_exit(0);
+    }
+    int child_status = 0;
+    ::waitpid(child, &child_status, 0);
+    trader.resume(KillSwitch::EMERGENCY_STOP, "not the owner");
+    bool owned = child > 0 && trader.owner(KillSwitch::EMERGENCY_STOP) == child &&
+                 KillSwitch::flags_of(trader.state()) == KillSwitch::EMERGENCY_STOP &&
+                 trader.stale_sources() == KillSwitch::EMERGENCY_STOP;
+    trader.override_resume(KillSwitch::EMERGENCY_STOP, "operator override");
+    owned &= !desk.halted() && trader.owner(KillSwitch::EMERGENCY_STOP) == 0;
+    
+    // A set source with no recorded owner belongs to nobody
+    trader.halt(KillSwitch::MONITOR_STOP, "owner lost");
+    const int shm_fd = ::shm_open(name.c_str(), O_RDWR, 0);
+    void* raw = shm_fd >= 0 ? ::mmap(nullptr, KillSwitch::PAGE_SIZE, PROT_READ | PROT_WRITE, MAP_SHARED, shm_fd, 0)
+                            : MAP_FAILED;
+    if (shm_fd >= 0) ::close(shm_fd);
+    owned &= raw != MAP_FAILED;
+    if (raw != MAP_FAILED) {
+        static_cast<hft::RiskStatePage*>(raw)->owner[4].store(0);
+        ::munmap(raw, KillSwitch::PAGE_SIZE);
+    }
+    trader.resume(KillSwitch::MONITOR_STOP, "unrecorded owner");
+    owned &= KillSwitch::flags_of(desk.state()) == KillSwitch::MONITOR_STOP;
+    desk.override_resume(KillSwitch::MONITOR_STOP, "operator override");
+    owned &= !trader.halted();
+    KillSwitch::unlink(name.c_str());
+    
+    // A risk manager's emergency stop halts every order path on the process-wide switch
+    PositionTracker tracker;
+    tracker.set_logging_enabled(false);
+    EnhancedRiskManager risk(&tracker);
+    risk.set_logging_enabled(false);
+    hft::OrderManager process_oms(16);
+    risk.emergency_stop("kill switch test");
+    request.order_id = process_oms.reserve_order_id();
+    bool published = KillSwitch::flags_of(KillSwitch::instance().state()) == KillSwitch::EMERGENCY_STOP &&
+                     !process_oms.submit(request);
+    risk.reset_emergency_stop();
+    published &= !KillSwitch::instance().halted() && process_oms.submit(request);
+    
+    print_test_result("Kill Switch - Shared Page, Independent Sources, OMS Gate and Emergency Stop",
+                      shared && sources && gated && owned && published);
+}
+
+void test_binary_logger() {
+    // Temporary files, no console; two threads log interleaved records
+    const auto dir = std::filesystem::temp_directory_path() / ("hft_logger_test_" + std::to_string(::getpid()));
+    std::filesystem::create_directories(dir);
+    hft::Logger::LoggerConfig config;
+    config.system_log_file = (dir / "system.log").string();
+    config.trading_log_file = (dir / "trading.log").string();
+    config.risk_log_file = (dir / "risk.log").string();
+    config.enable_console = false;
+    config.min_level = hft::LogLevel::INFO;
+    auto& logger = hft::Logger::instance();
+    logger.init(config);
+    
+    constexpr int RECORDS = 1000;
+    auto writer = [](int id) {
+        for (int i = 0; i < RECORDS; ++i) {
+            LOG_TRADE("writer {} seq {} px {:.2f} sym {}", id, i, 100.0 + i * 0.125, std::string("SPY"));
+        }
+    };
+    std::thread first(writer, 1), second(writer, 2);
+    first.join();
+    second.join();
+    LOG_RISK("limit {} of {} used", 3, 4.5);
+    LOG_DEBUG("below min level {}", 1);
+    logger.log(hft::LogLevel::WARNING, "monitoring", "free-form");
+    
+    // Hot-path cost: the caller only copies arguments into its ring
+    const auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < 2000; ++i) LOG_INFO("timing {} {:.3f}", i, i * 0.5);
+    const double ns_per_call = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / 2000;
+    logger.shutdown();
+    
+    auto read_lines = [](const std::filesystem::path& path) {
+        std::vector<std::string> lines;
+        std::ifstream in(path);
+        for (std::string line; std::getline(in, line);) lines.push_back(line);
+        return lines;
+    };
+    const auto trading = read_lines(dir / "trading.log");
+    const auto risk = read_lines(dir / "risk.log");
+    const auto system = read_lines(dir / "system.log");
+    
+    // Per-thread order kept, deferred formatting matches the format string
+    bool ordered = trading.size() == 2 * RECORDS;
+    int next[3] = {0, 0, 0};
+    for (const auto& line : trading) {
+        int id = 0, seq = 0;
+        const auto pos = line.find("writer ");
+        if (pos == std::string::npos || std::sscanf(line.c_str() + pos, "writer %d seq %d", &id, &seq) != 2 ||
+            id < 1 || id > 2 || seq != next[id]++) {
+            ordered = false;
+            break;
+        }
+    }
+    const bool formatted = !trading.empty() && trading[0].find("[INFO] [TRADING] [T:") != std::string::npos &&
+                           trading[0].find("seq 0 px 100.00 sym SPY") != std::string::npos &&
+                           risk.size() == 1 && risk[0].find("[WARN] [RISK]") != std::string::npos &&
+                           risk[0].find("limit 3 of 4.5 used") != std::string::npos;
+    bool routed = false, filtered = true;
+    for (const auto& line : system) {
+        routed |= line.find("[WARN] [monitoring]") != std::string::npos && line.find("free-form") != std::string::npos;
+        filtered &= line.find("below min level") == std::string::npos;
+    }
+    const auto stats = logger.stats();
+    std::filesystem::remove_all(dir);
+    
+    std::cout << "   Logger: " << ns_per_call << " ns per call, " << stats.batches << " batches, "
+              << stats.dropped << " dropped" << std::endl;
+    print_test_result("Binary Logger - Deferred Formatting, Per-Thread Order and Routing",
+                      ordered && formatted && routed && filtered && stats.dropped == 0 && ns_per_call < 2000.0);
+}
+
+void test_io_service() {
+    // Two threads append through their rings; the file rotates once a batch takes it past 16 KB
+    const auto dir = std::filesystem::temp_directory_path() / ("hft_io_test_" + std::to_string(::getpid()));
+    std::filesystem::create_directories(dir);
+    const std::string path = (dir / "events.csv").string();
+    auto& io = hft::IoService::instance();
+    const auto before = io.stats();
+    hft::IoService::FileOptions options;
+    options.header = "thread,seq,value\n";
+    options.rotate_bytes = 16 * 1024;
+    options.compress_rotated = false;
+    options.block_when_full = true;
+    const hft::IoFileId file = io.open(path, options);
+    bool registered = file != hft::INVALID_IO_FILE && io.open(path) == file && !io.write(hft::INVALID_IO_FILE, "x");
+    
+    constexpr int LINES = 2000;
+    auto writer = [&](int id) {
+        for (int i = 0; i < LINES; ++i) {
+            hft::IoLine line;
+            line << id << "," << i << "," << hft::io_fixed(2) << i * 0.25 << "\n";
+            io.write(file, line);
+        }
+    };
+    std::thread first(writer, 1), second(writer, 2);
+    first.join();
+    second.join();
+    io.flush();
+    const auto after = io.stats();
+    
+    // Every line once, per-thread order kept across rotations, a header atop each file
+    std::vector<std::filesystem::path> parts;
+    for (const auto& entry : std::filesystem::directory_iterator(dir)) {
+        if (entry.path().string() != path) parts.push_back(entry.path());
+    }
+    std::sort(parts.begin(), parts.end(), [](const auto& a, const auto& b) {
+        return std::stoi(a.extension().string().substr(1)) < std::stoi(b.extension().string().substr(1));
+    });
+    parts.push_back(path);
+    int next[3] = {0, 0, 0};
+    bool complete = parts.size() >= 2, headers = true;
+    for (const auto& part : parts) {
+        std::ifstream in(part);
+        std::string line;
+        headers &= std::getline(in, line) && line == "thread,seq,value";
+        while (std::getline(in, line)) {
+            int id = 0, seq = 0;
+            double value = 0.0;
+            if (std::sscanf(line.c_str(), "%d,%d,%lf", &id, &seq, &value) != 3 || id < 1 || id > 2 ||
+                seq != next[id]++ || value != seq * 0.25) {
+                complete = false;
+            }
+        }
+    }
+    complete &= next[1] == LINES && next[2] == LINES;
+    const bool batched = after.records - before.records == 2 * LINES + 1 && after.errors == before.errors &&
+                         after.writes - before.writes < LINES && after.rotations - before.rotations == parts.size() - 1;
+    
+    // Overrunning the ring: a default file drops whole records and returns at once,
+    // a block_when_full file waits and keeps every record
+    const std::string record(16 * 1024 - 1, 'x');
+    const std::string record_line = record + "\n";
+    const hft::IoFileId lossy = io.open((dir / "lossy.log").string());
+    hft::IoService::FileOptions audit_options;
+    audit_options.block_when_full = true;
+    const hft::IoFileId audit = io.open((dir / "audit.log").string(), audit_options);
+    size_t lossy_written = 0, overrun = 0;
+    for (int i = 0; i < 4096 && overrun == 0; ++i) {
+        if (io.write(lossy, record_line)) lossy_written++; else overrun++;
+    }
+    constexpr size_t AUDIT_RECORDS = 256;
+    size_t audit_written = 0;
+    for (size_t i = 0; i < AUDIT_RECORDS; ++i) audit_written += io.write(audit, record_line);
+    io.flush();
+    const auto overrun_stats = io.stats();
+    const bool dropped = overrun == 1 && overrun_stats.dropped - after.dropped == 1 &&
+                         std::filesystem::file_size(dir / "lossy.log") == lossy_written * record_line.size() &&
+                         audit_written == AUDIT_RECORDS &&
+                         std::filesystem::file_size(dir / "audit.log") == AUDIT_RECORDS * record_line.size();
+    std::filesystem::remove_all(dir);
+    
+    std::cout << "   I/O: " << (after.records - before.records) << " records in " << (after.writes - before.writes)
+              << " writes, " << (after.submits - before.submits) << " submits ("
+              << (after.io_uring ? "io_uring" : "pwrite") << "), " << parts.size() - 1 << " rotations" << std::endl;
+    print_test_result("I/O Service - Batched Writes, Per-Thread Order and Rotation",
+                      registered && complete && headers && batched);
+    print_test_result("I/O Service - Drop on Full Ring, Block Only for Audit Files", dropped);
+}
+
+void test_latency_histogram() {
+    using hft::LatencyHistogram;
+    // Buckets tile the range with no gaps and are at most 1/64 of their value wide
+    bool buckets_ok = LatencyHistogram::bucket_index(0) == 0 &&
+                      LatencyHistogram::bucket_index(UINT64_MAX) == LatencyHistogram::BUCKETS - 1;
+    for (size_t i = 0; i + 1 < LatencyHistogram::BUCKETS; ++i) {
+        const uint64_t lower = LatencyHistogram::bucket_lower(i), upper = LatencyHistogram::bucket_upper(i);
+        buckets_ok &= LatencyHistogram::bucket_index(lower) == i && LatencyHistogram::bucket_index(upper) == i &&
+                      LatencyHistogram::bucket_lower(i + 1) == upper + 1 && (upper - lower) * 64 <= std::max<uint64_t>(lower, 64);
+    }
+    
+    // Four threads record 1-11 us with a sparse 2 ms tail; the merge must match a single-threaded reference
+    constexpr int THREADS = 4, SAMPLES = 100000;
+    auto sample = [](int thread, int i) -> uint64_t {
+        return i % 5000 == 4999 ? 2000000 + thread * 1000 : 1000 + static_cast<uint64_t>((i * 7919 + thread) % 10000);
+    };
+    hft::LatencyRecorder recorder;
+    std::vector<std::thread> threads;
+    for (int t = 0; t < THREADS; ++t) {
+        threads.emplace_back([&, t] { for (int i = 0; i < SAMPLES; ++i) recorder.record(sample(t, i)); });
+    }
+    for (auto& thread : threads) thread.join();
+    
+    LatencyHistogram reference;
+    std::vector<uint64_t> values;
+    for (int t = 0; t < THREADS; ++t) {
+        for (int i = 0; i < SAMPLES; ++i) {
+            reference.record(sample(t, i));
+            values.push_back(sample(t, i));
+        }
+    }
+    std::sort(values.begin(), values.end());
+    const LatencyHistogram merged = recorder.interval();
+    bool exact = merged.count() == static_cast<uint64_t>(THREADS * SAMPLES) && merged.sum_ns() == reference.sum_ns() &&
+                 merged.min_ns() == values.front() && merged.max_ns() == values.back() && recorder.threads() == 0;
+    for (size_t i = 0; i < LatencyHistogram::BUCKETS; ++i) exact &= merged.bucket_count(i) == reference.bucket_count(i);
+    
+    // Percentiles up to p99.99 within one bucket of the exact order statistic
+    bool percentiles_ok = true;
+    for (double p : {50.0, 90.0, 99.0, 99.9, 99.99, 100.0}) {
+        const size_t rank = static_cast<size_t>(std::ceil(p / 100.0 * values.size()));
+        const uint64_t truth = values[std::max<size_t>(rank, 1) - 1];
+        const uint64_t reported = merged.percentile(p);
+        percentiles_ok &= reported >= truth && reported <= truth + truth / 64;
+    }
+    
+    // Next interval holds only what was recorded since (its range to bucket resolution); the snapshot holds everything
+    for (int i = 0; i < 1000; ++i) recorder.record(50000);
+    const LatencyHistogram next = recorder.interval();
+    const LatencyHistogram total = recorder.snapshot();
+    const bool intervals = next.count() == 1000 && next.percentile(50.0) >= 50000 && next.percentile(50.0) <= 50000 + 50000 / 64 &&
+                           next.min_ns() <= 50000 && next.max_ns() >= 50000 && next.max_ns() <= 50000 + 50000 / 64 &&
+                           total.count() == static_cast<uint64_t>(THREADS * SAMPLES + 1000) &&
+                           recorder.interval().count() == 0;
+    
+    // Hot-path cost and calibrated TSC
+    constexpr int TIMED = 1000000;
+    const uint64_t start = hft::get_timestamp_ns();
+    for (int i = 0; i < TIMED; ++i) recorder.record(static_cast<uint64_t>(i & 0xFFFF));
+    const double ns_per_record = static_cast<double>(hft::get_timestamp_ns() - start) / TIMED;
+    const uint64_t tsc_start = hft::rdtsc();
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    const uint64_t slept_ns = hft::TscClock::elapsed_ns(tsc_start);
+    const bool clock_ok = slept_ns >= 19000000 && slept_ns < 500000000;
+    
+    // Monitor reports cumulative and interval percentiles from its recorders
+    hft::monitoring::RealTimeMonitor monitor;
+    for (int i = 0; i < 100; ++i) monitor.record_latency("order_send", hft::rdtsc());
+    monitor.roll_latency_interval();
+    const auto cumulative = monitor.get_latency_metrics("order_send");
+    const auto interval = monitor.get_interval_latency_metrics("order_send");
+    const bool monitor_ok = cumulative && interval && cumulative->sample_count == 100 && interval->sample_count == 100 &&
+                            interval->p9999_ns >= interval->p50_ns && !monitor.get_latency_metrics("unknown");
+    
+    std::cout << "   Histogram: p50=" << merged.percentile(50.0) << "ns p99.99=" << merged.percentile(99.99)
+              << "ns, " << ns_per_record << " ns/record, TSC " << hft::TscClock::ticks_per_ns() << " ticks/ns" << std::endl;
+    print_test_result("Latency Histogram - Exact Merge, p99.99 Within a Bucket, Intervals and TSC Clock",
+                      buckets_ok && exact && percentiles_ok && intervals && clock_ok && monitor_ok);
+}
+
+void test_metrics_registry() {
+    auto& registry = hft::MetricsRegistry::instance();
+    const hft::CounterId orders = registry.counter("test.orders");
+    const hft::GaugeId depth = registry.gauge("test.queue_depth");
+    const hft::HistogramId ack = registry.histogram("test.ack_latency");
+    // Names resolve to the same dense ids, from a declaration or a call-site template
+    const bool ids_ok = orders.valid() && depth.valid() && ack.valid() && registry.counter("test.orders").index == orders.index &&
+                        hft::counter_metric<"test.orders">().index == orders.index &&
+                        hft::histogram_metric<"test.ack_latency">().index == ack.index && registry.name(depth) == "test.queue_depth";
+    
+    // Four threads count into their own slots; totals survive the threads exiting
+    constexpr int THREADS = 4, ADDS = 250000;
+    std::vector<std::thread> threads;
+    for (int t = 0; t < THREADS; ++t) {
+        threads.emplace_back([&] {
+            for (int i = 0; i < ADDS; ++i) {
+                registry.add(orders);
+                if ((i & 1023) == 0) registry.record(ack, 1000 + i % 7);
+            }
+        });
+    }
+    for (auto& thread : threads) thread.join();
+    registry.set(depth, 42.5);
+    registry.collect();
+    const bool counters_ok = registry.value(orders) == static_cast<uint64_t>(THREADS * ADDS) && registry.value(depth) == 42.5;
+    
+    // Collector snapshot: totals, rates between collections, histogram summaries
+    for (int i = 0; i < 1000; ++i) registry.add(orders);
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    registry.start(hft::MetricsRegistry::Config{20});
+    std::this_thread::sleep_for(std::chrono::milliseconds(60));
+    registry.stop();
+    const auto snapshot = registry.latest();
+    bool snapshot_ok = snapshot.sequence >= 3;
+    int found = 0;
+    for (const auto& sample : snapshot.samples) {
+        if (sample.name == "test.orders") {
+            snapshot_ok &= sample.kind == hft::MetricKind::COUNTER && sample.value == THREADS * ADDS + 1000;
+            ++found;
+        } else if (sample.name == "test.queue_depth") {
+            snapshot_ok &= sample.value == 42.5;
+            ++found;
+        } else if (sample.name == "test.ack_latency") {
+            snapshot_ok &= sample.value == THREADS * ((ADDS + 1023) / 1024) && sample.min_ns >= 1000 && sample.p9999_ns <= 1006;
+            ++found;
+        }
+    }
+    snapshot_ok &= found == 3;
+    
+    // Monitor components count through registry counters, resolved once
+    hft::monitoring::RealTimeMonitor monitor;
+    hft::monitoring::ComponentHealth* feed = monitor.component("feed_handler");
+    const uint64_t feed_before = feed ? feed->message_count() : 0;
+    std::thread feeder([&] { for (int i = 0; i < 1000; ++i) feed->increment_messages(); });
+    feeder.join();
+    for (int i = 0; i < 500; ++i) monitor.component_message_processed("feed_handler");
+    monitor.update_spread(7u, hft::Venue::CME, 2.5);
+    const bool monitor_ok = feed && feed->message_count() - feed_before == 1500 && !monitor.component("unknown") &&
+                            feed->check_health(5000000000ULL, 10) &&
+                            registry.value(registry.gauge("spread_bps.SYM7_" + std::to_string(static_cast<int>(hft::Venue::CME)))) == 2.5;
+    
+    // Hot-path cost of a counter increment
+    constexpr int TIMED = 10000000;
+    const uint64_t start = hft::get_timestamp_ns();
+    for (int i = 0; i < TIMED; ++i) registry.add(orders);
+    const double ns_per_add = static_cast<double>(hft::get_timestamp_ns() - start) / TIMED;
+    
+    std::cout << "   Metrics: " << registry.size() << " registered, " << ns_per_add << " ns/increment, "
+              << snapshot.sequence << " collections" << std::endl;
+    print_test_result("Metrics Registry - Dense Ids, Per-Thread Counter Slots and Collector Snapshots",
+                      ids_ok && counters_ok && snapshot_ok && monitor_ok);
+}
+
+void test_metrics_segment() {
+    // The publisher copies each collection into shared memory; a reader maps it read-only
+    const std::string name = "/hft_metrics_test_" + std::to_string(::getpid());
+    auto& registry = hft::MetricsRegistry::instance();
+    const hft::CounterId fills = registry.counter("test.segment_fills");
+    const hft::HistogramId latency = registry.histogram("test.segment_latency");
+    for (int i = 0; i < 500; ++i) {
+        registry.add(fills);
+        registry.record(latency, 2000 + i);
+    }
+    
+    auto& publisher = hft::MetricsPublisher::instance();
+    const bool started = publisher.start(name.c_str(), 20);
+    std::this_thread::sleep_for(std::chrono::milliseconds(80));
+    publisher.stop();
+    
+    hft::MetricsSegment reader;
+    const bool opened = reader.open(name.c_str());
+    const auto info = reader.info();
+    std::vector<hft::MetricRecord> records;
+    const size_t skipped = reader.read(records);
+    const size_t registered = registry.size();
+    bool fills_ok = false, latency_ok = false, infrastructure = false, risk_state = false;
+    for (const auto& record : records) {
+        const std::string metric = record.name;
+        if (metric == "test.segment_fills") {
+            fills_ok = record.kind == static_cast<uint8_t>(hft::MetricKind::COUNTER) && record.value == 500;
+        } else if (metric == "test.segment_latency") {
+            latency_ok = record.value == 500 && record.min_ns == 2000 && record.max_ns == 2499 &&
+                         record.p50_ns >= 2249 && record.p50_ns <= 2249 + 2249 / 64 && record.p9999_ns == 2499;
+        } else if (metric == "logger.ring_occupancy_pct" || metric == "io.ring_occupancy_pct") {
+            infrastructure = true;
+        } else if (metric == "risk.halted") {
+            risk_state = record.kind == static_cast<uint8_t>(hft::MetricKind::GAUGE) &&
+                         record.value == (hft::KillSwitch::instance().halted() ? 1.0 : 0.0);
+        }
+    }
+    const bool published = started && opened && info.valid && info.pid == ::getpid() && info.sequence >= 2 &&
+                           skipped == 0 && records.size() == registered && info.count == registered;
+    
+    // A segment of another layout is refused rather than misread
+    const std::string foreign = name + "_foreign";
+    const int fd = ::shm_open(foreign.c_str(), O_RDWR | O_CREAT, 0600);
+    const bool sized = fd >= 0 && ::ftruncate(fd, 4096) == 0;
+    if (fd >= 0) ::close(fd);
+    hft::MetricsSegment other;
+    const bool refused = sized && !other.open(foreign.c_str()) && errno == EPROTO && !other.is_open();
+    hft::MetricsSegment::unlink(foreign.c_str());
+    hft::MetricsSegment::unlink(name.c_str());
+    
+    std::cout << "   Segment: " << records.size() << " metrics, " << info.sequence << " publications, "
+              << hft::MetricsSegment::segment_size(hft::MetricsSegment::CAPACITY) / 1024 << " KB" << std::endl;
+    print_test_result("Metrics Segment - Shared-Memory Publication, Seqlock Reads and Layout Check",
+                      published && fills_ok && latency_ok && infrastructure && risk_state && refused);
+}
+
+void test_backtest_engine() {
+    // One synthetic session: SPY drifts away from VWAP with oversold RSI mid-morning
+    BacktestDay day;
+    day.date = "2026-03-17";
+    const uint64_t open_ns = 1773754200ULL * 1000000000ULL; // 2026-03-17 09:30 EDT
+    for (int i = 0; i < 4000; i++) {
+        EnhancedMarketData data;
+        data.symbol = (i % 2) ? "QQQ" : "SPY";
+        double base = (i % 2) ? 375.0 : 450.0;
+        data.last = base * (1.0 - 0.015 * std::sin(i * 0.002));
+        data.bid = data.last - 0.01;
+        data.ask = data.last + 0.01;
+        data.vwap = base;
+        data.rsi_5 = data.last < base ? 20.0 : 80.0;
+        data.rsi_14 = data.rsi_5;
+        data.cumulative_volume = 2000000;
+        data.average_volume_30d = 1000000;
+        data.timestamp_ns = open_ns + static_cast<uint64_t>(i) * 5000000000ULL;
+        day.ticks.push_back(data);
+    }
+    
+    ParameterGrid grid;
+    bool grid_ok = grid.sweep("vwap.min_distance_from_vwap", 0.005, 0.02, 0.005) &&
+                   grid.sweep("risk.max_trades_per_day", {2, 4}) &&
+                   !grid.sweep("vwap.no_such_field", {1.0}) && grid.size() == 8;
+    
+    BacktestConfig config;
+    config.threads = 2;
+    BacktestEngine engine(config, SessionCalendar());
+    engine.add_day(day);
+    auto first = engine.run(grid.build());
+    auto second = engine.run(grid.build());
+    
+    bool traded = false, repeatable = first.size() == 8;
+    for (size_t i = 0; i < first.size() && repeatable; i++) {
+        traded |= first[i].stats.trades_taken > 0;
+        repeatable &= first[i].stats.net_pnl == second[i].stats.net_pnl &&
+                      first[i].stats.trades_taken <= first[i].params.limits.max_trades_per_day;
+    }
+    
+    print_test_result("Backtest Engine - Parameter Grid and Deterministic Sweep",
+                      grid_ok && traded && repeatable);
+}
+
 int main() {
     std::cout << "🧪 Running Intraday Trading Strategy Tests...\n" << std::endl;
     
@@ -151,6 +2172,31 @@ int main() {
     
     std::cout << "\n=== Strategy Logic Tests ===" << std::endl;
     test_signal_generation();
+    test_session_clock();
+    test_pair_divergence();
+    test_strategy_host();
+    test_execution_pipeline();
+    test_order_manager();
+    test_smart_order_router();
+    test_execution_algos();
+    test_rate_limiter();
+    test_basket_orders();
+    test_position_tracker();
+    test_portfolio_aggregates();
+    test_session_recovery();
+    test_risk_fast_path();
+    test_risk_pipeline();
+    test_covariance_engine();
+    test_var_engine();
+    test_stress_matrix();
+    test_risk_event_coalescer();
+    test_kill_switch();
+    test_binary_logger();
+    test_io_service();
+    test_latency_histogram();
+    test_metrics_registry();
+    test_metrics_segment();
+    test_backtest_engine();
     
     std::cout << "\n✅ Strategy validation tests completed!" << std::endl;
     std::cout << "💡 For full integration testing, run the main intraday_trader executable" << std::endl;
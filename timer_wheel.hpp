@@ -0,0 +1,152 @@
+// timer_wheel.hpp - Hashed timer wheel for large numbers of event-loop timers
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace hft {
+
+/**
+ * Hashed Timer Wheel
+ *
+ * Timers hash into a power-of-two ring of slots by due tick; timers more
+ * than one rotation out stay in their slot until their tick comes round.
+ * schedule() and cancel() are O(1) (pooled doubly-linked nodes, no
+ * allocation after construction), and advance() only visits the slots for
+ * the ticks that elapsed, so the per-tick cost is independent of how many
+ * timers are pending. Single-threaded.
+ */
+class TimerWheel {
+public:
+    using TimerId = uint32_t;
+    static constexpr TimerId INVALID_TIMER = 0xFFFFFFFF;
+
+private:
+    static constexpr uint32_t NIL = 0xFFFFFFFF;
+
+    struct Node {
+        uint64_t due_tick;
+        uint64_t payload;
+        uint32_t prev;
+        uint32_t next;
+        uint32_t slot;
+        bool active;
+    };
+
+    uint64_t tick_ns_;
+    uint64_t slot_mask_;
+    uint64_t current_tick_ = 0;     // Last tick advanced to (the first advance() sweeps every slot)
+
+    std::vector<uint32_t> heads_;
+    std::vector<Node> nodes_;
+    std::vector<uint32_t> free_list_;
+    std::vector<uint64_t> fired_;       // Scratch for advance(); keeps callbacks out of list walks
+    size_t size_ = 0;
+
+public:
+    /**
+     * @param tick_ns Timer resolution
+     * @param slots Wheel size (rounded up to a power of two)
+     * @param capacity Maximum pending timers
+     */
+    TimerWheel(uint64_t tick_ns, size_t slots = 1024, size_t capacity = 4096)
+        : tick_ns_(tick_ns) {
+        size_t slot_count = 1;
+        while (slot_count < slots) slot_count <<= 1;
+        slot_mask_ = slot_count - 1;
+        heads_.assign(slot_count, NIL);
+
+        nodes_.resize(capacity);
+        free_list_.reserve(capacity);
+        for (size_t i = capacity; i-- > 0;) {
+            free_list_.push_back(static_cast<uint32_t>(i));
+        }
+        fired_.reserve(capacity);
+    }
+
+    /**
+     * Schedule a timer; it fires on the first advance() at or after due_ns
+     * @return Timer id, or INVALID_TIMER if the pool is exhausted
+     */
+    TimerId schedule(uint64_t due_ns, uint64_t payload) {
+        if (free_list_.empty()) return INVALID_TIMER;
+
+        uint64_t due_tick = (due_ns + tick_ns_ - 1) / tick_ns_;    // Never fire early
+        if (due_tick <= current_tick_) due_tick = current_tick_ + 1;
+
+        const uint32_t id = free_list_.back();
+        free_list_.pop_back();
+
+        const uint32_t slot = static_cast<uint32_t>(due_tick & slot_mask_);
+        Node& node = nodes_[id];
+        node.due_tick = due_tick;
+        node.payload = payload;
+        node.prev = NIL;
+        node.next = heads_[slot];
+        node.slot = slot;
+        node.active = true;
+        if (node.next != NIL) nodes_[node.next].prev = id;
+        heads_[slot] = id;
+        ++size_;
+        return id;
+    }
+
+    bool cancel(TimerId id) {
+        if (id >= nodes_.size() || !nodes_[id].active) return false;
+        unlink(id);
+        return true;
+    }
+
+    /**
+     * Fire every timer due at or before now_ns
+     * @param fn Called with each due timer's payload (may schedule new timers)
+     * @return Number of timers fired
+     */
+    template<typename Fn>
+    size_t advance(uint64_t now_ns, Fn&& fn) {
+        const uint64_t now_tick = now_ns / tick_ns_;
+        if (now_tick <= current_tick_) return 0;
+
+        fired_.clear();
+        // A jump longer than one rotation visits every slot once
+        const uint64_t elapsed = now_tick - current_tick_;
+        const uint64_t visits = elapsed > slot_mask_ ? slot_mask_ + 1 : elapsed;
+        for (uint64_t t = 1; t <= visits; ++t) {
+            const uint32_t slot = static_cast<uint32_t>((current_tick_ + t) & slot_mask_);
+            uint32_t id = heads_[slot];
+            while (id != NIL) {
+                const uint32_t next = nodes_[id].next;
+                if (nodes_[id].due_tick <= now_tick) {
+                    fired_.push_back(nodes_[id].payload);
+                    unlink(id);
+                }
+                id = next;
+            }
+        }
+        current_tick_ = now_tick;
+
+        for (uint64_t payload : fired_) fn(payload);
+        return fired_.size();
+    }
+
+    size_t size() const { return size_; }
+    size_t capacity() const { return nodes_.size(); }
+    uint64_t tick_ns() const { return tick_ns_; }
+
+private:
+    void unlink(uint32_t id) {
+        Node& node = nodes_[id];
+        if (node.prev != NIL) {
+            nodes_[node.prev].next = node.next;
+        } else {
+            heads_[node.slot] = node.next;
+        }
+        if (node.next != NIL) nodes_[node.next].prev = node.prev;
+        node.active = false;
+        free_list_.push_back(id);
+        --size_;
+    }
+};
+
+} // namespace hft
@@ -0,0 +1,175 @@
+// work_stealing_pool.hpp - Work-stealing thread pool for coarse-grained batch jobs
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "sequencer.hpp"
+
+namespace hft {
+
+/**
+ * Work-Stealing Thread Pool
+ *
+ * Each worker owns a deque: it pushes and pops its own work at the back
+ * (LIFO, cache-warm) and idle workers steal from the front of other
+ * deques (FIFO, oldest and usually largest work first). Intended for
+ * batch jobs such as backtest sweeps where tasks run for milliseconds to
+ * seconds, so a short mutex per deque is not a bottleneck.
+ */
+class WorkStealingPool {
+public:
+    using Task = std::function<void()>;
+
+private:
+    struct alignas(CACHE_LINE_SIZE) Worker {
+        std::mutex mutex;
+        std::deque<Task> tasks;
+        std::thread thread;
+    };
+
+    std::vector<std::unique_ptr<Worker>> workers_;
+
+    std::atomic<size_t> queued_{0};       // Tasks sitting in deques
+    std::atomic<size_t> in_flight_{0};    // Tasks submitted but not finished
+    std::atomic<size_t> next_worker_{0};  // Round-robin target for external submits
+    std::atomic<uint64_t> steals_{0};
+    std::atomic<bool> stopping_{false};
+
+    std::mutex wake_mutex_;
+    std::condition_variable wake_cv_;
+    std::condition_variable idle_cv_;
+
+    static inline thread_local WorkStealingPool* current_pool_ = nullptr;
+    static inline thread_local size_t current_index_ = 0;
+
+public:
+    /**
+     * @param threads Worker count (0 = hardware concurrency)
+     * @param pin_threads Pin worker i to core i
+     */
+    explicit WorkStealingPool(size_t threads = 0, bool pin_threads = false) {
+        if (threads == 0) {
+            threads = std::max(1u, std::thread::hardware_concurrency());
+        }
+
+        for (size_t i = 0; i < threads; ++i) {
+            workers_.push_back(std::make_unique<Worker>());
+        }
+        for (size_t i = 0; i < threads; ++i) {
+            workers_[i]->thread = std::thread([this, i, pin_threads] {
+                if (pin_threads) pin_current_thread(static_cast<int>(i));
+                worker_loop(i);
+            });
+        }
+    }
+
+    ~WorkStealingPool() {
+        wait_idle();
+        {
+            std::lock_guard<std::mutex> lock(wake_mutex_);
+            stopping_.store(true, std::memory_order_release);
+        }
+        wake_cv_.notify_all();
+        for (auto& worker : workers_) {
+            if (worker->thread.joinable()) worker->thread.join();
+        }
+    }
+
+    WorkStealingPool(const WorkStealingPool&) = delete;
+    WorkStealingPool& operator=(const WorkStealingPool&) = delete;
+
+    /**
+     * Queue a task. Tasks submitted from a worker go to that worker's own
+     * deque; external submits are spread round-robin.
+     */
+    void submit(Task task) {
+        const size_t target = current_pool_ == this
+            ? current_index_
+            : next_worker_.fetch_add(1, std::memory_order_relaxed) % workers_.size();
+
+        in_flight_.fetch_add(1, std::memory_order_acq_rel);
+        {
+            std::lock_guard<std::mutex> lock(workers_[target]->mutex);
+            workers_[target]->tasks.push_back(std::move(task));
+        }
+        queued_.fetch_add(1, std::memory_order_release);
+
+        {
+            std::lock_guard<std::mutex> lock(wake_mutex_);
+        }
+        wake_cv_.notify_one();
+    }
+
+    /**
+     * Block until every submitted task (including tasks they spawned) has run
+     */
+    void wait_idle() {
+        std::unique_lock<std::mutex> lock(wake_mutex_);
+        idle_cv_.wait(lock, [this] { return in_flight_.load(std::memory_order_acquire) == 0; });
+    }
+
+    size_t thread_count() const { return workers_.size(); }
+    uint64_t steal_count() const { return steals_.load(std::memory_order_relaxed); }
+
+private:
+    void worker_loop(size_t index) {
+        current_pool_ = this;
+        current_index_ = index;
+
+        Task task;
+        while (true) {
+            if (pop_local(index, task) || steal(index, task)) {
+                task();
+                task = nullptr;
+                if (in_flight_.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+                    std::lock_guard<std::mutex> lock(wake_mutex_);
+                    idle_cv_.notify_all();
+                }
+                continue;
+            }
+
+            std::unique_lock<std::mutex> lock(wake_mutex_);
+            wake_cv_.wait(lock, [this] {
+                return stopping_.load(std::memory_order_acquire) ||
+                       queued_.load(std::memory_order_acquire) > 0;
+            });
+            if (stopping_.load(std::memory_order_acquire) &&
+                queued_.load(std::memory_order_acquire) == 0) {
+                return;
+            }
+        }
+    }
+
+    bool pop_local(size_t index, Task& task) {
+        Worker& self = *workers_[index];
+        std::lock_guard<std::mutex> lock(self.mutex);
+        if (self.tasks.empty()) return false;
+        task = std::move(self.tasks.back());
+        self.tasks.pop_back();
+        queued_.fetch_sub(1, std::memory_order_acq_rel);
+        return true;
+    }
+
+    bool steal(size_t index, Task& task) {
+        const size_t n = workers_.size();
+        for (size_t offset = 1; offset < n; ++offset) {
+            Worker& victim = *workers_[(index + offset) % n];
+            std::lock_guard<std::mutex> lock(victim.mutex);
+            if (victim.tasks.empty()) continue;
+            task = std::move(victim.tasks.front());
+            victim.tasks.pop_front();
+            queued_.fetch_sub(1, std::memory_order_acq_rel);
+            steals_.fetch_add(1, std::memory_order_relaxed);
+            return true;
+        }
+        return false;
+    }
+};
+
+} // namespace hft